@@ -102,3 +102,13 @@ float Biquad::ProcessSample(float xn)
     // Return current output sample
     return yn;
 }
+
+void Biquad::GetCoefficients(float& B0, float& B1, float& B2, float& A1, float& A2) const
+{
+    // Normalise by a0, as ProcessSample does
+    B0 = b0 / a0;
+    B1 = b1 / a0;
+    B2 = b2 / a0;
+    A1 = a1 / a0;
+    A2 = a2 / a0;
+}
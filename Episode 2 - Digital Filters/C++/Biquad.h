@@ -47,6 +47,9 @@ class Biquad
 
     // Process a sample with the filter
     float ProcessSample(float xn);
+
+    // Get the coefficients normalised by a0, for running the same design in another number format.
+    void GetCoefficients(float& B0, float& B1, float& B2, float& A1, float& A2) const;
     
     private:
 
@@ -168,6 +171,16 @@ class Biquad
 
             case HighShelf:
 
+            // Compute the feedforward coefficients 'b'
+            b0 = A * ((A + 1.f) + (A - 1.f) * cosw + var2sqAa);
+            b1 = (-2.f) * A * ((A - 1.f) + (A + 1.f) * cosw);
+            b2 = A * ((A + 1.f) + (A - 1.f) * cosw - var2sqAa);
+
+            // Compute the feedback coefficients 'a'
+            a0 = (A + 1.f) - (A - 1.f) * cosw + var2sqAa;
+            a1 = 2.f * ((A - 1.f) - (A + 1.f) * cosw);
+            a2 = (A + 1.f) - (A - 1.f) * cosw - var2sqAa;
+
             break;
         }
 
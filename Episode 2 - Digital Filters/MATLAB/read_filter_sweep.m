@@ -0,0 +1,48 @@
+function [designs] = read_filter_sweep(filename)
+% Reads the binary output of the FilterSweep tool (Tools/FilterSweep).
+% Inputs:
+%   - filename: File written by FilterSweep --out
+% Output:
+%   - designs: Struct array with one entry per design, with the fields
+%     type, fc, Q, gain_dB, fs, flags, error_dB, impulse, freq, mag_dB and phase
+
+% Open the file as little endian
+fid = fopen(filename, 'r', 'ieee-le');
+cleanup = onCleanup(@() fclose(fid));
+
+% Check the header
+magic = fread(fid, 4, '*char')';
+if ~strcmp(magic, 'JEFS')
+    error('%s is not a FilterSweep file', filename);
+end
+
+header = fread(fid, 4, 'uint32');
+numDesigns = header(2);
+impulseLength = header(3);
+numPoints = header(4);
+
+designs = struct('type', {}, 'fc', {}, 'Q', {}, 'gain_dB', {}, 'fs', {}, 'flags', {}, ...
+                 'error_dB', {}, 'impulse', {}, 'freq', {}, 'mag_dB', {}, 'phase', {});
+
+% Read each design
+for i = 1:numDesigns
+
+    designs(i).type = fread(fid, 1, 'int32');
+
+    parameters = fread(fid, 4, 'single');
+    designs(i).fc = parameters(1);
+    designs(i).Q = parameters(2);
+    designs(i).gain_dB = parameters(3);
+    designs(i).fs = parameters(4);
+
+    designs(i).flags = fread(fid, 1, 'uint32');
+    designs(i).error_dB = fread(fid, 1, 'single');
+
+    designs(i).impulse = fread(fid, impulseLength, 'single');
+    designs(i).freq = fread(fid, numPoints, 'single');
+    designs(i).mag_dB = fread(fid, numPoints, 'single');
+    designs(i).phase = fread(fid, numPoints, 'single');
+
+end
+
+end
@@ -2,19 +2,63 @@
 // Author: Jordan Evans
 // Date: 20/06/2023
 
+#include <type_traits>
 #include "Biquad.h"
 
-Biquad::Biquad()
+namespace
 {
+    // Feedforward half of the filter, b0 * x[n] + b1 * x[n - 1] + b2 * x[n - 2], written over the input. It runs from the end of the block backwards
+    // so every batch reads inputs that have not been overwritten yet, and the first two samples take their older inputs from the previous block.
+    struct FeedForwardKernel
+    {
+        using Function = void (*)(float*, int, float, float, float, float, float);
+
+        template <typename Ops>
+        static void Process(float* data, int numSamples, float b0, float b1, float b2, float xminusone, float xminustwo)
+        {
+            using Scalar = Simd::ScalarOps;
+
+            int numBatches = numSamples > 2 ? (numSamples - 2) / Ops::Width : 0;
+            int batchEnd = 2 + numBatches * Ops::Width;
+
+            // Samples after the last full batch.
+            for (int sample = numSamples - 1; sample >= batchEnd; sample--)
+                data[sample] = Scalar::Fma(b0, data[sample], Scalar::Fma(b1, data[sample - 1], b2 * data[sample - 2]));
+
+            // Full batches, each one reads the two inputs before it.
+            for (int sample = batchEnd - Ops::Width; sample >= 2; sample -= Ops::Width)
+            {
+                auto x = Ops::Load(data + sample);
+                auto x1 = Ops::Load(data + sample - 1);
+                auto x2 = Ops::Load(data + sample - 2);
+
+                Ops::Store(data + sample, Ops::Fma(Ops::Set(b0), x, Ops::Fma(Ops::Set(b1), x1, Ops::Mul(Ops::Set(b2), x2))));
+            }
+
+            // The first two samples use the end of the previous block.
+            if (numSamples > 1)
+                data[1] = Scalar::Fma(b0, data[1], Scalar::Fma(b1, data[0], b2 * xminusone));
+
+            if (numSamples > 0)
+                data[0] = Scalar::Fma(b0, data[0], Scalar::Fma(b1, xminusone, b2 * xminustwo));
+        }
+    };
+}
 
+template <typename SampleType>
+FloatBiquad<SampleType>::FloatBiquad()
+{
+    feedForward = Simd::Dispatch<FeedForwardKernel>();
 }
 
-Biquad::~Biquad()
+template <typename SampleType>
+FloatBiquad<SampleType>::~FloatBiquad()
 {
 
 }
 
-void Biquad::Init(BiquadType filterType, float fc, float fs, float Q, float gain_dB)
+template <typename SampleType>
+void FloatBiquad<SampleType>::Init(BiquadType filterType, float fc, float fs, float Q, float gain_dB)
 {
     // Save variables
     CurrentType = filterType;
@@ -27,7 +71,8 @@ void Biquad::Init(BiquadType filterType, float fc, float fs, float Q, float gain
     CalcFilter();
 }
 
-void Biquad::SetParameters(float fc, float Q, float gain_dB)
+template <typename SampleType>
+void FloatBiquad<SampleType>::SetParameters(float fc, float Q, float gain_dB)
 {  
     // Only recalculate if a parameter has changed
     if(fc != CutoffFrequency || Q != QualityFactor || gain_dB != Gain_dB)
@@ -43,7 +88,8 @@ void Biquad::SetParameters(float fc, float Q, float gain_dB)
 
 }
 
-void Biquad::SetFc(float fc)
+template <typename SampleType>
+void FloatBiquad<SampleType>::SetFc(float fc)
 {
     // Only recalculate if cutoff frequency changed
     if(fc != CutoffFrequency)
@@ -56,7 +102,8 @@ void Biquad::SetFc(float fc)
     }
 }
 
-void Biquad::SetGain(float gain_dB)
+template <typename SampleType>
+void FloatBiquad<SampleType>::SetGain(float gain_dB)
 {
     // Only recalculate if gain has changed
     if(gain_dB != Gain_dB)
@@ -70,10 +117,11 @@ void Biquad::SetGain(float gain_dB)
 }
 
 
-void Biquad::Reset(float fs)
+template <typename SampleType>
+void FloatBiquad<SampleType>::Reset(float fs)
 {
     // Reset filter state variables
-    yminustwo = yminusone = xminustwo = xminusone = 0.0f;
+    yminustwo = yminusone = xminustwo = xminusone = 0;
 
     // Only recalculate if sample rate changed
     if (fs != SampleRate)
@@ -86,10 +134,11 @@ void Biquad::Reset(float fs)
     }
 }
 
-float Biquad::ProcessSample(float xn)
+template <typename SampleType>
+SampleType FloatBiquad<SampleType>::ProcessSample(SampleType xn)
 {
     // Calculate current output sample
-    float yn = (b0 / a0) * xn + (b1 / a0) * xminusone + (b2 / a0) * xminustwo - (a1 / a0) * yminusone - (a2 / a0) * yminustwo;
+    SampleType yn = (b0 / a0) * xn + (b1 / a0) * xminusone + (b2 / a0) * xminustwo - (a1 / a0) * yminusone - (a2 / a0) * yminustwo;
 
     // Update input state variables
     xminustwo = xminusone;
@@ -102,3 +151,87 @@ float Biquad::ProcessSample(float xn)
     // Return current output sample
     return yn;
 }
+
+template <typename SampleType>
+void FloatBiquad<SampleType>::GetCoefficients(SampleType& B0, SampleType& B1, SampleType& B2, SampleType& A1, SampleType& A2) const
+{
+    // Normalise by a0, as ProcessSample does
+    B0 = b0 / a0;
+    B1 = b1 / a0;
+    B2 = b2 / a0;
+    A1 = a1 / a0;
+    A2 = a2 / a0;
+}
+
+template <typename SampleType>
+void FloatBiquad<SampleType>::SetCoefficients(float fc, SampleType B0, SampleType B1, SampleType B2, SampleType A1, SampleType A2)
+{
+    // Save cutoff frequency so an unchanged cutoff does not recalculate over these
+    CutoffFrequency = fc;
+
+    // Already normalised, so a0 is 1
+    b0 = B0;
+    b1 = B1;
+    b2 = B2;
+    a0 = 1;
+    a1 = A1;
+    a2 = A2;
+}
+
+template <typename SampleType>
+void FloatBiquad<SampleType>::ProcessBlock(SampleType* data, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    // Normalised coefficients
+    SampleType B0 = b0 / a0;
+    SampleType B1 = b1 / a0;
+    SampleType B2 = b2 / a0;
+    SampleType A1 = a1 / a0;
+    SampleType A2 = a2 / a0;
+
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        // Keep the last two inputs for the next block before the kernel overwrites them.
+        float lastInput = data[numSamples - 1];
+        float secondLastInput = numSamples > 1 ? data[numSamples - 2] : xminusone;
+
+        // Feedforward half for the whole block
+        feedForward(data, numSamples, B0, B1, B2, xminusone, xminustwo);
+
+        // Feedback half, sample by sample
+        for (int sample = 0; sample < numSamples; sample++)
+        {
+            float yn = data[sample] - A1 * yminusone - A2 * yminustwo;
+
+            yminustwo = yminusone;
+            yminusone = yn;
+
+            data[sample] = yn;
+        }
+
+        // Update input state variables
+        xminusone = lastInput;
+        xminustwo = secondLastInput;
+    }
+    else
+    {
+        // Double has no SIMD kernel, so the whole filter runs sample by sample.
+        for (int sample = 0; sample < numSamples; sample++)
+        {
+            SampleType xn = data[sample];
+            SampleType yn = B0 * xn + B1 * xminusone + B2 * xminustwo - A1 * yminusone - A2 * yminustwo;
+
+            xminustwo = xminusone;
+            xminusone = xn;
+            yminustwo = yminusone;
+            yminusone = yn;
+
+            data[sample] = yn;
+        }
+    }
+}
+
+template class FloatBiquad<float>;
+template class FloatBiquad<double>;
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cmath>
+#include "Simd.h"
 #define pi 3.1415926535897932384626433
 
 enum BiquadType
@@ -18,15 +19,19 @@ enum BiquadType
 };
 
 
-class Biquad
+// Biquad in either floating point type. Biquad runs in float, with the feedforward half of ProcessBlock as a SIMD kernel, and BiquadDouble runs the
+// whole filter in double for hosts that process in double, which also keeps low cutoffs at high sample rates accurate where float coefficients
+// and state run out of bits. Both are defined in Biquad.cpp.
+template <typename SampleType>
+class FloatBiquad
 {
 
     public:
 
     // Ctor
-    Biquad();
+    FloatBiquad();
     // Dtor
-    ~Biquad();  
+    ~FloatBiquad();  
 
     // Initialise filter with specified parameters, call to change filter type 
     // Only peaking and shelving filters require gain so set to 0.0f when NOT using those types.
@@ -46,25 +51,36 @@ class Biquad
     void Reset(float fs);
 
     // Process a sample with the filter
-    float ProcessSample(float xn);
+    SampleType ProcessSample(SampleType xn);
+
+    // Get the coefficients normalised by a0, for running the same design in another number format.
+    void GetCoefficients(SampleType& B0, SampleType& B1, SampleType& B2, SampleType& A1, SampleType& A2) const;
+
+    // Load coefficients normalised by a0 (as GetCoefficients gives them) that were worked out ahead of time for cutoff fc, so a preset can change
+    // the filter without recalculating it. The filter state is kept, and SetFc only recalculates once it is given a cutoff other than fc.
+    void SetCoefficients(float fc, SampleType B0, SampleType B1, SampleType B2, SampleType A1, SampleType A2);
+
+    // Process a block of samples in place. In float the feedforward half of the filter only depends on the input, so it runs as a SIMD kernel
+    // over the whole block and only the feedback half is left sample by sample. The SIMD layer is float only, so double runs sample by sample.
+    void ProcessBlock(SampleType* data, int numSamples);
     
     private:
 
     // Feedforward coeffs
-    float a0 = 0.0f;
-    float a1 = 0.0f;
-    float a2 = 0.0f;
+    SampleType a0 = 0;
+    SampleType a1 = 0;
+    SampleType a2 = 0;
 
     // Feedback coeffs
-    float b0 = 0.0f;
-    float b1 = 0.0f;
-    float b2 = 0.0f;
+    SampleType b0 = 0;
+    SampleType b1 = 0;
+    SampleType b2 = 0;
     
     // State variables
-    float xminusone = 0.0f;
-    float xminustwo = 0.0f;
-    float yminusone = 0.0f;
-    float yminustwo = 0.0f;
+    SampleType xminusone = 0;
+    SampleType xminustwo = 0;
+    SampleType yminusone = 0;
+    SampleType yminustwo = 0;
 
     // Parameters
     float CutoffFrequency = 0.0f;
@@ -73,26 +89,29 @@ class Biquad
     float Gain_dB = 0.0f;
     int CurrentType = 0;
 
+    // Feedforward kernel for the widest instruction set the machine supports, picked when the filter is created. Only used in float.
+    void (*feedForward)(float* data, int numSamples, float b0, float b1, float b2, float xminusone, float xminustwo) = nullptr;
+
     // Calculate filter for current parameters
     void CalcFilter()
     {
         // Omega: Angular frequency
-        float w = 2 * pi * (CutoffFrequency / SampleRate);
+        SampleType w = 2 * pi * ((SampleType)CutoffFrequency / SampleRate);
 
         // Cos(Omega)
-        float cosw = cos(w);
+        SampleType cosw = cos(w);
 
         // Sin(Omega)
-        float sinw = sin(w);
+        SampleType sinw = sin(w);
 
         // Damping Coefficient
-        float a = sinw / (2 * QualityFactor);
+        SampleType a = sinw / (2 * QualityFactor);
 
         // Gain for shelving and peaking filters
-        float A = pow(10, (Gain_dB / 40.f));
+        SampleType A = pow(10, ((SampleType)Gain_dB / 40.f));
 
         // Variable for shelving filter coeff calculation (simplifies calculations)
-        float var2sqAa = 2 * sqrt(A) * a;
+        SampleType var2sqAa = 2 * sqrt(A) * a;
 
         switch(CurrentType)
         {
@@ -168,6 +187,16 @@ class Biquad
 
             case HighShelf:
 
+            // Compute the feedforward coefficients 'b'
+            b0 = A * ((A + 1.f) + (A - 1.f) * cosw + var2sqAa);
+            b1 = (-2.f) * A * ((A - 1.f) + (A + 1.f) * cosw);
+            b2 = A * ((A + 1.f) + (A - 1.f) * cosw - var2sqAa);
+
+            // Compute the feedback coefficients 'a'
+            a0 = (A + 1.f) - (A - 1.f) * cosw + var2sqAa;
+            a1 = 2.f * ((A - 1.f) - (A + 1.f) * cosw);
+            a2 = (A + 1.f) - (A - 1.f) * cosw - var2sqAa;
+
             break;
         }
 
@@ -175,3 +204,10 @@ class Biquad
     }
 
 };
+
+// The two precisions, defined in Biquad.cpp.
+using Biquad = FloatBiquad<float>;
+using BiquadDouble = FloatBiquad<double>;
+
+extern template class FloatBiquad<float>;
+extern template class FloatBiquad<double>;
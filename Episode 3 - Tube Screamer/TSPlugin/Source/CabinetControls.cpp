@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    CabinetControls.cpp
+    Created: 19 Oct 2026 10:06:41pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include "CabinetControls.h"
+#include "PluginProcessor.h"
+
+CabinetControls::CabinetControls(TSPluginAudioProcessor& processor)
+    : audioProcessor(processor)
+{
+    nameLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(nameLabel);
+
+    loadButton.onClick = [this] { chooseFile(); };
+    addAndMakeVisible(loadButton);
+
+    clearButton.onClick = [this]
+    {
+        audioProcessor.clearCabinet();
+        updateName();
+    };
+    addAndMakeVisible(clearButton);
+
+    updateName();
+    setSize(360, controlsHeight);
+}
+
+CabinetControls::~CabinetControls()
+{
+}
+
+void CabinetControls::resized()
+{
+    auto bounds = getLocalBounds().reduced(4);
+
+    clearButton.setBounds(bounds.removeFromRight(buttonWidth));
+    bounds.removeFromRight(4);
+    loadButton.setBounds(bounds.removeFromRight(buttonWidth));
+    nameLabel.setBounds(bounds);
+}
+
+void CabinetControls::chooseFile()
+{
+    chooser = std::make_unique<juce::FileChooser>("Load a cabinet impulse response", juce::File(), "*.wav;*.aif;*.aiff");
+
+    chooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles, [this](const juce::FileChooser& fileChooser)
+    {
+        juce::File file = fileChooser.getResult();
+
+        if (file != juce::File())
+            updateName(audioProcessor.loadCabinet(file));
+    });
+}
+
+void CabinetControls::updateName(const juce::String& error)
+{
+    juce::String name = audioProcessor.getCabinetName();
+
+    if (error.isNotEmpty())
+        nameLabel.setText(error, juce::dontSendNotification);
+    else
+        nameLabel.setText("Cabinet: " + (name.isNotEmpty() ? name : juce::String("none")), juce::dontSendNotification);
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    CabinetControls.h
+    Created: 19 Oct 2026 10:06:41pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class TSPluginAudioProcessor;
+
+// Load and clear buttons for the cabinet impulse response, with the name of the one that is loaded. Shown in the editor between the parameters and
+// the performance figures, the cabinet parameter itself is with the other parameters.
+class CabinetControls : public juce::Component
+{
+
+public:
+
+    // C-tor
+    CabinetControls(TSPluginAudioProcessor& processor);
+    // D-tor
+    ~CabinetControls() override;
+
+    void resized() override;
+
+private:
+
+    TSPluginAudioProcessor& audioProcessor;
+
+    juce::Label nameLabel;
+    juce::TextButton loadButton { "Load IR..." };
+    juce::TextButton clearButton { "Clear" };
+    std::unique_ptr<juce::FileChooser> chooser;
+
+    static constexpr int controlsHeight = 32;
+    static constexpr int buttonWidth = 80;
+
+    // Ask for an impulse response file and load it.
+    void chooseFile();
+
+    // Show the loaded impulse response, or an error message if loading failed.
+    void updateName(const juce::String& error = {});
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabinetControls)
+};
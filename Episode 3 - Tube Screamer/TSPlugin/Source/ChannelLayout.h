@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    ChannelLayout.h
+    Created: 19 Oct 2026 5:12:40pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// Channel layouts that have their own processing kernel. The layout is worked out once per block and passed down to the DSP stages, so the sample
+// loops inside the kernels never have to check the channel count.
+enum class ChannelLayout
+{
+    Mono,
+    MonoToStereo,
+    Stereo,
+    MultiChannel
+};
+
+// Pick the layout for the number of input and output channels being processed.
+inline ChannelLayout GetChannelLayout(int numInputs, int numOutputs)
+{
+    if (numInputs == 1 && numOutputs == 1)
+        return ChannelLayout::Mono;
+
+    if (numInputs == 1 && numOutputs == 2)
+        return ChannelLayout::MonoToStereo;
+
+    if (numInputs == 2 && numOutputs == 2)
+        return ChannelLayout::Stereo;
+
+    return ChannelLayout::MultiChannel;
+}
+
+// Number of channels a layout processes. Only channels that received input are processed, apart from mono/stereo which duplicates its input into the second output.
+inline int GetNumProcessedChannels(ChannelLayout layout, int numInputs, int numOutputs)
+{
+    return layout == ChannelLayout::MonoToStereo ? 2 : (numInputs < numOutputs ? numInputs : numOutputs);
+}
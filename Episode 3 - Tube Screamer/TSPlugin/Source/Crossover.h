@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    Crossover.h
+    Created: 20 Oct 2026 4:37:52pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Biquad.h"
+
+// Linkwitz-Riley (LR4) crossover splitting a signal into up to four bands that add back up to the input with only a change of phase. Each
+// crossover is a pair of cascaded Butterworth biquads (Q 0.7071) for the low side and another pair for the high side, designed with Biquad.
+//
+// The bands are not split as a tree, where each band waits on the filters of the band below it. Each band is worked out from the input on its
+// own, through the high sides of every crossover below it, the low side of its own crossover and an allpass for each crossover above it, and the
+// bands run side by side in the four lanes of one SIMD batch. The allpasses are what make the sum phase coherent, the low and high sides of an
+// LR4 crossover add up to a second order allpass at the crossover frequency, so every band has to go through the same allpass for each crossover
+// it was not split by. The bands then all carry the same phase and sum to the input through one allpass per crossover.
+//
+// Split writes the bands interleaved, the four bands of each sample next to each other, so the bands can be processed together by any kernel
+// that works on a plain array, and Combine adds them back up. Bands above the band count are silent. Float runs the filters as a SIMD kernel,
+// double runs them lane by lane. Both are defined in Crossover.cpp.
+template <typename SampleType>
+class FloatCrossover
+{
+
+public:
+
+    static constexpr int MaxBands = 4;
+
+    // C-tor
+    FloatCrossover();
+    // D-tor
+    ~FloatCrossover();
+
+    // Set the number of bands (1 - MaxBands) and the numBands - 1 crossover frequencies, lowest first. One band passes the input straight through.
+    void Init(int numBands, const float* frequencies, float fs);
+
+    // Clear the filter states, and redesign the filters if the sample rate has changed.
+    void Reset(float fs);
+
+    int GetNumBands() const { return NumBands; }
+
+    // Split numSamples samples of input into bands, which holds MaxBands * numSamples samples laid out band by band within each sample.
+    void Split(const SampleType* input, SampleType* bands, int numSamples);
+
+    // Add the bands of each sample back up into output, times gain.
+    static void Combine(const SampleType* bands, SampleType* output, int numSamples, SampleType gain);
+
+private:
+
+    // Sections each band runs through, the two biquads of each crossover's low or high side and an allpass for each crossover above.
+    static constexpr int MaxSections = 2 * (MaxBands - 1);
+
+    // Coefficients normalised by a0, b0, b1, b2, a1, a2 for each section with the four lanes of each one next to each other so each coefficient
+    // loads as a batch. Sections a band does not need pass it through unchanged.
+    SampleType Coefficients[MaxSections][5][MaxBands] = {};
+
+    // [n - 1] and [n - 2] of the input and then of each section's output, laid out the same way. Each section's output history is also the
+    // input history of the section after it.
+    SampleType State[MaxSections + 1][2][MaxBands] = {};
+
+    int NumBands = 1;
+    int NumSections = 0;
+    float Frequencies[MaxBands - 1] = {};
+    float SampleRate = 48000.0f;
+
+    // Filter kernel for the widest instruction set the machine supports, picked when the crossover is created. Only used in float.
+    void (*splitKernel)(const float* input, float* bands, int numSamples, const float* coefficients, float* state, int numSections) = nullptr;
+
+    // Work out the sections of every band for the current frequencies.
+    void design();
+
+    // Load a biquad's coefficients into one lane of a section.
+    void setSection(int section, int band, const SampleType* coefficients);
+};
+
+// The two precisions, defined in Crossover.cpp.
+using Crossover = FloatCrossover<float>;
+using CrossoverDouble = FloatCrossover<double>;
+
+extern template class FloatCrossover<float>;
+extern template class FloatCrossover<double>;
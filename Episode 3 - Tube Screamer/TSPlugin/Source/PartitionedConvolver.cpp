@@ -0,0 +1,576 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolver.cpp
+    Created: 19 Oct 2026 9:48:15pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include "PartitionedConvolver.h"
+
+namespace
+{
+    // Copy between the audio and the float blocks, converting when the audio is double.
+    void copySamples(float* destination, const float* source, int numSamples)
+    {
+        FloatVectorOperations::copy(destination, source, numSamples);
+    }
+
+    template <typename Destination, typename Source>
+    void copySamples(Destination* destination, const Source* source, int numSamples)
+    {
+        for (int sample = 0; sample < numSamples; sample++)
+            destination[sample] = (Destination)source[sample];
+    }
+
+    // First of a level's tasks to run in each of the numSteps blocks it has for a partition, firstTask(numSteps) is the number of tasks. The
+    // FFTs cost far more than a multiply-add, so where there are enough blocks each FFT gets one to itself, the forward FFTs in the first
+    // blocks and the inverse FFTs in the last, with the multiply-adds spread evenly over the blocks in between.
+    int firstTask(int step, int numSteps, int numChannels, int numPartitions)
+    {
+        if (numSteps <= 2 * numChannels)
+            return step * (2 * numChannels + numPartitions) / numSteps;
+
+        if (step < numChannels)
+            return step;
+
+        if (step <= numSteps - numChannels)
+            return numChannels + (step - numChannels) * numPartitions / (numSteps - 2 * numChannels);
+
+        return numChannels + numPartitions + step - (numSteps - numChannels);
+    }
+}
+
+template <typename Ops>
+void PartitionedConvolver::MultiplyAddKernel::Process(float* accumulatorReal, float* accumulatorImag, const float* inputReal, const float* inputImag,
+                                                      const float* impulseReal, const float* impulseImag, int numBins)
+{
+    // (a + bi)(c + di) = (ac - bd) + (ad + bc)i
+    Simd::ForEach<Ops>(numBins, [&](auto ops, int bin)
+    {
+        using O = decltype(ops);
+        auto a = O::Load(inputReal + bin);
+        auto b = O::Load(inputImag + bin);
+        auto c = O::Load(impulseReal + bin);
+        auto d = O::Load(impulseImag + bin);
+
+        auto real = O::Sub(O::Fma(a, c, O::Load(accumulatorReal + bin)), O::Mul(b, d));
+        auto imag = O::Fma(a, d, O::Fma(b, c, O::Load(accumulatorImag + bin)));
+
+        O::Store(accumulatorReal + bin, real);
+        O::Store(accumulatorImag + bin, imag);
+    });
+}
+
+PartitionedConvolver::PartitionedConvolver(const AudioBuffer<float>& impulse, int newBlockSize, int newNumChannels)
+    : blockSize(jmax(1, newBlockSize)), numChannels(jmax(1, newNumChannels))
+{
+    multiplyAdd = Simd::Dispatch<MultiplyAddKernel>();
+
+    impulseLength = jmax(1, impulse.getNumSamples());
+    numImpulseChannels = jmax(1, impulse.getNumChannels());
+
+    // Cut the impulse into levels. The head level has twice PartitionGrowth partitions of one block, so the next level starts at twice its own
+    // partition size, and every level after that has two fewer so the same holds all the way up. The last level takes whatever is left.
+    int offset = 0;
+    int partitionSize = blockSize;
+    int maxFFTSize = 0;
+
+    while (offset < impulseLength)
+    {
+        Level level;
+        level.PartitionSize = partitionSize;
+
+        int remaining = (impulseLength - offset + partitionSize - 1) / partitionSize;
+        bool lastLevel = (int64)partitionSize * PartitionGrowth > MaxPartitionSize;
+        level.NumPartitions = lastLevel ? remaining : jmin(2 * (offset == 0 ? PartitionGrowth : PartitionGrowth - 1), remaining);
+        level.NumSteps = partitionSize / blockSize;
+
+        // Overlap-save needs an FFT at least twice the partition size, the last PartitionSize samples of each inverse FFT are the output.
+        level.FFTSize = nextPowerOfTwo(2 * partitionSize);
+        level.NumBins = level.FFTSize / 2 + 1;
+        level.FFT = std::make_unique<dsp::FFT>(roundToInt(std::log2((double)level.FFTSize)));
+        maxFFTSize = jmax(maxFFTSize, level.FFTSize);
+
+        level.Channels.resize((size_t)numChannels);
+
+        for (auto& channel : level.Channels)
+        {
+            channel.Window.assign((size_t)(level.FFTSize + level.PartitionSize), 0.0f);
+            channel.DelayLine.assign((size_t)(level.NumPartitions * 2 * level.NumBins), 0.0f);
+            channel.Accumulator.assign((size_t)(2 * level.NumBins), 0.0f);
+            channel.Result.assign((size_t)level.PartitionSize, 0.0f);
+            channel.Output.assign((size_t)level.PartitionSize, 0.0f);
+        }
+
+        // Spectrum of each partition, zero padded to the FFT size.
+        fftBuffer.assign((size_t)(2 * level.FFTSize), 0.0f);
+        level.ImpulseSpectra.resize((size_t)numImpulseChannels);
+
+        for (int impulseChannel = 0; impulseChannel < numImpulseChannels; impulseChannel++)
+        {
+            auto& spectra = level.ImpulseSpectra[(size_t)impulseChannel];
+            spectra.assign((size_t)(level.NumPartitions * 2 * level.NumBins), 0.0f);
+
+            for (int partition = 0; partition < level.NumPartitions; partition++)
+            {
+                int start = offset + partition * partitionSize;
+                int length = jmin(partitionSize, impulse.getNumSamples() - start);
+
+                std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+
+                if (length > 0)
+                    FloatVectorOperations::copy(fftBuffer.data(), impulse.getReadPointer(impulseChannel, start), length);
+                else if (impulse.getNumSamples() == 0 && start == 0)
+                    fftBuffer[0] = 1.0f;
+
+                level.FFT->performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+                float* real = spectra.data() + partition * 2 * level.NumBins;
+                float* imag = real + level.NumBins;
+
+                for (int bin = 0; bin < level.NumBins; bin++)
+                {
+                    real[bin] = fftBuffer[(size_t)(2 * bin)];
+                    imag[bin] = fftBuffer[(size_t)(2 * bin + 1)];
+                }
+            }
+        }
+
+        offset += level.NumPartitions * partitionSize;
+        partitionSize *= PartitionGrowth;
+
+        levels.push_back(std::move(level));
+    }
+
+    fftBuffer.assign((size_t)(2 * maxFFTSize), 0.0f);
+
+    inputBlock.setSize(numChannels, blockSize);
+    outputBlock.setSize(numChannels, blockSize);
+    Reset();
+}
+
+void PartitionedConvolver::Reset()
+{
+    resetLevels();
+
+    inputBlock.clear();
+    outputBlock.clear();
+    blockPosition = 0;
+    previous = nullptr;
+    previousBlocksLeft = 0;
+}
+
+void PartitionedConvolver::resetLevels()
+{
+    for (auto& level : levels)
+    {
+        for (auto& channel : level.Channels)
+        {
+            std::fill(channel.Window.begin(), channel.Window.end(), 0.0f);
+            std::fill(channel.DelayLine.begin(), channel.DelayLine.end(), 0.0f);
+            std::fill(channel.Accumulator.begin(), channel.Accumulator.end(), 0.0f);
+            std::fill(channel.Result.begin(), channel.Result.end(), 0.0f);
+            std::fill(channel.Output.begin(), channel.Output.end(), 0.0f);
+        }
+
+        // No partition to work on until the first one fills.
+        level.FillCount = 0;
+        level.ReadPosition = 0;
+        level.DelayLineSlot = 0;
+        level.Step = level.NumSteps;
+    }
+}
+
+void PartitionedConvolver::TakeOverFrom(PartitionedConvolver& other)
+{
+    jassert(other.blockSize == blockSize && other.numChannels == numChannels);
+
+    if (other.blockSize != blockSize || other.numChannels != numChannels)
+        return;
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        inputBlock.copyFrom(channel, 0, other.inputBlock, channel, 0, blockSize);
+        outputBlock.copyFrom(channel, 0, other.outputBlock, channel, 0, blockSize);
+    }
+
+    // Carry on in the same state. The other convolver has already heard everything up to here, and this one's levels start from silence, so
+    // between them every input sample goes through one impulse response or the other. The other's output carries on for the length of its
+    // impulse response after the block its input fades out over.
+    blockPosition = other.blockPosition;
+    convolving = other.convolving;
+    previous = &other;
+    previousBlocksLeft = 1 + (other.impulseLength - 1 + blockSize - 1) / blockSize;
+    fadeInput = true;
+    fadeOutPrevious = false;
+}
+
+void PartitionedConvolver::EndTakeOver()
+{
+    if (previous == nullptr)
+        return;
+
+    previousBlocksLeft = 1;
+    fadeOutPrevious = true;
+}
+
+void PartitionedConvolver::Process(float* const* channelData, int numChannelsToProcess, int numSamples, bool convolve)
+{
+    processSamples(channelData, numChannelsToProcess, numSamples, convolve);
+}
+
+void PartitionedConvolver::Process(double* const* channelData, int numChannelsToProcess, int numSamples, bool convolve)
+{
+    processSamples(channelData, numChannelsToProcess, numSamples, convolve);
+}
+
+template <typename SampleType>
+void PartitionedConvolver::processSamples(SampleType* const* channelData, int numChannelsToProcess, int numSamples, bool convolve)
+{
+    int channels = jmin(numChannelsToProcess, numChannels);
+
+    // Swap the input into the block being collected and the output of the last block out, a block at a time.
+    for (int offset = 0; offset < numSamples;)
+    {
+        int count = jmin(numSamples - offset, blockSize - blockPosition);
+
+        for (int channel = 0; channel < channels; channel++)
+        {
+            SampleType* data = channelData[channel] + offset;
+
+            copySamples(inputBlock.getWritePointer(channel, blockPosition), data, count);
+            copySamples(data, outputBlock.getReadPointer(channel, blockPosition), count);
+        }
+
+        offset += count;
+        blockPosition += count;
+
+        if (blockPosition == blockSize)
+        {
+            processBlock(convolve);
+            blockPosition = 0;
+        }
+    }
+}
+
+void PartitionedConvolver::processBlock(bool convolve)
+{
+    PartitionedConvolver* fadingFrom = previous;
+    float step = 1.0f / (float)blockSize;
+
+    // The old convolver gets this block faded out while this one gets it faded in, and after that it only gets silence, so it rings out.
+    if (fadingFrom != nullptr)
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            float* input = inputBlock.getWritePointer(channel);
+            float* oldInput = fadingFrom->inputBlock.getWritePointer(channel);
+
+            if (fadeInput)
+            {
+                for (int sample = 0; sample < blockSize; sample++)
+                {
+                    float fade = step * (float)(sample + 1);
+
+                    oldInput[sample] = input[sample] * (1.0f - fade);
+                    input[sample] *= fade;
+                }
+            }
+            else
+            {
+                FloatVectorOperations::clear(oldInput, blockSize);
+            }
+        }
+
+        fadeInput = false;
+        fadingFrom->convolveBlock(convolve);
+    }
+
+    convolveBlock(convolve);
+
+    // Add the old impulse response's output, faded out if it is being let go early.
+    if (fadingFrom != nullptr)
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            float* output = outputBlock.getWritePointer(channel);
+            const float* old = fadingFrom->outputBlock.getReadPointer(channel);
+
+            if (fadeOutPrevious)
+            {
+                for (int sample = 0; sample < blockSize; sample++)
+                    output[sample] += old[sample] * (1.0f - step * (float)(sample + 1));
+            }
+            else
+            {
+                FloatVectorOperations::add(output, old, blockSize);
+            }
+        }
+
+        if (--previousBlocksLeft <= 0)
+            previous = nullptr;
+    }
+}
+
+void PartitionedConvolver::convolveBlock(bool convolve)
+{
+    // Only delaying, the output for this block is the input.
+    if (! convolve && ! convolving)
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+            outputBlock.copyFrom(channel, 0, inputBlock, channel, 0, blockSize);
+
+        return;
+    }
+
+    // The levels were left alone while only delaying, so start them again from silence.
+    if (convolve && ! convolving)
+        resetLevels();
+
+    // The head level fills a partition and does all the work on it every block, and its result covers this block. Every other level has
+    // already finished the output covering this block, so add its next block of output before giving it the new input.
+    processLevel(levels[0]);
+
+    for (int channel = 0; channel < numChannels; channel++)
+        outputBlock.copyFrom(channel, 0, levels[0].Channels[(size_t)channel].Result.data(), blockSize);
+
+    for (size_t index = 1; index < levels.size(); index++)
+    {
+        auto& level = levels[index];
+
+        for (int channel = 0; channel < numChannels; channel++)
+            outputBlock.addFrom(channel, 0, level.Channels[(size_t)channel].Output.data() + level.ReadPosition, blockSize);
+
+        level.ReadPosition += blockSize;
+        processLevel(level);
+    }
+
+    // Fade between the delayed input and the convolution across this block when convolution is switched on or off.
+    if (convolve != convolving)
+    {
+        float start = convolve ? 0.0f : 1.0f;
+        float step = (convolve ? 1.0f : -1.0f) / (float)blockSize;
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            float* output = outputBlock.getWritePointer(channel);
+            const float* input = inputBlock.getReadPointer(channel);
+
+            for (int sample = 0; sample < blockSize; sample++)
+                output[sample] = input[sample] + (output[sample] - input[sample]) * (start + step * (float)(sample + 1));
+        }
+
+        convolving = convolve;
+    }
+}
+
+void PartitionedConvolver::processLevel(Level& level)
+{
+    // Add the new block to the partition being collected, after the FFT input in each window.
+    int windowPosition = level.FFTSize + level.FillCount;
+
+    for (int channel = 0; channel < numChannels; channel++)
+        FloatVectorOperations::copy(level.Channels[(size_t)channel].Window.data() + windowPosition, inputBlock.getReadPointer(channel), blockSize);
+
+    level.FillCount += blockSize;
+
+    // A full partition. The work on the last one has just finished, so its result is the output from here on, and the window moves along a
+    // partition so the FFT input ends with the new one.
+    if (level.FillCount == level.PartitionSize)
+    {
+        for (auto& state : level.Channels)
+        {
+            std::swap(state.Output, state.Result);
+            std::copy(state.Window.begin() + level.PartitionSize, state.Window.end(), state.Window.begin());
+        }
+
+        level.FillCount = 0;
+        level.ReadPosition = 0;
+        level.DelayLineSlot = (level.DelayLineSlot + 1) % level.NumPartitions;
+        level.Step = 0;
+    }
+
+    // This block's share of the tasks, spread evenly over the blocks until the next partition fills. The smaller level underneath runs its FFTs
+    // in the first and last blocks of each of its partitions, so half of one of its partitions is left free at either end and this level's
+    // FFTs land between the smaller level's. The head level has one block, so it does every task now.
+    if (level.Step < level.NumSteps)
+    {
+        int margin = level.NumSteps / (2 * PartitionGrowth);
+        int numSteps = level.NumSteps - 2 * margin;
+        int step = level.Step - margin;
+
+        if (step >= 0 && step < numSteps)
+        {
+            int first = firstTask(step, numSteps, numChannels, level.NumPartitions);
+            int last = firstTask(step + 1, numSteps, numChannels, level.NumPartitions);
+
+            for (int task = first; task < last; task++)
+                runLevelTask(level, task);
+        }
+
+        level.Step++;
+    }
+}
+
+void PartitionedConvolver::runLevelTask(Level& level, int task)
+{
+    if (task < numChannels)
+    {
+        forwardTransform(level, level.Channels[(size_t)task]);
+        return;
+    }
+
+    task -= numChannels;
+
+    // Partition 0 uses the spectra the forward FFTs just made, the older ones were already in the delay line.
+    if (task < level.NumPartitions)
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+            multiplyAddPartitions(level, level.Channels[(size_t)channel], jmin(channel, numImpulseChannels - 1), task, task + 1);
+
+        return;
+    }
+
+    inverseTransform(level, level.Channels[(size_t)(task - level.NumPartitions)]);
+}
+
+void PartitionedConvolver::forwardTransform(Level& level, Level::Channel& channel)
+{
+    FloatVectorOperations::copy(fftBuffer.data(), channel.Window.data(), level.FFTSize);
+    level.FFT->performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+    float* real = channel.DelayLine.data() + level.DelayLineSlot * 2 * level.NumBins;
+    float* imag = real + level.NumBins;
+
+    for (int bin = 0; bin < level.NumBins; bin++)
+    {
+        real[bin] = fftBuffer[(size_t)(2 * bin)];
+        imag[bin] = fftBuffer[(size_t)(2 * bin + 1)];
+    }
+}
+
+void PartitionedConvolver::inverseTransform(Level& level, Level::Channel& channel)
+{
+    float* real = channel.Accumulator.data();
+    float* imag = real + level.NumBins;
+
+    for (int bin = 0; bin < level.NumBins; bin++)
+    {
+        fftBuffer[(size_t)(2 * bin)] = real[bin];
+        fftBuffer[(size_t)(2 * bin + 1)] = imag[bin];
+    }
+
+    level.FFT->performRealOnlyInverseTransform(fftBuffer.data());
+
+    // The start of the inverse FFT has wrapped around, only the last partition's worth is the real convolution.
+    FloatVectorOperations::copy(channel.Result.data(), fftBuffer.data() + level.FFTSize - level.PartitionSize, level.PartitionSize);
+    std::fill(channel.Accumulator.begin(), channel.Accumulator.end(), 0.0f);
+}
+
+void PartitionedConvolver::multiplyAddPartitions(Level& level, Level::Channel& channel, int impulseChannel, int first, int last)
+{
+    // Partition k is multiplied with the input from k partitions before the one that goes in DelayLineSlot.
+    const float* impulseSpectra = level.ImpulseSpectra[(size_t)impulseChannel].data();
+    float* accumulatorReal = channel.Accumulator.data();
+    float* accumulatorImag = accumulatorReal + level.NumBins;
+
+    for (int partition = first; partition < last; partition++)
+    {
+        int slot = (level.DelayLineSlot - partition + level.NumPartitions) % level.NumPartitions;
+        const float* input = channel.DelayLine.data() + slot * 2 * level.NumBins;
+        const float* impulse = impulseSpectra + partition * 2 * level.NumBins;
+
+        multiplyAdd(accumulatorReal, accumulatorImag, input, input + level.NumBins, impulse, impulse + level.NumBins, level.NumBins);
+    }
+}
+
+//==============================================================================
+String PartitionedConvolver::ReadImpulseFile(const File& file, AudioBuffer<float>& impulse, double& impulseSampleRate)
+{
+    AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<AudioFormatReader> reader(formats.createReaderFor(file));
+
+    if (reader == nullptr)
+        return "Could not read " + file.getFileName();
+
+    if (reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+        return file.getFileName() + " is empty";
+
+    // The plugins are mono or stereo, so only the first two channels are used.
+    int length = (int)jmin(reader->lengthInSamples, (int64)(MaxImpulseSeconds * reader->sampleRate) + 1);
+    int channels = jlimit(1, 2, (int)reader->numChannels);
+
+    impulse.setSize(channels, length);
+    reader->read(&impulse, 0, length, 0, true, true);
+    impulseSampleRate = reader->sampleRate;
+
+    return {};
+}
+
+AudioBuffer<float> PartitionedConvolver::PrepareImpulse(const AudioBuffer<float>& impulse, double impulseSampleRate, double sampleRate)
+{
+    // Input samples per output sample.
+    double ratio = impulseSampleRate / sampleRate;
+    int numChannels = jmax(1, impulse.getNumChannels());
+    int length = jlimit(1, jmax(1, (int)(MaxImpulseSeconds * sampleRate)), (int)std::ceil(impulse.getNumSamples() / ratio));
+
+    AudioBuffer<float> result(numChannels, length);
+    result.clear();
+
+    for (int channel = 0; channel < impulse.getNumChannels(); channel++)
+    {
+        if (ratio == 1.0)
+        {
+            result.copyFrom(channel, 0, impulse, channel, 0, jmin(length, impulse.getNumSamples()));
+        }
+        else
+        {
+            LagrangeInterpolator interpolator;
+            interpolator.process(ratio, impulse.getReadPointer(channel), result.getWritePointer(channel), length, impulse.getNumSamples(), 0);
+        }
+    }
+
+    // Drop the silence at the end, it would only cost partitions.
+    float threshold = Decibels::decibelsToGain(-90.0f) * jmax(result.getMagnitude(0, length), 1.0e-9f);
+    int end = length;
+
+    while (end > 1)
+    {
+        bool silent = true;
+
+        for (int channel = 0; channel < numChannels; channel++)
+            silent = silent && std::abs(result.getSample(channel, end - 1)) < threshold;
+
+        if (! silent)
+            break;
+
+        end--;
+    }
+
+    result.setSize(numChannels, end, true);
+
+    // Scale the loudest channel to unit energy, so white noise comes out at the level it went in.
+    double energy = 0.0;
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        double channelEnergy = 0.0;
+        const float* data = result.getReadPointer(channel);
+
+        for (int sample = 0; sample < end; sample++)
+            channelEnergy += (double)data[sample] * data[sample];
+
+        energy = jmax(energy, channelEnergy);
+    }
+
+    if (energy > 0.0)
+        result.applyGain((float)(1.0 / std::sqrt(energy)));
+
+    return result;
+}
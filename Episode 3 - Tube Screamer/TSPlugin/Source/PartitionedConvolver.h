@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolver.h
+    Created: 19 Oct 2026 9:48:15pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <JuceHeader.h>
+#include "Simd.h"
+
+using namespace juce;
+
+// Convolves the output of the TS stage with a cabinet or room impulse response, using FFT convolution so long impulse responses only cost a few
+// percent of a core.
+//
+// The input is collected into blocks of BlockSize samples, and each block is convolved while the next one is collected, so the latency is exactly
+// one block. The impulse response is cut into partitions that grow towards its tail:
+//
+//      BlockSize x 8, BlockSize * 4 x 6, BlockSize * 16 x 6 ... MaxPartitionSize x as many as it takes
+//
+// Each size of partition is a level. A level keeps the spectra of its last few input partitions (the frequency domain delay line), and for each
+// new partition it multiplies them with the spectra of its partitions and adds them up, so it needs one forward and one inverse FFT per channel
+// however many partitions it has. The head level does all of that in the block its partition fills, every block. Every other level starts at an
+// offset into the impulse response of twice its own partition size, so the output for a partition isn't needed until a whole partition after it
+// has filled, and the work is spread over the blocks of that partition: the forward FFT of each channel, the partitions' multiply-adds and then
+// the inverse FFT of each channel, a share in each block. No block has to run more than its share of each level, and the largest levels' FFTs
+// (up to MaxPartitionSize * 2 points) land in different blocks to the smaller levels' as the shares fall at different points in each level's
+// partition. A single FFT can't be split, so the heaviest block still has one of the largest level's FFTs in it.
+//
+// Build a convolver off the audio thread for each impulse response, block size and channel count, then hand it to the audio thread.
+class PartitionedConvolver
+{
+
+public:
+
+    // C-tor, builds the partitions of impulse for blocks of blockSize samples. Channel i of the audio uses channel i of the impulse, channels past
+    // the last impulse channel use the last one, and an empty impulse is a unit impulse. Allocates, so never call on the audio thread.
+    PartitionedConvolver(const AudioBuffer<float>& impulse, int blockSize, int numChannels);
+
+    // Latency in samples, always the block size.
+    int GetLatencySamples() const { return blockSize; }
+
+    // Length of the impulse response in samples.
+    int GetImpulseLength() const { return impulseLength; }
+
+    int GetNumChannels() const { return numChannels; }
+
+    // Clear the input, the output and every level, so the next output starts from silence.
+    void Reset();
+
+    // Take over the input and output blocks of another convolver with the same block size and channel count, so swapping to a new impulse
+    // response carries on without a gap. Over the next block the input is crossfaded from the other convolver to this one, and after that the
+    // other is fed silence and its output added to this one's until its impulse response has rung out, so the old tail decays naturally under
+    // the new impulse response rather than being cut off, and the new one starts from the input rather than from silence. Both convolvers run
+    // until then. Keep the other convolver alive until IsTakingOver returns false.
+    void TakeOverFrom(PartitionedConvolver& other);
+
+    // Whether the convolver taken over from is still needed for its tail.
+    bool IsTakingOver() const { return previous != nullptr; }
+
+    // Fade the tail of the convolver taken over from out over the next block and let it go, for when another impulse response is waiting to be
+    // swapped in and shouldn't have to wait for the whole tail.
+    void EndTakeOver();
+
+    // Convolve numSamples of each channel in place, delayed by the latency. While convolve is false the input is only delayed, which costs a copy,
+    // and switching between the two fades across one block.
+    void Process(float* const* channelData, int numChannels, int numSamples, bool convolve);
+
+    // Same for double audio. The convolution is float, so the audio is converted as it is copied in and out of the blocks.
+    void Process(double* const* channelData, int numChannels, int numSamples, bool convolve);
+
+    // Read an impulse response from a WAV or AIFF file. Returns an error message, or an empty string if it loaded. Call off the audio thread.
+    static String ReadImpulseFile(const File& file, AudioBuffer<float>& impulse, double& impulseSampleRate);
+
+    // The impulse response resampled to the plugin's sample rate, cut to MaxImpulseSeconds and normalised so the convolution has roughly unity
+    // gain for broadband input.
+    static AudioBuffer<float> PrepareImpulse(const AudioBuffer<float>& impulse, double impulseSampleRate, double sampleRate);
+
+    // Longest impulse response kept, cabinets are a few hundred milliseconds and rooms a few seconds.
+    static constexpr double MaxImpulseSeconds = 10.0;
+
+    // Each level's partitions are this many times larger than the last, up to MaxPartitionSize.
+    static constexpr int PartitionGrowth = 4;
+    static constexpr int MaxPartitionSize = 8192;
+
+private:
+
+    // Complex multiply-accumulate of one partition, acc += x * h, with the spectra stored as separate real and imaginary arrays.
+    struct MultiplyAddKernel
+    {
+        using Function = void (*)(float*, float*, const float*, const float*, const float*, const float*, int);
+
+        template <typename Ops>
+        static void Process(float* accumulatorReal, float* accumulatorImag, const float* inputReal, const float* inputImag,
+                            const float* impulseReal, const float* impulseImag, int numBins);
+    };
+
+    // One size of partition. Spectra are numBins long and stored back to back, real parts then imaginary parts.
+    struct Level
+    {
+        int PartitionSize = 0;
+        int NumPartitions = 0;
+        int FFTSize = 0;
+        int NumBins = 0;
+
+        // Blocks in a partition, the work on each partition is spread over this many blocks.
+        int NumSteps = 0;
+
+        std::unique_ptr<dsp::FFT> FFT;
+
+        // Partition spectra for each impulse channel, NumPartitions * 2 * NumBins.
+        std::vector<std::vector<float>> ImpulseSpectra;
+
+        struct Channel
+        {
+            // The FFT input, the last FFTSize input samples up to the end of the last full partition, followed by the partition being collected.
+            std::vector<float> Window;
+
+            // Spectra of the last NumPartitions windows, used as a ring.
+            std::vector<float> DelayLine;
+
+            // Sum of the products for the partition being worked on, its output once the work is finished, and the output being read.
+            std::vector<float> Accumulator;
+            std::vector<float> Result;
+            std::vector<float> Output;
+        };
+
+        std::vector<Channel> Channels;
+
+        // Samples collected towards the next partition, the next sample of Output to read, the slot in DelayLine the newest spectrum goes in,
+        // and how many blocks of work have been done on the last full partition.
+        int FillCount = 0;
+        int ReadPosition = 0;
+        int DelayLineSlot = 0;
+        int Step = 0;
+    };
+
+    int blockSize = 0;
+    int numChannels = 0;
+    int impulseLength = 0;
+    int numImpulseChannels = 1;
+
+    std::vector<Level> levels;
+
+    // The block being collected and the output for the last one, per channel, with the position in both.
+    AudioBuffer<float> inputBlock;
+    AudioBuffer<float> outputBlock;
+    int blockPosition = 0;
+
+    // Whether the last block was convolved, convolution is faded in and out when this changes.
+    bool convolving = false;
+
+    // Convolver taken over from, run until its tail has rung out. The blocks of its output still to add, counting the one its input is faded
+    // out over, whether that block is still to come, and whether to fade its output out over the next block.
+    PartitionedConvolver* previous = nullptr;
+    int previousBlocksLeft = 0;
+    bool fadeInput = false;
+    bool fadeOutPrevious = false;
+
+    // Scratch for the FFTs, twice the largest FFT size.
+    std::vector<float> fftBuffer;
+
+    MultiplyAddKernel::Function multiplyAdd = nullptr;
+
+    // Clear the state of every level, leaving the input and output blocks alone.
+    void resetLevels();
+
+    // Both Process overloads, collecting the input and handing out the output a block at a time.
+    template <typename SampleType>
+    void processSamples(SampleType* const* channelData, int numChannels, int numSamples, bool convolve);
+
+    // Called every time a block has been collected, runs the convolver taken over from alongside this one if there is one.
+    void processBlock(bool convolve);
+
+    // Work out the output for the block just collected.
+    void convolveBlock(bool convolve);
+
+    // Add the new block to a level, and run this block's share of the work on its last full partition.
+    void processLevel(Level& level);
+
+    // One piece of the work on a partition. Tasks are the forward FFT of each channel, then the multiply-add of each partition for every
+    // channel, then the inverse FFT of each channel, in that order.
+    void runLevelTask(Level& level, int task);
+
+    // Forward FFT of the window into the newest slot of the delay line, and inverse FFT of the accumulator into the result.
+    void forwardTransform(Level& level, Level::Channel& channel);
+    void inverseTransform(Level& level, Level::Channel& channel);
+
+    // Add partitions [first, last) of a level to a channel's accumulator.
+    void multiplyAddPartitions(Level& level, Level::Channel& channel, int impulseChannel, int first, int last);
+};
@@ -7,6 +7,12 @@
 */
 
 #include "PluginProcessor.h"
+#include "CabinetControls.h"
+
+// The plugin wrapper defines the plugin name from the .jucer, the headless tools build this file without it.
+#ifndef JucePlugin_Name
+ #define JucePlugin_Name "TSPlugin"
+#endif
 
 //==============================================================================
 TSPluginAudioProcessor::TSPluginAudioProcessor()
@@ -24,21 +30,56 @@ TSPluginAudioProcessor::TSPluginAudioProcessor()
                                ,std::make_unique<AudioParameterFloat>(ParameterID{"TONE", 1}, "Tone", NormalisableRange<float>(0.0f, 1.0f), 0.5f)
                                ,std::make_unique<AudioParameterFloat>(ParameterID{"LEVEL", 1}, "Level", NormalisableRange<float>(0.0f, 1.0f), 0.5f)
                                ,std::make_unique<AudioParameterChoice>("BYPASS", "Bypass", StringArray("OFF", "ON"), 1)
+                               ,std::make_unique<AudioParameterChoice>(ParameterID{"CLIPPER", 1}, "Clipper", StringArray("Tanh", "Diode"), 0)
+                               ,std::make_unique<AudioParameterChoice>(ParameterID{"CABINET", 1}, "Cabinet", StringArray("OFF", "ON"), 0)
+                               ,std::make_unique<AudioParameterChoice>(ParameterID{"BANDS", 1}, "Bands", StringArray("OFF", "2", "3", "4"), 0)
                            }) /* Because this is a relatively simple plugin with few paramters, we can define our parameters in the APTVS constructor, for larger plugins we typically define a ParameterLayout method and add our parameters to seperate
                           groups based on what the parameters are for*/
 #endif
 {
-    // Initialise our input stage filters, 48000 fs initially, however this will be reset before each playback anyway and will change if the host (DAW) changes sample rate. We can call this method here as the filter type will not change, only the sample rate.
-    InputStageHPF_L.Init(HPF, inputStageFc, 48000, 0.5, 0);
-    InputStageHPF_R.Init(HPF, inputStageFc, 48000, 0.5, 0);
-    
-    // Same for tone filters. However, the cutoff of these filters will be modulated at every parameter change so this will be updated in real time.
-    ToneFilter_L.Init(LPF, 5000.f, 48000, 0.5, 0);
-    ToneFilter_R.Init(LPF, 5000.f, 48000, 0.5, 0);
+    // Bind our parameters once, after this the audio thread never has to look them up by name.
+    DriveParameter = parameters.Bind(treestate.getParameter("DRIVE"), true);
+    ToneParameter = parameters.Bind(treestate.getParameter("TONE"), true);
+    LevelParameter = parameters.Bind(treestate.getParameter("LEVEL"), true);
+    BypassParameter = parameters.Bind(treestate.getParameter("BYPASS"), false);
+    ClipperParameter = parameters.Bind(treestate.getParameter("CLIPPER"), false);
+    CabinetParameter = parameters.Bind(treestate.getParameter("CABINET"), false);
+    BandsParameter = parameters.Bind(treestate.getParameter("BANDS"), false);
+    parameters.Prepare(48000, 512);
+
+    // Listen for changes to every bound parameter so they can be applied at the right sample.
+    events.Listen(treestate.getParameter("DRIVE"), DriveParameter);
+    events.Listen(treestate.getParameter("TONE"), ToneParameter);
+    events.Listen(treestate.getParameter("LEVEL"), LevelParameter);
+    events.Listen(treestate.getParameter("BYPASS"), BypassParameter);
+    events.Listen(treestate.getParameter("CLIPPER"), ClipperParameter);
+    events.Listen(treestate.getParameter("CABINET"), CabinetParameter);
+    events.Listen(treestate.getParameter("BANDS"), BandsParameter);
+
+    // The TS stage starts with a stereo set of DSP objects, prepareToPlay will resize this if the host gives us a different channel count.
+    floatAudio.ChannelPointers.resize(2);
+    doubleAudio.ChannelPointers.resize(2);
+
+    // Run the TS model at 88.2 or 96 kHz whatever the host rate, so the clipping sounds the same and costs the same at every rate.
+    tsStage.SetFixedRate(true);
+
+    // Start with an empty preset bank so the audio thread always has one.
+    presetBank = std::make_unique<TSPresetBank>();
+
+    performance.SetName(getName());
+    performance.SetStageName(TSTimingStage, "TS");
+    performance.SetStageName(BypassTimingStage, "Bypass");
+    performance.SetStageName(CabinetTimingStage, "Cabinet");
+
+    // Cabinet swaps are rare and the host only needs to hear about the new latency soon after, a few times a second is enough.
+    startTimerHz(5);
 }
 
 TSPluginAudioProcessor::~TSPluginAudioProcessor()
 {
+    stopTimer();
+    delete pendingCabinet.exchange(nullptr);
+    delete retiredCabinet.exchange(nullptr);
 }
 
 //==============================================================================
@@ -76,31 +117,42 @@ bool TSPluginAudioProcessor::isMidiEffect() const
 
 double TSPluginAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The output keeps ringing for as long as the TS filters and then the cabinet take to decay, any latency adds to that.
+    double sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 48000.0;
+
+    return TSStage::GetTailSeconds() + cabinetTailSeconds.load() + reportedLatencySamples.load() / sampleRate;
 }
 
 int TSPluginAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    const ScopedLock lock(presetLock);
+
+    return jmax(1, (int)presets.size());   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                                            // so this should be at least 1, even if you're not really implementing programs.
 }
 
 int TSPluginAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    const ScopedLock lock(presetLock);
+    return jmax(0, currentPreset);
 }
 
 void TSPluginAudioProcessor::setCurrentProgram (int index)
 {
+    selectPreset(index);
 }
 
 const juce::String TSPluginAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return getPresetName(index);
 }
 
 void TSPluginAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    const ScopedLock lock(presetLock);
+
+    if (isPositiveAndBelow(index, (int)presets.size()))
+        presets[(size_t)index].Name = newName;
 }
 
 //==============================================================================
@@ -109,11 +161,69 @@ void TSPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
     
-    // Reset our filters with the sample rate
-    InputStageHPF_L.Reset(sampleRate);
-    InputStageHPF_R.Reset(sampleRate);
-    ToneFilter_L.Reset(sampleRate);
-    ToneFilter_R.Reset(sampleRate);
+    // Make sure the TS stage has a set of DSP objects for every channel, this also resets them with the sample rate.
+    numDSPChannels = jmax(1, jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()));
+    tsStage.Prepare(sampleRate, numDSPChannels, isUsingDoublePrecision());
+    floatAudio.ChannelPointers.resize((size_t)numDSPChannels);
+    doubleAudio.ChannelPointers.resize((size_t)numDSPChannels);
+
+    // Drop any old parameter changes and size the parameter ramps for the largest block the host has told us about.
+    events.Reset();
+    parameters.Prepare(sampleRate, jmax(samplesPerBlock, ControlBlockSize));
+
+    // Resolve the presets for this sample rate. The audio thread is stopped, so the bank can be replaced directly.
+    {
+        const ScopedLock lock(presetLock);
+
+        presetSampleRate = tsStage.GetSampleRate();
+        presetHandover.Clear();
+        presetBank = createPresetBank();
+    }
+
+    // Start in whichever bypass state the parameter is in, there is nothing to crossfade from yet.
+    bypass = parameters.Get(BypassParameter) > 0.5f;
+    bypassFade = bypass ? 1.0f : 0.0f;
+    bypassFadeStep = 1.0f / jmax(1.0f, (float)sampleRate * bypassCrossfadeMs / 1000.0f);
+
+    // Build the cabinet for this block size and channel count, dropping any convolvers built for the old ones. The cabinet collects a whole host
+    // block before convolving it, so while an impulse response is loaded the plugin's latency is one block whether the cabinet is on or off. With
+    // none loaded there is no convolver and the only latency is the TS stage's resampling.
+    {
+        const ScopedLock lock(cabinetLock);
+
+        cabinetSampleRate = sampleRate;
+        cabinetBlockSize = jmax(1, samplesPerBlock);
+        cabinetNumChannels = numDSPChannels;
+
+        delete pendingCabinet.exchange(nullptr);
+        delete retiredCabinet.exchange(nullptr);
+        pendingCabinetClear = false;
+        fadingCabinet.reset();
+        cabinet = createCabinet();
+    }
+
+    cabinetTailSeconds = cabinet != nullptr ? (cabinet->GetImpulseLength() - 1) / sampleRate : 0.0;
+
+    // Dry buffers for the bypass crossfade in the host's precision, the other precision's are freed. The delay line is long enough for the
+    // latency with a cabinet, so loading or clearing one only changes how much of it is used.
+    auto prepareDry = [this](auto& audio, bool used)
+    {
+        audio.DryBuffer.setSize(used ? numDSPChannels : 0, used ? parameters.GetMaxBlockSize() : 0);
+        audio.DryDelayLine.setSize(used ? numDSPChannels : 0, used ? jmax(1, cabinetBlockSize + tsStage.GetLatencySamples()) : 0);
+    };
+
+    prepareDry(floatAudio, ! isUsingDoublePrecision());
+    prepareDry(doubleAudio, isUsingDoublePrecision());
+
+    updateLatency();
+    setLatencySamples(latencySamples);
+
+    // Start awake, the tail only depends on the filters and latency so it can be set once here.
+    tailTracker.Prepare(sampleRate);
+    tailTracker.SetTailSeconds(getTailLengthSeconds());
+
+    performance.Prepare(sampleRate);
+    analyser.Prepare(sampleRate);
     
 }
 
@@ -149,30 +259,56 @@ bool TSPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 }
 #endif
 
-void TSPluginAudioProcessor::getParameters()
+bool TSPluginAudioProcessor::scheduleParameterChange (int parameterIndex, float normalisedValue, int sampleOffset)
 {
-    // Get parameters from treestate and apply to *std::atomic<float> variables in the case of float parameters and *AudioParameterChoice in the case of the choice parameter.
-    psaturation = treestate.getRawParameterValue("DRIVE");
-    ptone = treestate.getRawParameterValue("TONE");
-    plevel = treestate.getRawParameterValue("LEVEL");
-    pbypass = (static_cast<AudioParameterChoice*>(treestate.getParameter("BYPASS")));
+    return events.PushParameterChange(parameterIndex, normalisedValue, sampleOffset);
+}
 
-    // Map our float parameters to desired bounds, save choice paramter.
-    saturation = map(*psaturation, 0.0f, 1.0f, 50.0f, 1000.0f);
-    tone = map(*ptone, 0.0f, 1.0f, 1000.f, 6000.f);
-    level = map(*plevel, 0.0f, 1.0f, 0.0f, 1.5f);
-    bypass = *pbypass;
+void TSPluginAudioProcessor::getParameters(int numSamples)
+{
+    // Drain the parameter changes for this block, they are applied as the block is processed. If any were lost take one snapshot of all the parameters instead.
+    if (! events.BeginBlock(numSamples))
+        parameters.Snapshot();
 
-    // Set frequency cutoff of tone filters.
-    ToneFilter_L.SetFc(tone);
-    ToneFilter_R.SetFc(tone);
+    updateBlockParameters();
+}
 
-    
+void TSPluginAudioProcessor::updateBlockParameters()
+{
+    // Save the block rate parameters.
+    bypass = parameters.Get(BypassParameter) > 0.5f;
+    diodeClipper = parameters.Get(ClipperParameter) > 0.5f;
+    cabinetEnabled = parameters.Get(CabinetParameter) > 0.5f;
+
+    // Off is a single band, the crossovers are only redesigned when the band count changes.
+    tsStage.SetBands(roundToInt(parameters.Get(BandsParameter)) + 1);
+}
+
+void TSPluginAudioProcessor::updateControlParameters()
+{
+    // Use the start of the drive and tone ramps for this sub-block, level is applied per sample.
+    tsStage.Update(parameters.GetRamp(DriveParameter)[0], parameters.GetRamp(ToneParameter)[0], diodeClipper, parameters.GetRamp(LevelParameter));
 }
 
 void TSPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples(buffer);
+}
+
+void TSPluginAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples(buffer);
+}
+
+template <typename SampleType>
+void TSPluginAudioProcessor::processSamples (AudioBuffer<SampleType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
+    performance.BeginBlock();
+
+    // Pick up a newly loaded cabinet.
+    swapCabinet();
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -185,110 +321,513 @@ void TSPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-    // Get write pointers to audio buffers.
-    float* channelData_L = buffer.getWritePointer(0);
-    float* channelData_R = buffer.getWritePointer(1);
+    int numSamples = buffer.getNumSamples();
 
+    // Collect the parameter changes for this block, then switch to a newly selected preset.
+    getParameters(numSamples);
+    applyPresetSelection();
 
-    // Save parameters to local plugin variables and set tone filter cutoffs.
-    getParameters();
-    
-    // As we are manually grabbing the channels we want, and we are not using any more than two at any one time we only need to handle the sample numbers. This loop will iterate through all the samples based on the block size of the buffer.
-    for (int sample = 0; sample < buffer.getNumSamples(); sample++)
+    // Never process more channels than we have DSP objects for.
+    int numInputs = jmin(totalNumInputChannels, numDSPChannels);
+    int numOutputs = jmin(totalNumOutputChannels, numDSPChannels);
+
+    // Pick the kernel for this channel layout once, rather than checking the layout for every sample. Only channels that received input are
+    // processed (mono/stereo duplicates its input into the second output), any extra outputs were cleared above.
+    ChannelLayout layout = GetChannelLayout(numInputs, numOutputs);
+    int numChannels = GetNumProcessedChannels(layout, numInputs, numOutputs);
+    int nextEvent = 0;
+
+    // Once the input has been silent for longer than the filters ring the output is silent too, so there is no need to run the DSP.
+    if (tailTracker.ProcessInput(buffer, numInputs, numSamples))
     {
-        
-        // This will be our DSP if our plugin is mono, it will use one set of our processing objects and the samples for the second (right) channel will be left unused. There are better ways of doing this (dynamic memory allocation) but this is simpler to understand.
-        if (totalNumInputChannels == 1 && totalNumOutputChannels == 1)
+        processIdleBlock(buffer, layout, numChannels, numSamples);
+        analyser.Push(buffer, numChannels, numSamples);
+        performance.EndBlock(numSamples);
+        return;
+    }
+
+    // Process the block in sub-blocks. The block is split at every parameter change so automation lands on the right sample. While drive or tone
+    // are moving the sub-blocks are ControlBlockSize long so the filters follow the ramps, otherwise they are as long as the parameter ramps allow.
+    for (int offset = 0; offset < numSamples;)
+    {
+        // Apply every parameter change that lands on this sample.
+        if (nextEvent < events.GetNumEvents() && events.GetEvent(nextEvent).SampleOffset <= offset)
         {
-        
-            // Get current input sample from buffer.
-            float xn = channelData_L[sample];
-
-            float dry = xn;
-            
-            // Process input with initial HPF. We also apply a mild sigmoid here to emulate the transistor non-linearity in the buffer.
-            xn = mildSigmoid(InputStageHPF_L.ProcessSample(xn));
-            
-            // Saturate filtered signal with our tanh soft clipper.
-            float xn_saturated = tanh(xn * saturation) / tanh(saturation);
-            
-            // Calculate output sample by applying the tone filter. Gain compensation is also applied due to additional gain applied by the soft clipper. Again apply additional non-linearity after filtering for transistor emulation. 
-            float yn = mildSigmoid(ToneFilter_L.ProcessSample(xn_saturated) * gainCompensation);
-
-            // This will check if bypass is activated, if bypass is activated then yn will become the dry input.
-            yn = bypass ? dry : (yn * level);
-            
-            // Write output sample back to buffer.
-            channelData_L[sample] = yn;
-        
+            while (nextEvent < events.GetNumEvents() && events.GetEvent(nextEvent).SampleOffset <= offset)
+            {
+                const auto& event = events.GetEvent(nextEvent++);
+                parameters.SetTarget(event.Slot, event.Value);
+            }
+
+            updateBlockParameters();
         }
-        
-        // This will be our DSP if our plugin is mono/stereo. The input sample of the single input channel is duplicated, the processing of each channel is then independant.
-        if (totalNumInputChannels == 1 && totalNumOutputChannels == 2)
+
+        // Stop this sub-block at the next parameter change.
+        int subBlockEnd = nextEvent < events.GetNumEvents() ? events.GetEvent(nextEvent).SampleOffset : numSamples;
+        int subBlockSize = jmin(subBlockEnd - offset, parameters.IsSmoothing() ? ControlBlockSize : parameters.GetMaxBlockSize());
+
+        // Fill the parameter ramps for this sub-block and update the TS stage from them.
+        parameters.Advance(subBlockSize);
+        updateControlParameters();
+
+        for (int channel = 0; channel < numChannels; channel++)
+            getAudio<SampleType>().ChannelPointers[(size_t)channel] = buffer.getWritePointer(channel, offset);
+
+        processSubBlock<SampleType>(layout, numChannels, subBlockSize);
+
+        offset += subBlockSize;
+    }
+
+    // Check whether the tail has died away, if it has clear the last of the filter states so they start from silence when the input comes back.
+    if (tailTracker.ProcessOutput(buffer, numChannels, numSamples))
+    {
+        tsStage.Reset();
+
+        if (cabinet != nullptr)
+            cabinet->Reset();
+    }
+
+    analyser.Push(buffer, numChannels, numSamples);
+    performance.EndBlock(numSamples);
+}
+
+template <typename SampleType>
+void TSPluginAudioProcessor::processIdleBlock(AudioBuffer<SampleType>& buffer, ChannelLayout layout, int numChannels, int numSamples)
+{
+    // Apply this block's parameter changes straight away, there is no audio for them to land on. Smoothed parameters carry on ramping when the DSP starts again.
+    for (int i = 0; i < events.GetNumEvents(); i++)
+        parameters.SetTarget(events.GetEvent(i).Slot, events.GetEvent(i).Value);
+
+    updateBlockParameters();
+
+    // There is nothing to crossfade while idle, so jump straight to the bypass state.
+    bypassFade = bypass ? 1.0f : 0.0f;
+
+    // Bypassed passes the input through untouched, otherwise the output of the DSP would be silence.
+    if (bypass)
+    {
+        if (layout == ChannelLayout::MonoToStereo)
+            buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+    }
+    else
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+            buffer.clear(channel, 0, numSamples);
+    }
+}
+
+template <typename SampleType>
+void TSPluginAudioProcessor::processSubBlock(ChannelLayout layout, int numChannels, int numSamples)
+{
+    auto& channelPointers = getAudio<SampleType>().ChannelPointers;
+    auto& dryBuffer = getAudio<SampleType>().DryBuffer;
+
+    float bypassTarget = bypass ? 1.0f : 0.0f;
+    int latency = latencySamples;
+
+    // Fully processing with no latency to match, just run the DSP.
+    if (bypassFade == 0.0f && bypassTarget == 0.0f && latency == 0)
+    {
         {
-            // Get current input samples from buffer and duplicate for second channel.
-            float xn_L = channelData_L[sample];
-            float xn_R = xn_L;
-
-            float dry_L = xn_L;
-            float dry_R = xn_R;
-            
-            // Process inputs with initial HPFs. We also apply a mild sigmoid here to emulate the transistor non-linearity in the buffer.
-            xn_L = mildSigmoid(InputStageHPF_L.ProcessSample(xn_L));
-            xn_R = mildSigmoid(InputStageHPF_R.ProcessSample(xn_R));
-            
-            // Saturate filtered signals with our tanh soft clipper.
-            float xn_saturated_L = tanh(xn_L * saturation) / tanh(saturation);
-            float xn_saturated_R = tanh(xn_R * saturation) / tanh(saturation);
-            
-            // Calculate output samples by applying the tone filters. Gain compensation is also applied due to additional gain applied by the soft clipper. Again apply additional non-linearity after filtering for transistor emulation. 
-            float yn_L = mildSigmoid(ToneFilter_L.ProcessSample(xn_saturated_L) * gainCompensation);
-            float yn_R = mildSigmoid(ToneFilter_R.ProcessSample(xn_saturated_R) * gainCompensation);
-
-            // This will check if bypass is activated, if bypass is activated then yn will become the dry input.
-            yn_L = bypass ? dry_L : (yn_L * level);
-            yn_R = bypass ? dry_R : (yn_R * level);
-            
-            // Write output samples back to buffers.
-            channelData_L[sample] = yn_L;
-            channelData_R[sample] = yn_R;
-        
+            PerformanceMonitor::ScopedStage timing(performance, TSTimingStage);
+            tsStage.Process(layout, channelPointers.data(), numChannels, numSamples);
         }
-        
-        // This will be our DSP if our plugin is stereo. This will take the input from both channels and process them independantly.
-        if (totalNumInputChannels == 2 && totalNumOutputChannels == 2)
+
+        processCabinet<SampleType>(numChannels, numSamples);
+        return;
+    }
+
+    // Fully bypassed with no latency to match, the input is already in the buffer so the only work is duplicating mono into stereo.
+    if (bypassFade == 1.0f && bypassTarget == 1.0f && latency == 0)
+    {
+        if (layout == ChannelLayout::MonoToStereo)
+            FloatVectorOperations::copy(channelPointers[1], channelPointers[0], numSamples);
+
+        return;
+    }
+
+    // Keep the dry signal lined up with the processed signal. While there is latency this has to run all the time so the delay line is full
+    // whenever bypass changes. Mono/stereo uses the single input for both channels.
+    performance.BeginStage(BypassTimingStage);
+
+    for (int channel = 0; channel < numChannels; channel++)
+        delayDry(channel, channelPointers[layout == ChannelLayout::MonoToStereo ? 0 : (size_t)channel], numSamples);
+
+    if (latency > 0)
+        dryDelayPosition = (dryDelayPosition + numSamples) % latency;
+
+    performance.EndStage(BypassTimingStage);
+
+    // Fully bypassed, output the delayed dry signal without running the DSP. The dry input still goes through the cabinet without being
+    // convolved, so when bypass is turned off the cabinet has the last block of input to fade out of.
+    if (bypassFade == 1.0f && bypassTarget == 1.0f)
+    {
+        if (layout == ChannelLayout::MonoToStereo)
+            FloatVectorOperations::copy(channelPointers[1], channelPointers[0], numSamples);
+
+        if (cabinet != nullptr)
+            cabinet->Process(channelPointers.data(), numChannels, numSamples, false);
+
+        for (int channel = 0; channel < numChannels; channel++)
+            FloatVectorOperations::copy(channelPointers[(size_t)channel], dryBuffer.getReadPointer(channel), numSamples);
+
+        return;
+    }
+
+    // Coming out of bypass, clear the old filter states first if the policy asks for it.
+    if (bypassFade == 1.0f && bypassPolicy == BypassPolicy::ResetState)
+        tsStage.Reset();
+
+    performance.BeginStage(TSTimingStage);
+    tsStage.Process(layout, channelPointers.data(), numChannels, numSamples);
+    performance.EndStage(TSTimingStage);
+
+    processCabinet<SampleType>(numChannels, numSamples);
+
+    // Fully processing, the dry signal was only needed to keep the delay line full.
+    if (bypassFade == 0.0f && bypassTarget == 0.0f)
+        return;
+
+    // Crossfade between the processed and dry signals, moving the fade towards the bypass target.
+    PerformanceMonitor::ScopedStage timing(performance, BypassTimingStage);
+    float step = bypassTarget > bypassFade ? bypassFadeStep : -bypassFadeStep;
+    float fade = bypassFade;
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        SampleType* data = channelPointers[(size_t)channel];
+        const SampleType* dry = dryBuffer.getReadPointer(channel);
+
+        fade = bypassFade;
+
+        for (int sample = 0; sample < numSamples; sample++)
         {
-            // Get current input samples from buffers.
-            float xn_L = channelData_L[sample];
-            float xn_R = channelData_R[sample];
+            fade = jlimit(0.0f, 1.0f, fade + step);
+            data[sample] += (dry[sample] - data[sample]) * fade;
+        }
+    }
+
+    bypassFade = fade;
+}
+
+template <typename SampleType>
+void TSPluginAudioProcessor::processCabinet(int numChannels, int numSamples)
+{
+    if (cabinet == nullptr)
+        return;
+
+    PerformanceMonitor::ScopedStage timing(performance, CabinetTimingStage);
+    cabinet->Process(getAudio<SampleType>().ChannelPointers.data(), numChannels, numSamples, cabinetEnabled);
+}
+
+template <typename SampleType>
+void TSPluginAudioProcessor::delayDry(int channel, const SampleType* input, int numSamples)
+{
+    SampleType* dry = getAudio<SampleType>().DryBuffer.getWritePointer(channel);
+    int latency = latencySamples;
+
+    if (latency == 0)
+    {
+        FloatVectorOperations::copy(dry, input, numSamples);
+        return;
+    }
 
-            float dry_L = xn_L;
-            float dry_R = xn_R;
+    // Swap each input sample with the sample written latency samples ago.
+    SampleType* line = getAudio<SampleType>().DryDelayLine.getWritePointer(channel);
+    int position = dryDelayPosition;
 
-            // Process inputs with initial HPFs.  We also apply a mild sigmoid here to emulate the transistor non-linearity in the buffer.
-            xn_L = mildSigmoid(InputStageHPF_L.ProcessSample(xn_L));
-            xn_R = mildSigmoid(InputStageHPF_R.ProcessSample(xn_R));
+    for (int sample = 0; sample < numSamples; sample++)
+    {
+        dry[sample] = line[position];
+        line[position] = input[sample];
+
+        if (++position == latency)
+            position = 0;
+    }
+}
+
+//==============================================================================
+String TSPluginAudioProcessor::loadCabinet(const File& file)
+{
+    // Read the file before taking the lock, so the audio settings are never held up by the disk.
+    AudioBuffer<float> impulse;
+    double impulseSampleRate = 0.0;
+    String error = PartitionedConvolver::ReadImpulseFile(file, impulse, impulseSampleRate);
+
+    if (error.isNotEmpty())
+        return error;
 
-            // Saturate filtered signals with our tanh soft clipper.
-            float xn_saturated_L = tanh(xn_L * saturation) / tanh(saturation);
-            float xn_saturated_R = tanh(xn_R * saturation) / tanh(saturation);
+    const ScopedLock lock(cabinetLock);
 
-            // Calculate output samples by applying the tone filters. Gain compensation is also applied due to additional gain applied by the soft clipper. Again apply additional non-linearity after filtering for transistor emulation. 
-            float yn_L = mildSigmoid(ToneFilter_L.ProcessSample(xn_saturated_L) * gainCompensation);
-            float yn_R = mildSigmoid(ToneFilter_R.ProcessSample(xn_saturated_R) * gainCompensation);
+    cabinetImpulse = std::move(impulse);
+    cabinetImpulseSampleRate = impulseSampleRate;
+    cabinetName = file.getFileNameWithoutExtension();
 
-            // This will check if bypass is activated, if bypass is activated then yn will become the dry input.
-            yn_L = bypass ? dry_L : (yn_L * level);
-            yn_R = bypass ? dry_R : (yn_R * level);
+    // Keep the path with the rest of the plugin's state.
+    treestate.state.setProperty("CabinetFile", file.getFullPathName(), nullptr);
 
-            // Write output samples back to buffers.
-            channelData_L[sample] = yn_L;
-            channelData_R[sample] = yn_R;
-        
+    postCabinet();
+
+    return {};
+}
+
+void TSPluginAudioProcessor::clearCabinet()
+{
+    const ScopedLock lock(cabinetLock);
+
+    cabinetImpulse.setSize(0, 0);
+    cabinetImpulseSampleRate = 0.0;
+    cabinetName = {};
+    treestate.state.removeProperty("CabinetFile", nullptr);
+
+    postCabinet();
+}
+
+String TSPluginAudioProcessor::getCabinetName() const
+{
+    const ScopedLock lock(cabinetLock);
+    return cabinetName;
+}
+
+std::unique_ptr<PartitionedConvolver> TSPluginAudioProcessor::createCabinet() const
+{
+    // With nothing loaded there is no cabinet at all, rather than a unit impulse that would cost a block of latency.
+    if (cabinetImpulse.getNumSamples() == 0)
+        return nullptr;
+
+    AudioBuffer<float> impulse = PartitionedConvolver::PrepareImpulse(cabinetImpulse, cabinetImpulseSampleRate, cabinetSampleRate);
+
+    return std::make_unique<PartitionedConvolver>(impulse, cabinetBlockSize, cabinetNumChannels);
+}
+
+void TSPluginAudioProcessor::postCabinet()
+{
+    // Not prepared yet, prepareToPlay builds the first convolver.
+    if (cabinetBlockSize == 0)
+        return;
+
+    // The audio thread only swaps while the retired slot is empty, so empty it first. A convolver still waiting was never used and can go too.
+    // Whichever of a new convolver or a clear is posted last wins, the audio thread may see the other first but then takes this one next block.
+    delete retiredCabinet.exchange(nullptr);
+
+    std::unique_ptr<PartitionedConvolver> next = createCabinet();
+
+    if (next == nullptr)
+    {
+        pendingCabinetClear = true;
+        delete pendingCabinet.exchange(nullptr);
+    }
+    else
+    {
+        delete pendingCabinet.exchange(next.release());
+        pendingCabinetClear = false;
+    }
+}
+
+void TSPluginAudioProcessor::swapCabinet()
+{
+    // The old convolver has to go somewhere it can be deleted from, so wait until the last one has been collected.
+    if (retiredCabinet.load() != nullptr)
+        return;
+
+    // A convolver being faded out of stays here until the new one has finished with it, only then does it go back to be deleted. If another
+    // swap is waiting the old tail is faded out over the next block rather than left to ring out, so a run of swaps never waits long.
+    if (fadingCabinet != nullptr)
+    {
+        if (cabinet != nullptr && cabinet->IsTakingOver())
+        {
+            if (pendingCabinet.load() != nullptr || pendingCabinetClear.load())
+                cabinet->EndTakeOver();
+
+            return;
+        }
+
+        retiredCabinet.store(fadingCabinet.release());
+        cabinetTailSeconds = cabinet != nullptr ? (cabinet->GetImpulseLength() - 1) / getSampleRate() : 0.0;
+        tailTracker.SetTailSeconds(getTailLengthSeconds());
+        return;
+    }
+
+    if (pendingCabinetClear.exchange(false))
+    {
+        // Take the cabinet and its latency out of the signal path.
+        if (cabinet != nullptr)
+        {
+            retiredCabinet.store(cabinet.release());
+            updateLatency();
         }
-        
     }
-    
+    else if (PartitionedConvolver* next = pendingCabinet.exchange(nullptr))
+    {
+        // Carry on from where the old convolver was, crossfading from the old impulse response to the new one over the next block. Without
+        // an old one the latency grows by the cabinet's block.
+        if (cabinet != nullptr)
+        {
+            next->TakeOverFrom(*cabinet);
+            fadingCabinet = std::move(cabinet);
+            cabinet.reset(next);
+        }
+        else
+        {
+            cabinet.reset(next);
+            updateLatency();
+        }
+    }
+    else
+    {
+        return;
+    }
+
+    // While the old impulse response rings out the tail is the longer of the two.
+    int impulseLength = cabinet != nullptr ? cabinet->GetImpulseLength() : 0;
+
+    if (fadingCabinet != nullptr)
+        impulseLength = jmax(impulseLength, fadingCabinet->GetImpulseLength());
+
+    cabinetTailSeconds = impulseLength > 0 ? (impulseLength - 1) / getSampleRate() : 0.0;
+    tailTracker.SetTailSeconds(getTailLengthSeconds());
+}
+
+void TSPluginAudioProcessor::updateLatency()
+{
+    latencySamples = (cabinet != nullptr ? cabinet->GetLatencySamples() : 0) + tsStage.GetLatencySamples();
+    reportedLatencySamples = latencySamples;
+
+    // The delayed dry signal was lined up with the old latency, start it again from silence.
+    floatAudio.DryDelayLine.clear();
+    doubleAudio.DryDelayLine.clear();
+    dryDelayPosition = 0;
+}
+
+void TSPluginAudioProcessor::timerCallback()
+{
+    int latency = reportedLatencySamples.load();
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+//==============================================================================
+int TSPluginAudioProcessor::storePreset(const String& name, int index)
+{
+    const ScopedLock lock(presetLock);
+
+    if (! isPositiveAndBelow(index, (int)presets.size()))
+    {
+        if ((int)presets.size() >= PresetState::MaxPresets)
+            return -1;
+
+        index = (int)presets.size();
+        presets.emplace_back();
+    }
+
+    presets[(size_t)index] = PresetState::Capture(*this, name);
+    currentPreset = index;
+
+    postPresets();
+
+    return index;
+}
+
+void TSPluginAudioProcessor::selectPreset(int index)
+{
+    const ScopedLock lock(presetLock);
+
+    if (! isPositiveAndBelow(index, (int)presets.size()))
+        return;
+
+    currentPreset = index;
+
+    // The audio thread switches to the resolved preset at the start of its next block. The parameters are then set to the same values, so the
+    // changes they send have nothing left to do.
+    presetSelection.Select(index);
+    presets[(size_t)index].Apply(*this, false);
+}
+
+void TSPluginAudioProcessor::morphPresets(int a, int b, float amount)
+{
+    const ScopedLock lock(presetLock);
+
+    if (isPositiveAndBelow(a, (int)presets.size()) && isPositiveAndBelow(b, (int)presets.size()))
+        presetSelection.Morph(a, b, amount);
+}
+
+int TSPluginAudioProcessor::getNumPresets()
+{
+    const ScopedLock lock(presetLock);
+    return (int)presets.size();
+}
+
+int TSPluginAudioProcessor::getSelectedPreset()
+{
+    const ScopedLock lock(presetLock);
+    return currentPreset;
+}
+
+String TSPluginAudioProcessor::getPresetName(int index)
+{
+    const ScopedLock lock(presetLock);
+    return isPositiveAndBelow(index, (int)presets.size()) ? presets[(size_t)index].Name : String();
+}
+
+std::unique_ptr<TSPluginAudioProcessor::TSPresetBank> TSPluginAudioProcessor::createPresetBank() const
+{
+    auto bank = std::make_unique<TSPresetBank>();
+
+    // The parameter values of each preset, then the stage settings for its drive and tone.
+    for (auto& preset : presets)
+    {
+        bank->Add(preset, parameters);
+        bank->StageSettings.emplace_back();
+
+        const auto& values = bank->Values.back();
+        TSStage::Resolve(values[(size_t)DriveParameter], values[(size_t)ToneParameter], presetSampleRate, bank->StageSettings.back());
+    }
+
+    return bank;
+}
+
+void TSPluginAudioProcessor::postPresets()
+{
+    // Not prepared yet, prepareToPlay resolves the first bank.
+    if (presetSampleRate == 0.0)
+        return;
+
+    presetHandover.Post(createPresetBank());
+}
+
+void TSPluginAudioProcessor::applyPresetSelection()
+{
+    // Pick up a newly resolved bank before looking at the selection, a preset that has just been stored is only in the new one.
+    presetHandover.Swap(presetBank);
+
+    PresetSelection::Selection selection;
+
+    if (! presetSelection.Poll(selection) || ! PresetSelection::ApplyValues(*presetBank, selection, parameters, BypassParameter))
+        return;
+
+    // Drive and tone jump straight to the preset, with the stage settings resolved for them, so the stage has nothing to recalculate. Level
+    // ramps to the preset and the clipper and cabinet switches are set, as ApplyValues left them.
+    const TSStage::Settings* settings = &presetBank->StageSettings[(size_t)selection.A];
+
+    if (selection.IsMorph())
+    {
+        TSStage::Mix(*settings, presetBank->StageSettings[(size_t)selection.B], selection.Amount, morphSettings);
+        settings = &morphSettings;
+    }
+
+    parameters.Jump(DriveParameter, settings->Drive);
+    parameters.Jump(ToneParameter, settings->Tone);
+    tsStage.Apply(*settings);
+
+    updateBlockParameters();
+}
+
+//==============================================================================
+AudioProcessorParameter* TSPluginAudioProcessor::getBypassParameter() const
+{
+    // Let the host use our bypass parameter for its own bypass button, so host bypass also gets the crossfade.
+    return treestate.getParameter("BYPASS");
 }
 
 //==============================================================================
@@ -298,28 +837,82 @@ bool TSPluginAudioProcessor::hasEditor() const
 }
 
 // We will use the JUCE generic audio processor editor for this project, this means we do not have to write any code for the GUI and we can focus on writing DSP code. You can add your own GUI but i feel it often overcomplicates things and gets in the way of learning DSP as a beginner.
+// The generic editor is wrapped with the performance figures for this instance underneath it, and the cabinet controls in between.
 juce::AudioProcessorEditor* TSPluginAudioProcessor::createEditor()
 {
-    return new GenericAudioProcessorEditor(*this);
+    return new PerformanceEditor(*this, performance, std::make_unique<CabinetControls>(*this), &analyser, this);
 }
 
 //==============================================================================
 void TSPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    // The parameters and cabinet file with the preset bank, in the compact binary format described in PresetState.h.
+    PresetState current = PresetState::Capture(*this);
+
+    {
+        const ScopedLock lock(cabinetLock);
+        String cabinetFile = treestate.state.getProperty("CabinetFile").toString();
+
+        if (cabinetFile.isNotEmpty())
+            current.SetProperty("CabinetFile", cabinetFile);
+    }
+
+    const ScopedLock lock(presetLock);
+    PresetState::WriteChunk(destData, current, currentPreset, presets);
 }
 
 void TSPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    PresetState current;
+    std::vector<PresetState> loadedPresets;
+    int loadedPreset = -1;
+
+    if (! PresetState::ReadChunk(data, sizeInBytes, current, loadedPreset, loadedPresets))
+        return;
+
+    current.Apply(*this, true);
+
+    // Load the cabinet again from its file. If the file has gone there is no cabinet, but its path is kept so saving again does not lose it.
+    String cabinetFile = current.GetProperty("CabinetFile");
+
+    if (cabinetFile.isEmpty())
+    {
+        if (getCabinetName().isNotEmpty())
+            clearCabinet();
+    }
+    else if (loadCabinet(File(cabinetFile)).isNotEmpty())
+    {
+        clearCabinet();
+
+        const ScopedLock lock(cabinetLock);
+        treestate.state.setProperty("CabinetFile", cabinetFile, nullptr);
+    }
+
+    const ScopedLock lock(presetLock);
+
+    presets = std::move(loadedPresets);
+    currentPreset = loadedPreset;
+    postPresets();
 }
 
 //==============================================================================
 // This creates new instances of the plugin..
+#if JEPLUGINS_HEADLESS
+// The headless tools link every plugin into one program, so each plugin gets its own factory instead of createPluginFilter.
+juce::AudioProcessor* createTSPluginProcessor()
+#else
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+#endif
 {
     return new TSPluginAudioProcessor();
 }
+
+#if JEPLUGINS_HEADLESS
+// Sample accurate parameter changes for the headless tools, which only see an AudioProcessor. Returns false for any other plugin's processor.
+bool scheduleTSParameterChange(juce::AudioProcessor& processor, int parameterIndex, float normalisedValue, int sampleOffset)
+{
+    auto* tsProcessor = dynamic_cast<TSPluginAudioProcessor*>(&processor);
+
+    return tsProcessor != nullptr && tsProcessor->scheduleParameterChange(parameterIndex, normalisedValue, sampleOffset);
+}
+#endif
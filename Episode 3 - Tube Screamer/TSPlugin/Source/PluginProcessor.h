@@ -8,9 +8,20 @@
 
 #pragma once
 
-#include <cmath>
+#include <atomic>
+#include <type_traits>
+#include <vector>
 #include <JuceHeader.h>
-#include "Biquad.h"
+#include "TSStage.h"
+#include "PartitionedConvolver.h"
+#include "ChannelLayout.h"
+#include "ParameterSnapshot.h"
+#include "ParameterEventQueue.h"
+#include "PresetState.h"
+#include "TailTracker.h"
+#include "PerformanceMonitor.h"
+#include "PerformanceEditor.h"
+#include "SpectrumAnalyser.h"
 
 
 using namespace juce;
@@ -19,6 +30,8 @@ using namespace juce;
 /**
 */
 class TSPluginAudioProcessor  : public juce::AudioProcessor
+                             , public PresetBankOwner
+                             , private juce::Timer
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
@@ -38,6 +51,11 @@ public:
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
+    // Hosts with a 64 bit mix bus can hand us double buffers, which run through the TS stage in double rather than being converted to float and
+    // back. The cabinet convolution is float only, it converts as it copies the audio in and out of its blocks.
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -61,11 +79,74 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    AudioProcessorParameter* getBypassParameter() const override;
+
+    // What happens to the filter and clipper states while the DSP is bypassed. The DSP is not run at all while bypassed, so the states are either
+    // kept as they were when bypass was engaged or cleared before the DSP is brought back in.
+    enum class BypassPolicy
+    {
+        KeepState,
+        ResetState
+    };
+
+    void setBypassPolicy (BypassPolicy newPolicy) { bypassPolicy = newPolicy; }
+
+    // Timing for this instance, shown in the editor.
+    PerformanceMonitor& getPerformanceMonitor() { return performance; }
+
+    // Change a parameter at sampleOffset samples into the next block, value is normalised (0 - 1). Hosts only tell the plugin about automation once
+    // a block, this is for callers that know exactly where a change lands, like the offline tools. Call between blocks from the thread that calls
+    // processBlock. Returns false if the parameter is not one the block is split for or too many changes are queued.
+    bool scheduleParameterChange (int parameterIndex, float normalisedValue, int sampleOffset);
+
+    // Load a cabinet impulse response from a WAV or AIFF file, returns an error message or an empty string if it loaded. The impulse is convolved
+    // with the output of the TS stage while the cabinet parameter is on. Call from the message thread, never the audio thread.
+    String loadCabinet(const File& file);
+
+    // Go back to no cabinet, which takes the convolver and its latency out of the signal path.
+    void clearCabinet();
+
+    // Name of the loaded impulse response, empty if there is none.
+    String getCabinetName() const;
+
+    // Presets, saved with the rest of the state and listed to the host as programs. Each preset's drive and tone are resolved into tone filter
+    // coefficients and a clipper circuit off the audio thread whenever the presets or sample rate change, so switching or morphing between
+    // presets only copies values in on the audio thread. Call from the message thread.
+
+    // Store the current settings as a preset, replacing the preset at index or adding one to the end. Returns the preset's index, or -1 if the
+    // bank is full.
+    int storePreset(const String& name, int index = -1) override;
+
+    // Switch to a preset. The parameters move to it as well, so the host and editor follow.
+    void selectPreset(int index) override;
+
+    // Morph between two presets, amount 0 is preset a and 1 is preset b. This is a performance control, it moves the DSP without changing the
+    // parameters, and moving a control or selecting a preset takes over from it.
+    void morphPresets(int a, int b, float amount) override;
+
+    int getNumPresets() override;
+    int getSelectedPreset() override;
+    String getPresetName(int index) override;
+
 private:
     
-    // --- Our audio DSP objects can go here, we will only be using one object type in this project, but we have four filters in total.
-    
-    Biquad InputStageHPF_L, InputStageHPF_R, ToneFilter_L, ToneFilter_R;
+    // --- Our audio DSP objects can go here, the whole TS circuit lives in a stage object which holds two filters and a clipper for each channel.
+
+    TSStage tsStage;
+
+    // Cabinet impulse response convolved with the TS output, null while no impulse response is loaded so the plugin only has the convolver's
+    // latency while there is a cabinet to convolve with. Only the audio thread touches the active convolver, new ones are built on the message
+    // thread and passed over through pendingCabinet, and the one they replace comes back through retiredCabinet to be deleted off the audio thread.
+    // pendingCabinetClear asks the audio thread to retire the active convolver and go on without one.
+    std::unique_ptr<PartitionedConvolver> cabinet;
+    std::atomic<PartitionedConvolver*> pendingCabinet { nullptr };
+    std::atomic<PartitionedConvolver*> retiredCabinet { nullptr };
+    std::atomic<bool> pendingCabinetClear { false };
+
+    // The convolver swapped out, kept running by the new one until its impulse response has rung out, or faded out early when another swap is
+    // waiting, before it is retired.
+    std::unique_ptr<PartitionedConvolver> fadingCabinet;
     
     // --- end DSP objects
 
@@ -74,44 +155,170 @@ private:
     // APVTS which will hold all of our parameter states
     AudioProcessorValueTreeState treestate;
 
+    // Parameters bound from the treestate, read once per block with drive, tone and level smoothed.
+    ParameterSnapshot parameters;
+    int DriveParameter = 0, ToneParameter = 0, LevelParameter = 0, BypassParameter = 0, ClipperParameter = 0, CabinetParameter = 0, BandsParameter = 0;
+
+    // Timestamped parameter changes, used to split each block at the samples where parameters change. Changes from the host land at the start of
+    // the block, scheduleParameterChange gives them their own sample.
+    ParameterEventQueue events;
+
+    // Audio for the sub-block being processed in one precision, the pointers into the host's buffer and the dry signal for the bypass crossfade.
+    // There is a set for each precision, only the set for the host's precision is sized in prepareToPlay.
+    template <typename SampleType>
+    struct SubBlockAudio
+    {
+        std::vector<SampleType*> ChannelPointers;
+
+        // Dry signal for the crossfade, delayed by the plugin latency so it lines up with the processed signal.
+        AudioBuffer<SampleType> DryBuffer;
+        AudioBuffer<SampleType> DryDelayLine;
+    };
+
+    SubBlockAudio<float> floatAudio;
+    SubBlockAudio<double> doubleAudio;
+
+    template <typename SampleType>
+    SubBlockAudio<SampleType>& getAudio()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleAudio;
+        else
+            return floatAudio;
+    }
+
+    // Watches for silence so the DSP can be skipped once the filters have rung out.
+    TailTracker tailTracker;
+
+    // The impulse response as it was loaded and the settings the convolvers are built for, guarded by cabinetLock because loading and
+    // prepareToPlay can happen on different threads.
+    CriticalSection cabinetLock;
+    AudioBuffer<float> cabinetImpulse;
+    double cabinetImpulseSampleRate = 0.0;
+    String cabinetName;
+    double cabinetSampleRate = 0.0;
+    int cabinetBlockSize = 0;
+    int cabinetNumChannels = 0;
+
+    // Times each block and the TS, bypass and cabinet stages inside it.
+    PerformanceMonitor performance;
+
+    // Output spectrum for the editor, fed with a copy of each block while the editor shows it.
+    SpectrumAnalyser analyser;
+
+    // Presets resolved for the audio thread, the parameter values and TS stage settings of each preset.
+    struct TSPresetBank : PresetBank
+    {
+        std::vector<TSStage::Settings> StageSettings;
+    };
+
+    // The presets as stored, guarded by presetLock, and the bank resolved from them for presetSampleRate, the rate the TS model runs at. Only the
+    // audio thread touches the active bank, new ones are resolved off the audio thread and passed over through presetHandover.
+    CriticalSection presetLock;
+    std::vector<PresetState> presets;
+    int currentPreset = -1;
+    double presetSampleRate = 0.0;
+
+    std::unique_ptr<TSPresetBank> presetBank;
+    RealtimeHandover<TSPresetBank> presetHandover;
+    PresetSelection presetSelection;
+
+    // Stage settings mixed for a morph, kept here so a morph allocates nothing.
+    TSStage::Settings morphSettings;
+
     // --- End member objects
     
     // --- Member variables
     
-    float inputStageFc = 300.f;
-    float gainCompensation = 0.125;
+    // Drive and tone recalculate the clipper and tone filters, so while they are being smoothed they are updated every ControlBlockSize samples rather than every sample.
+    static constexpr int ControlBlockSize = 32;
 
-    std::atomic<float>* psaturation = nullptr, *ptone = nullptr, *plevel = nullptr;
-    AudioParameterChoice* pbypass = nullptr;
+    // Stages timed by the performance monitor.
+    static constexpr int TSTimingStage = 0;
+    static constexpr int BypassTimingStage = 1;
+    static constexpr int CabinetTimingStage = 2;
 
-    float saturation = 0.0f;
-    float tone = 0.0f;
-    float level = 0.0f;
     bool bypass = false;
+    bool diodeClipper = false;
+    bool cabinetEnabled = false;
+    int numDSPChannels = 2;
+
+    // Bypass crossfade. bypassFade is 0 when processing and 1 when bypassed, it moves towards the bypass parameter over bypassCrossfadeMs.
+    BypassPolicy bypassPolicy = BypassPolicy::ResetState;
+    float bypassCrossfadeMs = 10.0f;
+    float bypassFade = 0.0f;
+    float bypassFadeStep = 1.0f;
+
+    // Position in the dry delay line.
+    int dryDelayPosition = 0;
+
+    // The latency the audio thread works to, and the same value published for the timer to report to the host. setLatencySamples tells the
+    // host on the calling thread, so a swap on the audio thread only stores the new value and the message thread passes it on.
+    int latencySamples = 0;
+    std::atomic<int> reportedLatencySamples { 0 };
+
+    // How long the active cabinet impulse rings for, read by getTailLengthSeconds from any thread.
+    std::atomic<double> cabinetTailSeconds { 0.0 };
     
     // --- end Member variables
     
     // --- Member functions
     
-    // Linear mapping function, this will allow us to calculate our current frequency cutoff without exposing the user to the cutoff value. The user will have a parameter between 0 and 1, we will then map that to our upper and lower cutoff bounds.
-    float map(float x, float in_min, float in_max, float out_min, float out_max) 
-    {
-            return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
-    }
+    // This function drains the parameter changes for a block of numSamples, falling back to reading every parameter if changes were lost.
+    void getParameters(int numSamples);
 
-    // Very mild sigmoid function which we can use to apply subtle non-linearity across the system to emulate non-linear elements such as transistors and op-amps.
-    float mildSigmoid(float xn)
-    {
-        const double EULER = 2.71828182845904523536;
+    // Stores the block rate parameters (bypass, clipper, cabinet and bands) in the plugins member variables, called again whenever an event changes them.
+    void updateBlockParameters();
 
-        // Scaling constant to map the function to -1 and 1 calculated using desmos
-        float sigmoidScale = 0.462;
+    // Updates the TS stage from the start of the current drive and tone ramps.
+    void updateControlParameters();
 
-        return (((pow(EULER, xn) - 1) * (EULER + 1)) / ((pow(EULER, xn) + 1) * (EULER - 1))) * sigmoidScale;
-    }
+    // Both processBlock overloads run this in their own precision.
+    template <typename SampleType>
+    void processSamples(AudioBuffer<SampleType>& buffer);
+
+    // Processes a sub-block that the channel pointers point at, skipping the DSP entirely while bypassed and crossfading when bypass changes.
+    template <typename SampleType>
+    void processSubBlock(ChannelLayout layout, int numChannels, int numSamples);
+
+    // Convolves the sub-block with the cabinet, or only delays it by the cabinet latency while the cabinet is off.
+    template <typename SampleType>
+    void processCabinet(int numChannels, int numSamples);
+
+    // Builds a convolver for the loaded impulse response and the prepared settings, or returns null if there is no impulse response. Call with
+    // cabinetLock held.
+    std::unique_ptr<PartitionedConvolver> createCabinet() const;
+
+    // Builds a convolver for the audio thread to pick up, or asks it to go on without one, call with cabinetLock held.
+    void postCabinet();
+
+    // Called at the start of each block on the audio thread, swaps in a new convolver or removes the old one if asked to.
+    void swapCabinet();
+
+    // Works out the latency of the TS stage plus the cabinet's if there is one, publishes it for the message thread to report, and starts the dry
+    // delay line again at the new length.
+    void updateLatency();
+
+    // Reports a latency published by the audio thread to the host. A timer polls for it, as the performance monitor does, because posting a
+    // message from the audio thread can take a lock.
+    void timerCallback() override;
+
+    // Resolves the stored presets for presetSampleRate, call with presetLock held.
+    std::unique_ptr<TSPresetBank> createPresetBank() const;
+
+    // Resolves a bank for the audio thread to pick up, call with presetLock held.
+    void postPresets();
+
+    // Called at the start of each block on the audio thread, swaps in a new bank if one is waiting and switches to a new preset selection.
+    void applyPresetSelection();
+
+    // Copies the dry input of a channel into the dry buffer, delayed by the plugin latency.
+    template <typename SampleType>
+    void delayDry(int channel, const SampleType* input, int numSamples);
 
-    // This function will get our parameters from the treestate and store them in the plugins member variables
-    void getParameters();
+    // Handles a block while the plugin is idle. Parameter changes are still applied but the DSP is not run.
+    template <typename SampleType>
+    void processIdleBlock(AudioBuffer<SampleType>& buffer, ChannelLayout layout, int numChannels, int numSamples);
     
     // --- end Member funtions
     
@@ -0,0 +1,440 @@
+/*
+  ==============================================================================
+
+    PresetState.h
+    Created: 20 Oct 2026 2:21:08pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+
+// Compact binary state shared by the plugins, used for the host's state chunk and for the preset banks stored in it. The whole chunk is
+//
+//      int32   Magic, "JEPS"
+//      int32   Format version
+//      int32   Index of the current preset, -1 for none
+//      state   The plugin's current state
+//      int32   Number of presets, followed by a state for each
+//
+// and each state is
+//
+//      int32   Size in bytes of the rest of the state
+//      string  Name
+//      int32   Number of values, followed by a parameter ID (string) and value in the parameter's own units (float) for each
+//      int32   Number of properties, followed by a name and value (strings) for each
+//
+// Numbers are little endian and strings are null terminated UTF-8. Each state carries its size so a reader can skip anything a newer version
+// appends to it, which means appending to a state does not need a new format version. Values are stored by parameter ID so parameters can be
+// added, removed or reordered without breaking saved states, and a parameter the state has no value for goes back to its default.
+class PresetState
+{
+
+public:
+
+    static constexpr int Magic = 0x5350454a;    // "JEPS"
+    static constexpr int Version = 1;
+
+    // Presets a bank can hold, the selection packs preset indices into a byte.
+    static constexpr int MaxPresets = 128;
+
+    juce::String Name;
+    std::vector<std::pair<juce::String, float>> Values;
+    std::vector<std::pair<juce::String, juce::String>> Properties;
+
+    // Capture every parameter of a processor that has an ID.
+    static PresetState Capture(juce::AudioProcessor& processor, const juce::String& name = {})
+    {
+        PresetState state;
+        state.Name = name;
+
+        for (auto* parameter : processor.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+                state.Values.push_back({ ranged->getParameterID(), ranged->convertFrom0to1(ranged->getValue()) });
+
+        return state;
+    }
+
+    // Set every parameter of a processor from the state, notifying the host. A preset leaves the bypass parameter alone so selecting one never
+    // bypasses the plugin, a saved state restores it.
+    void Apply(juce::AudioProcessor& processor, bool includeBypass) const
+    {
+        for (auto* parameter : processor.getParameters())
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+
+            if (ranged == nullptr || (! includeBypass && parameter == processor.getBypassParameter()))
+                continue;
+
+            ranged->setValueNotifyingHost(ranged->convertTo0to1(GetValue(ranged->getParameterID(), ranged->convertFrom0to1(ranged->getDefaultValue()))));
+        }
+    }
+
+    // Value of a parameter in its own units, or fallback if the state has none.
+    float GetValue(const juce::String& parameterID, float fallback) const
+    {
+        for (auto& value : Values)
+            if (value.first == parameterID)
+                return value.second;
+
+        return fallback;
+    }
+
+    juce::String GetProperty(const juce::String& name) const
+    {
+        for (auto& property : Properties)
+            if (property.first == name)
+                return property.second;
+
+        return {};
+    }
+
+    void SetProperty(const juce::String& name, const juce::String& value)
+    {
+        for (auto& property : Properties)
+            if (property.first == name)
+            {
+                property.second = value;
+                return;
+            }
+
+        Properties.push_back({ name, value });
+    }
+
+    // Write the plugin's state chunk.
+    static void WriteChunk(juce::MemoryBlock& destination, const PresetState& current, int currentPreset, const std::vector<PresetState>& presets)
+    {
+        juce::MemoryOutputStream stream(destination, false);
+
+        stream.writeInt(Magic);
+        stream.writeInt(Version);
+        stream.writeInt(currentPreset);
+
+        current.Write(stream);
+
+        stream.writeInt((int)presets.size());
+
+        for (auto& preset : presets)
+            preset.Write(stream);
+    }
+
+    // Read a chunk written by WriteChunk, returns false and leaves the arguments alone if it is not one or is from a newer version.
+    static bool ReadChunk(const void* data, int sizeInBytes, PresetState& current, int& currentPreset, std::vector<PresetState>& presets)
+    {
+        if (data == nullptr || sizeInBytes < 16)
+            return false;
+
+        juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+
+        if (stream.readInt() != Magic || stream.readInt() > Version)
+            return false;
+
+        PresetState readCurrent;
+        int readPreset = stream.readInt();
+        int numPresets = 0;
+
+        if (! readCurrent.Read(stream) || ! ReadInt(stream, numPresets))
+            return false;
+
+        if (numPresets < 0 || numPresets > MaxPresets)
+            return false;
+
+        std::vector<PresetState> readPresets((size_t)numPresets);
+
+        for (auto& preset : readPresets)
+            if (! preset.Read(stream))
+                return false;
+
+        current = std::move(readCurrent);
+        currentPreset = juce::isPositiveAndBelow(readPreset, numPresets) ? readPreset : -1;
+        presets = std::move(readPresets);
+
+        return true;
+    }
+
+private:
+
+    // Largest count a state can claim, anything above this is a corrupt chunk rather than a real state.
+    static constexpr int MaxEntries = 4096;
+
+    void Write(juce::OutputStream& stream) const
+    {
+        // Write the body on its own first so the state can be prefixed with its size.
+        juce::MemoryBlock body;
+
+        {
+            juce::MemoryOutputStream bodyStream(body, false);
+
+            bodyStream.writeString(Name);
+            bodyStream.writeInt((int)Values.size());
+
+            for (auto& value : Values)
+            {
+                bodyStream.writeString(value.first);
+                bodyStream.writeFloat(value.second);
+            }
+
+            bodyStream.writeInt((int)Properties.size());
+
+            for (auto& property : Properties)
+            {
+                bodyStream.writeString(property.first);
+                bodyStream.writeString(property.second);
+            }
+        }
+
+        stream.writeInt((int)body.getSize());
+        stream.write(body.getData(), body.getSize());
+    }
+
+    // A stream that has run out reads as 0, which would make a chunk cut off between two states look like a shorter one, so counts and sizes are
+    // only read while there are bytes for them.
+    static bool ReadInt(juce::InputStream& stream, int& value)
+    {
+        if (stream.getNumBytesRemaining() < (juce::int64)sizeof(int))
+            return false;
+
+        value = stream.readInt();
+        return true;
+    }
+
+    bool Read(juce::MemoryInputStream& stream)
+    {
+        int size = 0;
+
+        if (! ReadInt(stream, size) || size < 0 || size > stream.getNumBytesRemaining())
+            return false;
+
+        // Read from the state's own bytes so a newer version's additions are skipped, then move the outer stream past all of it.
+        juce::MemoryInputStream body(static_cast<const char*>(stream.getData()) + stream.getPosition(), (size_t)size, false);
+        stream.skipNextBytes(size);
+
+        Name = body.readString();
+
+        int numValues = body.readInt();
+
+        if (numValues < 0 || numValues > MaxEntries)
+            return false;
+
+        Values.clear();
+
+        for (int i = 0; i < numValues && ! body.isExhausted(); i++)
+        {
+            juce::String parameterID = body.readString();
+            Values.push_back({ parameterID, body.readFloat() });
+        }
+
+        int numProperties = body.readInt();
+
+        if (numProperties < 0 || numProperties > MaxEntries)
+            return false;
+
+        Properties.clear();
+
+        for (int i = 0; i < numProperties && ! body.isExhausted(); i++)
+        {
+            juce::String name = body.readString();
+            Properties.push_back({ name, body.readString() });
+        }
+
+        return true;
+    }
+
+};
+
+// The preset bank of a processor, so the editor's preset controls and the tools work with any plugin that keeps one. Call from the message thread.
+class PresetBankOwner
+{
+
+public:
+
+    // D-tor
+    virtual ~PresetBankOwner() {}
+
+    // Number of stored presets, the selected one (-1 for none) and a preset's name.
+    virtual int getNumPresets() = 0;
+    virtual int getSelectedPreset() = 0;
+    virtual juce::String getPresetName(int index) = 0;
+
+    // Store the current settings as a preset, replacing the preset at index or adding one to the end. Returns the preset's index, or -1 if the
+    // bank is full.
+    virtual int storePreset(const juce::String& name, int index = -1) = 0;
+
+    // Switch to a preset. The parameters move to it as well, so the host and editor follow.
+    virtual void selectPreset(int index) = 0;
+
+    // Morph between two presets, amount 0 is preset a and 1 is preset b. This is a performance control, it moves the DSP without changing the
+    // parameters, and moving a control or selecting a preset takes over from it.
+    virtual void morphPresets(int a, int b, float amount) = 0;
+
+};
+
+// A preset bank resolved for the audio thread. Each preset's value for every ParameterSnapshot slot is worked out off the audio thread, rounded
+// the way the parameter itself would round it, so the audio thread can move the parameters to a preset with no lookups. Plugins with derived DSP
+// state (coefficients and so on) extend this with that state resolved for each preset as well.
+struct PresetBank
+{
+    std::vector<std::vector<float>> Values;
+
+    int GetNumPresets() const { return (int)Values.size(); }
+
+    // Resolve a preset's values for the bound parameters.
+    void Add(const PresetState& state, const ParameterSnapshot& parameters)
+    {
+        std::vector<float> values((size_t)parameters.GetNumParameters());
+
+        for (int slot = 0; slot < parameters.GetNumParameters(); slot++)
+        {
+            auto* parameter = parameters.GetParameter(slot);
+            float value = state.GetValue(parameter->getParameterID(), parameter->convertFrom0to1(parameter->getDefaultValue()));
+
+            values[(size_t)slot] = parameter->convertFrom0to1(parameter->convertTo0to1(value));
+        }
+
+        Values.push_back(std::move(values));
+    }
+};
+
+// Which presets the audio thread should be playing, set from any thread and picked up at the start of a block. A selection is either a single
+// preset or a morph between two, and is packed with a sequence number into one atomic so the audio thread always sees a whole selection and
+// sees the same preset being selected again.
+class PresetSelection
+{
+
+public:
+
+    struct Selection
+    {
+        int A = -1;
+        int B = -1;
+        float Amount = 0.0f;
+
+        bool IsMorph() const { return A != B && Amount > 0.0f; }
+    };
+
+    // Switch to a single preset.
+    void Select(int index) { Morph(index, index, 0.0f); }
+
+    // Morph between two presets, amount 0 is preset a and 1 is preset b.
+    void Morph(int a, int b, float amount)
+    {
+        amount = juce::jlimit(0.0f, 1.0f, amount);
+
+        uint32_t amountBits;
+        std::memcpy(&amountBits, &amount, sizeof(amountBits));
+
+        uint64_t sequence = ((packed.load() >> 16) + 1) & 0xffff;
+        packed.store(((uint64_t)amountBits << 32) | (sequence << 16) | ((uint64_t)(uint8_t)b << 8) | (uint64_t)(uint8_t)a);
+    }
+
+    // Audio thread, returns true and fills selection if there is a selection it has not seen yet.
+    bool Poll(Selection& selection)
+    {
+        uint64_t current = packed.load();
+
+        if (current == lastSeen)
+            return false;
+
+        lastSeen = current;
+
+        uint32_t amountBits = (uint32_t)(current >> 32);
+        std::memcpy(&selection.Amount, &amountBits, sizeof(amountBits));
+        selection.A = (int)(current & 0xff);
+        selection.B = (int)((current >> 8) & 0xff);
+
+        return true;
+    }
+
+    // Move the bound parameters to a selection from the bank. Smoothed parameters are mixed and ramp there as they would for any other change,
+    // the rest jump to whichever preset the morph is nearer. ignoredSlot (the bypass parameter) is left alone. Returns false, changing nothing, if
+    // the bank does not have the presets, which can happen for a moment after a preset is added and before the new bank is swapped in.
+    static bool ApplyValues(const PresetBank& bank, const Selection& selection, ParameterSnapshot& parameters, int ignoredSlot)
+    {
+        if (! juce::isPositiveAndBelow(selection.A, bank.GetNumPresets()) || ! juce::isPositiveAndBelow(selection.B, bank.GetNumPresets()))
+            return false;
+
+        const auto& a = bank.Values[(size_t)selection.A];
+        const auto& b = bank.Values[(size_t)selection.B];
+
+        for (int slot = 0; slot < parameters.GetNumParameters(); slot++)
+        {
+            if (slot == ignoredSlot)
+                continue;
+
+            if (parameters.IsSmoothed(slot))
+                parameters.SetTarget(slot, a[(size_t)slot] + (b[(size_t)slot] - a[(size_t)slot]) * selection.Amount);
+            else
+                parameters.Jump(slot, selection.Amount < 0.5f ? a[(size_t)slot] : b[(size_t)slot]);
+        }
+
+        return true;
+    }
+
+private:
+
+    // Amount in the top 32 bits, then a 16 bit sequence number and the two preset indices. Starts on preset 255, which no bank has.
+    std::atomic<uint64_t> packed { 0xffff };
+    uint64_t lastSeen = 0xffff;
+
+};
+
+// Passes objects built off the audio thread (a resolved preset bank) to the audio thread, and the ones they replace back to be deleted off it,
+// the same way the TS plugin swaps in new cabinets.
+template <typename ObjectType>
+class RealtimeHandover
+{
+
+public:
+
+    // C-tor
+    RealtimeHandover() {}
+    // D-tor
+    ~RealtimeHandover() { Clear(); }
+
+    // Off the audio thread. A replaced object is only deleted once the audio thread has handed it back, and an object still waiting was never used.
+    void Post(std::unique_ptr<ObjectType> object)
+    {
+        delete retired.exchange(nullptr);
+        delete pending.exchange(object.release());
+    }
+
+    // Drop anything waiting or handed back, for when the audio thread is stopped and the active object is being replaced directly.
+    void Clear()
+    {
+        delete pending.exchange(nullptr);
+        delete retired.exchange(nullptr);
+    }
+
+    // Audio thread, swaps a waiting object into active and returns true. The old object has to go somewhere it can be deleted from, so nothing is
+    // swapped until the last one has been collected.
+    bool Swap(std::unique_ptr<ObjectType>& active)
+    {
+        if (retired.load() != nullptr)
+            return false;
+
+        if (ObjectType* next = pending.exchange(nullptr))
+        {
+            retired.store(active.release());
+            active.reset(next);
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+
+    std::atomic<ObjectType*> pending { nullptr };
+    std::atomic<ObjectType*> retired { nullptr };
+
+};
@@ -0,0 +1,476 @@
+/*
+  ==============================================================================
+
+    Resampler.cpp
+    Created: 20 Oct 2026 8:03:17pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include "Resampler.h"
+#include "Simd.h"
+
+namespace
+{
+    // Zero crossings of the sinc each side of its centre and the Kaiser window's beta, together about 80 dB of stopband with the transition band
+    // fitting between the cutoff and the lower Nyquist frequency.
+    static constexpr double ZeroCrossings = 24.0;
+    static constexpr double KaiserBeta = 8.0;
+
+    // Cutoff as a fraction of the lower Nyquist frequency, 19.8 kHz for a 44.1 kHz host.
+    static constexpr double CutoffRatio = 0.9;
+
+    // Rows are padded to a multiple of the widest batch so the dot product kernel has no samples left over.
+    static constexpr int TapMultiple = 16;
+
+    // A run of input positions is padded to a whole batch, the widest batch is this many samples.
+    static constexpr int MaxBatchWidth = 16;
+
+    static constexpr double Pi = 3.14159265358979323846;
+
+    // Modified Bessel function of the first kind, order zero, for the Kaiser window. The series converges well before 50 terms for any beta used here.
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 50 && term > sum * 1e-17; k++)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // The output of each row at each of a run of input positions, output[position * numRows + row] is row times the taps input samples from
+    // window + position. The batch runs across positions, so each tap is one multiply-add for a batch of output samples and there are no lanes to add
+    // up at the end. About eight sums are kept going at once so the multiply-adds are not all waiting on each other, from several batches of
+    // positions where the run is long enough and otherwise from splitting the taps between sums.
+    struct RowsKernel
+    {
+        using Function = void (*)(const float*, const float*, int, int, int, float*);
+
+        template <typename Ops>
+        static void Process(const float* window, const float* rows, int numRows, int taps, int numPositions, float* output)
+        {
+            switch (numRows)
+            {
+                case 1:  run<Ops, 1>(window, rows, taps, numPositions, output); break;
+                case 2:  run<Ops, 2>(window, rows, taps, numPositions, output); break;
+                case 3:  run<Ops, 3>(window, rows, taps, numPositions, output); break;
+                default: run<Ops, 4>(window, rows, taps, numPositions, output); break;
+            }
+        }
+
+        template <typename Ops, int NumRows>
+        static void run(const float* window, const float* rows, int taps, int numPositions, float* output)
+        {
+            static constexpr int NumBatches = std::max(1, 8 / NumRows);
+
+            int position = 0;
+
+            for (; position + NumBatches * Ops::Width <= numPositions; position += NumBatches * Ops::Width)
+                batches<Ops, NumRows, NumBatches>(window, rows, taps, position, output);
+
+            // The last run is padded up to a whole batch, the caller leaves room for it and ignores the extra output samples.
+            for (; position < numPositions; position += Ops::Width)
+                batches<Ops, NumRows, 1>(window, rows, taps, position, output);
+        }
+
+        template <typename Ops, int NumRows, int NumBatches>
+        static void batches(const float* window, const float* rows, int taps, int position, float* output)
+        {
+            // Taps are a multiple of 16, so they split evenly between up to eight sums.
+            static constexpr int NumSplits = std::max(1, 8 / (NumRows * NumBatches));
+
+            typename Ops::Batch sum[NumSplits][NumBatches][NumRows];
+
+            for (auto& split : sum)
+                for (auto& batch : split)
+                    for (auto& row : batch)
+                        row = Ops::Set(0.0f);
+
+            for (int tap = 0; tap < taps; tap += NumSplits)
+            {
+                for (int split = 0; split < NumSplits; split++)
+                {
+                    typename Ops::Batch coefficient[NumRows];
+
+                    for (int row = 0; row < NumRows; row++)
+                        coefficient[row] = Ops::Set(rows[row * taps + tap + split]);
+
+                    for (int batch = 0; batch < NumBatches; batch++)
+                    {
+                        typename Ops::Batch input = Ops::Load(window + position + batch * Ops::Width + tap + split);
+
+                        for (int row = 0; row < NumRows; row++)
+                            sum[split][batch][row] = Ops::Fma(coefficient[row], input, sum[split][batch][row]);
+                    }
+                }
+            }
+
+            // Add the splits together and interleave the rows, each position's row outputs next to each other.
+            float lanes[NumRows][Ops::Width];
+
+            for (int batch = 0; batch < NumBatches; batch++)
+            {
+                for (int row = 0; row < NumRows; row++)
+                {
+                    for (int split = 1; split < NumSplits; split++)
+                        sum[0][batch][row] = Ops::Add(sum[0][batch][row], sum[split][batch][row]);
+
+                    Ops::Store(lanes[row], sum[0][batch][row]);
+                }
+
+                float* destination = output + (position + batch * Ops::Width) * NumRows;
+
+                for (int lane = 0; lane < Ops::Width; lane++)
+                    for (int row = 0; row < NumRows; row++)
+                        destination[lane * NumRows + row] = lanes[row][lane];
+            }
+        }
+    };
+
+    // One output sample, the window of input samples times a row of taps, or times a row mixed with the next by fraction when nextRow is set.
+    struct DotKernel
+    {
+        using Function = void (*)(const float*, const float*, const float*, float, int, float*);
+
+        template <typename Ops>
+        static void Process(const float* window, const float* row, const float* nextRow, float fraction, int taps, float* output)
+        {
+            typename Ops::Batch sum = Ops::Set(0.0f);
+
+            if (nextRow == nullptr)
+            {
+                for (int tap = 0; tap < taps; tap += Ops::Width)
+                    sum = Ops::Fma(Ops::Load(row + tap), Ops::Load(window + tap), sum);
+            }
+            else
+            {
+                typename Ops::Batch mix = Ops::Set(fraction);
+
+                for (int tap = 0; tap < taps; tap += Ops::Width)
+                {
+                    typename Ops::Batch coefficient = Ops::Load(row + tap);
+                    coefficient = Ops::Fma(Ops::Sub(Ops::Load(nextRow + tap), coefficient), mix, coefficient);
+                    sum = Ops::Fma(coefficient, Ops::Load(window + tap), sum);
+                }
+            }
+
+            // Add the lanes up in pairs, halving each time.
+            float lanes[Ops::Width];
+            Ops::Store(lanes, sum);
+
+            for (int width = Ops::Width / 2; width > 0; width /= 2)
+                for (int lane = 0; lane < width; lane++)
+                    lanes[lane] += lanes[lane + width];
+
+            *output = lanes[0];
+        }
+    };
+
+    // Whole number ratio a rate ratio is close enough to, or 0.
+    int getWholeRatio(double ratio)
+    {
+        double whole = std::round(ratio);
+        return whole >= 1.0 && std::abs(ratio - whole) < 1e-9 ? (int)whole : 0;
+    }
+}
+
+template <typename SampleType>
+FloatResampler<SampleType>::FloatResampler()
+{
+    rowsKernel = Simd::Dispatch<RowsKernel>();
+    dotKernel = Simd::Dispatch<DotKernel>();
+}
+
+template <typename SampleType>
+FloatResampler<SampleType>::~FloatResampler()
+{
+
+}
+
+template <typename SampleType>
+void FloatResampler<SampleType>::Stage::Design(double inputRate, double outputRate, double cutoff, int maxInputSamples)
+{
+    Step = inputRate / outputRate;
+
+    // Whole number ratios read their rows a run at a time, up to MaxRows rows.
+    Interpolation = getWholeRatio(outputRate / inputRate);
+    Decimation = Interpolation == 0 ? getWholeRatio(Step) : 0;
+
+    if (Interpolation > MaxRows)
+        Interpolation = 0;
+
+    // The sinc's bandwidth as a fraction of the input rate, and how many input samples each side of the centre its zero crossings reach.
+    double bandwidth = 2.0 * cutoff / inputRate;
+    double halfWidth = ZeroCrossings / bandwidth;
+
+    // An output sample is read once the input is Centre samples past it, which covers the half of the filter after it. Taps covers both halves.
+    Centre = (int)halfWidth + 1;
+    Taps = (2 * Centre + 1 + TapMultiple - 1) / TapMultiple * TapMultiple;
+
+    // The row for an output sample fraction of an input sample after the input sample Centre samples before the newest. Tap t multiplies the
+    // input sample Taps - 1 - t samples before the newest. Each row is normalised so it passes DC at exactly unity, otherwise the rows' small
+    // differences in gain would modulate the signal as the position moves through them.
+    auto designRow = [this, bandwidth, halfWidth](double fraction, SampleType* row)
+    {
+        std::vector<double> taps((size_t)Taps);
+        double sum = 0.0;
+
+        for (int t = 0; t < Taps; t++)
+        {
+            double x = fraction + (Taps - 1 - Centre) - t;
+
+            if (std::abs(x) < halfWidth)
+            {
+                double sinc = x == 0.0 ? 1.0 : std::sin(Pi * bandwidth * x) / (Pi * bandwidth * x);
+                double window = besselI0(KaiserBeta * std::sqrt(1.0 - (x / halfWidth) * (x / halfWidth))) / besselI0(KaiserBeta);
+                taps[(size_t)t] = bandwidth * sinc * window;
+            }
+
+            sum += taps[(size_t)t];
+        }
+
+        for (int t = 0; t < Taps; t++)
+            row[t] = (SampleType)(taps[(size_t)t] / sum);
+    };
+
+    Rows.clear();
+    Table.clear();
+
+    if (Interpolation > 0)
+    {
+        Rows.resize((size_t)(Interpolation * Taps));
+
+        for (int r = 0; r < Interpolation; r++)
+            designRow((double)r / Interpolation, Rows.data() + r * Taps);
+    }
+    else if (Decimation > 0)
+    {
+        Rows.resize((size_t)Taps);
+        designRow(0.0, Rows.data());
+    }
+    else
+    {
+        Table.resize((size_t)((NumPhases + 1) * Taps));
+
+        for (int r = 0; r <= NumPhases; r++)
+            designRow((double)r / NumPhases, Table.data() + r * Taps);
+    }
+
+    // Room for the filter, a whole block written ahead of the oldest sample still to be read, the slack Down keeps and a padded batch.
+    int historySize = juce::nextPowerOfTwo(2 * Taps + maxInputSamples + MaxBatchWidth);
+    History.assign((size_t)historySize * 2, (SampleType)0);
+    HistoryMask = historySize - 1;
+}
+
+template <typename SampleType>
+void FloatResampler<SampleType>::Stage::Reset(double startTime)
+{
+    std::fill(History.begin(), History.end(), (SampleType)0);
+    Written = 0;
+
+    Index = (juce::int64)std::floor(startTime);
+    Fraction = startTime - (double)Index;
+}
+
+template <typename SampleType>
+void FloatResampler<SampleType>::Stage::Write(SampleType sample)
+{
+    size_t position = (size_t)(Written & HistoryMask);
+
+    History[position] = sample;
+    History[position + (size_t)HistoryMask + 1] = sample;
+    Written++;
+}
+
+template <typename SampleType>
+void FloatResampler<SampleType>::Prepare(double hostRate, double internalRate, int maxBlockSize)
+{
+    double cutoff = CutoffRatio * 0.5 * std::min(hostRate, internalRate);
+    double ratio = internalRate / hostRate;
+
+    MaxInternalSamples = (int)std::ceil(maxBlockSize * ratio) + 1;
+
+    up.Design(hostRate, internalRate, cutoff, maxBlockSize);
+    down.Design(internalRate, hostRate, cutoff, MaxInternalSamples);
+
+    // A run covers at most every input position of a block plus one, padded to a whole batch, with a row output for each.
+    Scratch.assign((size_t)((std::max(maxBlockSize, MaxInternalSamples) + 1 + MaxBatchWidth) * MaxRows), (SampleType)0);
+
+    // Host sample n has to come out of Down once host sample n has gone into Up. Up is Centre host samples behind its input and Down reads Centre
+    // internal samples behind its position, one sample more covers the rounding of both positions to whole samples.
+    LatencySamples = up.Centre + (int)std::ceil((down.Centre + 1) / ratio);
+
+    Reset();
+}
+
+template <typename SampleType>
+void FloatResampler<SampleType>::Reset()
+{
+    // Up starts at the first host sample. Down starts LatencySamples host samples before it, reading the silence in front of the first internal
+    // sample until the delay has passed.
+    up.Reset(0.0);
+    down.Reset(-LatencySamples * down.Step);
+}
+
+template <typename SampleType>
+int FloatResampler<SampleType>::Up(const SampleType* input, int numSamples, SampleType* internal)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+        up.Write(input[sample]);
+
+    return read(up, internal, MaxInternalSamples);
+}
+
+template <typename SampleType>
+void FloatResampler<SampleType>::Down(const SampleType* internal, int numInternal, SampleType* output, int numSamples)
+{
+    for (int sample = 0; sample < numInternal; sample++)
+        down.Write(internal[sample]);
+
+    // The latency keeps every output sample's window inside what has been written.
+    int numRead = read(down, output, numSamples);
+
+    jassert(numRead == numSamples);
+    juce::ignoreUnused(numRead);
+}
+
+template <typename SampleType>
+int FloatResampler<SampleType>::read(Stage& stage, SampleType* output, int maxOutputs)
+{
+    return stage.Rows.empty() ? readTable(stage, output, maxOutputs) : readRows(stage, output, maxOutputs);
+}
+
+template <typename SampleType>
+int FloatResampler<SampleType>::readRows(Stage& stage, SampleType* output, int maxOutputs)
+{
+    // Input positions the history has the input for, from the next output sample's up to the newest input sample.
+    juce::int64 first = stage.Index + stage.Centre;
+    juce::int64 numPositions = stage.Written - first;
+
+    if (numPositions <= 0)
+        return 0;
+
+    // The oldest sample still to be read must not have been written over.
+    jassert(stage.Written - first + stage.Taps + MaxBatchWidth <= stage.HistoryMask + 1);
+
+    if (stage.Interpolation > 0)
+    {
+        // Every position gives an output sample for each row, the run starts at the row the position has got to.
+        int numRows = stage.Interpolation;
+        int row = std::min((int)std::lround(stage.Fraction * numRows), numRows - 1);
+        int numOutputs = (int)std::min<juce::int64>(maxOutputs, numPositions * numRows - row);
+
+        if (numOutputs <= 0)
+            return 0;
+
+        runRows(stage, stage.GetWindow(first), numRows, (row + numOutputs + numRows - 1) / numRows);
+        std::copy(Scratch.begin() + row, Scratch.begin() + row + numOutputs, output);
+
+        int end = row + numOutputs;
+        stage.Index += end / numRows;
+        stage.Fraction = (double)(end % numRows) / numRows;
+
+        return numOutputs;
+    }
+
+    // Decimating, the one row runs at every position and every Decimation'th is kept. Working out the ones in between costs less than reading
+    // the output samples one at a time.
+    int decimation = stage.Decimation;
+    int numOutputs = (int)std::min<juce::int64>(maxOutputs, (numPositions - 1) / decimation + 1);
+
+    runRows(stage, stage.GetWindow(first), 1, (numOutputs - 1) * decimation + 1);
+
+    for (int sample = 0; sample < numOutputs; sample++)
+        output[sample] = Scratch[(size_t)(sample * decimation)];
+
+    stage.Index += (juce::int64)numOutputs * decimation;
+
+    return numOutputs;
+}
+
+template <typename SampleType>
+void FloatResampler<SampleType>::runRows(const Stage& stage, const SampleType* window, int numRows, int numPositions)
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        rowsKernel(window, stage.Rows.data(), numRows, stage.Taps, numPositions, Scratch.data());
+    }
+    else
+    {
+        // Double has no SIMD kernel.
+        for (int position = 0; position < numPositions; position++)
+        {
+            for (int row = 0; row < numRows; row++)
+            {
+                const SampleType* taps = stage.Rows.data() + row * stage.Taps;
+                SampleType sum = 0;
+
+                for (int tap = 0; tap < stage.Taps; tap++)
+                    sum += taps[tap] * window[position + tap];
+
+                Scratch[(size_t)(position * numRows + row)] = sum;
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+int FloatResampler<SampleType>::readTable(Stage& stage, SampleType* output, int maxOutputs)
+{
+    int numOutputs = 0;
+
+    for (; numOutputs < maxOutputs && stage.Index + stage.Centre < stage.Written; numOutputs++)
+    {
+        juce::int64 newest = stage.Index + stage.Centre;
+
+        // The oldest sample still to be read must not have been written over.
+        jassert(stage.Written - newest + stage.Taps <= stage.HistoryMask + 1);
+
+        const SampleType* window = stage.GetWindow(newest);
+
+        // The rows either side of the position and how far it is between them.
+        double phase = stage.Fraction * NumPhases;
+        int r = (int)phase;
+        SampleType fraction = (SampleType)(phase - r);
+
+        const SampleType* row = stage.Table.data() + r * stage.Taps;
+        const SampleType* nextRow = fraction == 0 ? nullptr : row + stage.Taps;
+
+        SampleType result = 0;
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            dotKernel(window, row, nextRow, fraction, stage.Taps, &result);
+        }
+        else
+        {
+            for (int tap = 0; tap < stage.Taps; tap++)
+            {
+                SampleType coefficient = nextRow == nullptr ? row[tap] : row[tap] + (nextRow[tap] - row[tap]) * fraction;
+                result += coefficient * window[tap];
+            }
+        }
+
+        output[numOutputs] = result;
+
+        // Step on to the next output sample, the fraction is never negative so truncating takes its whole part.
+        stage.Fraction += stage.Step;
+
+        juce::int64 whole = (juce::int64)stage.Fraction;
+        stage.Index += whole;
+        stage.Fraction -= (double)whole;
+    }
+
+    return numOutputs;
+}
+
+template class FloatResampler<float>;
+template class FloatResampler<double>;
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    Resampler.h
+    Created: 20 Oct 2026 8:03:17pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+
+// Polyphase resampler for running a nonlinear model at a fixed internal rate whatever rate the host runs at. Up converts host rate audio to the
+// internal rate, the model runs over it, and Down converts it back, so the model only ever sees one rate. The ratio can be anything, the usual
+// ones are 2 (44.1 and 48 kHz hosts), 1 / 2 (176.4 and 192 kHz), 3 (32 kHz) or 4 and 1 / 4, but a 50 kHz host works as well.
+//
+// Both directions use the same Kaiser windowed sinc low pass, cut off just below the lower of the two Nyquist frequencies so nothing the model
+// makes above the host's Nyquist aliases back down. The filter is stored as rows of taps, each row the filter shifted by a fraction of an input
+// sample. Whole number ratios only need a row for each output sample between two input samples, and the rows run side by side over a run of
+// input samples so each SIMD batch works out that many output samples at once. Any other ratio has NumPhases + 1 rows, and each output sample
+// is a dot product with the two rows either side of it, mixed linearly.
+//
+// Up gives out a varying number of internal samples per block, whatever the filter has enough input for. Down always gives exactly numSamples back,
+// it works out each output sample from a point far enough behind the newest internal sample that it is always there. That makes the delay through
+// both of them a whole number of host samples, GetLatencySamples, for the plugin to report. Float runs the filters as SIMD kernels, double runs
+// them sample by sample. Both are defined in Resampler.cpp.
+template <typename SampleType>
+class FloatResampler
+{
+
+public:
+
+    // C-tor
+    FloatResampler();
+    // D-tor
+    ~FloatResampler();
+
+    // Design the filters for the two rates and size the buffers for blocks of up to maxBlockSize host samples, then clear the state. This
+    // allocates, so call it from prepareToPlay.
+    void Prepare(double hostRate, double internalRate, int maxBlockSize);
+
+    // Clear the state, the filters are kept.
+    void Reset();
+
+    // Most internal samples Up can give out for a block of maxBlockSize host samples.
+    int GetMaxInternalSamples() const { return MaxInternalSamples; }
+
+    // Host samples of delay through Up, the model and Down.
+    int GetLatencySamples() const { return LatencySamples; }
+
+    // Convert numSamples host rate samples (up to maxBlockSize) to the internal rate, returns how many internal samples were written.
+    int Up(const SampleType* input, int numSamples, SampleType* internal);
+
+    // Convert the numInternal internal samples Up gave out for the same block back to exactly numSamples host rate samples.
+    void Down(const SampleType* internal, int numInternal, SampleType* output, int numSamples);
+
+    // Rows of the filter table for ratios that are not whole numbers, one per 1 / NumPhases of an input sample.
+    static constexpr int NumPhases = 128;
+
+    // Largest whole number ratio up that runs its rows side by side, higher ratios use the table.
+    static constexpr int MaxRows = 4;
+
+private:
+
+    // One direction of the conversion. The history is a ring of input samples written twice, once in each half, so any run of samples up to the
+    // ring's length can be read in one go. Position is the next output sample's time in input samples, Index its whole part and Fraction the rest.
+    struct Stage
+    {
+        // Output samples per input sample when it is a whole number, or input samples per output sample when that is, otherwise both 0.
+        int Interpolation = 0;
+        int Decimation = 0;
+
+        // Rows for the output samples between two input samples with a whole number ratio (one row decimating), and the table otherwise.
+        std::vector<SampleType> Rows;
+        std::vector<SampleType> Table;
+        int Taps = 0;
+        int Centre = 0;
+        double Step = 1.0;
+
+        std::vector<SampleType> History;
+        int HistoryMask = 0;
+        juce::int64 Written = 0;
+
+        juce::int64 Index = 0;
+        double Fraction = 0.0;
+
+        // Design for an input and output rate, cutting off at cutoff Hz, with room in the history for a block of maxInputSamples.
+        void Design(double inputRate, double outputRate, double cutoff, int maxInputSamples);
+
+        // Clear the history and start the position at startTime.
+        void Reset(double startTime);
+
+        void Write(SampleType sample);
+
+        // First of the Taps input samples for the output sample whose newest input sample is newest.
+        const SampleType* GetWindow(juce::int64 newest) const { return History.data() + ((newest - Taps + 1) & HistoryMask); }
+    };
+
+    Stage up;
+    Stage down;
+
+    int MaxInternalSamples = 0;
+    int LatencySamples = 0;
+
+    // Every row's output at every input position of a run, before the output samples are picked out of it.
+    std::vector<SampleType> Scratch;
+
+    // Kernels for the widest instruction set the machine supports, picked when the resampler is created. Only used in float.
+    void (*rowsKernel)(const float* window, const float* rows, int numRows, int taps, int numPositions, float* output) = nullptr;
+    void (*dotKernel)(const float* window, const float* row, const float* nextRow, float fraction, int taps, float* output) = nullptr;
+
+    // Read up to maxOutputs output samples from a stage, as many as its history has the input for. Returns how many were read.
+    int read(Stage& stage, SampleType* output, int maxOutputs);
+
+    // Output samples from a stage with a whole number ratio, read a run at a time.
+    int readRows(Stage& stage, SampleType* output, int maxOutputs);
+
+    // Output samples from a stage with any other ratio, read one at a time from the table.
+    int readTable(Stage& stage, SampleType* output, int maxOutputs);
+
+    // Every row's output for numPositions input positions in a row, starting at the window for position 0, into Scratch.
+    void runRows(const Stage& stage, const SampleType* window, int numRows, int numPositions);
+};
+
+// The two precisions, defined in Resampler.cpp.
+using Resampler = FloatResampler<float>;
+using ResamplerDouble = FloatResampler<double>;
+
+extern template class FloatResampler<float>;
+extern template class FloatResampler<double>;
@@ -8,31 +8,36 @@
   ==============================================================================
 */
 
+#include <JuceHeader.h>
 #include "CircularBuffer.h"
 
 // C-tor
-CircularBuffer::CircularBuffer(){};
+template <typename SampleType>
+FloatCircularBuffer<SampleType>::FloatCircularBuffer(){};
 // D-tor
-CircularBuffer::~CircularBuffer(){};
+template <typename SampleType>
+FloatCircularBuffer<SampleType>::~FloatCircularBuffer(){};
 
 
 
 // Function to reset all buffer values to zero
-void CircularBuffer::ClearBuffer(){
+template <typename SampleType>
+void FloatCircularBuffer<SampleType>::ClearBuffer(){
     
     // iterate through buffer
     for (int i = 0; i < buffer_length; i++)
     {
         
         // set to zero
-        delaybuffer[i] = 0.0f;
+        delaybuffer[i] = 0;
         
     }
     
 }
 
 // Function to initialise the buffer using the sample rate and the maximum desired delay time.
-void CircularBuffer::Init(int sr, float max_delay_time_ms) {
+template <typename SampleType>
+void FloatCircularBuffer<SampleType>::Init(int sr, float max_delay_time_ms) {
     
     // Save variables into object
     SampleRate = sr;
@@ -45,7 +50,7 @@ void CircularBuffer::Init(int sr, float max_delay_time_ms) {
     buffer_length = (unsigned int)(pow(2, ceil(log(buffer_length) / log(2))));
     
     // Reset array with new buffer length
-    delaybuffer.reset(new float[buffer_length]);
+    delaybuffer.reset(new SampleType[buffer_length]);
     
     // Initialise array values to zero
     ClearBuffer();
@@ -56,7 +61,8 @@ void CircularBuffer::Init(int sr, float max_delay_time_ms) {
 }
 
 // Function that reads from the buffer with a desired amount of delay in ms. Calculates delay in samples using sample rate. Optional calculation of fractional delay using a linear interpolation function.
-float CircularBuffer::BufferRead(float delay_time_ms, bool interpolate_line) {
+template <typename SampleType>
+SampleType FloatCircularBuffer<SampleType>::BufferRead(float delay_time_ms, bool interpolate_line) {
     
     // Save variables to object
     interpolateline = interpolate_line;
@@ -72,7 +78,7 @@ float CircularBuffer::BufferRead(float delay_time_ms, bool interpolate_line) {
     ReadIndex %=  buffer_length;
    
     // Calculate normal output
-    float yn = delaybuffer[ReadIndex];
+    SampleType yn = delaybuffer[ReadIndex];
     
     // interpolation enabled check
     if (interpolateline == true) {
@@ -84,9 +90,9 @@ float CircularBuffer::BufferRead(float delay_time_ms, bool interpolate_line) {
         bReadIndex %= buffer_length;
         
         // calculate input into interpolator
-        float a = yn;
-        float b = delaybuffer[bReadIndex];
-        float t = delay_fractional_samples - delay_time_samples;
+        SampleType a = yn;
+        SampleType b = delaybuffer[bReadIndex];
+        SampleType t = delay_fractional_samples - delay_time_samples;
         
         // calculate fractional delay sample with a linear interpolator
         yn = lerp(a, b, t);
@@ -98,7 +104,8 @@ float CircularBuffer::BufferRead(float delay_time_ms, bool interpolate_line) {
 
 
 // Function to read from the buffer if delay required is explicitly in samples. By default does not use interpolation.
-float CircularBuffer::BufferReadSamples(int delay_in_samples) {
+template <typename SampleType>
+SampleType FloatCircularBuffer<SampleType>::BufferReadSamples(int delay_in_samples) {
 
     // Set interpolation off
     interpolateline = false;
@@ -110,15 +117,36 @@ float CircularBuffer::BufferReadSamples(int delay_in_samples) {
     ReadIndex %= buffer_length;
 
     // Calculate normal output
-    float yn = delaybuffer[ReadIndex];
+    SampleType yn = delaybuffer[ReadIndex];
 
     // return output
     return yn;
 }
 
 
+// Function to read from the buffer with a fractional delay in samples, always uses linear interpolation. Used when the delay time is moving every sample.
+template <typename SampleType>
+SampleType FloatCircularBuffer<SampleType>::BufferReadFractional(float delay_in_samples) {
+
+    // Split the delay into whole and fractional samples
+    int delay_int_samples = (int)delay_in_samples;
+    SampleType t = delay_in_samples - delay_int_samples;
+
+    // Calculate read index for both samples and wrap using modulo
+    int ReadIndex = (WriteIndex - 1) - delay_int_samples;
+    ReadIndex %= buffer_length;
+
+    int bReadIndex = ReadIndex - 1;
+    bReadIndex %= buffer_length;
+
+    // return interpolated output
+    return lerp(delaybuffer[ReadIndex], delaybuffer[bReadIndex], t);
+}
+
+
 // Function to write to buffer
-void CircularBuffer::BufferWrite(float xn) {
+template <typename SampleType>
+void FloatCircularBuffer<SampleType>::BufferWrite(SampleType xn) {
  
     // Increment write index
     WriteIndex++;
@@ -132,5 +160,37 @@ void CircularBuffer::BufferWrite(float xn) {
 }
 
 
+// Function to read a block from the buffer with a delay in samples, the block is copied in at most two parts either side of the end of the buffer.
+template <typename SampleType>
+void FloatCircularBuffer<SampleType>::BufferReadBlock(int delay_in_samples, SampleType* destination, int numSamples) {
+
+    // Read index of the first sample, as BufferReadSamples would calculate it
+    unsigned int ReadIndex = (WriteIndex - 1 - (unsigned int)delay_in_samples) % buffer_length;
+
+    // Copy up to the end of the buffer, then the rest from the start
+    int firstPart = juce::jmin(numSamples, (int)(buffer_length - ReadIndex));
+
+    juce::FloatVectorOperations::copy(destination, delaybuffer.get() + ReadIndex, firstPart);
+    juce::FloatVectorOperations::copy(destination + firstPart, delaybuffer.get(), numSamples - firstPart);
+}
+
+
+// Function to write a block to the buffer
+template <typename SampleType>
+void FloatCircularBuffer<SampleType>::BufferWriteBlock(const SampleType* source, int numSamples) {
 
+    // The first sample goes one after the current write index, as with BufferWrite
+    unsigned int StartIndex = (WriteIndex + 1) % buffer_length;
+
+    // Copy up to the end of the buffer, then the rest from the start
+    int firstPart = juce::jmin(numSamples, (int)(buffer_length - StartIndex));
+
+    juce::FloatVectorOperations::copy(delaybuffer.get() + StartIndex, source, firstPart);
+    juce::FloatVectorOperations::copy(delaybuffer.get(), source + firstPart, numSamples - firstPart);
+
+    // Move the write index to the last sample written
+    WriteIndex = (WriteIndex + (unsigned int)numSamples) % buffer_length;
+}
 
+template class FloatCircularBuffer<float>;
+template class FloatCircularBuffer<double>;
@@ -12,24 +12,34 @@
 
 #include <iostream>
 #include <cmath>
+#include <memory>
 
- class CircularBuffer
+// Delay line in either floating point type, CircularBuffer stores float and CircularBufferDouble stores double for hosts that process in double.
+// Delay times stay in float whichever type the samples are. Both are defined in CircularBuffer.cpp.
+template <typename SampleType>
+class FloatCircularBuffer
 {
     
 public:
     
     // C-tor
-    CircularBuffer();
+    FloatCircularBuffer();
     // D-tor
-    ~CircularBuffer();
+    ~FloatCircularBuffer();
     
     
     //Public member functions
     void Init(int sr, float max_delay_time_ms);
     void ClearBuffer();
-    void BufferWrite(float xn);
-    float BufferRead(float delay_time_ms, bool interpolate_line);
-    float BufferReadSamples(int delay_int_samples);
+    void BufferWrite(SampleType xn);
+    SampleType BufferRead(float delay_time_ms, bool interpolate_line);
+    SampleType BufferReadSamples(int delay_int_samples);
+    SampleType BufferReadFractional(float delay_in_samples);
+
+    // Block versions of BufferReadSamples and BufferWrite. BufferReadBlock reads what BufferReadSamples would return over the next numSamples
+    // samples, so the delay must be at least numSamples for every sample it reads to have been written already.
+    void BufferReadBlock(int delay_in_samples, SampleType* destination, int numSamples);
+    void BufferWriteBlock(const SampleType* source, int numSamples);
     
     
     
@@ -50,14 +60,22 @@ private:
     bool interpolateline = false; 
     
     // Unique ptr array to use as circular buffer, self deletes when goes out of scope.
-    std::unique_ptr<float[]> delaybuffer = nullptr;
+    std::unique_ptr<SampleType[]> delaybuffer = nullptr;
     
 
     
     // linear interpolation function
-    float lerp(float a, float b, float f)
+    SampleType lerp(SampleType a, SampleType b, SampleType f)
     {
-        return a * (1.0f - f) + (b * f);
+        return a * (1 - f) + (b * f);
     }
     
 };
+
+// The two precisions, defined in CircularBuffer.cpp.
+using CircularBuffer = FloatCircularBuffer<float>;
+using CircularBufferDouble = FloatCircularBuffer<double>;
+
+extern template class FloatCircularBuffer<float>;
+extern template class FloatCircularBuffer<double>;
+
@@ -0,0 +1,351 @@
+/*
+  ==============================================================================
+
+    DelayStage.cpp
+    Created: 19 Oct 2026 5:12:40pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include "DelayStage.h"
+
+namespace
+{
+    // Delay line input, dry + feedback * delayed.
+    struct FeedbackKernel
+    {
+        using Function = void (*)(const float*, const float*, const float*, float*, int);
+
+        template <typename Ops>
+        static void Process(const float* dry, const float* delayed, const float* feedback, float* destination, int numSamples)
+        {
+            Simd::ForEach<Ops>(numSamples, [&](auto ops, int sample)
+            {
+                using O = decltype(ops);
+                O::Store(destination + sample, O::Fma(O::Load(feedback + sample), O::Load(delayed + sample), O::Load(dry + sample)));
+            });
+        }
+    };
+
+    // Mix the dry and delayed signals and apply the master gain, written over the dry signal.
+    struct MixKernel
+    {
+        using Function = void (*)(float*, const float*, const float*, const float*, int);
+
+        template <typename Ops>
+        static void Process(float* data, const float* delayed, const float* mix, const float* master, int numSamples)
+        {
+            Simd::ForEach<Ops>(numSamples, [&](auto ops, int sample)
+            {
+                using O = decltype(ops);
+                auto dry = O::Load(data + sample);
+                auto wet = O::Load(mix + sample);
+                auto yn = O::Fma(wet, O::Load(delayed + sample), O::Mul(dry, O::Sub(O::Set(1.0f), wet)));
+
+                O::Store(data + sample, O::Mul(yn, O::Load(master + sample)));
+            });
+        }
+    };
+}
+
+DelayStage::DelayStage()
+{
+    // Pick the kernels for this machine.
+    feedbackKernel = Simd::Dispatch<FeedbackKernel>();
+    mixKernel = Simd::Dispatch<MixKernel>();
+}
+
+DelayStage::~DelayStage()
+{
+
+}
+
+void DelayStage::Prepare(double sampleRate, int numChannels, int maxBlockSize, bool doublePrecision)
+{
+    // Create a delay line for every channel in the precision the host processes in, and drop the other precision's.
+    NumBuffers = juce::jmax(1, numChannels);
+
+    if (doublePrecision)
+    {
+        Buffers.reset();
+        BuffersDouble.reset(new CircularBufferDouble[NumBuffers]);
+
+        for (int channel = 0; channel < NumBuffers; channel++)
+            BuffersDouble[channel].Init((int)sampleRate, MaxDelayTimeMs);
+    }
+    else
+    {
+        BuffersDouble.reset();
+        Buffers.reset(new CircularBuffer[NumBuffers]);
+
+        for (int channel = 0; channel < NumBuffers; channel++)
+            Buffers[channel].Init((int)sampleRate, MaxDelayTimeMs);
+    }
+
+    // Size the delay glide ramp for the largest sub-block and drop any glide that was in progress.
+    delayRamp.assign((size_t)juce::jmax(1, maxBlockSize), 0.0f);
+    DelayGlideRemaining = 0;
+
+    // Scratch space for the block path.
+    MaxBlockSize = juce::jmax(1, maxBlockSize);
+    delayedBlock.assign((size_t)(NumBuffers * MaxBlockSize), 0.0f);
+    feedbackBlock.assign((size_t)(NumBuffers * MaxBlockSize), 0.0f);
+}
+
+void DelayStage::Clear()
+{
+    for (int channel = 0; channel < NumBuffers; channel++)
+    {
+        if (Buffers != nullptr)
+            Buffers[channel].ClearBuffer();
+
+        if (BuffersDouble != nullptr)
+            BuffersDouble[channel].ClearBuffer();
+    }
+}
+
+void DelayStage::SetDelayTime(float delaySamples, int glideSamples)
+{
+    if (glideSamples > 0)
+    {
+        // Glide to the new delay time.
+        TargetDelaySamples = delaySamples;
+        DelayGlideRemaining = glideSamples;
+        DelayGlideStep = (TargetDelaySamples - CurrentDelaySamples) / (float)DelayGlideRemaining;
+    }
+    else if (delaySamples != TargetDelaySamples || DelayGlideRemaining == 0)
+    {
+        // Anything else changes the delay time straight away, a glide that is heading to the same delay time carries on.
+        CurrentDelaySamples = TargetDelaySamples = delaySamples;
+        DelayGlideRemaining = 0;
+    }
+
+    DelaySamples = (int)CurrentDelaySamples;
+}
+
+void DelayStage::Update(bool pingPong, const float* feedbackRamp, const float* mixRamp, const float* masterRamp)
+{
+    PingPong = pingPong;
+
+    ramps.Feedback = feedbackRamp;
+    ramps.Mix = mixRamp;
+    ramps.Master = masterRamp;
+    ramps.Delay = delayRamp.data();
+}
+
+bool DelayStage::advanceDelayGlide(int numSamples)
+{
+    if (DelayGlideRemaining <= 0)
+        return false;
+
+    // Ramp for as long as the glide has left, then hold the new delay time for the rest of the sub-block.
+    int glideLength = juce::jmin(DelayGlideRemaining, numSamples);
+
+    for (int sample = 0; sample < glideLength; sample++)
+        delayRamp[(size_t)sample] = CurrentDelaySamples + DelayGlideStep * (float)(sample + 1);
+
+    for (int sample = glideLength; sample < numSamples; sample++)
+        delayRamp[(size_t)sample] = TargetDelaySamples;
+
+    DelayGlideRemaining -= glideLength;
+    CurrentDelaySamples = DelayGlideRemaining > 0 ? delayRamp[(size_t)numSamples - 1] : TargetDelaySamples;
+    DelaySamples = (int)CurrentDelaySamples;
+
+    return true;
+}
+
+template <ChannelLayout Layout, bool PingPong, bool Glide, typename SampleType>
+void DelayStage::processKernel(SampleType* const* channelData, int numChannels, int numSamples)
+{
+    if constexpr (Layout == ChannelLayout::Mono)
+    {
+        // Mono, one delay line processes the only channel.
+        SampleType* data = channelData[0];
+        auto& delayLine = getBuffer<SampleType>(0);
+
+        for (int sample = 0; sample < numSamples; sample++)
+        {
+            SampleType xn = data[sample];
+            SampleType bufferinput;
+
+            SampleType ynminusD = readDelay<Glide>(delayLine, xn, sample, bufferinput);
+
+            delayLine.BufferWrite(bufferinput);
+
+            data[sample] = mixOutput(xn, ynminusD, ramps.Mix[sample], ramps.Master[sample]);
+        }
+    }
+    else if constexpr (Layout == ChannelLayout::MonoToStereo)
+    {
+        // Mono/stereo, the single input channel is duplicated into the second channel which can then be processed as stereo.
+        juce::FloatVectorOperations::copy(channelData[1], channelData[0], numSamples);
+
+        processKernel<ChannelLayout::Stereo, PingPong, Glide>(channelData, 2, numSamples);
+    }
+    else if constexpr (Layout == ChannelLayout::Stereo)
+    {
+        // Stereo, both channels are processed in the same loop so ping pong can cross the feedback between them.
+        SampleType* data_L = channelData[0];
+        SampleType* data_R = channelData[1];
+        auto& delayLine_L = getBuffer<SampleType>(0);
+        auto& delayLine_R = getBuffer<SampleType>(1);
+
+        for (int sample = 0; sample < numSamples; sample++)
+        {
+            SampleType xn_L = data_L[sample];
+            SampleType xn_R = data_R[sample];
+            SampleType bufferinput_L, bufferinput_R;
+
+            SampleType ynminusD_L = readDelay<Glide>(delayLine_L, xn_L, sample, bufferinput_L);
+            SampleType ynminusD_R = readDelay<Glide>(delayLine_R, xn_R, sample, bufferinput_R);
+
+            // With ping pong enabled each channel feeds the opposite delay line.
+            if constexpr (PingPong)
+            {
+                delayLine_L.BufferWrite(bufferinput_R);
+                delayLine_R.BufferWrite(bufferinput_L);
+            }
+            else
+            {
+                delayLine_L.BufferWrite(bufferinput_L);
+                delayLine_R.BufferWrite(bufferinput_R);
+            }
+
+            data_L[sample] = mixOutput(xn_L, ynminusD_L, ramps.Mix[sample], ramps.Master[sample]);
+            data_R[sample] = mixOutput(xn_R, ynminusD_R, ramps.Mix[sample], ramps.Master[sample]);
+        }
+    }
+    else
+    {
+        // Any other channel count, each channel is processed in turn with its own delay line. Ping pong only applies to stereo.
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            SampleType* data = channelData[channel];
+            auto& delayLine = getBuffer<SampleType>(channel);
+
+            for (int sample = 0; sample < numSamples; sample++)
+            {
+                SampleType xn = data[sample];
+                SampleType bufferinput;
+
+                SampleType ynminusD = readDelay<Glide>(delayLine, xn, sample, bufferinput);
+
+                delayLine.BufferWrite(bufferinput);
+
+                data[sample] = mixOutput(xn, ynminusD, ramps.Mix[sample], ramps.Master[sample]);
+            }
+        }
+    }
+}
+
+void DelayStage::processBlocks(ChannelLayout layout, bool pingPong, float* const* channelData, int numChannels, int numSamples)
+{
+    // Mono/stereo duplicates the single input channel and is then processed as stereo.
+    if (layout == ChannelLayout::MonoToStereo)
+    {
+        juce::FloatVectorOperations::copy(channelData[1], channelData[0], numSamples);
+        numChannels = juce::jmin(2, NumBuffers);
+    }
+    else if (layout == ChannelLayout::Mono)
+        numChannels = 1;
+
+    // Ping pong only applies to stereo.
+    pingPong = pingPong && numChannels == 2;
+
+    // Read every delay line and work out its input before anything is written, ping pong needs both channels' inputs before either is written.
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        float* delayed = delayedBlock.data() + channel * MaxBlockSize;
+        float* feedback = feedbackBlock.data() + channel * MaxBlockSize;
+
+        Buffers[channel].BufferReadBlock(DelaySamples, delayed, numSamples);
+        feedbackKernel(channelData[channel], delayed, ramps.Feedback, feedback, numSamples);
+    }
+
+    // With ping pong enabled each channel feeds the opposite delay line.
+    for (int channel = 0; channel < numChannels; channel++)
+        Buffers[pingPong ? 1 - channel : channel].BufferWriteBlock(feedbackBlock.data() + channel * MaxBlockSize, numSamples);
+
+    for (int channel = 0; channel < numChannels; channel++)
+        mixKernel(channelData[channel], delayedBlock.data() + channel * MaxBlockSize, ramps.Mix, ramps.Master, numSamples);
+}
+
+template <ChannelLayout Layout, typename SampleType>
+void DelayStage::runLayoutKernel(bool pingPong, bool glide, SampleType* const* channelData, int numChannels, int numSamples)
+{
+    if (glide)
+        pingPong ? processKernel<Layout, true, true>(channelData, numChannels, numSamples)
+                 : processKernel<Layout, false, true>(channelData, numChannels, numSamples);
+    else
+        pingPong ? processKernel<Layout, true, false>(channelData, numChannels, numSamples)
+                 : processKernel<Layout, false, false>(channelData, numChannels, numSamples);
+}
+
+void DelayStage::Process(ChannelLayout layout, float* const* channelData, int numChannels, int numSamples)
+{
+    // Only a stage prepared in float has float delay lines.
+    if (Buffers == nullptr)
+    {
+        jassertfalse;
+        return;
+    }
+
+    // Never process more channels than we have delay lines for.
+    numChannels = juce::jmin(numChannels, NumBuffers);
+
+    // Fill the delay ramp if the delay time is gliding.
+    bool glide = advanceDelayGlide(numSamples);
+
+    // A fixed delay at least a sub-block long can be processed a block at a time. Ping pong only applies to stereo.
+    if (! glide && DelaySamples >= numSamples && numSamples <= MaxBlockSize)
+    {
+        bool pingPong = PingPong && (layout == ChannelLayout::Stereo || layout == ChannelLayout::MonoToStereo);
+        processBlocks(layout, pingPong, channelData, numChannels, numSamples);
+        return;
+    }
+
+    runKernel(layout, glide, channelData, numChannels, numSamples);
+}
+
+void DelayStage::Process(ChannelLayout layout, double* const* channelData, int numChannels, int numSamples)
+{
+    // Only a stage prepared in double has double delay lines.
+    if (BuffersDouble == nullptr)
+    {
+        jassertfalse;
+        return;
+    }
+
+    // Never process more channels than we have delay lines for.
+    numChannels = juce::jmin(numChannels, NumBuffers);
+
+    // Fill the delay ramp if the delay time is gliding, there is no block path in double.
+    bool glide = advanceDelayGlide(numSamples);
+
+    runKernel(layout, glide, channelData, numChannels, numSamples);
+}
+
+template <typename SampleType>
+void DelayStage::runKernel(ChannelLayout layout, bool glide, SampleType* const* channelData, int numChannels, int numSamples)
+{
+    // Pick the kernel for the current layout, ping pong and glide settings. Ping pong only applies to stereo.
+    switch (layout)
+    {
+        case ChannelLayout::Mono:
+            runLayoutKernel<ChannelLayout::Mono>(false, glide, channelData, numChannels, numSamples);
+            break;
+
+        case ChannelLayout::MonoToStereo:
+            runLayoutKernel<ChannelLayout::MonoToStereo>(PingPong, glide, channelData, numChannels, numSamples);
+            break;
+
+        case ChannelLayout::Stereo:
+            runLayoutKernel<ChannelLayout::Stereo>(PingPong, glide, channelData, numChannels, numSamples);
+            break;
+
+        case ChannelLayout::MultiChannel:
+            runLayoutKernel<ChannelLayout::MultiChannel>(false, glide, channelData, numChannels, numSamples);
+            break;
+    }
+}
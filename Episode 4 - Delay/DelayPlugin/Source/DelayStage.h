@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    DelayStage.h
+    Created: 19 Oct 2026 5:12:40pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <JuceHeader.h>
+#include "CircularBuffer.h"
+#include "ChannelLayout.h"
+#include "Simd.h"
+
+// The delay DSP on its own, without any of the plugin around it (parameters, tempo sync, idle detection). The delay plugin runs one of these over its
+// buffer, and because it only needs channel pointers it can also be run as a stage in a chain of effects.
+class DelayStage
+{
+
+public:
+
+    // Longest delay the delay lines are allocated for.
+    static constexpr float MaxDelayTimeMs = 2000.0f;
+
+    // C-tor
+    DelayStage();
+    // D-tor
+    ~DelayStage();
+
+    // Create a delay line for each channel and size the delay glide for the largest sub-block, call from prepareToPlay. With doublePrecision set
+    // the delay lines store double, and only the double Process can be used until the next Prepare.
+    void Prepare(double sampleRate, int numChannels, int maxBlockSize, bool doublePrecision = false);
+
+    // Clears the delay lines.
+    void Clear();
+
+    // Set the delay time in samples. With glideSamples above 0 the delay time moves smoothly to the new value over that many samples, otherwise it
+    // jumps straight there. A glide that is already heading to the same delay time carries on.
+    void SetDelayTime(float delaySamples, int glideSamples);
+
+    // Set ping pong and the per sample feedback, mix and master gains for the next sub-block, the ramps must cover the whole sub-block.
+    void Update(bool pingPong, const float* feedbackRamp, const float* mixRamp, const float* masterRamp);
+
+    // Process numSamples samples in place, channelData holds numChannels pointers laid out as the layout describes.
+    void Process(ChannelLayout layout, float* const* channelData, int numChannels, int numSamples);
+
+    // Same in double precision, for a stage prepared with doublePrecision. The block path's kernels are float only, so every sub-block runs the
+    // per sample kernels.
+    void Process(ChannelLayout layout, double* const* channelData, int numChannels, int numSamples);
+
+private:
+
+    // One delay line per channel, in the precision given to Prepare. The other precision has none.
+    std::unique_ptr<CircularBuffer[]> Buffers;
+    std::unique_ptr<CircularBufferDouble[]> BuffersDouble;
+    int NumBuffers = 0;
+
+    template <typename SampleType>
+    FloatCircularBuffer<SampleType>& getBuffer(int channel)
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return BuffersDouble[channel];
+        else
+            return Buffers[channel];
+    }
+
+    // Block rate values used by the processing kernels.
+    int DelaySamples = 0;
+    bool PingPong = false;
+
+    // Delay time glide. CurrentDelaySamples is fractional while gliding and delayRamp holds the per sample delay for the current sub-block.
+    float CurrentDelaySamples = 0.0f;
+    float TargetDelaySamples = 0.0f;
+    float DelayGlideStep = 0.0f;
+    int DelayGlideRemaining = 0;
+    std::vector<float> delayRamp;
+
+    // Scratch space for the block path, the delayed samples and the delay line input for every channel.
+    std::vector<float> delayedBlock;
+    std::vector<float> feedbackBlock;
+    int MaxBlockSize = 0;
+
+    // SIMD kernels for the block path, picked for the machine when the stage is created.
+    void (*feedbackKernel)(const float* dry, const float* delayed, const float* feedback, float* destination, int numSamples) = nullptr;
+    void (*mixKernel)(float* data, const float* delayed, const float* mix, const float* master, int numSamples) = nullptr;
+
+    // Per sample parameter ramps used by the processing kernels.
+    struct KernelRamps
+    {
+        const float* Feedback = nullptr;
+        const float* Mix = nullptr;
+        const float* Master = nullptr;
+        const float* Delay = nullptr;     // Only used while the delay time is gliding
+    };
+
+    KernelRamps ramps;
+
+    // Fills delayRamp for the next numSamples samples of a glide, returns false if the delay time is not gliding.
+    bool advanceDelayGlide(int numSamples);
+
+    // Delay line for a single sample on one channel, returns the delayed sample and the value to write back into the line. While gliding the delay
+    // time comes from the delay ramp and is read with interpolation, otherwise the whole sample delay is used.
+    template <bool Glide, typename SampleType>
+    SampleType readDelay(FloatCircularBuffer<SampleType>& delayLine, SampleType xn, int sample, SampleType& bufferinput)
+    {
+        SampleType ynminusD;
+
+        if constexpr (Glide)
+            ynminusD = delayLine.BufferReadFractional(ramps.Delay[sample]);
+        else
+            ynminusD = delayLine.BufferReadSamples(DelaySamples);
+
+        bufferinput = xn + ramps.Feedback[sample] * ynminusD;
+
+        return ynminusD;
+    }
+
+    // Mix the dry and delayed signals and apply the master gain.
+    template <typename SampleType>
+    SampleType mixOutput(SampleType dry, SampleType ynminusD, float mix, float master)
+    {
+        return ((dry * (1.f - mix)) + (mix * ynminusD)) * master;
+    }
+
+    // Processing kernel for a channel layout. The layout, ping pong and glide settings are checked once per sub-block to pick a kernel, so the sample loops inside the kernels have no branches.
+    template <ChannelLayout Layout, bool PingPong, bool Glide, typename SampleType>
+    void processKernel(SampleType* const* channelData, int numChannels, int numSamples);
+
+    // Block path, used when the delay time is not gliding and is at least a sub-block long. None of the reads then depend on this sub-block's
+    // writes, so each delay line is read for the whole sub-block, the feedback and mix run as SIMD kernels, and the delay line input is written
+    // back as a block.
+    void processBlocks(ChannelLayout layout, bool pingPong, float* const* channelData, int numChannels, int numSamples);
+
+    // Picks the kernel for the ping pong and glide settings within a layout.
+    template <ChannelLayout Layout, typename SampleType>
+    void runLayoutKernel(bool pingPong, bool glide, SampleType* const* channelData, int numChannels, int numSamples);
+
+    // Picks the kernel for the layout, shared by both precisions.
+    template <typename SampleType>
+    void runKernel(ChannelLayout layout, bool glide, SampleType* const* channelData, int numChannels, int numSamples);
+
+};
@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+    Modulation.h
+    Created: 20 Oct 2026 10:24:17pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include "Simd.h"
+
+// Modulation sources for the modulated effects, LFOs and envelope followers, so every effect that wobbles a delay time or sweeps a filter
+// shares one set of them rather than calling std::sin per sample in each.
+//
+// Both work on a bank of voices, the LFOs of every chorus voice or the follower of every channel, packed four to a SIMD batch with
+// Simd::QuadOps the way the crossover packs its bands. Their audio rate output is laid out the same way, the voices of each sample next to each
+// other, GetStride() floats per sample with the voices padded up to a multiple of four, so an effect reads every voice's value for a sample from
+// one place. Both also give one value per voice per block for effects that only update their controls once a block.
+
+// Bank of up to MaxVoices LFOs, each its own phase accumulator running at its own rate, free or in time with the host. The phase is kept in
+// double precision between kernel calls, a float phase gains a rounding error on every sample and a slow LFO would drift several percent off
+// its rate, and the kernel works its float phase out from the start of the call on each sample rather than adding up. The shapes are all
+// worked out from the phase without any library calls: the sine is an odd polynomial over a quarter of a cycle, the triangle is the distance
+// to the nearest whole cycle, and the smooth random eases from one random value to the next over each cycle with a smoothstep, so it is
+// continuous and so is its slope. Every voice starts at its phase offset, which is also where it sits on the beat when synced.
+//
+// All outputs are between -1 and 1, the sine and the triangle start at 0 on the way up.
+class LfoBank
+{
+
+public:
+
+    static constexpr int MaxVoices = 16;
+
+    enum class Shape
+    {
+        Sine,
+        Triangle,
+        SmoothRandom
+    };
+
+    // C-tor
+    LfoBank();
+    // D-tor
+    ~LfoBank();
+
+    // Set the sample rate, the number of voices (1 - MaxVoices) and the longest block Process is asked for, this is the only call that
+    // allocates. Resets every voice.
+    void Prepare(double sampleRate, int numVoices, int maxBlockSize);
+
+    // Every voice back to its phase offset, with new random values.
+    void Reset();
+
+    void SetShape(int voice, Shape shape);
+
+    // Run a voice freely at a rate in Hz, up to a quarter of the sample rate.
+    void SetRate(int voice, float hz);
+
+    // Run a voice in time with the tempo, one cycle every beatsPerCycle beats (a quarter note is one beat). 0 goes back to the free rate.
+    void SetSync(int voice, double beatsPerCycle);
+
+    // Phase (0 - 1) the voice starts at, and is at on the beat when synced.
+    void SetPhaseOffset(int voice, float phase);
+
+    // Seed for the smooth random voices, so a render can be repeated. Takes effect on the next Reset.
+    void SetSeed(juce::int64 seed);
+
+    // Tempo for the synced voices.
+    void SetTempo(double bpm);
+
+    // Line the synced voices up with a position in the song, in beats. Call it once a block while the transport is playing, between blocks it
+    // only ever corrects the voices by the rounding of the phase accumulators, far less than a sample's worth of phase.
+    void SyncToPosition(double ppqPosition);
+
+    // Take the tempo and, while the transport is playing, the position from the host. Not every host gives both, so whatever is missing is
+    // left as it was.
+    void SyncToPlayHead(juce::AudioPlayHead* playHead);
+
+    // Run every voice over the next numSamples (up to maxBlockSize) samples. Returns the audio rate output, the value of voice v at sample n is
+    // output[n * GetStride() + v].
+    const float* Process(int numSamples);
+
+    // Block rate output, the value of each voice at the start of the block, then move every voice on by numSamples. Returns one value per voice.
+    const float* ProcessBlock(int numSamples);
+
+    int GetNumVoices() const { return NumVoices; }
+    int GetStride() const { return 4 * NumGroups; }
+
+private:
+
+    struct Voice
+    {
+        Shape VoiceShape = Shape::Sine;
+        float RateHz = 1.0f;
+        double BeatsPerCycle = 0.0;
+        float PhaseOffset = 0.0f;
+    };
+
+    Voice Voices[MaxVoices];
+
+    int NumVoices = 1;
+    int NumGroups = 1;
+    double SampleRate = 48000.0;
+    double Bpm = 120.0;
+    bool AnyRandom = false;
+
+    // Phase (0 - 1) and phase increment per sample of each voice.
+    double Phase[MaxVoices] = {};
+    double Increment[MaxVoices] = {};
+
+    // Lane state, in the order the kernel takes it. Lanes above the voice count stay at 0 and are never read.
+    float StartPhase[MaxVoices] = {};
+    float Step[MaxVoices] = {};
+    float Zero[MaxVoices] = {};
+
+    // Weight of the sine, triangle and smooth random shapes in each lane, 1 for the voice's shape and 0 for the others.
+    float Weights[3][MaxVoices] = {};
+
+    // The value a smooth random lane eases from, the one it eases to, and the one after that which it moves on to when its phase wraps.
+    float Random[3][MaxVoices] = {};
+
+    // Times each lane's phase has wrapped in the last kernel call, so new random values can be drawn for it.
+    float Wraps[MaxVoices] = {};
+
+    float BlockValues[MaxVoices] = {};
+    std::vector<float> Output;
+
+    juce::int64 Seed = 0x5eed;
+    juce::Random Generator;
+
+    // LFO kernel for the widest instruction set the machine supports, picked when the bank is created.
+    void (*lfoKernel)(const float* phase, const float* increment, const float* weights, float* random, float* wraps, int numGroups, int numSamples,
+                      float* output, int stride) = nullptr;
+
+    // Work out a voice's phase increment from its rate or the tempo, and its shape weights.
+    void updateVoice(int voice);
+
+    // Hand the kernel each voice's phase as a float.
+    void loadStartPhases();
+
+    // Move every voice on by numSamples the kernel has just run, taking off the wraps the kernel made, so the two always agree on which cycle
+    // a voice is in.
+    void advancePhases(int numSamples);
+
+    // Move a smooth random lane on to its next value and draw a new one after it.
+    void nextRandom(int voice);
+
+    // Draw new values for the smooth random lanes that wrapped in the last kernel call.
+    void drawWrapped();
+
+    JUCE_DECLARE_NON_COPYABLE(LfoBank)
+};
+
+// Peak envelope followers for up to MaxChannels signals, a one pole smoother on the rectified signal that rises with the attack time and falls
+// with the release time. The channels are interleaved into a scratch block first so each sample of every channel loads as one batch.
+class EnvelopeFollower
+{
+
+public:
+
+    static constexpr int MaxChannels = 16;
+
+    // C-tor
+    EnvelopeFollower();
+    // D-tor
+    ~EnvelopeFollower();
+
+    // Set the sample rate, the number of channels (1 - MaxChannels) and the longest block Process is asked for, this is the only call that
+    // allocates. Resets every channel.
+    void Prepare(double sampleRate, int numChannels, int maxBlockSize);
+
+    // Every envelope back to silence.
+    void Reset();
+
+    // Attack and release times of every channel, in ms, the time to get 63% of the way to a new level.
+    void SetTimes(float attackMs, float releaseMs);
+
+    // Follow numSamples (up to maxBlockSize) samples of each channel's input. Returns the audio rate output, the envelope of channel c at sample
+    // n is output[n * GetStride() + c]. Defined for float and double input in Modulation.cpp.
+    template <typename SampleType>
+    const float* Process(const SampleType* const* input, int numSamples);
+
+    // Block rate output, the envelope of each channel at the end of the last Process. Returns one value per channel.
+    const float* GetLevels() const { return Levels; }
+
+    int GetNumChannels() const { return NumChannels; }
+    int GetStride() const { return 4 * NumGroups; }
+
+private:
+
+    int NumChannels = 1;
+    int NumGroups = 1;
+    double SampleRate = 48000.0;
+    float AttackMs = 10.0f;
+    float ReleaseMs = 100.0f;
+
+    // One pole coefficients and envelope of each lane, in the order the kernel takes them.
+    float Attack[MaxChannels] = {};
+    float Release[MaxChannels] = {};
+    float Levels[MaxChannels] = {};
+
+    std::vector<float> Input;
+    std::vector<float> Output;
+
+    // Follower kernel for the widest instruction set the machine supports, picked when the follower is created.
+    void (*followerKernel)(const float* input, const float* attack, const float* release, float* levels, int numGroups, int numSamples,
+                           float* output, int stride) = nullptr;
+
+    // Work out the one pole coefficients for the times and the sample rate.
+    void updateCoefficients();
+
+    JUCE_DECLARE_NON_COPYABLE(EnvelopeFollower)
+};
+
+extern template const float* EnvelopeFollower::Process<float>(const float* const*, int);
+extern template const float* EnvelopeFollower::Process<double>(const double* const*, int);
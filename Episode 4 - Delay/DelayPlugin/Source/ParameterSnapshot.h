@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshot.h
+    Created: 19 Oct 2026 11:40:51am
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+
+// Parameter layer shared by the plugins. Parameters are bound once by pointer when the processor is constructed, then read once per block with
+// Snapshot(), so the audio thread never does string lookups and only touches each parameter's atomic once per block. Continuous parameters can be
+// smoothed, in which case Advance() fills a per sample ramp towards the latest value which the processing kernels read instead of the parameter.
+class ParameterSnapshot
+{
+
+public:
+
+    // C-tor
+    ParameterSnapshot() {}
+    // D-tor
+    ~ParameterSnapshot() {}
+
+    // Bind a parameter, call from the processor constructor. Returns the index used to read the parameter back.
+    int Bind(juce::RangedAudioParameter* parameter, bool smoothed)
+    {
+        Slot slot;
+        slot.Parameter = parameter;
+        slot.Smoothed = smoothed;
+        slot.Current = slot.Target = ReadParameter(parameter);
+
+        slots.push_back(slot);
+
+        return (int)slots.size() - 1;
+    }
+
+    // Allocate the ramps and jump straight to the current parameter values, call from prepareToPlay. Advance must never be asked for more than maxBlockSize samples.
+    void Prepare(double sampleRate, int maxBlockSize, float rampTimeMs = 20.0f)
+    {
+        MaxBlockSize = juce::jmax(1, maxBlockSize);
+        RampSamples = juce::jmax(1, (int)(sampleRate * rampTimeMs / 1000.0));
+
+        ramps.assign(slots.size() * (size_t)MaxBlockSize, 0.0f);
+
+        for (auto& slot : slots)
+        {
+            slot.Current = slot.Target = ReadParameter(slot.Parameter);
+            slot.StepsRemaining = 0;
+        }
+    }
+
+    int GetMaxBlockSize() const { return MaxBlockSize; }
+
+    // Read every bound parameter, call once at the start of each block.
+    void Snapshot()
+    {
+        for (auto& slot : slots)
+            SetTarget(slot, ReadParameter(slot.Parameter));
+    }
+
+    // Move a parameter towards a new value without reading the parameter itself.
+    void SetTarget(int index, float value)
+    {
+        SetTarget(slots[(size_t)index], value);
+    }
+
+    // Jump a parameter straight to a value, stopping any ramp it is on. Used when whatever the parameter drives has already been set for the value.
+    void Jump(int index, float value)
+    {
+        Slot& slot = slots[(size_t)index];
+
+        slot.Current = slot.Target = value;
+        slot.StepsRemaining = 0;
+    }
+
+    // Fill the ramps for the next numSamples samples (no more than the prepared block size).
+    void Advance(int numSamples)
+    {
+        if (numSamples <= 0)
+            return;
+
+        for (size_t i = 0; i < slots.size(); i++)
+        {
+            Slot& slot = slots[i];
+
+            if (! slot.Smoothed)
+                continue;
+
+            float* ramp = &ramps[i * (size_t)MaxBlockSize];
+
+            // Ramp for as long as the smoothing has left, then hold the target for the rest of the block.
+            int rampLength = juce::jmin(slot.StepsRemaining, numSamples);
+
+            for (int sample = 0; sample < rampLength; sample++)
+                ramp[sample] = slot.Current + slot.Step * (float)(sample + 1);
+
+            for (int sample = rampLength; sample < numSamples; sample++)
+                ramp[sample] = slot.Target;
+
+            slot.StepsRemaining -= rampLength;
+            slot.Current = slot.StepsRemaining > 0 ? ramp[numSamples - 1] : slot.Target;
+        }
+    }
+
+    // Current value of a parameter. For smoothed parameters this is the value at the end of the last Advance.
+    float Get(int index) const { return slots[(size_t)index].Current; }
+
+    // Per sample values of a smoothed parameter for the last Advance.
+    const float* GetRamp(int index) const { return &ramps[(size_t)index * (size_t)MaxBlockSize]; }
+
+    // The bound parameters, for code that needs to match the slots up with parameter IDs.
+    int GetNumParameters() const { return (int)slots.size(); }
+    juce::RangedAudioParameter* GetParameter(int index) const { return slots[(size_t)index].Parameter; }
+    bool IsSmoothed(int index) const { return slots[(size_t)index].Smoothed; }
+
+    // True if any smoothed parameter is still moving towards its target.
+    bool IsSmoothing() const
+    {
+        for (auto& slot : slots)
+            if (slot.StepsRemaining > 0)
+                return true;
+
+        return false;
+    }
+
+private:
+
+    struct Slot
+    {
+        juce::RangedAudioParameter* Parameter = nullptr;
+        bool Smoothed = false;
+
+        float Current = 0.0f;
+        float Target = 0.0f;
+        float Step = 0.0f;
+        int StepsRemaining = 0;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<float> ramps;
+
+    int MaxBlockSize = 0;
+    int RampSamples = 1;
+
+    // Parameter value in its own units, for choice and bool parameters this is the index.
+    static float ReadParameter(juce::RangedAudioParameter* parameter)
+    {
+        return parameter->convertFrom0to1(parameter->getValue());
+    }
+
+    void SetTarget(Slot& slot, float value)
+    {
+        if (value == slot.Target)
+            return;
+
+        slot.Target = value;
+
+        // Unsmoothed parameters jump straight to the new value
+        if (! slot.Smoothed)
+        {
+            slot.Current = value;
+            return;
+        }
+
+        // Smoothed parameters start a new linear ramp from wherever they currently are
+        slot.Step = (value - slot.Current) / (float)RampSamples;
+        slot.StepsRemaining = RampSamples;
+    }
+
+};
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    PerformanceEditor.cpp
+    Created: 19 Oct 2026 8:46:30pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include "PerformanceEditor.h"
+
+PerformanceEditor::PerformanceEditor(juce::AudioProcessor& processor, PerformanceMonitor& monitor, std::unique_ptr<juce::Component> extraControls,
+                                     SpectrumAnalyser* analyser, PresetBankOwner* presetOwner)
+    : AudioProcessorEditor(processor), parameterEditor(processor), performanceMonitor(monitor), controls(std::move(extraControls))
+{
+    addAndMakeVisible(parameterEditor);
+
+    // The analyser only runs while the view exists, so it stops when the editor closes.
+    if (analyser != nullptr)
+    {
+        spectrum = std::make_unique<SpectrumView>(*analyser);
+        addAndMakeVisible(*spectrum);
+    }
+
+    if (presetOwner != nullptr)
+    {
+        presets = std::make_unique<PresetControls>(*presetOwner);
+        addAndMakeVisible(*presets);
+    }
+
+    if (controls != nullptr)
+        addAndMakeVisible(*controls);
+
+    statsLabel.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain));
+    statsLabel.setJustificationType(juce::Justification::topLeft);
+    addAndMakeVisible(statsLabel);
+
+    resetButton.onClick = [this] { performanceMonitor.ResetStats(); };
+    addAndMakeVisible(resetButton);
+
+    int controlsHeight = (controls != nullptr ? controls->getHeight() : 0) + (presets != nullptr ? presets->getHeight() : 0);
+    int viewHeight = spectrum != nullptr ? spectrumHeight : 0;
+    setSize(juce::jmax(parameterEditor.getWidth(), 360), parameterEditor.getHeight() + viewHeight + controlsHeight + statsHeight);
+
+    // The monitor collects ten times a second, a few refreshes a second is plenty to read.
+    timerCallback();
+    startTimerHz(4);
+}
+
+PerformanceEditor::~PerformanceEditor()
+{
+    stopTimer();
+}
+
+void PerformanceEditor::resized()
+{
+    auto bounds = getLocalBounds();
+    auto statsArea = bounds.removeFromBottom(statsHeight);
+
+    if (controls != nullptr)
+        controls->setBounds(bounds.removeFromBottom(controls->getHeight()));
+
+    if (presets != nullptr)
+        presets->setBounds(bounds.removeFromBottom(presets->getHeight()));
+
+    if (spectrum != nullptr)
+        spectrum->setBounds(bounds.removeFromBottom(spectrumHeight));
+
+    parameterEditor.setBounds(bounds);
+    resetButton.setBounds(statsArea.removeFromRight(resetButtonWidth).reduced(4));
+    statsLabel.setBounds(statsArea.reduced(4, 0));
+}
+
+void PerformanceEditor::timerCallback()
+{
+    const auto& summary = performanceMonitor.GetSummary();
+
+    juce::String text = performanceMonitor.GetInstanceName()
+                      + "   load " + juce::String(summary.LoadPercent, 1) + "%   peak " + juce::String(summary.PeakLoadPercent, 1) + "%\n"
+                      + "max block " + juce::String(summary.MaxBlockUs, 1) + " us   overruns " + juce::String(summary.NumOverruns)
+                      + "   dropped " + juce::String(summary.NumDropped) + "\n";
+
+    // Whatever is not in a stage is parameter handling and the rest of processBlock.
+    double otherPercent = summary.LoadPercent > 0.0 ? 100.0 : 0.0;
+
+    for (int stage = 0; stage < performanceMonitor.GetNumStages(); stage++)
+    {
+        text += performanceMonitor.GetStageName(stage) + " " + juce::String(summary.StagePercent[stage], 0) + "%   ";
+        otherPercent -= summary.StagePercent[stage];
+    }
+
+    text += "other " + juce::String(juce::jmax(0.0, otherPercent), 0) + "%";
+
+    statsLabel.setText(text, juce::dontSendNotification);
+}
@@ -0,0 +1,356 @@
+/*
+  ==============================================================================
+
+    PerformanceMonitor.h
+    Created: 19 Oct 2026 8:21:05pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <JuceHeader.h>
+
+#if JUCE_INTEL && JUCE_MSVC
+ #include <intrin.h>
+#elif JUCE_INTEL
+ #include <x86intrin.h>
+#endif
+
+// Per instance profiling shared by the plugins. The audio thread times each block, and the stages inside it, with the CPU cycle counter and pushes
+// one record per block into a wait-free single producer/single consumer ring, so timing never allocates, locks or waits. A timer on the message
+// thread drains the ring, works out the load against each block's real-time budget, and keeps the summary the editor shows. Set the
+// JEPLUGINS_PERFORMANCE_LOG environment variable to a folder to also log the summary once a second, with one file per instance.
+class PerformanceMonitor : private juce::Timer
+{
+
+public:
+
+    // Maximum number of stages a processor can time inside its blocks.
+    static constexpr int MaxStages = 4;
+
+    // Number of blocks that can be waiting between two collections, blocks beyond this are dropped and counted.
+    static constexpr int Capacity = 1024;
+
+    // What the editor and the log show, the load and stage figures cover the last collection interval.
+    struct Summary
+    {
+        double LoadPercent = 0.0;                 // Average time spent processing as a share of the audio's duration
+        double PeakLoadPercent = 0.0;             // Worst single block as a share of its own duration
+        double MaxBlockUs = 0.0;                  // Longest block since the last reset
+        double StagePercent[MaxStages] = {};      // Share of the processing time spent in each stage
+        juce::int64 NumBlocks = 0;
+        juce::int64 NumOverruns = 0;              // Blocks that took longer than their own duration
+        juce::int64 NumDropped = 0;               // Blocks lost because the ring was full
+    };
+
+    // C-tor, every monitor gets a number so instances can be told apart in the editor and the log.
+    PerformanceMonitor()
+    {
+        static std::atomic<int> instanceCount { 0 };
+        InstanceNumber = ++instanceCount;
+
+        calibrationCycles = ReadCycleCounter();
+        calibrationTicks = juce::Time::getHighResolutionTicks();
+
+        startTimer(CollectIntervalMs);
+    }
+
+    // D-tor
+    ~PerformanceMonitor() override
+    {
+        stopTimer();
+    }
+
+    // Set the name shown with the instance number, call from the processor constructor.
+    void SetName(const juce::String& name)
+    {
+        InstanceName = name + " #" + juce::String(InstanceNumber);
+    }
+
+    // Name a stage, call from the processor constructor.
+    void SetStageName(int stage, const juce::String& name)
+    {
+        jassert(stage >= 0 && stage < MaxStages);
+        StageNames[stage] = name;
+        NumStages = juce::jmax(NumStages, stage + 1);
+    }
+
+    // Set the sample rate the block budgets are worked out from, call from prepareToPlay.
+    void Prepare(double sampleRate)
+    {
+        SampleRate.store(sampleRate, std::memory_order_relaxed);
+    }
+
+    // --- Audio thread
+
+    // Read the CPU cycle counter, on processors without one this falls back to the high resolution timer.
+    static juce::uint64 ReadCycleCounter()
+    {
+       #if JUCE_INTEL
+        return (juce::uint64)__rdtsc();
+       #else
+        return (juce::uint64)juce::Time::getHighResolutionTicks();
+       #endif
+    }
+
+    // Start timing a block.
+    void BeginBlock()
+    {
+        current = BlockRecord();
+        blockStart = ReadCycleCounter();
+    }
+
+    // Time a stage, a stage can be started and ended any number of times in a block and its times are added up.
+    void BeginStage(int stage)
+    {
+        stageStart[stage] = ReadCycleCounter();
+    }
+
+    void EndStage(int stage)
+    {
+        current.StageCycles[stage] += (juce::uint32)(ReadCycleCounter() - stageStart[stage]);
+    }
+
+    // Finish timing a block of numSamples and push it into the ring.
+    void EndBlock(int numSamples)
+    {
+        current.Cycles = ReadCycleCounter() - blockStart;
+        current.NumSamples = numSamples;
+
+        size_t writePosition = writeIndex.load(std::memory_order_relaxed);
+
+        if (writePosition - readIndex.load(std::memory_order_acquire) >= (size_t)Capacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        ring[writePosition % Capacity] = current;
+        writeIndex.store(writePosition + 1, std::memory_order_release);
+    }
+
+    // Times a stage for as long as it is in scope.
+    struct ScopedStage
+    {
+        ScopedStage(PerformanceMonitor& m, int s) : monitor(m), stage(s) { monitor.BeginStage(stage); }
+        ~ScopedStage() { monitor.EndStage(stage); }
+
+        PerformanceMonitor& monitor;
+        int stage;
+    };
+
+    // --- Message thread
+
+    const juce::String& GetInstanceName() const { return InstanceName; }
+    const juce::String& GetStageName(int stage) const { return StageNames[stage]; }
+    int GetNumStages() const { return NumStages; }
+
+    const Summary& GetSummary() const { return summary; }
+
+    // Clear the maximum block time and the overrun and drop counts.
+    void ResetStats()
+    {
+        summary.MaxBlockUs = 0.0;
+        summary.NumOverruns = 0;
+        summary.NumDropped = 0;
+        droppedAtReset = dropped.load(std::memory_order_relaxed);
+    }
+
+    // Drain the ring and update the summary. Called by the timer, headless hosts without a message loop can call it themselves.
+    void Collect()
+    {
+        updateCalibration();
+
+        Window window;
+        BlockRecord record;
+
+        while (pop(record))
+        {
+            window.Add(record, SampleRate.load(std::memory_order_relaxed), cyclesPerUs);
+            logWindow.Add(record, SampleRate.load(std::memory_order_relaxed), cyclesPerUs);
+        }
+
+        summary.LoadPercent = window.GetLoadPercent();
+        summary.PeakLoadPercent = window.PeakLoadPercent;
+        summary.MaxBlockUs = juce::jmax(summary.MaxBlockUs, window.MaxBlockUs);
+        summary.NumBlocks += window.NumBlocks;
+        summary.NumOverruns += window.NumOverruns;
+        summary.NumDropped = dropped.load(std::memory_order_relaxed) - droppedAtReset;
+
+        for (int stage = 0; stage < MaxStages; stage++)
+            summary.StagePercent[stage] = window.GetStagePercent(stage);
+    }
+
+private:
+
+    static constexpr int CollectIntervalMs = 100;
+    static constexpr int LogIntervalMs = 1000;
+
+    // One block's timing as it goes through the ring.
+    struct BlockRecord
+    {
+        juce::uint64 Cycles = 0;
+        juce::uint32 StageCycles[MaxStages] = {};
+        int NumSamples = 0;
+    };
+
+    // Totals over a run of blocks.
+    struct Window
+    {
+        double Cycles = 0.0;
+        double BudgetCycles = 0.0;
+        double StageCycles[MaxStages] = {};
+        double PeakLoadPercent = 0.0;
+        double MaxBlockUs = 0.0;
+        juce::int64 NumBlocks = 0;
+        juce::int64 NumOverruns = 0;
+
+        void Add(const BlockRecord& record, double sampleRate, double cyclesPerUs)
+        {
+            double budget = (double)record.NumSamples / sampleRate * 1.0e6 * cyclesPerUs;
+
+            Cycles += (double)record.Cycles;
+            BudgetCycles += budget;
+            MaxBlockUs = juce::jmax(MaxBlockUs, (double)record.Cycles / cyclesPerUs);
+            ++NumBlocks;
+
+            for (int stage = 0; stage < MaxStages; stage++)
+                StageCycles[stage] += (double)record.StageCycles[stage];
+
+            if (budget > 0.0)
+            {
+                PeakLoadPercent = juce::jmax(PeakLoadPercent, (double)record.Cycles / budget * 100.0);
+
+                if ((double)record.Cycles > budget)
+                    ++NumOverruns;
+            }
+        }
+
+        double GetLoadPercent() const { return BudgetCycles > 0.0 ? Cycles / BudgetCycles * 100.0 : 0.0; }
+        double GetStagePercent(int stage) const { return Cycles > 0.0 ? StageCycles[stage] / Cycles * 100.0 : 0.0; }
+    };
+
+    int InstanceNumber = 0;
+    juce::String InstanceName;
+    juce::String StageNames[MaxStages];
+    int NumStages = 0;
+
+    std::atomic<double> SampleRate { 48000.0 };
+
+    // Audio thread state for the block being timed.
+    BlockRecord current;
+    juce::uint64 blockStart = 0;
+    juce::uint64 stageStart[MaxStages] = {};
+
+    // The ring, written by the audio thread and read by the message thread.
+    BlockRecord ring[Capacity];
+    std::atomic<size_t> writeIndex { 0 };
+    std::atomic<size_t> readIndex { 0 };
+    std::atomic<juce::int64> dropped { 0 };
+    juce::int64 droppedAtReset = 0;
+
+    // Cycle counter rate, measured against the high resolution timer from when the monitor was created. The cycle counter does not have a
+    // known rate, so it is calibrated on the message thread rather than the audio thread.
+    juce::uint64 calibrationCycles = 0;
+    juce::int64 calibrationTicks = 0;
+    double cyclesPerUs = 1000.0;
+
+    Summary summary;
+
+    // Log file, only opened if the environment variable is set.
+    std::unique_ptr<juce::FileOutputStream> logStream;
+    Window logWindow;
+    int msSinceLog = 0;
+    bool logOpened = false;
+
+    bool pop(BlockRecord& record)
+    {
+        size_t readPosition = readIndex.load(std::memory_order_relaxed);
+
+        if (readPosition == writeIndex.load(std::memory_order_acquire))
+            return false;
+
+        record = ring[readPosition % Capacity];
+        readIndex.store(readPosition + 1, std::memory_order_release);
+        return true;
+    }
+
+    void updateCalibration()
+    {
+        juce::int64 elapsedTicks = juce::Time::getHighResolutionTicks() - calibrationTicks;
+        double elapsedUs = (double)elapsedTicks * 1.0e6 / (double)juce::Time::getHighResolutionTicksPerSecond();
+
+        if (elapsedUs > 1.0e4)
+            cyclesPerUs = (double)(ReadCycleCounter() - calibrationCycles) / elapsedUs;
+    }
+
+    void openLog()
+    {
+        logOpened = true;
+
+        juce::String folder = juce::SystemStats::getEnvironmentVariable("JEPLUGINS_PERFORMANCE_LOG", {});
+
+        if (folder.isEmpty())
+            return;
+
+        juce::File logFile = juce::File(folder).getChildFile(InstanceName.replaceCharacters(" #", "__") + "_"
+                                                             + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S") + ".csv");
+
+        if (! juce::File(folder).createDirectory())
+            return;
+
+        logStream = logFile.createOutputStream();
+
+        if (logStream == nullptr || ! logStream->openedOk())
+        {
+            logStream.reset();
+            return;
+        }
+
+        juce::String header = "time,blocks,load %,peak load %,max block us,overruns,dropped";
+
+        for (int stage = 0; stage < NumStages; stage++)
+            header += "," + StageNames[stage] + " %";
+
+        logStream->writeText(header + "\n", false, false, nullptr);
+    }
+
+    void writeLog()
+    {
+        if (! logOpened)
+            openLog();
+
+        if (logStream != nullptr && logWindow.NumBlocks > 0)
+        {
+            juce::String line = juce::Time::getCurrentTime().toISO8601(true) + "," + juce::String(logWindow.NumBlocks) + ","
+                              + juce::String(logWindow.GetLoadPercent(), 2) + "," + juce::String(logWindow.PeakLoadPercent, 2) + ","
+                              + juce::String(logWindow.MaxBlockUs, 2) + "," + juce::String(logWindow.NumOverruns) + "," + juce::String(summary.NumDropped);
+
+            for (int stage = 0; stage < NumStages; stage++)
+                line += "," + juce::String(logWindow.GetStagePercent(stage), 2);
+
+            logStream->writeText(line + "\n", false, false, nullptr);
+            logStream->flush();
+        }
+
+        logWindow = Window();
+    }
+
+    void timerCallback() override
+    {
+        Collect();
+
+        msSinceLog += CollectIntervalMs;
+
+        if (msSinceLog >= LogIntervalMs)
+        {
+            msSinceLog = 0;
+            writeLog();
+        }
+    }
+
+};
@@ -8,6 +8,11 @@
 
 #include "PluginProcessor.h"
 
+// The plugin wrapper defines the plugin name from the .jucer, the headless tools build this file without it.
+#ifndef JucePlugin_Name
+ #define JucePlugin_Name "DelayPlugin"
+#endif
+
 
 //==============================================================================
 DelayPluginAudioProcessor::DelayPluginAudioProcessor()
@@ -52,6 +57,30 @@ DelayPluginAudioProcessor::DelayPluginAudioProcessor()
 
     addParameter(SyncSetting = new juce::AudioParameterChoice("SYNCSETTING", "SyncSetting", StringArray{ "1/1", "1/1D", "1/1T", "1/2", "1/2D", "1/2T", "1/4", "1/4D", "1/4T", "1/8", "1/8D", "1/8T", "1/16", "1/16D", "1/16T", "1/32"}, 0));
 
+    // Bind our parameters so they can be read once per block, the gains are smoothed to avoid zipper noise.
+    MasterParameter = parameters.Bind(Master, true);
+    MixParameter = parameters.Bind(Mix, true);
+    FeedbackParameter = parameters.Bind(Feedback, true);
+    DelayTimeParameter = parameters.Bind(DelayTimeMs, false);
+    PingPongParameter = parameters.Bind(PingPongEnabled, false);
+    SyncEnabledParameter = parameters.Bind(SyncEnabled, false);
+    SyncSettingParameter = parameters.Bind(SyncSetting, false);
+    parameters.Prepare(48000, 512);
+
+    // Listen for changes to every bound parameter so they can be applied at the right sample.
+    events.Listen(Master, MasterParameter);
+    events.Listen(Mix, MixParameter);
+    events.Listen(Feedback, FeedbackParameter);
+    events.Listen(DelayTimeMs, DelayTimeParameter);
+    events.Listen(PingPongEnabled, PingPongParameter);
+    events.Listen(SyncEnabled, SyncEnabledParameter);
+    events.Listen(SyncSetting, SyncSettingParameter);
+
+    performance.SetName(getName());
+    performance.SetStageName(DelayTimingStage, "Delay");
+
+    // Start with an empty preset bank so the audio thread always has one.
+    presetBank = std::make_unique<PresetBank>();
 }
 
 
@@ -94,31 +123,43 @@ bool DelayPluginAudioProcessor::isMidiEffect() const
 
 double DelayPluginAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The repeats carry on until the feedback has decayed them below the silence threshold. Before the first block use the delay time parameter.
+    float finalDelayTime = FinalDelayTime.load();
+    float delayTimeMs = finalDelayTime > 0.0f ? finalDelayTime : DelayTimeMs->get();
+
+    return TailTracker::FeedbackDelayTailTime(delayTimeMs / 1000.0, Feedback->get());
 }
 
 int DelayPluginAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    const ScopedLock lock(presetLock);
+
+    return jmax(1, (int)presets.size());   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                                            // so this should be at least 1, even if you're not really implementing programs.
 }
 
 int DelayPluginAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    const ScopedLock lock(presetLock);
+    return jmax(0, currentPreset);
 }
 
 void DelayPluginAudioProcessor::setCurrentProgram (int index)
 {
+    selectPreset(index);
 }
 
 const juce::String DelayPluginAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return getPresetName(index);
 }
 
 void DelayPluginAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    const ScopedLock lock(presetLock);
+
+    if (isPositiveAndBelow(index, (int)presets.size()))
+        presets[(size_t)index].Name = newName;
 }
 
 //==============================================================================
@@ -127,9 +168,25 @@ void DelayPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
 
-    BufferL.Init(sampleRate, 2000.f);
-    BufferR.Init(sampleRate, 2000.f);
+    // Drop any old parameter changes and size the parameter ramps for the largest block the host has told us about.
+    events.Reset();
+    parameters.Prepare(sampleRate, samplesPerBlock);
+
+    // Create a delay line for every channel, with a delay glide as long as the parameter ramps.
+    NumBuffers = jmax(1, jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()));
+    delayStage.Prepare(sampleRate, NumBuffers, parameters.GetMaxBlockSize(), isUsingDoublePrecision());
+    channelPointers.resize((size_t)NumBuffers);
+    channelPointersDouble.resize((size_t)NumBuffers);
+
+    // Make sure the sync delay time is recalculated for the new sample rate without gliding.
+    SyncBpm = 0.0;
+    SyncDivision = -1;
 
+    // Start awake, the tail is updated every block as the delay time and feedback change.
+    tailTracker.Prepare(sampleRate);
+
+    performance.Prepare(sampleRate);
+    analyser.Prepare(sampleRate);
 }
 
 void DelayPluginAudioProcessor::releaseResources()
@@ -165,8 +222,21 @@ bool DelayPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 #endif
 
 void DelayPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples(buffer);
+}
+
+void DelayPluginAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples(buffer);
+}
+
+template <typename SampleType>
+void DelayPluginAudioProcessor::processSamples (AudioBuffer<SampleType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
+    performance.BeginBlock();
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -179,128 +249,246 @@ void DelayPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // In case we have more outputs than inputs, this code clears any output
-     // channels that didn't contain input data, (because these aren't
-     // guaranteed to be empty - they may contain garbage).
-     // This is here to avoid people getting screaming feedback
-     // when they first compile a plugin, but obviously you don't need to keep
-     // this code if your algorithm always overwrites all the output channels.
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear(i, 0, buffer.getNumSamples());
+    int numSamples = buffer.getNumSamples();
+    BlockSamples = numSamples;
+
+    // Get the host tempo for this block before working out the delay time.
+    updateTempo();
+
+    // Drain the parameter changes for this block, they are applied as the block is processed. If any were lost take one snapshot of all the parameters instead.
+    if (! events.BeginBlock(numSamples))
+        parameters.Snapshot();
 
-    // Get write pointers to audio buffers.
-    float* channelData_L = buffer.getWritePointer(0);
-    float* channelData_R = buffer.getWritePointer(1);
+    updateBlockParameters();
 
-    FinalDelayTime = *SyncEnabled ? CalcDelayTime(Playhead.bpm, *SyncSetting) : *DelayTimeMs;
+    // Then switch to a newly selected preset.
+    applyPresetSelection();
 
+    // Never process more channels than we have delay lines for.
+    int numInputs = jmin(totalNumInputChannels, NumBuffers);
+    int numOutputs = jmin(totalNumOutputChannels, NumBuffers);
 
-    // As we are manually grabbing the channels we want, and we are not using any more than two at any one time we only need to handle the sample numbers. This loop will iterate through all the samples based on the block size of the buffer.
-    for (int sample = 0; sample < buffer.getNumSamples(); sample++)
+    // Pick the kernel for this channel layout once, rather than checking the layout for every sample. Only channels that received input are
+    // processed (mono/stereo duplicates its input into the second output), any extra outputs were cleared above.
+    ChannelLayout layout = GetChannelLayout(numInputs, numOutputs);
+    int numChannels = GetNumProcessedChannels(layout, numInputs, numOutputs);
+    int nextEvent = 0;
+
+    // Once the input has been silent for longer than the repeats take to decay the output is silent too, so there is no need to run the delay lines.
+    tailTracker.SetTailSeconds(TailTracker::FeedbackDelayTailTime(FinalDelayTime / 1000.0, parameters.Get(FeedbackParameter)));
+
+    if (tailTracker.ProcessInput(buffer, numInputs, numSamples))
     {
+        processIdleBlock(buffer, numChannels, numSamples);
+        analyser.Push(buffer, numChannels, numSamples);
+        performance.EndBlock(numSamples);
+        return;
+    }
 
-        // This will be our DSP if our plugin is mono, it will use one set of our processing objects and the samples for the second (right) channel will be left unused. 
-        //There are better ways of doing this (dynamic memory allocation) but this is simpler to understand.
-        if (totalNumInputChannels == 1 && totalNumOutputChannels == 1)
+    // Process the block in sub-blocks no longer than the parameter ramps, split at every parameter change so automation lands on the right sample.
+    for (int offset = 0; offset < numSamples;)
+    {
+        // Apply every parameter change that lands on this sample.
+        if (nextEvent < events.GetNumEvents() && events.GetEvent(nextEvent).SampleOffset <= offset)
         {
+            while (nextEvent < events.GetNumEvents() && events.GetEvent(nextEvent).SampleOffset <= offset)
+            {
+                const auto& event = events.GetEvent(nextEvent++);
+                parameters.SetTarget(event.Slot, event.Value);
+            }
 
-            // Get current input sample from buffer.
-            float xn = channelData_L[sample];
+            updateBlockParameters();
+        }
 
-            float dry = xn;
-            
-            float ynminusD = BufferL.BufferRead(FinalDelayTime, false);
+        // Stop this sub-block at the next parameter change.
+        int subBlockEnd = nextEvent < events.GetNumEvents() ? events.GetEvent(nextEvent).SampleOffset : numSamples;
+        int subBlockSize = jmin(subBlockEnd - offset, parameters.GetMaxBlockSize());
 
-            float bufferinput = xn + *Feedback * ynminusD;
+        // Fill the parameter ramps for this sub-block.
+        parameters.Advance(subBlockSize);
 
-            BufferL.BufferWrite(bufferinput);
+        delayStage.Update(PingPong, parameters.GetRamp(FeedbackParameter), parameters.GetRamp(MixParameter), parameters.GetRamp(MasterParameter));
 
-            float output = (dry * (1.f - *Mix)) + (*Mix * ynminusD);
+        auto& pointers = getChannelPointers<SampleType>();
 
-            channelData_L[sample] = output * *Master;
+        for (int channel = 0; channel < numChannels; channel++)
+            pointers[(size_t)channel] = buffer.getWritePointer(channel, offset);
 
-        }
+        performance.BeginStage(DelayTimingStage);
+        delayStage.Process(layout, pointers.data(), numChannels, subBlockSize);
+        performance.EndStage(DelayTimingStage);
 
-        // This will be our DSP if our plugin is mono/stereo. The input sample of the single input channel is duplicated, the processing of each channel is then independant.
-        if (totalNumInputChannels == 1 && totalNumOutputChannels == 2)
-        {
-            // Get current input samples from buffer and duplicate for second channel.
-            float xn_L = channelData_L[sample];
-            float xn_R = xn_L;
+        offset += subBlockSize;
+    }
 
-            float dry_L = xn_L;
-            float dry_R = xn_R;
+    // Check whether the repeats have died away. If they have clear the delay lines, the write position stops while idle so anything left in them
+    // (including audio from before the silence) could otherwise be read back when the input returns with a longer delay time.
+    if (tailTracker.ProcessOutput(buffer, numChannels, numSamples))
+        delayStage.Clear();
 
-            float ynminusD_L = BufferL.BufferRead(FinalDelayTime, false);
-            float ynminusD_R = BufferR.BufferRead(FinalDelayTime, false);
+    analyser.Push(buffer, numChannels, numSamples);
+    performance.EndBlock(numSamples);
+}
 
-            float bufferinput_L = xn_L + *Feedback * ynminusD_L;
-            float bufferinput_R = xn_R + *Feedback * ynminusD_R;
+template <typename SampleType>
+void DelayPluginAudioProcessor::processIdleBlock(AudioBuffer<SampleType>& buffer, int numChannels, int numSamples)
+{
+    // Apply this block's parameter changes straight away, there is no audio for them to land on. Smoothed parameters carry on ramping when the delay starts again.
+    for (int i = 0; i < events.GetNumEvents(); i++)
+        parameters.SetTarget(events.GetEvent(i).Slot, events.GetEvent(i).Value);
 
-            if (PingPongEnabled->get() != true)
-            {
+    updateBlockParameters();
 
-                BufferL.BufferWrite(bufferinput_L);
-                BufferR.BufferWrite(bufferinput_R);
+    // The delay lines are empty and the input is silent, so the output is silence.
+    for (int channel = 0; channel < numChannels; channel++)
+        buffer.clear(channel, 0, numSamples);
+}
 
-            }
-            else if (PingPongEnabled->get() == true)
-            {
+void DelayPluginAudioProcessor::updateTempo()
+{
+    // Ask the host for the tempo once per block. Not every host gives us a playhead or a tempo, in which case we keep the last tempo we were given.
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition())
+            if (auto bpm = position->getBpm())
+                if (*bpm > 0.0)
+                    HostBpm = *bpm;
+}
 
-                BufferL.BufferWrite(bufferinput_R);
-                BufferR.BufferWrite(bufferinput_L);
+bool DelayPluginAudioProcessor::scheduleParameterChange (int parameterIndex, float normalisedValue, int sampleOffset)
+{
+    return events.PushParameterChange(parameterIndex, normalisedValue, sampleOffset);
+}
 
-            }
+void DelayPluginAudioProcessor::updateBlockParameters()
+{
+    bool tempoChanged = false;
+
+    if (parameters.Get(SyncEnabledParameter) > 0.5f)
+    {
+        int division = (int)parameters.Get(SyncSettingParameter);
 
-            float output_L = (dry_L * (1.f - *Mix)) + (*Mix * ynminusD_L);
-            float output_R = (dry_R * (1.f - *Mix)) + (*Mix * ynminusD_R);
+        // Only recalculate the sync delay time when the tempo or sync setting has changed. A tempo change on its own glides to the new delay time,
+        // a new sync setting jumps straight to it.
+        if (HostBpm != SyncBpm || division != SyncDivision)
+        {
+            tempoChanged = division == SyncDivision && SyncBpm > 0.0;
 
-            channelData_L[sample] = output_L * *Master;
-            channelData_R[sample] = output_R * *Master;
-        
+            SyncBpm = HostBpm;
+            SyncDivision = division;
+            SyncDelayTimeMs = jmin(CalcDelayTime(HostBpm, division), DelayStage::MaxDelayTimeMs);
         }
 
-        // This will be our DSP if our plugin is stereo. This will take the input from both channels and process them independantly.
-        if (totalNumInputChannels == 2 && totalNumOutputChannels == 2)
-        {
+        FinalDelayTime = SyncDelayTimeMs;
+    }
+    else
+    {
+        // Forget the sync delay time so turning sync back on jumps to the current tempo.
+        SyncDivision = -1;
+
+        FinalDelayTime = parameters.Get(DelayTimeParameter);
+    }
 
-            // Get current input samples from buffers.
-            float xn_L = channelData_L[sample];
-            float xn_R = channelData_R[sample];
+    // A tempo change or preset morph glides to the new delay time across this block, anything else jumps straight to it.
+    delayStage.SetDelayTime((FinalDelayTime / 1000) * (float)getSampleRate(), tempoChanged || PresetGlide ? jmax(1, BlockSamples) : 0);
 
-            float dry_L = xn_L;
-            float dry_R = xn_R;
+    PingPong = parameters.Get(PingPongParameter) > 0.5f;
+}
 
-            float ynminusD_L = BufferL.BufferRead(FinalDelayTime, false);
-            float ynminusD_R = BufferR.BufferRead(FinalDelayTime, false);
+//==============================================================================
+int DelayPluginAudioProcessor::storePreset(const String& name, int index)
+{
+    const ScopedLock lock(presetLock);
 
-            float bufferinput_L = xn_L + *Feedback * ynminusD_L;
-            float bufferinput_R = xn_R + *Feedback * ynminusD_R;
+    if (! isPositiveAndBelow(index, (int)presets.size()))
+    {
+        if ((int)presets.size() >= PresetState::MaxPresets)
+            return -1;
 
-            if (PingPongEnabled->get() != true)
-            {
+        index = (int)presets.size();
+        presets.emplace_back();
+    }
 
-                BufferL.BufferWrite(bufferinput_L);
-                BufferR.BufferWrite(bufferinput_R);
+    presets[(size_t)index] = PresetState::Capture(*this, name);
+    currentPreset = index;
 
-            }
-            else if (PingPongEnabled->get() == true)
-            {
+    postPresets();
 
-                BufferL.BufferWrite(bufferinput_R);
-                BufferR.BufferWrite(bufferinput_L);
+    return index;
+}
 
-            }
+void DelayPluginAudioProcessor::selectPreset(int index)
+{
+    const ScopedLock lock(presetLock);
 
-            float output_L = (dry_L * (1.f - *Mix)) + (*Mix * ynminusD_L);
-            float output_R = (dry_R * (1.f - *Mix)) + (*Mix * ynminusD_R);
+    if (! isPositiveAndBelow(index, (int)presets.size()))
+        return;
 
-            channelData_L[sample] = output_L * *Master;
-            channelData_R[sample] = output_R * *Master;
+    currentPreset = index;
 
-        }
+    // The audio thread switches to the resolved preset at the start of its next block. The parameters are then set to the same values, so the
+    // changes they send have nothing left to do.
+    presetSelection.Select(index);
+    presets[(size_t)index].Apply(*this, false);
+}
 
+void DelayPluginAudioProcessor::morphPresets(int a, int b, float amount)
+{
+    const ScopedLock lock(presetLock);
+
+    if (isPositiveAndBelow(a, (int)presets.size()) && isPositiveAndBelow(b, (int)presets.size()))
+        presetSelection.Morph(a, b, amount);
+}
+
+int DelayPluginAudioProcessor::getNumPresets()
+{
+    const ScopedLock lock(presetLock);
+    return (int)presets.size();
+}
+
+int DelayPluginAudioProcessor::getSelectedPreset()
+{
+    const ScopedLock lock(presetLock);
+    return currentPreset;
+}
+
+String DelayPluginAudioProcessor::getPresetName(int index)
+{
+    const ScopedLock lock(presetLock);
+    return isPositiveAndBelow(index, (int)presets.size()) ? presets[(size_t)index].Name : String();
+}
+
+void DelayPluginAudioProcessor::postPresets()
+{
+    auto bank = std::make_unique<PresetBank>();
+
+    for (auto& preset : presets)
+        bank->Add(preset, parameters);
+
+    presetHandover.Post(std::move(bank));
+}
+
+void DelayPluginAudioProcessor::applyPresetSelection()
+{
+    // Pick up a newly resolved bank before looking at the selection, a preset that has just been stored is only in the new one.
+    presetHandover.Swap(presetBank);
+
+    PresetSelection::Selection selection;
+
+    if (! presetSelection.Poll(selection) || ! PresetSelection::ApplyValues(*presetBank, selection, parameters, -1))
+        return;
+
+    // The delay time is not smoothed, so ApplyValues jumps it to the nearer preset. A morph mixes it instead and glides there.
+    if (selection.IsMorph())
+    {
+        float a = presetBank->Values[(size_t)selection.A][(size_t)DelayTimeParameter];
+        float b = presetBank->Values[(size_t)selection.B][(size_t)DelayTimeParameter];
+
+        parameters.Jump(DelayTimeParameter, a + (b - a) * selection.Amount);
     }
+
+    PresetGlide = selection.IsMorph();
+    updateBlockParameters();
+    PresetGlide = false;
 }
 
 //==============================================================================
@@ -309,28 +497,58 @@ bool DelayPluginAudioProcessor::hasEditor() const
     return true; // (change this to false if you choose to not supply an editor)
 }
 
+// The generic editor with the performance figures for this instance underneath it.
 juce::AudioProcessorEditor* DelayPluginAudioProcessor::createEditor()
 {
-    return new GenericAudioProcessorEditor (*this);
+    return new PerformanceEditor (*this, performance, nullptr, &analyser, this);
 }
 
 //==============================================================================
 void DelayPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    // The parameters with the preset bank, in the compact binary format described in PresetState.h.
+    PresetState current = PresetState::Capture(*this);
+
+    const ScopedLock lock(presetLock);
+    PresetState::WriteChunk(destData, current, currentPreset, presets);
 }
 
 void DelayPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    PresetState current;
+    std::vector<PresetState> loadedPresets;
+    int loadedPreset = -1;
+
+    if (! PresetState::ReadChunk(data, sizeInBytes, current, loadedPreset, loadedPresets))
+        return;
+
+    current.Apply(*this, true);
+
+    const ScopedLock lock(presetLock);
+
+    presets = std::move(loadedPresets);
+    currentPreset = loadedPreset;
+    postPresets();
 }
 
 //==============================================================================
 // This creates new instances of the plugin..
+#if JEPLUGINS_HEADLESS
+// The headless tools link every plugin into one program, so each plugin gets its own factory instead of createPluginFilter.
+juce::AudioProcessor* createDelayPluginProcessor()
+#else
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+#endif
 {
     return new DelayPluginAudioProcessor();
 }
+
+#if JEPLUGINS_HEADLESS
+// Sample accurate parameter changes for the headless tools, which only see an AudioProcessor. Returns false for any other plugin's processor.
+bool scheduleDelayParameterChange(juce::AudioProcessor& processor, int parameterIndex, float normalisedValue, int sampleOffset)
+{
+    auto* delayProcessor = dynamic_cast<DelayPluginAudioProcessor*>(&processor);
+
+    return delayProcessor != nullptr && delayProcessor->scheduleParameterChange(parameterIndex, normalisedValue, sampleOffset);
+}
+#endif
@@ -8,8 +8,18 @@
 
 #pragma once
 
+#include <type_traits>
+#include <vector>
 #include <JuceHeader.h>
-#include "CircularBuffer.h"
+#include "DelayStage.h"
+#include "ChannelLayout.h"
+#include "ParameterSnapshot.h"
+#include "ParameterEventQueue.h"
+#include "PresetState.h"
+#include "TailTracker.h"
+#include "PerformanceMonitor.h"
+#include "PerformanceEditor.h"
+#include "SpectrumAnalyser.h"
 
 
 using namespace juce;
@@ -19,6 +29,7 @@ using namespace juce;
 /**
 */
 class DelayPluginAudioProcessor  : public juce::AudioProcessor
+                             , public PresetBankOwner
 {
 public:
     //==============================================================================
@@ -35,6 +46,10 @@ public:
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
+    // Hosts with a 64 bit mix bus can hand us double buffers, which run through double delay lines rather than being converted to float and back.
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -58,36 +73,48 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    // Timing for this instance, shown in the editor.
+    PerformanceMonitor& getPerformanceMonitor() { return performance; }
+
+    // Change a parameter at sampleOffset samples into the next block, value is normalised (0 - 1). Hosts only tell the plugin about automation once
+    // a block, this is for callers that know exactly where a change lands, like the offline tools. Call between blocks from the thread that calls
+    // processBlock. Returns false if the parameter is not one the block is split for or too many changes are queued.
+    bool scheduleParameterChange (int parameterIndex, float normalisedValue, int sampleOffset);
+
+    // Presets, saved with the rest of the state and listed to the host as programs. Each preset's parameter values are resolved off the audio
+    // thread whenever the presets change, so switching or morphing between presets costs the audio thread no lookups. Call from the message thread.
+
+    // Store the current settings as a preset, replacing the preset at index or adding one to the end. Returns the preset's index, or -1 if the
+    // bank is full.
+    int storePreset(const String& name, int index = -1) override;
+
+    // Switch to a preset. The parameters move to it as well, so the host and editor follow.
+    void selectPreset(int index) override;
+
+    // Morph between two presets, amount 0 is preset a and 1 is preset b, gliding the delay time between them. This is a performance control, it
+    // moves the DSP without changing the parameters, and moving a control or selecting a preset takes over from it.
+    void morphPresets(int a, int b, float amount) override;
+
+    int getNumPresets() override;
+    int getSelectedPreset() override;
+    String getPresetName(int index) override;
+
 private:
     //==============================================================================
 
-    float CalcDelayTime(float BPM, int syncSetting) 
+    // Length of each sync setting in quarter notes, in the same order as the SyncSetting choices. Dotted notes are 1.5x and triplets 2/3 of the straight note.
+    static constexpr double DivisionMultipliers[16] = { 4.0, 6.0, 8.0 / 3.0,          // 1/1, 1/1D, 1/1T
+                                                        2.0, 3.0, 4.0 / 3.0,          // 1/2, 1/2D, 1/2T
+                                                        1.0, 1.5, 2.0 / 3.0,          // 1/4, 1/4D, 1/4T
+                                                        0.5, 0.75, 1.0 / 3.0,         // 1/8, 1/8D, 1/8T
+                                                        0.25, 0.375, 1.0 / 6.0,       // 1/16, 1/16D, 1/16T
+                                                        0.125 };                      // 1/32
+
+    float CalcDelayTime(double BPM, int syncSetting) 
     {
-        float quarterNoteDelay = 60.0 / BPM;
-        float fullNoteDelay = quarterNoteDelay * 4;
-        float fullNoteDotted = fullNoteDelay * 1.5;
-        float fullNoteTriplet = fullNoteDelay / 1.5;
-        float halfNoteDelay = quarterNoteDelay * 2;
-        float halfNoteDotted = halfNoteDelay * 1.5;
-        float halfNoteTriplet = halfNoteDelay / 1.5;
-        float quarterNoteDotted = quarterNoteDelay * 1.5;
-        float quarterNoteTriplet = quarterNoteDelay / 1.5;
-        float eighthNoteDelay = quarterNoteDelay / 2.0;
-        float eighthNoteDotted = eighthNoteDelay * 1.5;
-        float eighthNoteTripletDelay = quarterNoteDelay / 3.0;
-        float sixteenthNoteDelay = quarterNoteDelay / 4.0;
-        float sixteenthNoteDotted = sixteenthNoteDelay * 1.5;
-        float sixteenthNoteTripletDelay = quarterNoteDelay / 5.0;
-        float thirtytwothNoteDelay = quarterNoteDelay / 6.0;
-
-
-        double delayNotes[16] = { fullNoteDelay, fullNoteDotted, fullNoteTriplet,
-            halfNoteDelay, halfNoteDotted, halfNoteTriplet, quarterNoteDelay,
-            quarterNoteDotted, quarterNoteTriplet, eighthNoteDelay, eighthNoteDotted,
-            eighthNoteTripletDelay, sixteenthNoteDelay, sixteenthNoteDotted, sixteenthNoteTripletDelay,
-            thirtytwothNoteDelay };
-
-        return (delayNotes[syncSetting] * 1000);
+        // One quarter note lasts 60 / BPM seconds, the table scales that to the sync setting.
+        return (float)(60000.0 / BPM * DivisionMultipliers[jlimit(0, 15, syncSetting)]);
     }
     
 
@@ -96,7 +123,8 @@ private:
     AudioParameterFloat* Feedback;
     AudioParameterFloat* DelayTimeMs;
 
-    float FinalDelayTime = 0.0f;
+    // Delay time in use, written by the audio thread and read by getTailLengthSeconds from any thread.
+    std::atomic<float> FinalDelayTime { 0.0f };
 
 
     AudioParameterBool* PingPongEnabled;
@@ -104,9 +132,87 @@ private:
 
     AudioParameterChoice* SyncSetting;
 
-    AudioPlayHead::CurrentPositionInfo Playhead;
+    // Tempo read from the host playhead once per block, this stays at the last known tempo if the host stops giving us one.
+    double HostBpm = 120.0;
+
+    // Tempo and sync setting the sync delay time was last calculated for, it is only recalculated when one of these changes.
+    double SyncBpm = 0.0;
+    int SyncDivision = -1;
+    float SyncDelayTimeMs = 0.0f;
+
+    // The delay lines and kernels, sized in prepareToPlay once we know how many channels the host is giving us.
+    DelayStage delayStage;
+    int NumBuffers = 0;
+
+    // Parameters bound once in the constructor and read once per block, feedback, mix and master are smoothed.
+    ParameterSnapshot parameters;
+    int MasterParameter = 0, MixParameter = 0, FeedbackParameter = 0, DelayTimeParameter = 0;
+    int PingPongParameter = 0, SyncEnabledParameter = 0, SyncSettingParameter = 0;
+
+    // Timestamped parameter changes, used to split each block at the samples where parameters change. Changes from the host land at the start of
+    // the block, scheduleParameterChange gives them their own sample.
+    ParameterEventQueue events;
+
+    // Pointers into the buffer for the sub-block currently being processed, sized in prepareToPlay. Only the ones for the host's precision are used.
+    std::vector<float*> channelPointers;
+    std::vector<double*> channelPointersDouble;
+
+    template <typename SampleType>
+    std::vector<SampleType*>& getChannelPointers()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return channelPointersDouble;
+        else
+            return channelPointers;
+    }
+
+    // Watches for silence so the delay lines can be skipped once the repeats have died away.
+    TailTracker tailTracker;
+
+    // Times each block and the delay stage inside it.
+    PerformanceMonitor performance;
+
+    // Output spectrum for the editor, fed with a copy of each block while the editor shows it.
+    SpectrumAnalyser analyser;
+    static constexpr int DelayTimingStage = 0;
+
+    // Block rate values passed to the delay stage.
+    bool PingPong = false;
+    int BlockSamples = 0;
+
+    // The presets as stored, guarded by presetLock, and the bank resolved from them. Only the audio thread touches the active bank, new ones are
+    // resolved off the audio thread and passed over through presetHandover. The delay's only derived value is its delay time in samples, which
+    // updateBlockParameters works out with a multiply, so the bank only needs the parameter values.
+    CriticalSection presetLock;
+    std::vector<PresetState> presets;
+    int currentPreset = -1;
+
+    std::unique_ptr<PresetBank> presetBank;
+    RealtimeHandover<PresetBank> presetHandover;
+    PresetSelection presetSelection;
+
+    // Set while a morph is being applied, so the delay time glides across the block like a tempo change.
+    bool PresetGlide = false;
+
+    // Resolves a bank for the audio thread to pick up, call with presetLock held.
+    void postPresets();
+
+    // Called at the start of each block on the audio thread, swaps in a new bank if one is waiting and switches to a new preset selection.
+    void applyPresetSelection();
+
+    // Reads the tempo from the host playhead, called once at the start of each block.
+    void updateTempo();
+
+    // Works out the block rate values from the parameters, called at the start of the block and whenever an event changes a parameter.
+    void updateBlockParameters();
+
+    // Both processBlock overloads run this in their own precision.
+    template <typename SampleType>
+    void processSamples(AudioBuffer<SampleType>& buffer);
 
-    CircularBuffer BufferL, BufferR;
+    // Handles a block while the plugin is idle. Parameter changes are still applied but the delay lines are not run.
+    template <typename SampleType>
+    void processIdleBlock(AudioBuffer<SampleType>& buffer, int numChannels, int numSamples);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DelayPluginAudioProcessor)
 };
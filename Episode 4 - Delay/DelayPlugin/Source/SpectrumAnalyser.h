@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyser.h
+    Created: 20 Oct 2026 6:12:44pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include <JuceHeader.h>
+
+// Output spectrum for the editor, shared by the plugins. The audio thread mixes each block down to mono as it copies it into a wait-free single
+// producer/single consumer FIFO, which is all the analyser costs it, and only while a view is open. A background thread drains the FIFO and runs
+// a Hann windowed FFT every HopSize samples, with the FFT plan and every buffer made once when the analyser is created, and keeps the latest
+// spectrum in dB for the view to copy out. This is the live version of fftfrequencyplot.m from the filters episode.
+class SpectrumAnalyser : private juce::Thread
+{
+
+public:
+
+    static constexpr int FFTOrder = 11;
+    static constexpr int FFTSize = 1 << FFTOrder;
+    static constexpr int NumBins = FFTSize / 2 + 1;
+
+    // Frames overlap by three quarters, so at 48 kHz there is a new frame about every 11 ms.
+    static constexpr int HopSize = FFTSize / 4;
+
+    // Samples the FIFO holds, enough for the background thread to fall well behind at 192 kHz before blocks are dropped.
+    static constexpr int Capacity = 1 << 15;
+
+    // Floor of the spectrum, and how fast peaks fall back towards it.
+    static constexpr float MinDb = -120.0f;
+    static constexpr float FallDbPerSecond = 40.0f;
+
+    // C-tor
+    SpectrumAnalyser()
+        : juce::Thread("Spectrum analyser"), fft(FFTOrder), fifo((size_t)Capacity), window((size_t)FFTSize), history((size_t)FFTSize),
+          fftBuffer((size_t)FFTSize * 2), working((size_t)NumBins, MinDb), spectrum((size_t)NumBins, MinDb)
+    {
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t)FFTSize, juce::dsp::WindowingFunction<float>::hann, false);
+
+        // A full scale sine reads 0 dB. The FFT of a sine peaks at its amplitude times half the window's sum.
+        float windowSum = 0.0f;
+
+        for (float w : window)
+            windowSum += w;
+
+        magnitudeScale = 2.0f / windowSum;
+    }
+
+    // D-tor
+    ~SpectrumAnalyser() override
+    {
+        stopThread(1000);
+    }
+
+    // Set the sample rate the bins are spaced for, call from prepareToPlay.
+    void Prepare(double sampleRate)
+    {
+        SampleRate.store(sampleRate, std::memory_order_relaxed);
+    }
+
+    // --- Audio thread
+
+    // Copy the first numChannels channels of a block into the FIFO, mixed to mono. Does nothing while no view is open, and drops the block if the
+    // background thread has fallen so far behind that it does not fit.
+    template <typename SampleType>
+    void Push(const juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples)
+    {
+        if (numViewers.load(std::memory_order_relaxed) == 0 || numChannels <= 0 || numSamples <= 0)
+            return;
+
+        size_t writePosition = writeIndex.load(std::memory_order_relaxed);
+
+        if (writePosition + (size_t)numSamples - readIndex.load(std::memory_order_acquire) > (size_t)Capacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const SampleType* const* channels = buffer.getArrayOfReadPointers();
+        float gain = 1.0f / (float)numChannels;
+
+        for (int sample = 0; sample < numSamples; sample++)
+        {
+            SampleType sum = channels[0][sample];
+
+            for (int channel = 1; channel < numChannels; channel++)
+                sum += channels[channel][sample];
+
+            fifo[(writePosition + (size_t)sample) & (Capacity - 1)] = (float)sum * gain;
+        }
+
+        writeIndex.store(writePosition + (size_t)numSamples, std::memory_order_release);
+    }
+
+    // --- Message thread
+
+    // Views register while they are showing, the background thread and the audio thread's copy only run while at least one is.
+    void AddViewer()
+    {
+        if (numViewers.fetch_add(1) == 0)
+            startThread();
+    }
+
+    void RemoveViewer()
+    {
+        if (numViewers.fetch_sub(1) == 1)
+            stopThread(1000);
+    }
+
+    // Copy the latest spectrum into destination, NumBins values in dB from DC to Nyquist. Returns the sample rate the bins are spaced for.
+    double GetSpectrum(float* destination) const
+    {
+        const juce::ScopedLock lock(spectrumLock);
+        std::copy(spectrum.begin(), spectrum.end(), destination);
+
+        return SampleRate.load(std::memory_order_relaxed);
+    }
+
+    // Blocks dropped because the FIFO was full.
+    juce::int64 GetNumDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+
+    // How long the background thread sleeps once it has caught up, a little under one hop at 48 kHz.
+    static constexpr int PollIntervalMs = 10;
+
+    juce::dsp::FFT fft;
+
+    // The FIFO, written by the audio thread and read by the background thread.
+    std::vector<float> fifo;
+    std::atomic<size_t> writeIndex { 0 };
+    std::atomic<size_t> readIndex { 0 };
+    std::atomic<juce::int64> dropped { 0 };
+    std::atomic<int> numViewers { 0 };
+
+    std::atomic<double> SampleRate { 48000.0 };
+
+    // Background thread buffers, the last FFTSize samples, the windowed frame and its transform, and the spectrum with the peaks falling.
+    std::vector<float> window;
+    std::vector<float> history;
+    std::vector<float> fftBuffer;
+    std::vector<float> working;
+    float magnitudeScale = 1.0f;
+
+    // The spectrum the view copies, guarded by spectrumLock. Neither side is the audio thread so a lock is fine here.
+    juce::CriticalSection spectrumLock;
+    std::vector<float> spectrum;
+
+    void run() override
+    {
+        // Start from the audio arriving now rather than whatever was left in the FIFO when the last view closed. The read index belongs to this
+        // thread, so it can be moved up to the write index.
+        readIndex.store(writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+        std::fill(history.begin(), history.end(), 0.0f);
+
+        while (! threadShouldExit())
+        {
+            while (readHop())
+                analyseFrame();
+
+            wait(PollIntervalMs);
+        }
+    }
+
+    // Move the next HopSize samples from the FIFO onto the end of the history, returns false if there are not that many yet.
+    bool readHop()
+    {
+        size_t readPosition = readIndex.load(std::memory_order_relaxed);
+
+        if (writeIndex.load(std::memory_order_acquire) - readPosition < (size_t)HopSize)
+            return false;
+
+        std::copy(history.begin() + HopSize, history.end(), history.begin());
+
+        for (int sample = 0; sample < HopSize; sample++)
+            history[(size_t)(FFTSize - HopSize + sample)] = fifo[(readPosition + (size_t)sample) & (Capacity - 1)];
+
+        readIndex.store(readPosition + (size_t)HopSize, std::memory_order_release);
+        return true;
+    }
+
+    // Window the history, transform it and update the spectrum, peaks jump up and fall back at FallDbPerSecond.
+    void analyseFrame()
+    {
+        for (int sample = 0; sample < FFTSize; sample++)
+            fftBuffer[(size_t)sample] = history[(size_t)sample] * window[(size_t)sample];
+
+        std::fill(fftBuffer.begin() + FFTSize, fftBuffer.end(), 0.0f);
+        fft.performFrequencyOnlyForwardTransform(fftBuffer.data(), true);
+
+        float fall = FallDbPerSecond * (float)HopSize / (float)SampleRate.load(std::memory_order_relaxed);
+
+        for (int bin = 0; bin < NumBins; bin++)
+        {
+            float db = juce::Decibels::gainToDecibels(fftBuffer[(size_t)bin] * magnitudeScale, MinDb);
+            working[(size_t)bin] = std::max(db, working[(size_t)bin] - fall);
+        }
+
+        const juce::ScopedLock lock(spectrumLock);
+        std::copy(working.begin(), working.end(), spectrum.begin());
+    }
+
+};
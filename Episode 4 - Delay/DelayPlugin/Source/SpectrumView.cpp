@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    SpectrumView.cpp
+    Created: 20 Oct 2026 6:12:44pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include "SpectrumView.h"
+
+SpectrumView::SpectrumView(SpectrumAnalyser& analyser)
+    : spectrumAnalyser(analyser), bins((size_t)SpectrumAnalyser::NumBins, SpectrumAnalyser::MinDb)
+{
+    spectrumAnalyser.AddViewer();
+
+    // Redraw at about the rate the analyser makes new frames.
+    startTimerHz(30);
+}
+
+SpectrumView::~SpectrumView()
+{
+    stopTimer();
+    spectrumAnalyser.RemoveViewer();
+}
+
+void SpectrumView::timerCallback()
+{
+    sampleRate = spectrumAnalyser.GetSpectrum(bins.data());
+    repaint();
+}
+
+float SpectrumView::getColumnLevel(float lowFrequency, float highFrequency) const
+{
+    float binsPerHz = (float)SpectrumAnalyser::FFTSize / (float)sampleRate;
+    float lowBin = lowFrequency * binsPerHz;
+    float highBin = highFrequency * binsPerHz;
+    int lastBin = SpectrumAnalyser::NumBins - 1;
+
+    if (lowBin >= (float)lastBin)
+        return SpectrumAnalyser::MinDb;
+
+    // Narrower than a bin, interpolate between the two bins either side.
+    if (highBin - lowBin < 1.0f)
+    {
+        int bin = (int)lowBin;
+        float t = lowBin - (float)bin;
+
+        return bins[(size_t)bin] + (bins[(size_t)bin + 1] - bins[(size_t)bin]) * t;
+    }
+
+    // Wider, the loudest bin in the column.
+    float level = SpectrumAnalyser::MinDb;
+
+    for (int bin = (int)std::ceil(lowBin); bin <= juce::jmin((int)highBin, lastBin); bin++)
+        level = juce::jmax(level, bins[(size_t)bin]);
+
+    return level;
+}
+
+void SpectrumView::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    float width = bounds.getWidth();
+    float height = bounds.getHeight();
+
+    g.fillAll(juce::Colours::black);
+
+    auto frequencyToX = [width](float frequency)
+    {
+        return width * std::log(frequency / minFrequency) / std::log(maxFrequency / minFrequency);
+    };
+
+    auto dbToY = [height](float db)
+    {
+        return juce::jmap(juce::jlimit(minDb, maxDb, db), minDb, maxDb, height, 0.0f);
+    };
+
+    // Grid, a line at every decade and every 24 dB.
+    g.setColour(juce::Colours::darkgrey);
+
+    for (float frequency : { 100.0f, 1000.0f, 10000.0f })
+        g.drawVerticalLine(juce::roundToInt(frequencyToX(frequency)), 0.0f, height);
+
+    for (float db = 0.0f; db > minDb; db -= 24.0f)
+        g.drawHorizontalLine(juce::roundToInt(dbToY(db)), 0.0f, width);
+
+    // One point per pixel column.
+    int numColumns = juce::jmax(1, getWidth());
+    float ratio = maxFrequency / minFrequency;
+
+    path.clear();
+
+    for (int x = 0; x < numColumns; x++)
+    {
+        float lowFrequency = minFrequency * std::pow(ratio, (float)x / (float)numColumns);
+        float highFrequency = minFrequency * std::pow(ratio, (float)(x + 1) / (float)numColumns);
+        float y = dbToY(getColumnLevel(lowFrequency, highFrequency));
+
+        if (x == 0)
+            path.startNewSubPath((float)x, y);
+        else
+            path.lineTo((float)x, y);
+    }
+
+    g.setColour(juce::Colours::lightgreen);
+    g.strokePath(path, juce::PathStrokeType(1.5f));
+}
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    TailTracker.h
+    Created: 19 Oct 2026 4:05:22pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <JuceHeader.h>
+
+// Silence detection with tail tracking, shared by the plugins. Once the input has been silent for longer than the plugin's tail and the last processed
+// output has decayed below the threshold, the tracker reports the plugin as idle so processBlock can skip the DSP. Any input above the threshold wakes
+// it straight back up.
+class TailTracker
+{
+
+public:
+
+    // Level below which a block counts as silent
+    static constexpr float ThresholdDb = -90.0f;
+
+    // C-tor
+    TailTracker() {}
+    // D-tor
+    ~TailTracker() {}
+
+    // Call from prepareToPlay, the tracker starts awake.
+    void Prepare(double sampleRate)
+    {
+        SampleRate = sampleRate;
+        Threshold = juce::Decibels::decibelsToGain(ThresholdDb);
+        SilentSamples = 0;
+        Idle = false;
+    }
+
+    // Set how long the output can keep ringing after the input goes silent, can be infinite.
+    void SetTailSeconds(double seconds)
+    {
+        TailSamples = std::isfinite(seconds) ? (juce::int64)(seconds * SampleRate) : std::numeric_limits<juce::int64>::max();
+    }
+
+    // Call at the start of each block with the input. Returns true if the plugin is idle and the block can be skipped.
+    template <typename SampleType>
+    bool ProcessInput(const juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples)
+    {
+        if (GetPeak(buffer, numChannels, numSamples) > Threshold)
+        {
+            SilentSamples = 0;
+            Idle = false;
+
+            return false;
+        }
+
+        SilentSamples = juce::jmin(SilentSamples + numSamples, std::numeric_limits<juce::int64>::max() / 2);
+
+        return Idle;
+    }
+
+    // Call after processing a block that was not skipped, with the output. Goes idle once the tail has run out and the output is silent, returns
+    // true on the block where that happens so the caller can clear whatever is left in its DSP state.
+    template <typename SampleType>
+    bool ProcessOutput(const juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples)
+    {
+        if (Idle || SilentSamples < TailSamples || GetPeak(buffer, numChannels, numSamples) > Threshold)
+            return false;
+
+        Idle = true;
+
+        return true;
+    }
+
+    bool IsIdle() const { return Idle; }
+
+    // Time for the impulse response of a second order filter to decay below the threshold. The envelope decays with a time constant of 2Q / w0,
+    // or 1 / w0 for filters that don't resonate.
+    static double FilterRingTime(double fc, double Q)
+    {
+        double timeConstant = juce::jmax(1.0, 2.0 * Q) / (juce::MathConstants<double>::twoPi * fc);
+
+        return timeConstant * DecayRatio();
+    }
+
+    // Time for a feedback delay to decay below the threshold, infinite if the feedback does not decay.
+    static double FeedbackDelayTailTime(double delaySeconds, double feedback)
+    {
+        feedback = std::fabs(feedback);
+
+        if (feedback >= 0.9999)
+            return std::numeric_limits<double>::infinity();
+
+        // The first echo comes out after one delay time, each repeat after that is scaled by the feedback again
+        double repeats = feedback > 0.0 ? std::ceil(-DecayRatio() / std::log(feedback)) : 0.0;
+
+        return delaySeconds * (1.0 + repeats);
+    }
+
+private:
+
+    double SampleRate = 48000.0;
+    float Threshold = 0.0f;
+    juce::int64 TailSamples = 0;
+    juce::int64 SilentSamples = 0;
+    bool Idle = false;
+
+    // Number of time constants needed to decay below the threshold
+    static double DecayRatio()
+    {
+        return std::log(1.0 / juce::Decibels::decibelsToGain((double)ThresholdDb));
+    }
+
+    template <typename SampleType>
+    static float GetPeak(const juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples)
+    {
+        float peak = 0.0f;
+
+        for (int channel = 0; channel < numChannels; channel++)
+            peak = juce::jmax(peak, (float)buffer.getMagnitude(channel, 0, numSamples));
+
+        return peak;
+    }
+
+};
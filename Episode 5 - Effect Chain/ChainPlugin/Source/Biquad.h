@@ -0,0 +1,213 @@
+// Biquad Filter
+// Author: Jordan Evans
+// Date: 20/06/2023
+
+#pragma once
+
+#include <cmath>
+#include "Simd.h"
+#define pi 3.1415926535897932384626433
+
+enum BiquadType
+{
+    LPF = 0,
+    HPF = 1,
+    Notch = 2,
+    Peaking = 3,
+    LowShelf = 4,
+    HighShelf = 5
+};
+
+
+// Biquad in either floating point type. Biquad runs in float, with the feedforward half of ProcessBlock as a SIMD kernel, and BiquadDouble runs the
+// whole filter in double for hosts that process in double, which also keeps low cutoffs at high sample rates accurate where float coefficients
+// and state run out of bits. Both are defined in Biquad.cpp.
+template <typename SampleType>
+class FloatBiquad
+{
+
+    public:
+
+    // Ctor
+    FloatBiquad();
+    // Dtor
+    ~FloatBiquad();  
+
+    // Initialise filter with specified parameters, call to change filter type 
+    // Only peaking and shelving filters require gain so set to 0.0f when NOT using those types.
+    void Init(BiquadType filterType, float fc, float fs, float Q, float gain_dB);
+
+    // Call to set all parameters without changing filter type 
+    void SetParameters(float fc, float Q, float gain_dB);
+
+    // Call to only set frequency cutoff
+    void SetFc(float fc);
+
+    // Call to only set gain. Only peaking and shelving filters require gain
+    // so set to 0.0f when NOT using those types.
+    void SetGain(float gain_dB);
+
+    // Reset filter
+    void Reset(float fs);
+
+    // Process a sample with the filter
+    SampleType ProcessSample(SampleType xn);
+
+    // Get the coefficients normalised by a0, for running the same design in another number format.
+    void GetCoefficients(SampleType& B0, SampleType& B1, SampleType& B2, SampleType& A1, SampleType& A2) const;
+
+    // Load coefficients normalised by a0 (as GetCoefficients gives them) that were worked out ahead of time for cutoff fc, so a preset can change
+    // the filter without recalculating it. The filter state is kept, and SetFc only recalculates once it is given a cutoff other than fc.
+    void SetCoefficients(float fc, SampleType B0, SampleType B1, SampleType B2, SampleType A1, SampleType A2);
+
+    // Process a block of samples in place. In float the feedforward half of the filter only depends on the input, so it runs as a SIMD kernel
+    // over the whole block and only the feedback half is left sample by sample. The SIMD layer is float only, so double runs sample by sample.
+    void ProcessBlock(SampleType* data, int numSamples);
+    
+    private:
+
+    // Feedforward coeffs
+    SampleType a0 = 0;
+    SampleType a1 = 0;
+    SampleType a2 = 0;
+
+    // Feedback coeffs
+    SampleType b0 = 0;
+    SampleType b1 = 0;
+    SampleType b2 = 0;
+    
+    // State variables
+    SampleType xminusone = 0;
+    SampleType xminustwo = 0;
+    SampleType yminusone = 0;
+    SampleType yminustwo = 0;
+
+    // Parameters
+    float CutoffFrequency = 0.0f;
+    float SampleRate = 0.0f;
+    float QualityFactor = 0.0f;
+    float Gain_dB = 0.0f;
+    int CurrentType = 0;
+
+    // Feedforward kernel for the widest instruction set the machine supports, picked when the filter is created. Only used in float.
+    void (*feedForward)(float* data, int numSamples, float b0, float b1, float b2, float xminusone, float xminustwo) = nullptr;
+
+    // Calculate filter for current parameters
+    void CalcFilter()
+    {
+        // Omega: Angular frequency
+        SampleType w = 2 * pi * ((SampleType)CutoffFrequency / SampleRate);
+
+        // Cos(Omega)
+        SampleType cosw = cos(w);
+
+        // Sin(Omega)
+        SampleType sinw = sin(w);
+
+        // Damping Coefficient
+        SampleType a = sinw / (2 * QualityFactor);
+
+        // Gain for shelving and peaking filters
+        SampleType A = pow(10, ((SampleType)Gain_dB / 40.f));
+
+        // Variable for shelving filter coeff calculation (simplifies calculations)
+        SampleType var2sqAa = 2 * sqrt(A) * a;
+
+        switch(CurrentType)
+        {
+            case LPF:
+
+            // Compute the feedforward coefficients 'b'
+            b0 = (1.f - cosw) / 2.f;
+            b1 = 1.f - cosw;
+            b2 = (1.f - cosw) / 2.f;
+
+            // Compute the feedback coefficients 'a'
+            a0 = 1.f + a;
+            a1 = -2.f * cosw;
+            a2 = 1.f - a;
+
+            break;
+
+            case HPF:
+
+            // Compute the feedforward coefficients 'b'
+            b0 = (1.f + cosw) / 2.f;
+            b1 = -(1.f + cosw);
+            b2 = (1.f + cosw) / 2.f;
+
+            // Compute the feedback coefficients 'a'
+            a0 = 1.f + a;
+            a1 = -2.f * cosw;
+            a2 = 1.f - a;
+
+            break;
+
+            case Notch:
+
+            // Compute the feedforward coefficients 'b'
+            b0 = 1.f;
+            b1 = -2.f * cosw;
+            b2 = 1.f;
+
+            // Compute the feedback coefficients 'a'
+            a0 = 1.f + a;
+            a1 = -2.f * cosw;
+            a2 = 1.f - a;
+
+            break;
+
+            case Peaking:
+
+            // Compute the feedforward coefficients 'b'
+            b0 = 1.f + a * A;
+            b1 = -2.f * cosw;
+            b2 = 1.f - a * A;
+
+            // Compute the feedback coefficients 'a'
+            a0 = 1.f + (a / A);
+            a1 = -2.f * cosw;
+            a2 = 1.f - (a / A);
+
+            break;
+
+            case LowShelf:
+
+            // Compute the feedforward coefficients 'b'
+            b0 = A * ((A + 1.f) - (A - 1.f) * cosw + var2sqAa);
+            b1 = 2.f * A * ((A - 1.f) - (A + 1.f) * cosw);
+            b2 = A * ((A + 1.f) - (A - 1.f) * cosw - var2sqAa);
+
+            // Compute the feedback coefficients 'a'
+            a0 = (A + 1.f) + (A - 1.f) * cosw + var2sqAa;
+            a1 = (-2.f) * ((A - 1.f) + (A + 1.f) * cosw);
+            a2 = (A + 1.f) + (A - 1.f) * cosw - var2sqAa;
+
+            break;
+
+            case HighShelf:
+
+            // Compute the feedforward coefficients 'b'
+            b0 = A * ((A + 1.f) + (A - 1.f) * cosw + var2sqAa);
+            b1 = (-2.f) * A * ((A - 1.f) + (A + 1.f) * cosw);
+            b2 = A * ((A + 1.f) + (A - 1.f) * cosw - var2sqAa);
+
+            // Compute the feedback coefficients 'a'
+            a0 = (A + 1.f) - (A - 1.f) * cosw + var2sqAa;
+            a1 = 2.f * ((A - 1.f) - (A + 1.f) * cosw);
+            a2 = (A + 1.f) - (A - 1.f) * cosw - var2sqAa;
+
+            break;
+        }
+
+
+    }
+
+};
+
+// The two precisions, defined in Biquad.cpp.
+using Biquad = FloatBiquad<float>;
+using BiquadDouble = FloatBiquad<double>;
+
+extern template class FloatBiquad<float>;
+extern template class FloatBiquad<double>;
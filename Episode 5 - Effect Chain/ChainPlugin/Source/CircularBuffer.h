@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    CircularBuffer.h
+    Created: 3 Nov 2022 10:13:02am
+    Author:  Jordan Evans
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <iostream>
+#include <cmath>
+#include <memory>
+
+// Delay line in either floating point type, CircularBuffer stores float and CircularBufferDouble stores double for hosts that process in double.
+// Delay times stay in float whichever type the samples are. Both are defined in CircularBuffer.cpp.
+template <typename SampleType>
+class FloatCircularBuffer
+{
+    
+public:
+    
+    // C-tor
+    FloatCircularBuffer();
+    // D-tor
+    ~FloatCircularBuffer();
+    
+    
+    //Public member functions
+    void Init(int sr, float max_delay_time_ms);
+    void ClearBuffer();
+    void BufferWrite(SampleType xn);
+    SampleType BufferRead(float delay_time_ms, bool interpolate_line);
+    SampleType BufferReadSamples(int delay_int_samples);
+    SampleType BufferReadFractional(float delay_in_samples);
+
+    // Block versions of BufferReadSamples and BufferWrite. BufferReadBlock reads what BufferReadSamples would return over the next numSamples
+    // samples, so the delay must be at least numSamples for every sample it reads to have been written already.
+    void BufferReadBlock(int delay_in_samples, SampleType* destination, int numSamples);
+    void BufferWriteBlock(const SampleType* source, int numSamples);
+    
+    
+    
+    
+private:
+    
+    
+    //Private member variables
+    unsigned int WriteIndex = 0;
+    float SampleRate = 0.0f;
+    unsigned int buffer_length = 0;
+    
+    int delay_time_samples = 0;
+    float delay_fractional_samples = 0.0f;
+    
+    float MaxDelayTimeMs = 0.0f;
+    
+    bool interpolateline = false; 
+    
+    // Unique ptr array to use as circular buffer, self deletes when goes out of scope.
+    std::unique_ptr<SampleType[]> delaybuffer = nullptr;
+    
+
+    
+    // linear interpolation function
+    SampleType lerp(SampleType a, SampleType b, SampleType f)
+    {
+        return a * (1 - f) + (b * f);
+    }
+    
+};
+
+// The two precisions, defined in CircularBuffer.cpp.
+using CircularBuffer = FloatCircularBuffer<float>;
+using CircularBufferDouble = FloatCircularBuffer<double>;
+
+extern template class FloatCircularBuffer<float>;
+extern template class FloatCircularBuffer<double>;
+
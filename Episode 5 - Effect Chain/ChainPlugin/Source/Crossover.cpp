@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+
+    Crossover.cpp
+    Created: 20 Oct 2026 4:37:52pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <type_traits>
+#include "Crossover.h"
+
+namespace
+{
+    // Q of the Butterworth biquads, two of them in a row make one side of an LR4 crossover.
+    static constexpr float ButterworthQ = 0.70710678f;
+
+    // Runs every section of the four bands over the input, one sample at a time with the four bands in the lanes of one batch. The history of the
+    // input and of each section's output is kept in batches for the whole block, the output history of one section is the input history of the
+    // next, so the sections are a compile time count and the loops over them unroll.
+    struct SplitKernel
+    {
+        using Function = void (*)(const float*, float*, int, const float*, float*, int);
+
+        template <typename Ops>
+        static void Process(const float* input, float* bands, int numSamples, const float* coefficients, float* state, int numSections)
+        {
+            using Q = Simd::QuadOps<Ops>;
+
+            switch (numSections)
+            {
+                case 2:  run<Q, 2>(input, bands, numSamples, coefficients, state); break;
+                case 4:  run<Q, 4>(input, bands, numSamples, coefficients, state); break;
+                default: run<Q, 6>(input, bands, numSamples, coefficients, state); break;
+            }
+        }
+
+        template <typename Q, int NumSections>
+        static void run(const float* input, float* bands, int numSamples, const float* coefficients, float* state)
+        {
+            using Batch = typename Q::Batch;
+
+            // [n - 1] and [n - 2] of the input, then of each section's output.
+            Batch h1[NumSections + 1], h2[NumSections + 1];
+
+            for (int i = 0; i <= NumSections; i++)
+            {
+                h1[i] = Q::Load(state + i * 8);
+                h2[i] = Q::Load(state + i * 8 + 4);
+            }
+
+            for (int sample = 0; sample < numSamples; sample++)
+            {
+                Batch x = Q::Set(input[sample]);
+
+                for (int section = 0; section < NumSections; section++)
+                {
+                    const float* c = coefficients + section * 20;
+
+                    Batch y = Q::Fma(Q::Load(c), x, Q::Fma(Q::Load(c + 4), h1[section], Q::Mul(Q::Load(c + 8), h2[section])));
+                    y = Q::Sub(y, Q::Fma(Q::Load(c + 12), h1[section + 1], Q::Mul(Q::Load(c + 16), h2[section + 1])));
+
+                    h2[section] = h1[section];
+                    h1[section] = x;
+                    x = y;
+                }
+
+                h2[NumSections] = h1[NumSections];
+                h1[NumSections] = x;
+
+                Q::Store(bands + sample * 4, x);
+            }
+
+            for (int i = 0; i <= NumSections; i++)
+            {
+                Q::Store(state + i * 8, h1[i]);
+                Q::Store(state + i * 8 + 4, h2[i]);
+            }
+        }
+    };
+}
+
+template <typename SampleType>
+FloatCrossover<SampleType>::FloatCrossover()
+{
+    static_assert(MaxBands == 4, "The bands are packed into the four lanes of Simd::QuadOps");
+
+    splitKernel = Simd::Dispatch<SplitKernel>();
+    design();
+}
+
+template <typename SampleType>
+FloatCrossover<SampleType>::~FloatCrossover()
+{
+
+}
+
+template <typename SampleType>
+void FloatCrossover<SampleType>::Init(int numBands, const float* frequencies, float fs)
+{
+    // Save parameters
+    NumBands = std::clamp(numBands, 1, MaxBands);
+    SampleRate = fs;
+
+    for (int i = 0; i < NumBands - 1; i++)
+        Frequencies[i] = frequencies[i];
+
+    // The old states belong to other filters, so start from silence
+    std::fill(&State[0][0][0], &State[0][0][0] + sizeof(State) / sizeof(SampleType), (SampleType)0);
+
+    design();
+}
+
+template <typename SampleType>
+void FloatCrossover<SampleType>::Reset(float fs)
+{
+    // Reset filter state variables
+    std::fill(&State[0][0][0], &State[0][0][0] + sizeof(State) / sizeof(SampleType), (SampleType)0);
+
+    // Only redesign if sample rate changed
+    if (fs != SampleRate)
+    {
+        SampleRate = fs;
+        design();
+    }
+}
+
+template <typename SampleType>
+void FloatCrossover<SampleType>::setSection(int section, int band, const SampleType* coefficients)
+{
+    for (int i = 0; i < 5; i++)
+        Coefficients[section][i][band] = coefficients[i];
+}
+
+template <typename SampleType>
+void FloatCrossover<SampleType>::design()
+{
+    NumSections = 2 * (NumBands - 1);
+
+    // Every band starts as a straight pass through, and any lane above the band count stays silent.
+    const SampleType passThrough[5] = { 1, 0, 0, 0, 0 };
+    const SampleType silence[5] = {};
+
+    for (int section = 0; section < MaxSections; section++)
+        for (int band = 0; band < MaxBands; band++)
+            setSection(section, band, band < NumBands ? passThrough : silence);
+
+    // Low, high and allpass sections of each crossover, designed in double. The allpass is the low pass denominator reversed over itself.
+    SampleType lowPass[MaxBands - 1][5], highPass[MaxBands - 1][5], allPass[MaxBands - 1][5];
+
+    for (int i = 0; i < NumBands - 1; i++)
+    {
+        double b0, b1, b2, a1, a2;
+
+        BiquadDouble filter;
+        filter.Init(LPF, Frequencies[i], SampleRate, ButterworthQ, 0);
+        filter.GetCoefficients(b0, b1, b2, a1, a2);
+
+        const double low[5] = { b0, b1, b2, a1, a2 };
+        const double all[5] = { a2, a1, 1.0, a1, a2 };
+
+        filter.Init(HPF, Frequencies[i], SampleRate, ButterworthQ, 0);
+        filter.GetCoefficients(b0, b1, b2, a1, a2);
+
+        const double high[5] = { b0, b1, b2, a1, a2 };
+
+        for (int c = 0; c < 5; c++)
+        {
+            lowPass[i][c] = (SampleType)low[c];
+            highPass[i][c] = (SampleType)high[c];
+            allPass[i][c] = (SampleType)all[c];
+        }
+    }
+
+    // Band k is the high side of every crossover below it, the low side of its own crossover, then an allpass for every crossover above that.
+    for (int band = 0; band < NumBands; band++)
+    {
+        int section = 0;
+
+        for (int below = 0; below < band; below++)
+        {
+            setSection(section++, band, highPass[below]);
+            setSection(section++, band, highPass[below]);
+        }
+
+        if (band < NumBands - 1)
+        {
+            setSection(section++, band, lowPass[band]);
+            setSection(section++, band, lowPass[band]);
+        }
+
+        for (int above = band + 1; above < NumBands - 1; above++)
+            setSection(section++, band, allPass[above]);
+    }
+}
+
+template <typename SampleType>
+void FloatCrossover<SampleType>::Split(const SampleType* input, SampleType* bands, int numSamples)
+{
+    // A single band is the input as it is.
+    if (NumSections == 0)
+    {
+        for (int sample = 0; sample < numSamples; sample++)
+        {
+            SampleType* b = bands + sample * MaxBands;
+            b[0] = input[sample];
+            b[1] = b[2] = b[3] = 0;
+        }
+
+        return;
+    }
+
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        splitKernel(input, bands, numSamples, &Coefficients[0][0][0], &State[0][0][0], NumSections);
+    }
+    else
+    {
+        // Double has no SIMD kernel, so each lane runs in turn. The history is laid out as the float kernel's, [n - 1] and [n - 2] of the input
+        // and then of each section's output.
+        SampleType (*history)[2][MaxBands] = State;
+
+        for (int sample = 0; sample < numSamples; sample++)
+        {
+            for (int band = 0; band < MaxBands; band++)
+            {
+                SampleType x = input[sample];
+
+                for (int section = 0; section < NumSections; section++)
+                {
+                    const auto& c = Coefficients[section];
+
+                    SampleType y = c[0][band] * x + c[1][band] * history[section][0][band] + c[2][band] * history[section][1][band]
+                                 - c[3][band] * history[section + 1][0][band] - c[4][band] * history[section + 1][1][band];
+
+                    history[section][1][band] = history[section][0][band];
+                    history[section][0][band] = x;
+                    x = y;
+                }
+
+                history[NumSections][1][band] = history[NumSections][0][band];
+                history[NumSections][0][band] = x;
+
+                bands[sample * MaxBands + band] = x;
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void FloatCrossover<SampleType>::Combine(const SampleType* bands, SampleType* output, int numSamples, SampleType gain)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+    {
+        const SampleType* b = bands + sample * MaxBands;
+        output[sample] = (b[0] + b[1] + b[2] + b[3]) * gain;
+    }
+}
+
+template class FloatCrossover<float>;
+template class FloatCrossover<double>;
@@ -0,0 +1,227 @@
+/*
+  ==============================================================================
+
+    DiodeClipper.cpp
+    Created: 19 Oct 2026 9:02:14am
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include "DiodeClipper.h"
+
+template <typename SampleType>
+FloatDiodeClipper<SampleType>::FloatDiodeClipper()
+{
+
+}
+
+template <typename SampleType>
+FloatDiodeClipper<SampleType>::~FloatDiodeClipper()
+{
+
+}
+
+template <typename SampleType>
+void FloatDiodeClipper<SampleType>::Init(float fs, float drive)
+{
+    // Save variables
+    SampleRate = fs;
+    Drive = drive;
+
+    // Clear state variables
+    h3 = h4 = 0;
+
+    // Calculate circuit for current parameters
+    CalcCircuit();
+}
+
+template <typename SampleType>
+void FloatDiodeClipper<SampleType>::SetDrive(float drive)
+{
+    // Only recalculate if drive has changed
+    if (drive != Drive)
+    {
+        // Save drive
+        Drive = drive;
+
+        // Calculate circuit for current parameters
+        CalcCircuit();
+    }
+}
+
+template <typename SampleType>
+void FloatDiodeClipper<SampleType>::Reset(float fs)
+{
+    // Reset state variables
+    h3 = h4 = 0;
+
+    // Only recalculate if sample rate changed
+    if (fs != SampleRate)
+    {
+        // Save sample rate
+        SampleRate = fs;
+
+        // Calculate circuit for current parameters
+        CalcCircuit();
+    }
+}
+
+template <typename SampleType>
+void FloatDiodeClipper<SampleType>::GetCircuit(Circuit& circuit) const
+{
+    circuit.SampleRate = SampleRate;
+    circuit.Drive = Drive;
+
+    circuit.G3 = G3;
+    circuit.G4 = G4;
+    circuit.GIn = GIn;
+    circuit.InvGIn = InvGIn;
+    circuit.a = a;
+    circuit.k = k;
+    circuit.qScale = qScale;
+
+    std::memcpy(circuit.Solution, solution, sizeof(solution));
+}
+
+template <typename SampleType>
+void FloatDiodeClipper<SampleType>::SetCircuit(const Circuit& circuit)
+{
+    // Worked out for another sample rate, so only the drive can be used
+    if (circuit.SampleRate != SampleRate)
+    {
+        SetDrive(circuit.Drive);
+        return;
+    }
+
+    // Save drive so an unchanged drive does not recalculate over this circuit
+    Drive = circuit.Drive;
+
+    G3 = (SampleType)circuit.G3;
+    G4 = (SampleType)circuit.G4;
+    GIn = (SampleType)circuit.GIn;
+    InvGIn = (SampleType)circuit.InvGIn;
+    a = (SampleType)circuit.a;
+    k = (SampleType)circuit.k;
+    qScale = (SampleType)circuit.qScale;
+
+    std::memcpy(solution, circuit.Solution, sizeof(solution));
+}
+
+template <typename SampleType>
+SampleType FloatDiodeClipper<SampleType>::ProcessSample(SampleType xn)
+{
+    // Voltage across C3, from the node equation (xn - vc3) / R4 = G3 * vc3 - h3
+    SampleType vc3 = (xn * ((SampleType)1 / R4) + h3) * InvGIn;
+
+    // Current drawn through the R4/C3 branch, this has to be supplied by the feedback network
+    SampleType i = (xn - vc3) * ((SampleType)1 / R4);
+
+    // Solve the feedback network for the voltage across the diodes
+    SampleType vd = nVt * LookupSolution((i + h4) * qScale);
+
+    // Update companion model history currents
+    h3 = 2 * G3 * vc3 - h3;
+    h4 = 2 * G4 * vd - h4;
+
+    // The op-amp output is the input plus the voltage across the feedback network
+    return (xn + vd) * OutputScale;
+}
+
+template <typename SampleType>
+void FloatDiodeClipper<SampleType>::CalcCircuit()
+{
+    // Drive pot in series with the fixed feedback resistor
+    SampleType Rf = RfMin + (SampleType)Drive * DrivePot;
+
+    // Trapezoidal companion conductances for both capacitors
+    G3 = 2 * (SampleType)C3 * SampleRate;
+    G4 = 2 * (SampleType)C4 * SampleRate;
+    GIn = (SampleType)1 / R4 + G3;
+    InvGIn = 1 / GIn;
+
+    // Linear conductance of the feedback network
+    a = 1 / Rf + G4;
+
+    // Normalise the diode equation to u + k * sinh(u) = q
+    k = 2 * (SampleType)Is / (a * nVt);
+    qScale = 1 / (a * nVt);
+
+    // Find where k sits in the 2D table
+    float kPosition = (std::log2((float)k) - KMinExponent) * KStepsPerOctave;
+    kPosition = std::fmin(std::fmax(kPosition, 0.0f), (float)(KTableSize - 1) - 1.0e-3f);
+
+    int row = (int)kPosition;
+    float frac = kPosition - row;
+
+    // Interpolate a 1D slice of solutions for the current k
+    const float* table = GetSolverTable();
+    const float* rowA = table + row * QTableSize;
+    const float* rowB = rowA + QTableSize;
+
+    for (int i = 0; i < QTableSize; i++)
+        solution[i] = rowA[i] + frac * (rowB[i] - rowA[i]);
+}
+
+void DiodeClipperSolver::Circuit::Mix(const Circuit& a, const Circuit& b, float amount, Circuit& result)
+{
+    auto mix = [amount](double x, double y) { return x + (y - x) * amount; };
+
+    result.SampleRate = a.SampleRate;
+    result.Drive = a.Drive + (b.Drive - a.Drive) * amount;
+
+    result.G3 = mix(a.G3, b.G3);
+    result.G4 = mix(a.G4, b.G4);
+    result.GIn = mix(a.GIn, b.GIn);
+    result.InvGIn = mix(a.InvGIn, b.InvGIn);
+    result.a = mix(a.a, b.a);
+    result.k = mix(a.k, b.k);
+    result.qScale = mix(a.qScale, b.qScale);
+
+    for (int i = 0; i < QTableSize; i++)
+        result.Solution[i] = a.Solution[i] + (b.Solution[i] - a.Solution[i]) * amount;
+}
+
+float DiodeClipperSolver::SolveNewton(float q, float k)
+{
+    // Start from whichever of the linear or fully conducting solutions is smaller, Newton then converges from below
+    double u = std::fmin((double)q, std::asinh((double)q / k));
+
+    for (int iteration = 0; iteration < 100; iteration++)
+    {
+        double f = u + k * std::sinh(u) - q;
+        double df = 1.0 + k * std::cosh(u);
+        double step = f / df;
+
+        u -= step;
+
+        if (std::fabs(step) < 1.0e-9)
+            break;
+    }
+
+    return (float)u;
+}
+
+const float* DiodeClipperSolver::GetSolverTable()
+{
+    // Built once on the first call and shared between all instances. This happens in the constructor of the processor, never on the audio thread.
+    static const std::unique_ptr<float[]> table = []()
+    {
+        std::unique_ptr<float[]> t(new float[KTableSize * QTableSize]);
+
+        for (int row = 0; row < KTableSize; row++)
+        {
+            float kRow = std::exp2((float)KMinExponent + (float)row / KStepsPerOctave);
+
+            for (int i = 0; i < QTableSize; i++)
+                t[row * QTableSize + i] = SolveNewton(QAtIndex(i), kRow);
+        }
+
+        return t;
+    }();
+
+    return table.get();
+}
+
+template class FloatDiodeClipper<float>;
+template class FloatDiodeClipper<double>;
@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+    DiodeClipper.h
+    Created: 19 Oct 2026 9:02:14am
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// The solver tables, shared by the float and double clippers so there is only ever one copy of the 2D grid.
+class DiodeClipperSolver
+{
+
+    protected:
+
+    // Solver table layout. q is indexed by its binary exponent and then linearly inside each octave, which follows the logarithmic growth of u
+    // without needing a log per sample. Below the first octave the diodes are not conducting and u = q / (1 + k) is used directly.
+    static constexpr int QMinExponent = -8;
+    static constexpr int QOctaves = 24;
+    static constexpr int QStepsPerOctave = 16;
+    static constexpr int QTableSize = QOctaves * QStepsPerOctave + 1;
+    static constexpr float QLinearLimit = 1.0f / 256.0f;     // 2^QMinExponent
+    static constexpr float QTableLimit = 65536.0f;           // 2^(QMinExponent + QOctaves)
+
+    // k is indexed logarithmically, it only changes with drive and sample rate
+    static constexpr int KMinExponent = -14;
+    static constexpr int KOctaves = 16;
+    static constexpr int KStepsPerOctave = 4;
+    static constexpr int KTableSize = KOctaves * KStepsPerOctave + 1;
+
+    // Solve u + k * sinh(u) = q for q >= 0 with Newton iterations, only used to build the tables
+    static float SolveNewton(float q, float k);
+
+    // Shared 2D grid of solutions, built once on first use
+    static const float* GetSolverTable();
+
+    // Value of q at a position along the table
+    static float QAtIndex(int i)
+    {
+        int octave = i / QStepsPerOctave;
+        float frac = (float)(i % QStepsPerOctave) / QStepsPerOctave;
+
+        return std::ldexp(1.0f + frac, QMinExponent + octave);
+    }
+
+    public:
+
+    // The discretised circuit and solver slice for one drive and sample rate. Working this out (a log and a slice interpolated from the table) is
+    // the costly part of changing the drive, so presets work it out ahead of time and load it with SetCircuit.
+    struct Circuit
+    {
+        float SampleRate = 0.0f;
+        float Drive = 0.0f;
+
+        double G3 = 0, G4 = 0, GIn = 0, InvGIn = 0, a = 0, k = 0, qScale = 0;
+        float Solution[QTableSize] = {};
+
+        // Mix two circuits, amount 0 is a and 1 is b. Every value is mixed linearly, so the result is a circuit between the two rather than
+        // exactly the circuit for the mixed drive.
+        static void Mix(const Circuit& a, const Circuit& b, float amount, Circuit& result);
+    };
+
+};
+
+// Circuit model of the Tube Screamer clipping stage. The op-amp is treated as ideal, so the input voltage appears across the R4/C3 branch to ground and the
+// current drawn through that branch must flow through the feedback network (Rf || C4 || anti-parallel diodes). Both capacitors are discretised with the
+// trapezoidal rule (DK-method companion models), which leaves one implicit equation per sample for the voltage across the diodes:
+//
+//      a * Vd + 2 * Is * sinh(Vd / nVt) = p
+//
+// Rather than running Newton iterations every sample, the equation is normalised to u + k * sinh(u) = q (u = Vd / nVt) and solved ahead of time over a
+// 2D grid of (k, q). k only depends on the drive and sample rate, so when either changes we interpolate a 1D slice of the grid for the current k, and the
+// per sample cost is a single interpolated table read.
+//
+// DiodeClipper runs in float and DiodeClipperDouble keeps the circuit and its state in double for hosts that process in double, the table of
+// solutions is float in both. Both are defined in DiodeClipper.cpp.
+template <typename SampleType>
+class FloatDiodeClipper : private DiodeClipperSolver
+{
+
+    public:
+
+    using Circuit = DiodeClipperSolver::Circuit;
+
+    // Ctor
+    FloatDiodeClipper();
+    // Dtor
+    ~FloatDiodeClipper();
+
+    // Initialise the clipper with the sample rate and drive (0 - 1)
+    void Init(float fs, float drive);
+
+    // Call to set the drive (0 - 1), this maps onto the drive pot in the feedback network
+    void SetDrive(float drive);
+
+    // Reset clipper state, recalculates the circuit if the sample rate has changed
+    void Reset(float fs);
+
+    // Get the circuit for the current drive and sample rate, or load one worked out ahead of time. A circuit for another sample rate is
+    // recalculated for this one from its drive.
+    void GetCircuit(Circuit& circuit) const;
+    void SetCircuit(const Circuit& circuit);
+
+    // Process a sample with the clipper
+    SampleType ProcessSample(SampleType xn);
+
+    private:
+
+    // Circuit component values
+    static constexpr float R4 = 4.7e3f;
+    static constexpr float C3 = 0.047e-6f;
+    static constexpr float C4 = 51e-12f;
+    static constexpr float RfMin = 51e3f;
+    static constexpr float DrivePot = 500e3f;
+
+    // 1N914 diode saturation current and emission coefficient * thermal voltage
+    static constexpr float Is = 2.52e-9f;
+    static constexpr float nVt = 1.752f * 0.02585f;
+
+    // Output scaling, brings the clipped output up to roughly the same level as the tanh clipper. Measured through the TS stage with a 220Hz sine
+    // at 0.5 - 1.0 peak and drive 0.25 - 1.0, the unscaled diode clipper is 2.47 - 3.19 times (7.9 - 10.1dB) quieter, and with this scale it is
+    // within 1.3dB. Quiet input that barely clips is still up to 12.7dB quieter than the tanh clipper, which clips much earlier.
+    static constexpr float OutputScale = 2.75f;
+
+    // Discretised circuit values
+    SampleType G3 = 0;    // Capacitor C3 companion conductance
+    SampleType G4 = 0;    // Capacitor C4 companion conductance
+    SampleType GIn = 0;   // Total conductance of the R4/C3 node
+    SampleType InvGIn = 0;
+    SampleType a = 0;     // Linear conductance seen by the diodes
+    SampleType k = 0;     // Normalised diode current
+    SampleType qScale = 0;
+
+    // State variables (companion model history currents)
+    SampleType h3 = 0;
+    SampleType h4 = 0;
+
+    // Parameters
+    float SampleRate = 0.0f;
+    float Drive = 0.0f;
+
+    // Solution of u + k * sinh(u) = q for the current k
+    float solution[QTableSize] = {};
+
+    // Calculate the discretised circuit and solver slice for the current parameters
+    void CalcCircuit();
+
+    // Look up u for a given q using the current slice, the equation is odd so negative values use the same table
+    SampleType LookupSolution(SampleType q) const
+    {
+        SampleType absq = std::fabs(q);
+
+        // Diodes not conducting, the equation is linear
+        if (absq < QLinearLimit)
+            return q / (1 + k);
+
+        // Beyond the table the linear term is negligible, so u = asinh(q / k)
+        if (absq >= QTableLimit)
+            return std::asinh(q / k);
+
+        // Read the binary exponent and mantissa straight from the float bits to find the octave and position inside it. Double takes them
+        // from frexp, which gives the mantissa in [0.5, 1).
+        int exponent;
+        SampleType mantissa;
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &absq, sizeof(bits));
+
+            exponent = (int)(bits >> 23) - 127;
+            mantissa = (float)(bits & 0x7fffff) * (1.0f / 8388608.0f);
+        }
+        else
+        {
+            mantissa = std::frexp(absq, &exponent) * 2 - 1;
+            exponent--;
+        }
+
+        SampleType position = (exponent - QMinExponent + mantissa) * QStepsPerOctave;
+        int index = (int)position;
+        SampleType frac = position - index;
+
+        SampleType u = solution[index] + frac * (solution[index + 1] - solution[index]);
+
+        return q < 0 ? -u : u;
+    }
+
+};
+
+// The two precisions, defined in DiodeClipper.cpp.
+using DiodeClipper = FloatDiodeClipper<float>;
+using DiodeClipperDouble = FloatDiodeClipper<double>;
+
+extern template class FloatDiodeClipper<float>;
+extern template class FloatDiodeClipper<double>;
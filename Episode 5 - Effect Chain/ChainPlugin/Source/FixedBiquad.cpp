@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    FixedBiquad.cpp
+    Created: 20 Oct 2026 11:02:37am
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include "FixedBiquad.h"
+
+FixedBiquad::FixedBiquad()
+{
+
+}
+
+FixedBiquad::~FixedBiquad()
+{
+
+}
+
+void FixedBiquad::Init(BiquadType filterType, float fc, float fs, float Q, float gain_dB)
+{
+    design.Init(filterType, fc, fs, Q, gain_dB);
+    quantiseCoefficients();
+}
+
+void FixedBiquad::SetParameters(float fc, float Q, float gain_dB)
+{
+    design.SetParameters(fc, Q, gain_dB);
+    quantiseCoefficients();
+}
+
+void FixedBiquad::SetFc(float fc)
+{
+    design.SetFc(fc);
+    quantiseCoefficients();
+}
+
+void FixedBiquad::SetGain(float gain_dB)
+{
+    design.SetGain(gain_dB);
+    quantiseCoefficients();
+}
+
+void FixedBiquad::Reset(float fs)
+{
+    // Reset filter state variables
+    yminustwo = yminusone = xminustwo = xminusone = 0;
+    quantisationError = 0;
+
+    design.Reset(fs);
+    quantiseCoefficients();
+}
+
+void FixedBiquad::quantiseCoefficients()
+{
+    float B0, B1, B2, A1, A2;
+    design.GetCoefficients(B0, B1, B2, A1, A2);
+
+    // Smallest shift that fits the largest coefficient, so the coefficients keep as many bits as they can.
+    float largest = std::max({ std::fabs(B0), std::fabs(B1), std::fabs(B2), std::fabs(A1), std::fabs(A2) });
+
+    coefficientShift = 0;
+
+    while (coefficientShift < MaxCoefficientShift && largest >= (float)(1 << coefficientShift))
+        coefficientShift++;
+
+    float scale = 1.0f / (float)(1 << coefficientShift);
+
+    b0 = FixedPoint::FromFloat<int32_t>(B0 * scale);
+    b1 = FixedPoint::FromFloat<int32_t>(B1 * scale);
+    b2 = FixedPoint::FromFloat<int32_t>(B2 * scale);
+    a1 = FixedPoint::FromFloat<int32_t>(A1 * scale);
+    a2 = FixedPoint::FromFloat<int32_t>(A2 * scale);
+}
+
+int32_t FixedBiquad::ProcessSampleQ31(int32_t xn)
+{
+    // Sum of the products, each one Q(62 - shift) dropped to Q(60 - shift), plus what was dropped from the last output.
+    int64_t accumulator = (((int64_t)b0 * xn) >> 2) + (((int64_t)b1 * xminusone) >> 2) + (((int64_t)b2 * xminustwo) >> 2)
+                        - (((int64_t)a1 * yminusone) >> 2) - (((int64_t)a2 * yminustwo) >> 2)
+                        + quantisationError;
+
+    // Back to Q31, keeping the dropped bits for the next sample. If the output clips the error is meaningless, so it is dropped.
+    int outputShift = 29 - coefficientShift;
+    int64_t wide = accumulator >> outputShift;
+    int32_t yn = FixedPoint::Saturate<int32_t>(wide);
+
+    quantisationError = yn == wide ? accumulator - wide * ((int64_t)1 << outputShift) : 0;
+
+    // Update input state variables
+    xminustwo = xminusone;
+    xminusone = xn;
+
+    // Update output state variables
+    yminustwo = yminusone;
+    yminusone = yn;
+
+    // Return current output sample
+    return yn;
+}
+
+void FixedBiquad::ProcessBlockQ31(int32_t* data, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+        data[sample] = ProcessSampleQ31(data[sample]);
+}
+
+float FixedBiquad::ProcessSample(float xn)
+{
+    return FixedPoint::ToFloat(ProcessSampleQ31(FixedPoint::FromFloat<int32_t>(xn)));
+}
+
+void FixedBiquad::ProcessBlock(float* data, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+        data[sample] = ProcessSample(data[sample]);
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    FixedBiquad.h
+    Created: 20 Oct 2026 11:02:37am
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include "Biquad.h"
+#include "FixedPoint.h"
+
+// Biquad with the same API running in Q31 fixed point, for hardware without an FPU. The design is still worked out by a float Biquad, which only
+// happens when a parameter changes, and the normalised coefficients are then quantised to Q31 with a shift, so coefficients up to +-2^7 fit
+// (a1 is close to -2 for low cutoffs, and shelves and peaks with gain have large b coefficients).
+//
+// Each sample accumulates the five products in 64 bits. The products are Q62 before the shift, and are dropped by two bits before adding so the
+// sum of five can never overflow. The accumulator is quantised back to Q31 with error feedback: the bits dropped from one output are added to the
+// next, which pushes the quantisation noise away from DC where low cutoff filters would otherwise amplify it.
+//
+// The float API converts at the edges and saturates at full scale, so leave headroom for filters with gain. The Q31 API is what a port runs.
+class FixedBiquad
+{
+
+public:
+
+    // C-tor
+    FixedBiquad();
+    // D-tor
+    ~FixedBiquad();
+
+    // Same as Biquad, the coefficients are quantised every time the design changes.
+    void Init(BiquadType filterType, float fc, float fs, float Q, float gain_dB);
+    void SetParameters(float fc, float Q, float gain_dB);
+    void SetFc(float fc);
+    void SetGain(float gain_dB);
+    void Reset(float fs);
+
+    // Float in and out, converted to Q31 and back.
+    float ProcessSample(float xn);
+    void ProcessBlock(float* data, int numSamples);
+
+    // Q31 in and out.
+    int32_t ProcessSampleQ31(int32_t xn);
+    void ProcessBlockQ31(int32_t* data, int numSamples);
+
+    // The coefficients are stored as c * 2^(31 - shift).
+    int GetCoefficientShift() const { return coefficientShift; }
+
+private:
+
+    // Largest shift, coefficients up to 2^MaxCoefficientShift in magnitude.
+    static constexpr int MaxCoefficientShift = 7;
+
+    // Float design, only used to calculate the coefficients.
+    Biquad design;
+
+    // Quantised coefficients, normalised by a0
+    int32_t b0 = 0;
+    int32_t b1 = 0;
+    int32_t b2 = 0;
+    int32_t a1 = 0;
+    int32_t a2 = 0;
+    int coefficientShift = 0;
+
+    // State variables, Q31
+    int32_t xminusone = 0;
+    int32_t xminustwo = 0;
+    int32_t yminusone = 0;
+    int32_t yminustwo = 0;
+
+    // Bits dropped when the last output was quantised.
+    int64_t quantisationError = 0;
+
+    // Quantise the current design's coefficients.
+    void quantiseCoefficients();
+};
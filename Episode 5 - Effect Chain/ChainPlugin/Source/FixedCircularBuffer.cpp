@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    FixedCircularBuffer.cpp
+    Created: 20 Oct 2026 11:02:37am
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include "FixedCircularBuffer.h"
+
+template <typename StorageType>
+FixedCircularBuffer<StorageType>::FixedCircularBuffer()
+{
+
+}
+
+template <typename StorageType>
+FixedCircularBuffer<StorageType>::~FixedCircularBuffer()
+{
+
+}
+
+template <typename StorageType>
+void FixedCircularBuffer<StorageType>::Init(int sr, float max_delay_time_ms)
+{
+    SampleRate = (float)sr;
+
+    // Same length as CircularBuffer, the next power of 2 above the longest delay, so indices wrap with a mask
+    unsigned int length = (unsigned int)((max_delay_time_ms / 1000) * SampleRate + 1);
+
+    buffer_length = 1;
+
+    while (buffer_length < length)
+        buffer_length <<= 1;
+
+    delaybuffer.reset(new StorageType[buffer_length]);
+
+    ClearBuffer();
+
+    WriteIndex = 0;
+}
+
+template <typename StorageType>
+void FixedCircularBuffer<StorageType>::ClearBuffer()
+{
+    for (unsigned int i = 0; i < buffer_length; i++)
+        delaybuffer[i] = 0;
+}
+
+template <typename StorageType>
+void FixedCircularBuffer<StorageType>::BufferWriteQ31(int32_t xn)
+{
+    WriteIndex = (WriteIndex + 1) & (buffer_length - 1);
+    delaybuffer[WriteIndex] = FixedPoint::FromQ31<StorageType>(xn);
+}
+
+template <typename StorageType>
+int32_t FixedCircularBuffer<StorageType>::BufferReadSamplesQ31(int delay_in_samples) const
+{
+    return readQ31(delay_in_samples);
+}
+
+template <typename StorageType>
+int32_t FixedCircularBuffer<StorageType>::BufferReadFractionalQ31(int32_t delay_in_samples_q16) const
+{
+    // Split the delay into whole samples and a 16 bit fraction, then interpolate linearly towards the older sample
+    int delay_int_samples = delay_in_samples_q16 >> 16;
+    int64_t t = delay_in_samples_q16 & 0xffff;
+
+    int32_t a = readQ31(delay_int_samples);
+    int32_t b = readQ31(delay_int_samples + 1);
+
+    return (int32_t)(a + ((((int64_t)b - a) * t) >> 16));
+}
+
+template <typename StorageType>
+void FixedCircularBuffer<StorageType>::BufferWrite(float xn)
+{
+    // Convert straight to the storage type so Q15 is only rounded once
+    WriteIndex = (WriteIndex + 1) & (buffer_length - 1);
+    delaybuffer[WriteIndex] = FixedPoint::FromFloat<StorageType>(xn);
+}
+
+template <typename StorageType>
+float FixedCircularBuffer<StorageType>::BufferRead(float delay_time_ms, bool interpolate_line)
+{
+    float delay_in_samples = (delay_time_ms / 1000) * SampleRate;
+
+    return interpolate_line ? BufferReadFractional(delay_in_samples) : BufferReadSamples((int)delay_in_samples);
+}
+
+template <typename StorageType>
+float FixedCircularBuffer<StorageType>::BufferReadSamples(int delay_in_samples)
+{
+    return FixedPoint::ToFloat(readQ31(delay_in_samples));
+}
+
+template <typename StorageType>
+float FixedCircularBuffer<StorageType>::BufferReadFractional(float delay_in_samples)
+{
+    int delay_int_samples = (int)delay_in_samples;
+    float t = delay_in_samples - delay_int_samples;
+
+    float a = FixedPoint::ToFloat(readQ31(delay_int_samples));
+    float b = FixedPoint::ToFloat(readQ31(delay_int_samples + 1));
+
+    return a * (1.0f - t) + (b * t);
+}
+
+template <typename StorageType>
+void FixedCircularBuffer<StorageType>::BufferReadBlock(int delay_in_samples, float* destination, int numSamples)
+{
+    // The first sample is the one BufferReadSamples would read now, and each one after it is one sample newer
+    for (int sample = 0; sample < numSamples; sample++)
+        destination[sample] = FixedPoint::ToFloat(readQ31(delay_in_samples - sample));
+}
+
+template <typename StorageType>
+void FixedCircularBuffer<StorageType>::BufferWriteBlock(const float* source, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+        BufferWrite(source[sample]);
+}
+
+template class FixedCircularBuffer<int16_t>;
+template class FixedCircularBuffer<int32_t>;
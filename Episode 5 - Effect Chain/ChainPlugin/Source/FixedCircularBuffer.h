@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    FixedCircularBuffer.h
+    Created: 20 Oct 2026 11:02:37am
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "FixedPoint.h"
+
+// CircularBuffer with the same API storing the delay line as integers, Q15 in an int16_t or Q31 in an int32_t. The Q15 line takes half the memory
+// of a float line, which is what makes long delays fit on a pedal, at the cost of a noise floor around -90 dBFS. The Q31 line is as large as the
+// float one and quieter than it.
+//
+// The float API converts at the edges and saturates at full scale. The Q31 API reads and writes Q31 whatever the storage type, and takes
+// fractional delays as 16.16 fixed point samples, so a port needs no float at all.
+template <typename StorageType>
+class FixedCircularBuffer
+{
+
+public:
+
+    // C-tor
+    FixedCircularBuffer();
+    // D-tor
+    ~FixedCircularBuffer();
+
+    // Same as CircularBuffer
+    void Init(int sr, float max_delay_time_ms);
+    void ClearBuffer();
+    void BufferWrite(float xn);
+    float BufferRead(float delay_time_ms, bool interpolate_line);
+    float BufferReadSamples(int delay_in_samples);
+    float BufferReadFractional(float delay_in_samples);
+    void BufferReadBlock(int delay_in_samples, float* destination, int numSamples);
+    void BufferWriteBlock(const float* source, int numSamples);
+
+    // Q31 in and out, the fractional delay is in 16.16 fixed point samples.
+    void BufferWriteQ31(int32_t xn);
+    int32_t BufferReadSamplesQ31(int delay_in_samples) const;
+    int32_t BufferReadFractionalQ31(int32_t delay_in_samples_q16) const;
+
+    // Memory used by the delay line.
+    size_t GetSizeInBytes() const { return (size_t)buffer_length * sizeof(StorageType); }
+
+private:
+
+    unsigned int WriteIndex = 0;
+    unsigned int buffer_length = 0;
+    float SampleRate = 0.0f;
+
+    std::unique_ptr<StorageType[]> delaybuffer = nullptr;
+
+    // Read one stored sample a number of samples behind the last write, as Q31.
+    int32_t readQ31(int delay_in_samples) const
+    {
+        return FixedPoint::ToQ31<StorageType>(delaybuffer[(WriteIndex - 1 - (unsigned int)delay_in_samples) & (buffer_length - 1)]);
+    }
+};
+
+// The two storage types, defined in FixedCircularBuffer.cpp.
+using CircularBufferQ15 = FixedCircularBuffer<int16_t>;
+using CircularBufferQ31 = FixedCircularBuffer<int32_t>;
+
+extern template class FixedCircularBuffer<int16_t>;
+extern template class FixedCircularBuffer<int32_t>;
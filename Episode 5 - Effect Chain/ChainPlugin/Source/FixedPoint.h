@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    FixedPoint.h
+    Created: 20 Oct 2026 11:02:37am
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Fractional fixed point formats for running the DSP on hardware without an FPU. A Q31 value is an int32_t holding x * 2^31 and a Q15 value is
+// an int16_t holding x * 2^15, so both cover -1 to just under 1. Everything here is integer only apart from the float conversions, which are only
+// used at the edges (the float APIs and coefficient design).
+namespace FixedPoint
+{
+    // Number of fractional bits of each storage type.
+    template <typename Type> struct Format;
+    template <> struct Format<int16_t> { static constexpr int FractionalBits = 15; };
+    template <> struct Format<int32_t> { static constexpr int FractionalBits = 31; };
+
+    // Clamp a wider value into the range of Type.
+    template <typename Type>
+    inline Type Saturate(int64_t x)
+    {
+        if (x > (int64_t)std::numeric_limits<Type>::max())
+            return std::numeric_limits<Type>::max();
+
+        if (x < (int64_t)std::numeric_limits<Type>::min())
+            return std::numeric_limits<Type>::min();
+
+        return (Type)x;
+    }
+
+    // Float to fixed point, rounded to nearest and saturated, so 1.0 becomes the largest value just under 1.
+    template <typename Type>
+    inline Type FromFloat(float x)
+    {
+        double scaled = std::round((double)x * (double)(int64_t(1) << Format<Type>::FractionalBits));
+
+        if (scaled >= (double)std::numeric_limits<Type>::max())
+            return std::numeric_limits<Type>::max();
+
+        if (scaled <= (double)std::numeric_limits<Type>::min())
+            return std::numeric_limits<Type>::min();
+
+        return (Type)scaled;
+    }
+
+    template <typename Type>
+    inline float ToFloat(Type x)
+    {
+        return (float)x * (1.0f / (float)(int64_t(1) << Format<Type>::FractionalBits));
+    }
+
+    // Between the two formats, Q31 to Q15 rounds to nearest.
+    inline int32_t Q15ToQ31(int16_t x)
+    {
+        return (int32_t)x * 65536;
+    }
+
+    inline int16_t Q31ToQ15(int32_t x)
+    {
+        return Saturate<int16_t>(((int64_t)x + 32768) >> 16);
+    }
+
+    // Convert a Q31 value to the storage type and back, so code can be written once for both storage types.
+    template <typename Type> inline Type FromQ31(int32_t x);
+    template <> inline int16_t FromQ31<int16_t>(int32_t x) { return Q31ToQ15(x); }
+    template <> inline int32_t FromQ31<int32_t>(int32_t x) { return x; }
+
+    template <typename Type> inline int32_t ToQ31(Type x);
+    template <> inline int32_t ToQ31<int16_t>(int16_t x) { return Q15ToQ31(x); }
+    template <> inline int32_t ToQ31<int32_t>(int32_t x) { return x; }
+}
@@ -0,0 +1,495 @@
+/*
+  ==============================================================================
+
+    Modulation.cpp
+    Created: 20 Oct 2026 10:24:17pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <cmath>
+#include "Modulation.h"
+
+namespace
+{
+    // Taylor series of sin(2 pi x) up to x^11, each term from the one before. Within a quarter of a cycle of 0 it is good to about 6e-8, below
+    // float's own rounding.
+    static constexpr double TwoPiSquared = 6.283185307179586 * 6.283185307179586;
+    static constexpr double SineC1 = 6.283185307179586;
+    static constexpr double SineC3 = SineC1 * -TwoPiSquared / 6.0;
+    static constexpr double SineC5 = SineC3 * -TwoPiSquared / 20.0;
+    static constexpr double SineC7 = SineC5 * -TwoPiSquared / 42.0;
+    static constexpr double SineC9 = SineC7 * -TwoPiSquared / 72.0;
+    static constexpr double SineC11 = SineC9 * -TwoPiSquared / 110.0;
+
+    // Fastest a voice may run, as a share of the sample rate. It keeps every voice at least four samples a cycle, so the smooth random voices
+    // can always be run in chunks that wrap at most once.
+    static constexpr float MaxIncrement = 0.25f;
+
+    // Runs each group of four voices over the block, one sample at a time with the voices in the lanes of one batch. Every shape is worked out
+    // in every lane and weighted, it is only a few multiplies each and keeps the lanes free of branches.
+    //
+    // The phase of each sample is the phase at the start of the call, or of the lane's last wrap, plus the samples since times the increment.
+    // Adding the increment on every sample instead would round on every sample, and the error adds up to a rate several percent out for a slow
+    // LFO, where the increment is tiny next to the phase.
+    struct LfoKernel
+    {
+        using Function = void (*)(const float*, const float*, const float*, float*, float*, int, int, float*, int);
+
+        template <typename Ops>
+        static void Process(const float* phase, const float* increment, const float* weights, float* random, float* wraps, int numGroups, int numSamples,
+                            float* output, int stride)
+        {
+            using Q = Simd::QuadOps<Ops>;
+            using Batch = typename Q::Batch;
+
+            const Batch zero = Q::Set(0.0f);
+            const Batch one = Q::Set(1.0f);
+            const Batch half = Q::Set(0.5f);
+            const Batch quarter = Q::Set(0.25f);
+
+            for (int group = 0; group < numGroups; group++)
+            {
+                int lane = group * 4;
+
+                Batch base = Q::Load(phase + lane);
+                Batch count = zero;
+                Batch p = base;
+                Batch step = Q::Load(increment + lane);
+                Batch sineWeight = Q::Load(weights + lane);
+                Batch triangleWeight = Q::Load(weights + LfoBank::MaxVoices + lane);
+                Batch randomWeight = Q::Load(weights + 2 * LfoBank::MaxVoices + lane);
+                Batch from = Q::Load(random + lane);
+                Batch to = Q::Load(random + LfoBank::MaxVoices + lane);
+                Batch next = Q::Load(random + 2 * LfoBank::MaxVoices + lane);
+                Batch wrapped = Q::Load(wraps + lane);
+
+                for (int sample = 0; sample < numSamples; sample++)
+                {
+                    // Sine, the phase brought to within half a cycle of 0 and then folded into the quarter either side of it.
+                    Batch x = Q::Sub(p, Q::Round(p));
+                    x = Q::Min(x, Q::Sub(half, x));
+                    x = Q::Max(x, Q::Sub(Q::Sub(zero, half), x));
+
+                    Batch x2 = Q::Mul(x, x);
+                    Batch sine = Q::Fma(x2, Q::Set((float)SineC11), Q::Set((float)SineC9));
+                    sine = Q::Fma(x2, sine, Q::Set((float)SineC7));
+                    sine = Q::Fma(x2, sine, Q::Set((float)SineC5));
+                    sine = Q::Fma(x2, sine, Q::Set((float)SineC3));
+                    sine = Q::Fma(x2, sine, Q::Set((float)SineC1));
+                    sine = Q::Mul(sine, x);
+
+                    // Triangle, 1 less four times the distance from the peak a quarter of the way through the cycle.
+                    Batch t = Q::Sub(p, quarter);
+                    t = Q::Sub(t, Q::Round(t));
+                    t = Q::Max(t, Q::Sub(zero, t));
+                    Batch triangle = Q::Sub(one, Q::Mul(Q::Set(4.0f), t));
+
+                    // Smooth random, eased from one value to the next with 3p^2 - 2p^3.
+                    Batch ease = Q::Mul(Q::Mul(p, p), Q::Sub(Q::Set(3.0f), Q::Add(p, p)));
+                    Batch smooth = Q::Fma(Q::Sub(to, from), ease, from);
+
+                    Batch value = Q::Fma(sineWeight, sine, Q::Fma(triangleWeight, triangle, Q::Mul(randomWeight, smooth)));
+                    Q::Store(output + sample * stride + lane, value);
+
+                    // Move on, and wrap any lane that has finished its cycle on to its next random value. A wrapped lane counts on from
+                    // where it wrapped.
+                    count = Q::Add(count, one);
+                    p = Q::Fma(count, step, base);
+
+                    auto running = Q::Less(p, one);
+                    p = Q::Select(running, p, Q::Sub(p, one));
+                    base = Q::Select(running, base, p);
+                    count = Q::Select(running, count, zero);
+                    from = Q::Select(running, from, to);
+                    to = Q::Select(running, to, next);
+                    wrapped = Q::Add(wrapped, Q::Select(running, zero, one));
+                }
+
+                Q::Store(random + lane, from);
+                Q::Store(random + LfoBank::MaxVoices + lane, to);
+                Q::Store(wraps + lane, wrapped);
+            }
+        }
+    };
+
+    // Runs each group of four channels over the block, the rectified input eased towards with the attack coefficient while it is above the
+    // envelope and the release coefficient while it is below.
+    struct FollowerKernel
+    {
+        using Function = void (*)(const float*, const float*, const float*, float*, int, int, float*, int);
+
+        template <typename Ops>
+        static void Process(const float* input, const float* attack, const float* release, float* levels, int numGroups, int numSamples,
+                            float* output, int stride)
+        {
+            using Q = Simd::QuadOps<Ops>;
+            using Batch = typename Q::Batch;
+
+            const Batch zero = Q::Set(0.0f);
+
+            for (int group = 0; group < numGroups; group++)
+            {
+                int lane = group * 4;
+
+                Batch a = Q::Load(attack + lane);
+                Batch r = Q::Load(release + lane);
+                Batch level = Q::Load(levels + lane);
+
+                for (int sample = 0; sample < numSamples; sample++)
+                {
+                    Batch x = Q::Load(input + sample * stride + lane);
+                    x = Q::Max(x, Q::Sub(zero, x));
+
+                    Batch coefficient = Q::Select(Q::Less(level, x), a, r);
+                    level = Q::Fma(coefficient, Q::Sub(x, level), level);
+
+                    Q::Store(output + sample * stride + lane, level);
+                }
+
+                Q::Store(levels + lane, level);
+            }
+        }
+    };
+
+    // One pole coefficient that gets 63% of the way to a new level in ms.
+    float onePoleCoefficient(float ms, double sampleRate)
+    {
+        double samples = ms * 0.001 * sampleRate;
+        return samples > 1.0 ? (float)(1.0 - std::exp(-1.0 / samples)) : 1.0f;
+    }
+}
+
+//==============================================================================
+LfoBank::LfoBank()
+{
+    lfoKernel = Simd::Dispatch<LfoKernel>();
+
+    updateVoice(0);
+    Reset();
+}
+
+LfoBank::~LfoBank()
+{
+
+}
+
+void LfoBank::Prepare(double sampleRate, int numVoices, int maxBlockSize)
+{
+    // Save parameters
+    SampleRate = sampleRate;
+    NumVoices = juce::jlimit(1, MaxVoices, numVoices);
+    NumGroups = (NumVoices + 3) / 4;
+
+    Output.assign((size_t)(GetStride() * juce::jmax(1, maxBlockSize)), 0.0f);
+
+    // Voices above the count are silent lanes.
+    for (int voice = 0; voice < MaxVoices; voice++)
+    {
+        if (voice < NumVoices)
+        {
+            updateVoice(voice);
+        }
+        else
+        {
+            Increment[voice] = 0.0;
+            Step[voice] = 0.0f;
+
+            for (int shape = 0; shape < 3; shape++)
+                Weights[shape][voice] = 0.0f;
+        }
+    }
+
+    Reset();
+}
+
+void LfoBank::Reset()
+{
+    Generator.setSeed(Seed);
+
+    for (int voice = 0; voice < NumVoices; voice++)
+    {
+        Phase[voice] = Voices[voice].PhaseOffset;
+        Wraps[voice] = 0.0f;
+
+        for (int i = 0; i < 3; i++)
+            Random[i][voice] = Generator.nextFloat() * 2.0f - 1.0f;
+    }
+}
+
+void LfoBank::SetShape(int voice, Shape shape)
+{
+    jassert(juce::isPositiveAndBelow(voice, MaxVoices));
+
+    Voices[voice].VoiceShape = shape;
+    updateVoice(voice);
+}
+
+void LfoBank::SetRate(int voice, float hz)
+{
+    jassert(juce::isPositiveAndBelow(voice, MaxVoices));
+
+    Voices[voice].RateHz = juce::jmax(0.0f, hz);
+    Voices[voice].BeatsPerCycle = 0.0;
+    updateVoice(voice);
+}
+
+void LfoBank::SetSync(int voice, double beatsPerCycle)
+{
+    jassert(juce::isPositiveAndBelow(voice, MaxVoices));
+
+    Voices[voice].BeatsPerCycle = juce::jmax(0.0, beatsPerCycle);
+    updateVoice(voice);
+}
+
+void LfoBank::SetPhaseOffset(int voice, float phase)
+{
+    jassert(juce::isPositiveAndBelow(voice, MaxVoices));
+
+    Voices[voice].PhaseOffset = phase - std::floor(phase);
+}
+
+void LfoBank::SetSeed(juce::int64 seed)
+{
+    Seed = seed;
+}
+
+void LfoBank::SetTempo(double bpm)
+{
+    if (bpm <= 0.0 || bpm == Bpm)
+        return;
+
+    Bpm = bpm;
+
+    for (int voice = 0; voice < NumVoices; voice++)
+        if (Voices[voice].BeatsPerCycle > 0.0)
+            updateVoice(voice);
+}
+
+void LfoBank::SyncToPosition(double ppqPosition)
+{
+    for (int voice = 0; voice < NumVoices; voice++)
+    {
+        if (Voices[voice].BeatsPerCycle <= 0.0)
+            continue;
+
+        double cycles = ppqPosition / Voices[voice].BeatsPerCycle + Voices[voice].PhaseOffset;
+        double phase = cycles - std::floor(cycles);
+
+        // A correction back by more than half a cycle is the voice being a little behind a wrap it should already have made, and one forward by
+        // more than half a cycle is the voice having wrapped a little early, which waits at the start of its new cycle rather than going back
+        // over the wrap.
+        if (Voices[voice].VoiceShape == Shape::SmoothRandom)
+        {
+            if (phase < Phase[voice] - 0.5)
+                nextRandom(voice);
+            else if (phase > Phase[voice] + 0.5)
+                phase = 0.0;
+        }
+
+        Phase[voice] = phase;
+    }
+}
+
+void LfoBank::SyncToPlayHead(juce::AudioPlayHead* playHead)
+{
+    if (playHead == nullptr)
+        return;
+
+    if (auto position = playHead->getPosition())
+    {
+        if (auto bpm = position->getBpm())
+            SetTempo(*bpm);
+
+        if (position->getIsPlaying())
+            if (auto ppq = position->getPpqPosition())
+                SyncToPosition(*ppq);
+    }
+}
+
+const float* LfoBank::Process(int numSamples)
+{
+    int stride = GetStride();
+    numSamples = juce::jlimit(0, (int)Output.size() / stride, numSamples);
+
+    // A smooth random voice can only take its next value from the kernel once per call, so run in chunks short enough that none of them wraps
+    // twice.
+    int chunk = juce::jmax(1, numSamples);
+
+    if (AnyRandom)
+        for (int voice = 0; voice < NumVoices; voice++)
+            if (Voices[voice].VoiceShape == Shape::SmoothRandom && Increment[voice] > 0.0)
+                chunk = juce::jmin(chunk, juce::jmax(1, (int)(1.0 / Increment[voice]) - 1));
+
+    for (int start = 0; start < numSamples; start += chunk)
+    {
+        int length = juce::jmin(chunk, numSamples - start);
+
+        loadStartPhases();
+        lfoKernel(StartPhase, Step, &Weights[0][0], &Random[0][0], Wraps, NumGroups, length, Output.data() + start * stride, stride);
+        advancePhases(length);
+        drawWrapped();
+    }
+
+    return Output.data();
+}
+
+const float* LfoBank::ProcessBlock(int numSamples)
+{
+    // The value at the start of the block is the kernel run for one sample without moving on.
+    loadStartPhases();
+    lfoKernel(StartPhase, Zero, &Weights[0][0], &Random[0][0], Wraps, NumGroups, 1, BlockValues, GetStride());
+
+    // Then move every voice on by the whole block, which may be many cycles.
+    for (int voice = 0; voice < NumVoices; voice++)
+    {
+        double phase = Phase[voice] + Increment[voice] * numSamples;
+        double wraps = std::floor(phase);
+
+        Phase[voice] = phase - wraps;
+
+        // Past two wraps both random values it eases between are new, so there is no need to draw any more.
+        for (int i = 0; i < juce::jmin(2, (int)wraps); i++)
+            nextRandom(voice);
+    }
+
+    return BlockValues;
+}
+
+void LfoBank::updateVoice(int voice)
+{
+    const Voice& v = Voices[voice];
+
+    double hz = v.BeatsPerCycle > 0.0 ? Bpm / 60.0 / v.BeatsPerCycle : v.RateHz;
+    Increment[voice] = juce::jlimit(0.0, (double)MaxIncrement, hz / SampleRate);
+    Step[voice] = (float)Increment[voice];
+
+    Weights[0][voice] = v.VoiceShape == Shape::Sine ? 1.0f : 0.0f;
+    Weights[1][voice] = v.VoiceShape == Shape::Triangle ? 1.0f : 0.0f;
+    Weights[2][voice] = v.VoiceShape == Shape::SmoothRandom ? 1.0f : 0.0f;
+
+    AnyRandom = false;
+
+    for (int i = 0; i < NumVoices; i++)
+        AnyRandom = AnyRandom || Voices[i].VoiceShape == Shape::SmoothRandom;
+}
+
+void LfoBank::loadStartPhases()
+{
+    // A phase a hair under a whole cycle rounds up to 1 as a float, which the kernel would wrap before it had run a sample.
+    static const float LastBeforeWrap = std::nextafter(1.0f, 0.0f);
+
+    for (int voice = 0; voice < NumVoices; voice++)
+        StartPhase[voice] = juce::jmin((float)Phase[voice], LastBeforeWrap);
+}
+
+void LfoBank::advancePhases(int numSamples)
+{
+    for (int voice = 0; voice < NumVoices; voice++)
+    {
+        double phase = Phase[voice] + Increment[voice] * numSamples - Wraps[voice];
+
+        // The kernel's float phase and this one can only disagree about a wrap right at the end of a cycle. Where this one has wrapped and the
+        // kernel hasn't, the voice moves on to its next cycle here, and where the kernel has and this one hasn't, it waits at the start.
+        if (phase >= 1.0)
+        {
+            phase -= 1.0;
+
+            if (Voices[voice].VoiceShape == Shape::SmoothRandom)
+                nextRandom(voice);
+        }
+
+        Phase[voice] = juce::jmax(0.0, phase);
+    }
+}
+
+void LfoBank::nextRandom(int voice)
+{
+    Random[0][voice] = Random[1][voice];
+    Random[1][voice] = Random[2][voice];
+    Random[2][voice] = Generator.nextFloat() * 2.0f - 1.0f;
+}
+
+void LfoBank::drawWrapped()
+{
+    // The kernel has already moved a wrapped lane on to its next value, so only the one after that is new.
+    for (int voice = 0; voice < NumVoices; voice++)
+    {
+        if (Wraps[voice] > 0.0f)
+        {
+            Random[2][voice] = Generator.nextFloat() * 2.0f - 1.0f;
+            Wraps[voice] = 0.0f;
+        }
+    }
+}
+
+//==============================================================================
+EnvelopeFollower::EnvelopeFollower()
+{
+    followerKernel = Simd::Dispatch<FollowerKernel>();
+
+    updateCoefficients();
+}
+
+EnvelopeFollower::~EnvelopeFollower()
+{
+
+}
+
+void EnvelopeFollower::Prepare(double sampleRate, int numChannels, int maxBlockSize)
+{
+    // Save parameters
+    SampleRate = sampleRate;
+    NumChannels = juce::jlimit(1, MaxChannels, numChannels);
+    NumGroups = (NumChannels + 3) / 4;
+
+    // Lanes above the channel count are never written, so they follow silence.
+    Input.assign((size_t)(GetStride() * juce::jmax(1, maxBlockSize)), 0.0f);
+    Output.assign(Input.size(), 0.0f);
+
+    updateCoefficients();
+    Reset();
+}
+
+void EnvelopeFollower::Reset()
+{
+    std::fill(Levels, Levels + MaxChannels, 0.0f);
+}
+
+void EnvelopeFollower::SetTimes(float attackMs, float releaseMs)
+{
+    AttackMs = attackMs;
+    ReleaseMs = releaseMs;
+
+    updateCoefficients();
+}
+
+void EnvelopeFollower::updateCoefficients()
+{
+    for (int channel = 0; channel < MaxChannels; channel++)
+    {
+        Attack[channel] = onePoleCoefficient(AttackMs, SampleRate);
+        Release[channel] = onePoleCoefficient(ReleaseMs, SampleRate);
+    }
+}
+
+template <typename SampleType>
+const float* EnvelopeFollower::Process(const SampleType* const* input, int numSamples)
+{
+    int stride = GetStride();
+    numSamples = juce::jlimit(0, (int)Input.size() / stride, numSamples);
+
+    // Interleave the channels so each sample of a group loads as a batch.
+    for (int channel = 0; channel < NumChannels; channel++)
+        for (int sample = 0; sample < numSamples; sample++)
+            Input[(size_t)(sample * stride + channel)] = (float)input[channel][sample];
+
+    followerKernel(Input.data(), Attack, Release, Levels, NumGroups, numSamples, Output.data(), stride);
+
+    return Output.data();
+}
+
+template const float* EnvelopeFollower::Process<float>(const float* const*, int);
+template const float* EnvelopeFollower::Process<double>(const double* const*, int);
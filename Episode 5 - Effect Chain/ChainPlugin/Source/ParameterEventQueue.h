@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    ParameterEventQueue.h
+    Created: 19 Oct 2026 2:17:36pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <JuceHeader.h>
+
+// Lock-free queue of timestamped parameter changes, drained by processBlock so the block can be split at the sample each change lands on.
+//
+// Parameter changes are picked up through the parameter listener callback, which can be called from any thread (host automation, the editor, the
+// message thread), so the queue is a bounded multi-producer/single-consumer ring with a sequence number per cell. JUCE does not pass the host's sample
+// offsets for automation, and hosts usually deliver it on the audio thread just before processBlock, so listener events land at the start of the next
+// block, where the parameters used to be read. Automation from a plugin host is therefore only block accurate. Callers that know the exact sample
+// offset, such as the offline tools through the processors' scheduleParameterChange, push the change with PushParameterChange and the block is
+// split at that sample.
+class ParameterEventQueue : public juce::AudioProcessorParameter::Listener
+{
+
+public:
+
+    // Maximum number of events between two blocks, anything beyond this is dropped and the queue reports an overflow.
+    static constexpr int Capacity = 256;
+
+    // Maximum number of parameters that can be listened to.
+    static constexpr int MaxParameters = 64;
+
+    // A parameter change for the current block. Slot is the index the parameter was given in the ParameterSnapshot.
+    struct Event
+    {
+        int Slot = 0;
+        float Value = 0.0f;
+        int SampleOffset = 0;
+    };
+
+    // C-tor
+    ParameterEventQueue()
+    {
+        for (int i = 0; i < Capacity; i++)
+            cells[i].Sequence.store((size_t)i, std::memory_order_relaxed);
+
+        for (int i = 0; i < MaxParameters; i++)
+            slotForParameter[i] = -1;
+    }
+
+    // D-tor
+    ~ParameterEventQueue() override
+    {
+        for (int i = 0; i < MaxParameters; i++)
+            if (listenedParameters[i] != nullptr)
+                listenedParameters[i]->removeListener(this);
+    }
+
+    // Listen to a parameter, call from the processor constructor after the parameter has been added to the processor.
+    void Listen(juce::RangedAudioParameter* parameter, int slot)
+    {
+        int index = parameter->getParameterIndex();
+
+        jassert(index >= 0 && index < MaxParameters);
+
+        listenedParameters[index] = parameter;
+        slotForParameter[index] = slot;
+
+        parameter->addListener(this);
+    }
+
+    // Change a listened parameter at a known sample offset into the next block, value is normalised (0 - 1). The parameter is set without
+    // notifying its listeners, so it holds the new value for the host and the state straight away while the queue only sees the change once, at
+    // its offset. Call from the thread that calls BeginBlock, between blocks. Returns false if the parameter is not listened to or the queue is full.
+    bool PushParameterChange(int parameterIndex, float normalisedValue, int sampleOffset)
+    {
+        if (parameterIndex < 0 || parameterIndex >= MaxParameters || slotForParameter[parameterIndex] < 0)
+            return false;
+
+        juce::RangedAudioParameter* parameter = listenedParameters[parameterIndex];
+        parameter->setValue(normalisedValue);
+
+        return Push({ slotForParameter[parameterIndex], parameter->convertFrom0to1(normalisedValue), sampleOffset });
+    }
+
+    // Drop anything still queued, call from prepareToPlay.
+    void Reset()
+    {
+        PendingEvent event;
+
+        while (Pop(event)) {}
+
+        numEvents = 0;
+        overflowed.store(false);
+    }
+
+    // Drain everything pushed since the last block and work out where each event lands in a block of numSamples. Returns false if events were
+    // dropped since the last block, in which case the caller should read every parameter directly. The block then has no events, the ones that
+    // were kept are the oldest and would leave the parameters on stale values.
+    bool BeginBlock(int numSamples)
+    {
+        numEvents = 0;
+
+        PendingEvent pending;
+
+        while (Pop(pending))
+        {
+            Event event { pending.Slot, pending.Value, juce::jlimit(0, juce::jmax(0, numSamples - 1), pending.SampleOffset) };
+
+            // Insert in sample order, events at the same sample keep their arrival order.
+            int position = numEvents++;
+
+            while (position > 0 && events[position - 1].SampleOffset > event.SampleOffset)
+            {
+                events[position] = events[position - 1];
+                position--;
+            }
+
+            events[position] = event;
+        }
+
+        if (overflowed.exchange(false))
+        {
+            numEvents = 0;
+            return false;
+        }
+
+        return true;
+    }
+
+    // Events for the current block, in sample order.
+    int GetNumEvents() const { return numEvents; }
+    const Event& GetEvent(int index) const { return events[index]; }
+
+    // Parameter listener, called from whichever thread changed the parameter.
+    void parameterValueChanged(int parameterIndex, float newValue) override
+    {
+        if (parameterIndex < 0 || parameterIndex >= MaxParameters || slotForParameter[parameterIndex] < 0)
+            return;
+
+        float value = listenedParameters[parameterIndex]->convertFrom0to1(newValue);
+
+        Push({ slotForParameter[parameterIndex], value, 0 });
+    }
+
+    void parameterGestureChanged(int, bool) override {}
+
+private:
+
+    // Listener events have no sample offset of their own and are pushed at 0, PushParameterChange gives its own.
+    struct PendingEvent
+    {
+        int Slot;
+        float Value;
+        int SampleOffset;
+    };
+
+    struct Cell
+    {
+        std::atomic<size_t> Sequence;
+        PendingEvent Data;
+    };
+
+    // Ring of cells, each cell's sequence number tells producers and the consumer whose turn it is.
+    Cell cells[Capacity];
+    std::atomic<size_t> enqueuePosition { 0 };
+    size_t dequeuePosition = 0;
+    std::atomic<bool> overflowed { false };
+
+    // Events for the current block, only touched by the audio thread.
+    Event events[Capacity];
+    int numEvents = 0;
+
+    juce::RangedAudioParameter* listenedParameters[MaxParameters] = {};
+    int slotForParameter[MaxParameters];
+
+    // Claim the next cell and write the event into it. Safe to call from any number of threads.
+    bool Push(const PendingEvent& event)
+    {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Cell& cell = cells[position % Capacity];
+            size_t sequence = cell.Sequence.load(std::memory_order_acquire);
+            auto difference = (std::ptrdiff_t)sequence - (std::ptrdiff_t)position;
+
+            if (difference == 0)
+            {
+                // Cell is free, try to claim it
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.Data = event;
+                    cell.Sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                // Queue is full
+                overflowed.store(true);
+                return false;
+            }
+            else
+            {
+                // Another producer claimed this cell, try again from the latest position
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Read the oldest event, only called from the audio thread.
+    bool Pop(PendingEvent& event)
+    {
+        Cell& cell = cells[dequeuePosition % Capacity];
+        size_t sequence = cell.Sequence.load(std::memory_order_acquire);
+
+        if ((std::ptrdiff_t)sequence - (std::ptrdiff_t)(dequeuePosition + 1) < 0)
+            return false;
+
+        event = cell.Data;
+        cell.Sequence.store(dequeuePosition + Capacity, std::memory_order_release);
+        dequeuePosition++;
+
+        return true;
+    }
+
+};
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    PerformanceEditor.h
+    Created: 19 Oct 2026 8:46:30pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PerformanceMonitor.h"
+#include "SpectrumView.h"
+#include "PresetControls.h"
+
+// The generic parameter editor with the performance monitor's figures underneath, so the instance causing a glitch can be picked out of a session.
+// A plugin with settings that are not parameters can pass its own controls, which go between the two at the height they were created with, and a
+// plugin with a spectrum analyser tap can pass that to show its output spectrum under the parameters. A plugin with a preset bank can pass itself to
+// get the preset controls above its own.
+class PerformanceEditor : public juce::AudioProcessorEditor, private juce::Timer
+{
+
+public:
+
+    // C-tor
+    PerformanceEditor(juce::AudioProcessor& processor, PerformanceMonitor& monitor, std::unique_ptr<juce::Component> extraControls = nullptr,
+                      SpectrumAnalyser* analyser = nullptr, PresetBankOwner* presetOwner = nullptr);
+    // D-tor
+    ~PerformanceEditor() override;
+
+    void resized() override;
+
+private:
+
+    juce::GenericAudioProcessorEditor parameterEditor;
+    PerformanceMonitor& performanceMonitor;
+    std::unique_ptr<juce::Component> controls;
+    std::unique_ptr<SpectrumView> spectrum;
+    std::unique_ptr<PresetControls> presets;
+
+    juce::Label statsLabel;
+    juce::TextButton resetButton { "Reset" };
+
+    static constexpr int statsHeight = 64;
+    static constexpr int spectrumHeight = 140;
+    static constexpr int resetButtonWidth = 60;
+
+    // Refresh the figures from the monitor's latest summary.
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PerformanceEditor)
+};
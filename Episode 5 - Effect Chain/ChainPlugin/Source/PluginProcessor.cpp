@@ -0,0 +1,412 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+
+// The plugin wrapper defines the plugin name from the .jucer, the headless tools build this file without it.
+#ifndef JucePlugin_Name
+ #define JucePlugin_Name "ChainPlugin"
+#endif
+
+//==============================================================================
+ChainPluginAudioProcessor::ChainPluginAudioProcessor()
+#ifndef JucePlugin_PreferredChannelConfigurations
+     : AudioProcessor (BusesProperties()
+                     #if ! JucePlugin_IsMidiEffect
+                      #if ! JucePlugin_IsSynth
+                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                      #endif
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                     #endif
+                       ) ,treestate(*this, nullptr, "PARAMETERS",
+                           {
+                               // Tube Screamer
+                               std::make_unique<AudioParameterFloat>(ParameterID{"DRIVE", 1}, "Drive", NormalisableRange<float>(0.0f, 1.0f), 0.5f)
+                               ,std::make_unique<AudioParameterFloat>(ParameterID{"TONE", 1}, "Tone", NormalisableRange<float>(0.0f, 1.0f), 0.5f)
+                               ,std::make_unique<AudioParameterFloat>(ParameterID{"LEVEL", 1}, "Level", NormalisableRange<float>(0.0f, 1.0f), 0.5f)
+                               ,std::make_unique<AudioParameterChoice>(ParameterID{"CLIPPER", 1}, "Clipper", StringArray("Tanh", "Diode"), 0)
+
+                               // Delay
+                               ,std::make_unique<AudioParameterFloat>(ParameterID{"MASTER", 1}, "Master", NormalisableRange<float>(0.0f, 1.0f), 0.5f)
+                               ,std::make_unique<AudioParameterFloat>(ParameterID{"MIX", 1}, "Mix", NormalisableRange<float>(0.0f, 1.0f), 0.5f)
+                               ,std::make_unique<AudioParameterFloat>(ParameterID{"FEEDBACK", 1}, "Feedback", NormalisableRange<float>(0.0f, 1.0f), 0.5f)
+                               ,std::make_unique<AudioParameterFloat>(ParameterID{"DELAYTIMEMS", 1}, "DelayTimeMs", NormalisableRange<float>(20.0f, 2000.0f), 100.0f)
+                               ,std::make_unique<AudioParameterBool>(ParameterID{"PINGPONGENABLED", 1}, "PingPongEnabled", false)
+                               ,std::make_unique<AudioParameterBool>(ParameterID{"SYNCENABLED", 1}, "SyncEnabled", false)
+                               ,std::make_unique<AudioParameterChoice>(ParameterID{"SYNCSETTING", 1}, "SyncSetting", StringArray{ "1/1", "1/1D", "1/1T", "1/2", "1/2D", "1/2T", "1/4", "1/4D", "1/4T", "1/8", "1/8D", "1/8T", "1/16", "1/16D", "1/16T", "1/32"}, 0)
+                           })
+#endif
+{
+    // Bind our parameters once, after this the audio thread never has to look them up by name.
+    DriveParameter = parameters.Bind(treestate.getParameter("DRIVE"), true);
+    ToneParameter = parameters.Bind(treestate.getParameter("TONE"), true);
+    LevelParameter = parameters.Bind(treestate.getParameter("LEVEL"), true);
+    ClipperParameter = parameters.Bind(treestate.getParameter("CLIPPER"), false);
+    MasterParameter = parameters.Bind(treestate.getParameter("MASTER"), true);
+    MixParameter = parameters.Bind(treestate.getParameter("MIX"), true);
+    FeedbackParameter = parameters.Bind(treestate.getParameter("FEEDBACK"), true);
+    DelayTimeParameter = parameters.Bind(treestate.getParameter("DELAYTIMEMS"), false);
+    PingPongParameter = parameters.Bind(treestate.getParameter("PINGPONGENABLED"), false);
+    SyncEnabledParameter = parameters.Bind(treestate.getParameter("SYNCENABLED"), false);
+    SyncSettingParameter = parameters.Bind(treestate.getParameter("SYNCSETTING"), false);
+    parameters.Prepare(48000, 512);
+
+    // Listen for changes to every bound parameter so they can be applied at the right sample.
+    events.Listen(treestate.getParameter("DRIVE"), DriveParameter);
+    events.Listen(treestate.getParameter("TONE"), ToneParameter);
+    events.Listen(treestate.getParameter("LEVEL"), LevelParameter);
+    events.Listen(treestate.getParameter("CLIPPER"), ClipperParameter);
+    events.Listen(treestate.getParameter("MASTER"), MasterParameter);
+    events.Listen(treestate.getParameter("MIX"), MixParameter);
+    events.Listen(treestate.getParameter("FEEDBACK"), FeedbackParameter);
+    events.Listen(treestate.getParameter("DELAYTIMEMS"), DelayTimeParameter);
+    events.Listen(treestate.getParameter("PINGPONGENABLED"), PingPongParameter);
+    events.Listen(treestate.getParameter("SYNCENABLED"), SyncEnabledParameter);
+    events.Listen(treestate.getParameter("SYNCSETTING"), SyncSettingParameter);
+
+    channelPointers.resize(2);
+
+    performance.SetName(getName());
+    performance.SetStageName(0, "TS");
+    performance.SetStageName(1, "Delay");
+}
+
+ChainPluginAudioProcessor::~ChainPluginAudioProcessor()
+{
+}
+
+//==============================================================================
+const juce::String ChainPluginAudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool ChainPluginAudioProcessor::acceptsMidi() const
+{
+   #if JucePlugin_WantsMidiInput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool ChainPluginAudioProcessor::producesMidi() const
+{
+   #if JucePlugin_ProducesMidiOutput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool ChainPluginAudioProcessor::isMidiEffect() const
+{
+   #if JucePlugin_IsMidiEffect
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+double ChainPluginAudioProcessor::getTailLengthSeconds() const
+{
+    // The TS filters ring into the delay, which then repeats until the feedback has decayed. Before the first block use the delay time parameter.
+    float finalDelayTime = FinalDelayTime.load();
+    float delayTimeMs = finalDelayTime > 0.0f ? finalDelayTime : treestate.getRawParameterValue("DELAYTIMEMS")->load();
+    float feedback = treestate.getRawParameterValue("FEEDBACK")->load();
+
+    return TSStage::GetTailSeconds() + TailTracker::FeedbackDelayTailTime(delayTimeMs / 1000.0, feedback);
+}
+
+int ChainPluginAudioProcessor::getNumPrograms()
+{
+    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                // so this should be at least 1, even if you're not really implementing programs.
+}
+
+int ChainPluginAudioProcessor::getCurrentProgram()
+{
+    return 0;
+}
+
+void ChainPluginAudioProcessor::setCurrentProgram (int index)
+{
+}
+
+const juce::String ChainPluginAudioProcessor::getProgramName (int index)
+{
+    return {};
+}
+
+void ChainPluginAudioProcessor::changeProgramName (int index, const juce::String& newName)
+{
+}
+
+//==============================================================================
+void ChainPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    // Drop any old parameter changes and size the parameter ramps for the largest block the host has told us about.
+    events.Reset();
+    parameters.Prepare(sampleRate, jmax(samplesPerBlock, FusedBlockSize));
+
+    // Prepare both stages for every channel, the delay glide is as long as the parameter ramps.
+    NumChannels = jmax(1, jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()));
+    tsStage().Prepare(sampleRate, NumChannels);
+    delayStage().Prepare(sampleRate, NumChannels, parameters.GetMaxBlockSize());
+    channelPointers.resize((size_t)NumChannels);
+
+    // Make sure the sync delay time is recalculated for the new sample rate without gliding.
+    SyncBpm = 0.0;
+    SyncDivision = -1;
+
+    // Start awake, the tail is updated every block as the delay time and feedback change.
+    tailTracker.Prepare(sampleRate);
+
+    performance.Prepare(sampleRate);
+    analyser.Prepare(sampleRate);
+}
+
+void ChainPluginAudioProcessor::releaseResources()
+{
+    // When playback stops, you can use this as an opportunity to free up any
+    // spare memory, etc.
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool ChainPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused (layouts);
+    return true;
+  #else
+    // This is the place where you check if the layout is supported.
+    // In this template code we only support mono or stereo.
+    // Some plugin hosts, such as certain GarageBand versions, will only
+    // load plugins that support stereo bus layouts.
+    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
+     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+        return false;
+
+    // This checks if the input layout matches the output layout
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+
+    return true;
+  #endif
+}
+#endif
+
+void ChainPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    performance.BeginBlock();
+
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    // In case we have more outputs than inputs, this code clears any output
+    // channels that didn't contain input data, (because these aren't
+    // guaranteed to be empty - they may contain garbage).
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    int numSamples = buffer.getNumSamples();
+    BlockSamples = numSamples;
+
+    // Get the host tempo for this block before working out the delay time.
+    updateTempo();
+
+    // Drain the parameter changes for this block, they are applied as the block is processed. If any were lost take one snapshot of all the parameters instead.
+    if (! events.BeginBlock(numSamples))
+        parameters.Snapshot();
+
+    updateBlockParameters();
+
+    // Never process more channels than the stages were prepared for.
+    int numInputs = jmin(totalNumInputChannels, NumChannels);
+    int numOutputs = jmin(totalNumOutputChannels, NumChannels);
+
+    // Pick the kernels for this channel layout once. Only channels that received input are processed (mono/stereo duplicates its input into the
+    // second output), any extra outputs were cleared above.
+    ChannelLayout layout = GetChannelLayout(numInputs, numOutputs);
+    int numChannels = GetNumProcessedChannels(layout, numInputs, numOutputs);
+    int nextEvent = 0;
+
+    // Once the input has been silent for longer than both effects ring the output is silent too, so there is no need to run the chain.
+    tailTracker.SetTailSeconds(TSStage::GetTailSeconds() + TailTracker::FeedbackDelayTailTime(FinalDelayTime / 1000.0, parameters.Get(FeedbackParameter)));
+
+    if (tailTracker.ProcessInput(buffer, numInputs, numSamples))
+    {
+        processIdleBlock(buffer, numChannels, numSamples);
+        analyser.Push(buffer, numChannels, numSamples);
+        performance.EndBlock(numSamples);
+        return;
+    }
+
+    // Process the block in short sub-blocks, running the whole chain over each one before moving on so the audio stays in cache between the TS and
+    // the delay. Sub-blocks are also split at every parameter change so automation lands on the right sample.
+    for (int offset = 0; offset < numSamples;)
+    {
+        // Apply every parameter change that lands on this sample.
+        if (nextEvent < events.GetNumEvents() && events.GetEvent(nextEvent).SampleOffset <= offset)
+        {
+            while (nextEvent < events.GetNumEvents() && events.GetEvent(nextEvent).SampleOffset <= offset)
+            {
+                const auto& event = events.GetEvent(nextEvent++);
+                parameters.SetTarget(event.Slot, event.Value);
+            }
+
+            updateBlockParameters();
+        }
+
+        // Stop this sub-block at the next parameter change.
+        int subBlockEnd = nextEvent < events.GetNumEvents() ? events.GetEvent(nextEvent).SampleOffset : numSamples;
+        int subBlockSize = jmin(subBlockEnd - offset, parameters.IsSmoothing() ? ControlBlockSize : FusedBlockSize);
+
+        // Fill the parameter ramps for this sub-block and update both stages from them.
+        parameters.Advance(subBlockSize);
+
+        tsStage().Update(parameters.GetRamp(DriveParameter)[0], parameters.GetRamp(ToneParameter)[0], diodeClipper, parameters.GetRamp(LevelParameter));
+        delayStage().Update(PingPong, parameters.GetRamp(FeedbackParameter), parameters.GetRamp(MixParameter), parameters.GetRamp(MasterParameter));
+
+        for (int channel = 0; channel < numChannels; channel++)
+            channelPointers[(size_t)channel] = buffer.getWritePointer(channel, offset);
+
+        chain.Process(layout, channelPointers.data(), numChannels, subBlockSize, performance);
+
+        offset += subBlockSize;
+    }
+
+    // Check whether both effects have died away, if they have clear the stages so they start from silence when the input comes back.
+    if (tailTracker.ProcessOutput(buffer, numChannels, numSamples))
+    {
+        tsStage().Reset();
+        delayStage().Clear();
+    }
+
+    analyser.Push(buffer, numChannels, numSamples);
+    performance.EndBlock(numSamples);
+}
+
+void ChainPluginAudioProcessor::processIdleBlock(AudioBuffer<float>& buffer, int numChannels, int numSamples)
+{
+    // Apply this block's parameter changes straight away, there is no audio for them to land on. Smoothed parameters carry on ramping when the chain starts again.
+    for (int i = 0; i < events.GetNumEvents(); i++)
+        parameters.SetTarget(events.GetEvent(i).Slot, events.GetEvent(i).Value);
+
+    updateBlockParameters();
+
+    // Both stages are empty and the input is silent, so the output is silence.
+    for (int channel = 0; channel < numChannels; channel++)
+        buffer.clear(channel, 0, numSamples);
+}
+
+void ChainPluginAudioProcessor::updateTempo()
+{
+    // Ask the host for the tempo once per block. Not every host gives us a playhead or a tempo, in which case we keep the last tempo we were given.
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition())
+            if (auto bpm = position->getBpm())
+                if (*bpm > 0.0)
+                    HostBpm = *bpm;
+}
+
+bool ChainPluginAudioProcessor::scheduleParameterChange (int parameterIndex, float normalisedValue, int sampleOffset)
+{
+    return events.PushParameterChange(parameterIndex, normalisedValue, sampleOffset);
+}
+
+void ChainPluginAudioProcessor::updateBlockParameters()
+{
+    diodeClipper = parameters.Get(ClipperParameter) > 0.5f;
+
+    bool tempoChanged = false;
+
+    if (parameters.Get(SyncEnabledParameter) > 0.5f)
+    {
+        int division = (int)parameters.Get(SyncSettingParameter);
+
+        // Only recalculate the sync delay time when the tempo or sync setting has changed. A tempo change on its own glides to the new delay time,
+        // a new sync setting jumps straight to it.
+        if (HostBpm != SyncBpm || division != SyncDivision)
+        {
+            tempoChanged = division == SyncDivision && SyncBpm > 0.0;
+
+            SyncBpm = HostBpm;
+            SyncDivision = division;
+            SyncDelayTimeMs = jmin(CalcDelayTime(HostBpm, division), DelayStage::MaxDelayTimeMs);
+        }
+
+        FinalDelayTime = SyncDelayTimeMs;
+    }
+    else
+    {
+        // Forget the sync delay time so turning sync back on jumps to the current tempo.
+        SyncDivision = -1;
+
+        FinalDelayTime = parameters.Get(DelayTimeParameter);
+    }
+
+    // A tempo change glides to the new delay time across this block, anything else jumps straight to it.
+    delayStage().SetDelayTime((FinalDelayTime / 1000) * (float)getSampleRate(), tempoChanged ? jmax(1, BlockSamples) : 0);
+
+    PingPong = parameters.Get(PingPongParameter) > 0.5f;
+}
+
+//==============================================================================
+bool ChainPluginAudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+// The generic editor with the performance figures for this instance underneath it.
+juce::AudioProcessorEditor* ChainPluginAudioProcessor::createEditor()
+{
+    return new PerformanceEditor(*this, performance, nullptr, &analyser);
+}
+
+//==============================================================================
+void ChainPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    // The parameters in the same compact binary format as the TS and delay plugins, the chain has no preset bank so the chunk lists none.
+    PresetState::WriteChunk(destData, PresetState::Capture(*this), -1, {});
+}
+
+void ChainPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    PresetState current;
+    std::vector<PresetState> presets;
+    int currentPreset = -1;
+
+    if (PresetState::ReadChunk(data, sizeInBytes, current, currentPreset, presets))
+        current.Apply(*this, true);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+#if JEPLUGINS_HEADLESS
+// The headless tools link every plugin into one program, so each plugin gets its own factory instead of createPluginFilter.
+juce::AudioProcessor* createChainPluginProcessor()
+#else
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+#endif
+{
+    return new ChainPluginAudioProcessor();
+}
+
+#if JEPLUGINS_HEADLESS
+// Sample accurate parameter changes for the headless tools, which only see an AudioProcessor. Returns false for any other plugin's processor.
+bool scheduleChainParameterChange(juce::AudioProcessor& processor, int parameterIndex, float normalisedValue, int sampleOffset)
+{
+    auto* chainProcessor = dynamic_cast<ChainPluginAudioProcessor*>(&processor);
+
+    return chainProcessor != nullptr && chainProcessor->scheduleParameterChange(parameterIndex, normalisedValue, sampleOffset);
+}
+#endif
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "TSStage.h"
+#include "DelayStage.h"
+#include "StageChain.h"
+#include "ChannelLayout.h"
+#include "ParameterSnapshot.h"
+#include "ParameterEventQueue.h"
+#include "PresetState.h"
+#include "TailTracker.h"
+#include "PerformanceMonitor.h"
+#include "PerformanceEditor.h"
+#include "SpectrumAnalyser.h"
+
+
+using namespace juce;
+
+//==============================================================================
+/**
+*/
+class ChainPluginAudioProcessor  : public juce::AudioProcessor
+{
+public:
+    //==============================================================================
+    ChainPluginAudioProcessor();
+    ~ChainPluginAudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    //==============================================================================
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+    //==============================================================================
+    // Timing for this instance, shown in the editor.
+    PerformanceMonitor& getPerformanceMonitor() { return performance; }
+
+    // Change a parameter at sampleOffset samples into the next block, value is normalised (0 - 1). Hosts only tell the plugin about automation once
+    // a block, this is for callers that know exactly where a change lands, like the offline tools. Call between blocks from the thread that calls
+    // processBlock. Returns false if the parameter is not one the block is split for or too many changes are queued.
+    bool scheduleParameterChange (int parameterIndex, float normalisedValue, int sampleOffset);
+
+private:
+
+    // --- Our audio DSP objects, the Tube Screamer feeding the delay. The stages are the same ones the TS and delay plugins use.
+
+    StageChain<TSStage, DelayStage> chain;
+
+    TSStage& tsStage() { return chain.Get<0>(); }
+    DelayStage& delayStage() { return chain.Get<1>(); }
+
+    // --- end DSP objects
+
+    // --- Member objects
+
+    // APVTS which will hold all of our parameter states
+    AudioProcessorValueTreeState treestate;
+
+    // Parameters bound from the treestate, read once per block. The TS drive, tone and level and the delay gains are smoothed.
+    ParameterSnapshot parameters;
+    int DriveParameter = 0, ToneParameter = 0, LevelParameter = 0, ClipperParameter = 0;
+    int MasterParameter = 0, MixParameter = 0, FeedbackParameter = 0, DelayTimeParameter = 0;
+    int PingPongParameter = 0, SyncEnabledParameter = 0, SyncSettingParameter = 0;
+
+    // Timestamped parameter changes, used to split each block at the samples where parameters change. Changes from the host land at the start of
+    // the block, scheduleParameterChange gives them their own sample.
+    ParameterEventQueue events;
+
+    // Pointers into the buffer for the sub-block currently being processed, sized in prepareToPlay.
+    std::vector<float*> channelPointers;
+
+    // Watches for silence so the chain can be skipped once both effects have died away.
+    TailTracker tailTracker;
+
+    // Times each block and every stage of the chain inside it, the stages are timed in chain order.
+    PerformanceMonitor performance;
+
+    // Output spectrum for the editor, fed with a copy of each block while the editor shows it.
+    SpectrumAnalyser analyser;
+
+    // --- End member objects
+
+    // --- Member variables
+
+    // Both stages run over the same sub-block before moving on, so the sub-blocks are kept short enough for the audio to stay in cache between the
+    // stages. While drive or tone are moving they are shorter again so the TS filters follow the ramps.
+    static constexpr int FusedBlockSize = 64;
+    static constexpr int ControlBlockSize = 32;
+
+    int NumChannels = 2;
+    int BlockSamples = 0;
+    bool diodeClipper = false;
+    bool PingPong = false;
+    // Delay time in use, written by the audio thread and read by getTailLengthSeconds from any thread.
+    std::atomic<float> FinalDelayTime { 0.0f };
+
+    // Length of each sync setting in quarter notes, in the same order as the SyncSetting choices. Dotted notes are 1.5x and triplets 2/3 of the straight note.
+    static constexpr double DivisionMultipliers[16] = { 4.0, 6.0, 8.0 / 3.0,          // 1/1, 1/1D, 1/1T
+                                                        2.0, 3.0, 4.0 / 3.0,          // 1/2, 1/2D, 1/2T
+                                                        1.0, 1.5, 2.0 / 3.0,          // 1/4, 1/4D, 1/4T
+                                                        0.5, 0.75, 1.0 / 3.0,         // 1/8, 1/8D, 1/8T
+                                                        0.25, 0.375, 1.0 / 6.0,       // 1/16, 1/16D, 1/16T
+                                                        0.125 };                      // 1/32
+
+    // Tempo read from the host playhead once per block, and the tempo and sync setting the sync delay time was last calculated for.
+    double HostBpm = 120.0;
+    double SyncBpm = 0.0;
+    int SyncDivision = -1;
+    float SyncDelayTimeMs = 0.0f;
+
+    // --- end Member variables
+
+    // --- Member functions
+
+    float CalcDelayTime(double BPM, int syncSetting)
+    {
+        // One quarter note lasts 60 / BPM seconds, the table scales that to the sync setting.
+        return (float)(60000.0 / BPM * DivisionMultipliers[jlimit(0, 15, syncSetting)]);
+    }
+
+    // Reads the tempo from the host playhead, called once at the start of each block.
+    void updateTempo();
+
+    // Works out the block rate values (clipper, delay time and ping pong) from the parameters, called at the start of the block and whenever an event changes a parameter.
+    void updateBlockParameters();
+
+    // Handles a block while the plugin is idle. Parameter changes are still applied but the chain is not run.
+    void processIdleBlock(AudioBuffer<float>& buffer, int numChannels, int numSamples);
+
+    // --- end Member funtions
+
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChainPluginAudioProcessor)
+};
@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+    PresetControls.cpp
+    Created: 20 Oct 2026 11:48:12pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include "PresetControls.h"
+
+PresetControls::PresetControls(PresetBankOwner& owner)
+    : presetOwner(owner)
+{
+    // Item IDs are the preset index plus one, a combo box item can't have the ID 0.
+    presetBox.setTextWhenNothingSelected("No preset");
+    presetBox.setTextWhenNoChoicesAvailable("No presets stored");
+    presetBox.onChange = [this]
+    {
+        int index = presetBox.getSelectedId() - 1;
+
+        if (index >= 0 && index != presetOwner.getSelectedPreset())
+        {
+            presetOwner.selectPreset(index);
+            morphSlider.setValue(0.0, juce::dontSendNotification);
+        }
+    };
+    addAndMakeVisible(presetBox);
+
+    storeButton.onClick = [this]
+    {
+        int index = presetOwner.getSelectedPreset();
+
+        if (index >= 0)
+            presetOwner.storePreset(presetOwner.getPresetName(index), index);
+        else
+            presetOwner.storePreset("Preset " + juce::String(presetOwner.getNumPresets() + 1));
+
+        timerCallback();
+    };
+    addAndMakeVisible(storeButton);
+
+    addButton.onClick = [this]
+    {
+        presetOwner.storePreset("Preset " + juce::String(presetOwner.getNumPresets() + 1));
+        timerCallback();
+    };
+    addAndMakeVisible(addButton);
+
+    addAndMakeVisible(morphLabel);
+
+    morphBox.setTextWhenNothingSelected("Preset");
+    morphBox.onChange = [this] { updateMorph(); };
+    addAndMakeVisible(morphBox);
+
+    morphSlider.setRange(0.0, 1.0);
+    morphSlider.onValueChange = [this] { updateMorph(); };
+    addAndMakeVisible(morphSlider);
+
+    timerCallback();
+    setSize(360, 2 * rowHeight);
+
+    // Only a handful of presets to compare, twice a second is quick enough to follow a host loading a session.
+    startTimerHz(2);
+}
+
+PresetControls::~PresetControls()
+{
+    stopTimer();
+}
+
+void PresetControls::resized()
+{
+    auto bounds = getLocalBounds();
+    auto presetRow = bounds.removeFromTop(rowHeight).reduced(4);
+    auto morphRow = bounds.reduced(4);
+
+    addButton.setBounds(presetRow.removeFromRight(buttonWidth));
+    presetRow.removeFromRight(4);
+    storeButton.setBounds(presetRow.removeFromRight(buttonWidth));
+    presetRow.removeFromRight(4);
+    presetBox.setBounds(presetRow);
+
+    morphLabel.setBounds(morphRow.removeFromLeft(labelWidth));
+    morphBox.setBounds(morphRow.removeFromLeft(morphRow.getWidth() / 2));
+    morphRow.removeFromLeft(4);
+    morphSlider.setBounds(morphRow);
+}
+
+void PresetControls::timerCallback()
+{
+    juce::StringArray names;
+
+    for (int index = 0; index < presetOwner.getNumPresets(); index++)
+        names.add(juce::String(index + 1) + ": " + presetOwner.getPresetName(index));
+
+    if (names != listedNames)
+    {
+        listedNames = names;
+
+        int morphTarget = morphBox.getSelectedId();
+
+        presetBox.clear(juce::dontSendNotification);
+        presetBox.addItemList(names, 1);
+
+        morphBox.clear(juce::dontSendNotification);
+        morphBox.addItemList(names, 1);
+        morphBox.setSelectedId(morphTarget <= names.size() ? morphTarget : 0, juce::dontSendNotification);
+    }
+
+    presetBox.setSelectedId(presetOwner.getSelectedPreset() + 1, juce::dontSendNotification);
+}
+
+void PresetControls::updateMorph()
+{
+    int a = presetOwner.getSelectedPreset();
+    int b = morphBox.getSelectedId() - 1;
+
+    if (a >= 0 && b >= 0)
+        presetOwner.morphPresets(a, b, (float)morphSlider.getValue());
+}
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    PresetControls.h
+    Created: 20 Oct 2026 11:48:12pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetState.h"
+
+// Preset bank controls for the editor. The top row picks a preset, stores the current settings over it or adds them as a new one, and the bottom
+// row morphs from the selected preset to another with a slider, which is the live control for moving between song sections.
+class PresetControls : public juce::Component, private juce::Timer
+{
+
+public:
+
+    // C-tor
+    PresetControls(PresetBankOwner& owner);
+    // D-tor
+    ~PresetControls() override;
+
+    void resized() override;
+
+private:
+
+    PresetBankOwner& presetOwner;
+
+    juce::ComboBox presetBox;
+    juce::TextButton storeButton { "Store" };
+    juce::TextButton addButton { "Add" };
+
+    juce::Label morphLabel { {}, "Morph to" };
+    juce::ComboBox morphBox;
+    juce::Slider morphSlider { juce::Slider::LinearHorizontal, juce::Slider::NoTextBox };
+
+    // Preset names as last listed, so the lists are only rebuilt when the bank changes.
+    juce::StringArray listedNames;
+
+    static constexpr int rowHeight = 32;
+    static constexpr int buttonWidth = 60;
+    static constexpr int labelWidth = 64;
+
+    // Rebuild the preset lists if the bank has changed, the host can load a new one or select a preset as a program at any time.
+    void timerCallback() override;
+
+    // Morph from the selected preset to the one in the morph list by the slider's amount.
+    void updateMorph();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetControls)
+};
@@ -0,0 +1,398 @@
+/*
+  ==============================================================================
+
+    Simd.h
+    Created: 19 Oct 2026 9:48:30pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <JuceHeader.h>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+// Thin SIMD layer shared by the DSP classes. Each instruction set has an Ops struct with the same batch type and operations (load, store, fma,
+// min, max...), and the DSP kernels are written once as templates over Ops. Every kernel is compiled for every instruction set in the same binary,
+// and the widest one the machine supports is picked once, when the first DSP object is created at plugin load, so one build runs AVX-512 kernels on
+// machines that have it and falls back to AVX2, SSE4.2 or plain scalar code on machines that do not.
+//
+// A kernel is a struct with a Function pointer type and a Process template taking the same arguments:
+//
+//      struct GainKernel
+//      {
+//          using Function = void (*)(float*, int, float);
+//
+//          template <typename Ops>
+//          static void Process(float* data, int numSamples, float gain);
+//      };
+//
+//      GainKernel::Function gain = Simd::Dispatch<GainKernel>();   // Once, outside the audio thread
+//      gain(data, numSamples, 0.5f);
+
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+ // Ops functions are compiled for their own instruction set, and each kernel entry point inlines the whole kernel so the compiler can use that
+ // instruction set throughout it.
+ #define JEPLUGINS_SIMD_TARGET(isa) __attribute__((target(isa)))
+ #define JEPLUGINS_SIMD_KERNEL(isa) __attribute__((target(isa), flatten))
+
+ // Batches are passed between the Ops functions inside a kernel, which warns about the vector calling convention. Everything is inlined into the
+ // kernel entry point so no batch ever crosses a real call.
+ #if JUCE_GCC
+  #pragma GCC diagnostic ignored "-Wpsabi"
+ #elif defined(__has_warning)
+  #if __has_warning("-Wpsabi")
+   #pragma clang diagnostic ignored "-Wpsabi"
+  #endif
+ #endif
+#else
+ // MSVC compiles any intrinsic without a target attribute.
+ #define JEPLUGINS_SIMD_TARGET(isa)
+ #define JEPLUGINS_SIMD_KERNEL(isa)
+#endif
+
+namespace Simd
+{
+    enum class Isa
+    {
+        Scalar,
+        SSE42,
+        AVX2,
+        AVX512
+    };
+
+    inline const char* GetIsaName(Isa isa)
+    {
+        switch (isa)
+        {
+            case Isa::SSE42:  return "sse4.2";
+            case Isa::AVX2:   return "avx2";
+            case Isa::AVX512: return "avx512";
+            default:          return "scalar";
+        }
+    }
+
+    // Widest instruction set this machine supports. Setting the JEPLUGINS_SIMD environment variable to one of the names above lowers it, so the
+    // kernels for each instruction set can be compared on one machine.
+    inline Isa DetectIsa()
+    {
+        Isa isa = Isa::Scalar;
+
+       #if JUCE_INTEL
+        if (juce::SystemStats::hasAVX512F())
+            isa = Isa::AVX512;
+        else if (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+            isa = Isa::AVX2;
+        else if (juce::SystemStats::hasSSE42())
+            isa = Isa::SSE42;
+       #endif
+
+        juce::String limit = juce::SystemStats::getEnvironmentVariable("JEPLUGINS_SIMD", {});
+
+        for (Isa lower : { Isa::Scalar, Isa::SSE42, Isa::AVX2 })
+            if (limit.equalsIgnoreCase(GetIsaName(lower)))
+                isa = std::min(isa, lower);
+
+        return isa;
+    }
+
+    // The instruction set every kernel is dispatched to, detected the first time it is asked for.
+    inline Isa GetIsa()
+    {
+        static const Isa isa = DetectIsa();
+        return isa;
+    }
+
+    //==============================================================================
+    // Plain C++, used on machines without SIMD and for the samples left over after the last full batch.
+    struct ScalarOps
+    {
+        using Batch = float;
+        static constexpr int Width = 1;
+
+        static Batch Load(const float* source)                  { return *source; }
+        static void Store(float* destination, Batch value)      { *destination = value; }
+        static Batch Set(float value)                           { return value; }
+
+        static Batch Add(Batch a, Batch b)                      { return a + b; }
+        static Batch Sub(Batch a, Batch b)                      { return a - b; }
+        static Batch Mul(Batch a, Batch b)                      { return a * b; }
+        static Batch Div(Batch a, Batch b)                      { return a / b; }
+        static Batch Fma(Batch a, Batch b, Batch c)             { return a * b + c; }
+        static Batch Min(Batch a, Batch b)                      { return std::min(a, b); }
+        static Batch Max(Batch a, Batch b)                      { return std::max(a, b); }
+
+        // a < b per lane, and a where the mask is set and b where it is not.
+        using Mask = bool;
+        static Mask Less(Batch a, Batch b)                      { return a < b; }
+        static Batch Select(Mask mask, Batch a, Batch b)        { return mask ? a : b; }
+
+        // Round to the nearest whole number, and 2^n for a whole number n.
+        static Batch Round(Batch a)                             { return std::nearbyint(a); }
+        static Batch Pow2(Batch n)                              { return std::ldexp(1.0f, (int)n); }
+
+        template <typename Kernel, typename... Args>
+        static void Run(Args... args)                           { Kernel::template Process<ScalarOps>(args...); }
+    };
+
+   #if JUCE_INTEL
+    struct Sse42Ops
+    {
+        using Batch = __m128;
+        static constexpr int Width = 4;
+
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Load(const float* source)              { return _mm_loadu_ps(source); }
+        JEPLUGINS_SIMD_TARGET("sse4.2") static void Store(float* destination, Batch value)  { _mm_storeu_ps(destination, value); }
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Set(float value)                       { return _mm_set1_ps(value); }
+
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Add(Batch a, Batch b)                  { return _mm_add_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Sub(Batch a, Batch b)                  { return _mm_sub_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Mul(Batch a, Batch b)                  { return _mm_mul_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Div(Batch a, Batch b)                  { return _mm_div_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Fma(Batch a, Batch b, Batch c)         { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Min(Batch a, Batch b)                  { return _mm_min_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Max(Batch a, Batch b)                  { return _mm_max_ps(a, b); }
+
+        using Mask = __m128;
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Mask Less(Batch a, Batch b)                  { return _mm_cmplt_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Select(Mask mask, Batch a, Batch b)    { return _mm_blendv_ps(b, a, mask); }
+
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Round(Batch a)                         { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+        JEPLUGINS_SIMD_TARGET("sse4.2") static Batch Pow2(Batch n)
+        {
+            return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23));
+        }
+
+        template <typename Kernel, typename... Args>
+        JEPLUGINS_SIMD_KERNEL("sse4.2") static void Run(Args... args)                       { Kernel::template Process<Sse42Ops>(args...); }
+    };
+
+    struct Avx2Ops
+    {
+        using Batch = __m256;
+        static constexpr int Width = 8;
+
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Load(const float* source)              { return _mm256_loadu_ps(source); }
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static void Store(float* destination, Batch value)  { _mm256_storeu_ps(destination, value); }
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Set(float value)                       { return _mm256_set1_ps(value); }
+
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Add(Batch a, Batch b)                  { return _mm256_add_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Sub(Batch a, Batch b)                  { return _mm256_sub_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Mul(Batch a, Batch b)                  { return _mm256_mul_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Div(Batch a, Batch b)                  { return _mm256_div_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Fma(Batch a, Batch b, Batch c)         { return _mm256_fmadd_ps(a, b, c); }
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Min(Batch a, Batch b)                  { return _mm256_min_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Max(Batch a, Batch b)                  { return _mm256_max_ps(a, b); }
+
+        using Mask = __m256;
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Mask Less(Batch a, Batch b)                  { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Select(Mask mask, Batch a, Batch b)    { return _mm256_blendv_ps(b, a, mask); }
+
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Round(Batch a)                         { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+        JEPLUGINS_SIMD_TARGET("avx2,fma") static Batch Pow2(Batch n)
+        {
+            return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23));
+        }
+
+        template <typename Kernel, typename... Args>
+        JEPLUGINS_SIMD_KERNEL("avx2,fma") static void Run(Args... args)                       { Kernel::template Process<Avx2Ops>(args...); }
+    };
+
+    struct Avx512Ops
+    {
+        using Batch = __m512;
+        static constexpr int Width = 16;
+
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Load(const float* source)              { return _mm512_loadu_ps(source); }
+        JEPLUGINS_SIMD_TARGET("avx512f") static void Store(float* destination, Batch value)  { _mm512_storeu_ps(destination, value); }
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Set(float value)                       { return _mm512_set1_ps(value); }
+
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Add(Batch a, Batch b)                  { return _mm512_add_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Sub(Batch a, Batch b)                  { return _mm512_sub_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Mul(Batch a, Batch b)                  { return _mm512_mul_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Div(Batch a, Batch b)                  { return _mm512_div_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Fma(Batch a, Batch b, Batch c)         { return _mm512_fmadd_ps(a, b, c); }
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Min(Batch a, Batch b)                  { return _mm512_min_ps(a, b); }
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Max(Batch a, Batch b)                  { return _mm512_max_ps(a, b); }
+
+        using Mask = __mmask16;
+        JEPLUGINS_SIMD_TARGET("avx512f") static Mask Less(Batch a, Batch b)                  { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Select(Mask mask, Batch a, Batch b)    { return _mm512_mask_blend_ps(mask, b, a); }
+
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Round(Batch a)                         { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+        JEPLUGINS_SIMD_TARGET("avx512f") static Batch Pow2(Batch n)
+        {
+            return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23));
+        }
+
+        template <typename Kernel, typename... Args>
+        JEPLUGINS_SIMD_KERNEL("avx512f") static void Run(Args... args)                       { Kernel::template Process<Avx512Ops>(args...); }
+    };
+   #endif
+
+    //==============================================================================
+    // Four lanes as plain C++, the scalar version of QuadOps below.
+    struct ScalarQuadOps
+    {
+        struct Batch { float Lane[4]; };
+        static constexpr int Width = 4;
+
+        static Batch Load(const float* source)                  { return { { source[0], source[1], source[2], source[3] } }; }
+        static void Store(float* destination, Batch value)      { std::copy(value.Lane, value.Lane + 4, destination); }
+        static Batch Set(float value)                           { return { { value, value, value, value } }; }
+
+        static Batch Add(Batch a, Batch b)                      { return apply(a, b, [](float x, float y) { return x + y; }); }
+        static Batch Sub(Batch a, Batch b)                      { return apply(a, b, [](float x, float y) { return x - y; }); }
+        static Batch Mul(Batch a, Batch b)                      { return apply(a, b, [](float x, float y) { return x * y; }); }
+        static Batch Div(Batch a, Batch b)                      { return apply(a, b, [](float x, float y) { return x / y; }); }
+        static Batch Fma(Batch a, Batch b, Batch c)             { return Add(Mul(a, b), c); }
+        static Batch Min(Batch a, Batch b)                      { return apply(a, b, [](float x, float y) { return std::min(x, y); }); }
+        static Batch Max(Batch a, Batch b)                      { return apply(a, b, [](float x, float y) { return std::max(x, y); }); }
+
+        struct Mask { bool Lane[4]; };
+
+        static Mask Less(Batch a, Batch b)
+        {
+            return { { a.Lane[0] < b.Lane[0], a.Lane[1] < b.Lane[1], a.Lane[2] < b.Lane[2], a.Lane[3] < b.Lane[3] } };
+        }
+
+        static Batch Select(Mask mask, Batch a, Batch b)
+        {
+            Batch result;
+
+            for (int lane = 0; lane < 4; lane++)
+                result.Lane[lane] = mask.Lane[lane] ? a.Lane[lane] : b.Lane[lane];
+
+            return result;
+        }
+
+        static Batch Round(Batch a)                             { return apply(a, a, [](float x, float) { return ScalarOps::Round(x); }); }
+        static Batch Pow2(Batch n)                              { return apply(n, n, [](float x, float) { return ScalarOps::Pow2(x); }); }
+
+    private:
+
+        template <typename Function>
+        static Batch apply(Batch a, Batch b, Function function)
+        {
+            Batch result;
+
+            for (int lane = 0; lane < 4; lane++)
+                result.Lane[lane] = function(a.Lane[lane], b.Lane[lane]);
+
+            return result;
+        }
+    };
+
+    // Ops for exactly four lanes inside a kernel compiled for Ops, for kernels that pack four separate signals (the bands of a crossover) into
+    // one batch rather than four samples of one signal. Every instruction set from SSE4.2 up uses the SSE registers, which the wider ones can
+    // run as well, and the scalar kernel loops over four floats.
+    template <typename Ops>
+    struct Quad                                                 { using Type = ScalarQuadOps; };
+
+   #if JUCE_INTEL
+    template <> struct Quad<Sse42Ops>                           { using Type = Sse42Ops; };
+    template <> struct Quad<Avx2Ops>                            { using Type = Sse42Ops; };
+    template <> struct Quad<Avx512Ops>                          { using Type = Sse42Ops; };
+   #endif
+
+    template <typename Ops>
+    using QuadOps = typename Quad<Ops>::Type;
+
+    //==============================================================================
+    // Call body(ops, sample) for every batch in numSamples samples, then once per sample for whatever is left over. ops is an Ops object, so the
+    // body is written once as a generic lambda and runs with both batch widths.
+    template <typename Ops, typename Body>
+    void ForEach(int numSamples, Body&& body)
+    {
+        int sample = 0;
+
+        for (; sample + Ops::Width <= numSamples; sample += Ops::Width)
+            body(Ops(), sample);
+
+        for (; sample < numSamples; sample++)
+            body(ScalarOps(), sample);
+    }
+
+    // e^x, accurate to about one float rounding error over the range the kernels use (|x| < 80). The exponent is split into a power of two and a
+    // remainder below ln(2) / 2, and the remainder goes through a polynomial.
+    template <typename Ops>
+    typename Ops::Batch Exp(typename Ops::Batch x)
+    {
+        x = Ops::Min(Ops::Max(x, Ops::Set(-80.0f)), Ops::Set(80.0f));
+
+        typename Ops::Batch n = Ops::Round(Ops::Mul(x, Ops::Set(1.44269504088896341f)));
+
+        // Subtract n * ln(2) in two parts so the remainder keeps its precision.
+        x = Ops::Fma(n, Ops::Set(-0.693359375f), x);
+        x = Ops::Fma(n, Ops::Set(2.12194440e-4f), x);
+
+        typename Ops::Batch y = Ops::Set(1.9875691500e-4f);
+        y = Ops::Fma(y, x, Ops::Set(1.3981999507e-3f));
+        y = Ops::Fma(y, x, Ops::Set(8.3334519073e-3f));
+        y = Ops::Fma(y, x, Ops::Set(4.1665795894e-2f));
+        y = Ops::Fma(y, x, Ops::Set(1.6666665459e-1f));
+        y = Ops::Fma(y, x, Ops::Set(5.0000001201e-1f));
+        y = Ops::Fma(y, Ops::Mul(x, x), Ops::Add(x, Ops::Set(1.0f)));
+
+        return Ops::Mul(y, Ops::Pow2(n));
+    }
+
+    // tanh(x). Near zero (e^2x - 1) / (e^2x + 1) loses precision to cancellation, so below |x| = 0.625 an odd polynomial is used instead. Beyond
+    // |x| = 10 tanh is 1 to float precision, so the input is limited there to keep e^2x finite.
+    template <typename Ops>
+    typename Ops::Batch Tanh(typename Ops::Batch x)
+    {
+        x = Ops::Min(Ops::Max(x, Ops::Set(-10.0f)), Ops::Set(10.0f));
+
+        typename Ops::Batch z = Ops::Mul(x, x);
+        typename Ops::Batch p = Ops::Set(-5.70498872745e-3f);
+        p = Ops::Fma(p, z, Ops::Set(2.06390887954e-2f));
+        p = Ops::Fma(p, z, Ops::Set(-5.37397155531e-2f));
+        p = Ops::Fma(p, z, Ops::Set(1.33314422036e-1f));
+        p = Ops::Fma(p, z, Ops::Set(-3.33332819422e-1f));
+        typename Ops::Batch small = Ops::Fma(Ops::Mul(p, z), x, x);
+
+        typename Ops::Batch e = Exp<Ops>(Ops::Add(x, x));
+        typename Ops::Batch large = Ops::Div(Ops::Sub(e, Ops::Set(1.0f)), Ops::Add(e, Ops::Set(1.0f)));
+
+        return Ops::Select(Ops::Less(z, Ops::Set(0.625f * 0.625f)), small, large);
+    }
+
+    //==============================================================================
+    template <typename Kernel, typename Function = typename Kernel::Function>
+    struct Dispatcher;
+
+    template <typename Kernel, typename... Args>
+    struct Dispatcher<Kernel, void (*)(Args...)>
+    {
+        static typename Kernel::Function Select()
+        {
+            switch (GetIsa())
+            {
+               #if JUCE_INTEL
+                case Isa::AVX512: return &Avx512Ops::template Run<Kernel, Args...>;
+                case Isa::AVX2:   return &Avx2Ops::template Run<Kernel, Args...>;
+                case Isa::SSE42:  return &Sse42Ops::template Run<Kernel, Args...>;
+               #endif
+                default:          return &ScalarOps::template Run<Kernel, Args...>;
+            }
+        }
+    };
+
+    // The version of a kernel for the widest instruction set this machine supports. Look kernels up when a DSP object is created and keep the
+    // pointer, rather than on the audio thread.
+    template <typename Kernel>
+    typename Kernel::Function Dispatch()
+    {
+        return Dispatcher<Kernel>::Select();
+    }
+}
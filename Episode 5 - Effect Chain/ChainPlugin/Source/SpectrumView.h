@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    SpectrumView.h
+    Created: 20 Oct 2026 6:12:44pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "SpectrumAnalyser.h"
+
+// Draws a spectrum analyser's latest spectrum on a log frequency axis from 20 Hz to 20 kHz. The analyser only runs while a view of it exists.
+class SpectrumView : public juce::Component, private juce::Timer
+{
+
+public:
+
+    // C-tor
+    explicit SpectrumView(SpectrumAnalyser& analyser);
+    // D-tor
+    ~SpectrumView() override;
+
+    void paint(juce::Graphics& g) override;
+
+private:
+
+    SpectrumAnalyser& spectrumAnalyser;
+
+    // The spectrum as last copied out of the analyser and the sample rate its bins are spaced for. The path keeps its storage between frames.
+    std::vector<float> bins;
+    double sampleRate = 48000.0;
+    juce::Path path;
+
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float minDb = -96.0f;
+    static constexpr float maxDb = 6.0f;
+
+    // Level in dB of the pixel column covering frequencies lowFrequency to highFrequency, the loudest bin in it or between the two nearest bins
+    // where a column is narrower than a bin.
+    float getColumnLevel(float lowFrequency, float highFrequency) const;
+
+    // Copy the latest spectrum and redraw.
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumView)
+};
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    StageChain.h
+    Created: 19 Oct 2026 5:48:03pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <tuple>
+#include <utility>
+#include "ChannelLayout.h"
+
+// A fixed chain of DSP stages, run one after the other over the same sub-block. The chain is built at compile time from the stage types, so running
+// it is just a sequence of direct calls with no virtual functions or per stage buffers. Each sub-block is kept short by the processor, so the audio
+// stays in cache as it passes from one stage to the next instead of every stage making its own pass over the whole buffer.
+//
+// Every stage needs a Process(ChannelLayout, float* const*, int numChannels, int numSamples) method that works in place.
+template <typename... Stages>
+class StageChain
+{
+
+public:
+
+    // Access a stage by its position in the chain, used to prepare and update the stages.
+    template <size_t Index>
+    auto& Get() { return std::get<Index>(stages); }
+
+    // Run every stage over a sub-block in order. Mono/stereo duplicates the input into the second channel in the first stage, so every stage after
+    // that processes stereo.
+    void Process(ChannelLayout layout, float* const* channelData, int numChannels, int numSamples)
+    {
+        std::apply([&](auto&... stage)
+        {
+            ((stage.Process(layout, channelData, numChannels, numSamples), layout = layout == ChannelLayout::MonoToStereo ? ChannelLayout::Stereo : layout), ...);
+        }, stages);
+    }
+
+    // Same as Process, with each stage timed by a monitor (anything with BeginStage(int) and EndStage(int)). Each stage is timed as the monitor
+    // stage matching its position in the chain.
+    template <typename Monitor>
+    void Process(ChannelLayout layout, float* const* channelData, int numChannels, int numSamples, Monitor& monitor)
+    {
+        processTimed(layout, channelData, numChannels, numSamples, monitor, std::index_sequence_for<Stages...>());
+    }
+
+private:
+
+    std::tuple<Stages...> stages;
+
+    template <typename Monitor, size_t... Index>
+    void processTimed(ChannelLayout layout, float* const* channelData, int numChannels, int numSamples, Monitor& monitor, std::index_sequence<Index...>)
+    {
+        ((monitor.BeginStage((int)Index),
+          std::get<Index>(stages).Process(layout, channelData, numChannels, numSamples),
+          monitor.EndStage((int)Index),
+          layout = layout == ChannelLayout::MonoToStereo ? ChannelLayout::Stereo : layout), ...);
+    }
+
+};
@@ -0,0 +1,439 @@
+/*
+  ==============================================================================
+
+    TSStage.cpp
+    Created: 19 Oct 2026 5:12:40pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <cmath>
+#include "TSStage.h"
+#include "TailTracker.h"
+
+namespace
+{
+    // Very mild sigmoid used to emulate the non-linearity of the transistors and op-amps, (e^x - 1) / (e^x + 1) scaled so the function maps onto
+    // -1 and 1, which is the same as tanh(x / 2) times that scale.
+    static constexpr float EULER = 2.71828182845904523536f;
+    static constexpr float SigmoidScale = 0.462f * (EULER + 1.0f) / (EULER - 1.0f);
+
+    template <typename Ops>
+    typename Ops::Batch mildSigmoid(typename Ops::Batch x)
+    {
+        return Ops::Mul(Simd::Tanh<Ops>(Ops::Mul(x, Ops::Set(0.5f))), Ops::Set(SigmoidScale));
+    }
+
+    // Sigmoid on its own, ahead of the diode clipper.
+    struct SigmoidKernel
+    {
+        using Function = void (*)(float*, int);
+
+        template <typename Ops>
+        static void Process(float* data, int numSamples)
+        {
+            Simd::ForEach<Ops>(numSamples, [&](auto ops, int sample)
+            {
+                using O = decltype(ops);
+                O::Store(data + sample, mildSigmoid<O>(O::Load(data + sample)));
+            });
+        }
+    };
+
+    // Sigmoid followed by the tanh clipper.
+    struct SigmoidTanhKernel
+    {
+        using Function = void (*)(float*, int, float, float);
+
+        template <typename Ops>
+        static void Process(float* data, int numSamples, float saturation, float normalisation)
+        {
+            Simd::ForEach<Ops>(numSamples, [&](auto ops, int sample)
+            {
+                using O = decltype(ops);
+                auto yn = mildSigmoid<O>(O::Load(data + sample));
+                O::Store(data + sample, O::Mul(Simd::Tanh<O>(O::Mul(yn, O::Set(saturation))), O::Set(normalisation)));
+            });
+        }
+    };
+
+    // Sigmoid after the tone filter and the level ramp.
+    struct OutputKernel
+    {
+        using Function = void (*)(float*, const float*, int, float, float);
+
+        template <typename Ops>
+        static void Process(float* data, const float* levelRamp, int numSamples, float inputGain, float outputGain)
+        {
+            Simd::ForEach<Ops>(numSamples, [&](auto ops, int sample)
+            {
+                using O = decltype(ops);
+                auto yn = mildSigmoid<O>(O::Mul(O::Load(data + sample), O::Set(inputGain)));
+                O::Store(data + sample, O::Mul(yn, O::Mul(O::Load(levelRamp + sample), O::Set(outputGain))));
+            });
+        }
+    };
+
+    // The same sigmoid in double, for the double precision path.
+    double mildSigmoid(double x)
+    {
+        return std::tanh(x * 0.5) * (double)SigmoidScale;
+    }
+}
+
+TSStage::TSStage()
+{
+    // Pick the kernels for this machine.
+    sigmoidKernel = Simd::Dispatch<SigmoidKernel>();
+    sigmoidTanhKernel = Simd::Dispatch<SigmoidTanhKernel>();
+    outputKernel = Simd::Dispatch<OutputKernel>();
+
+    // Start with a stereo set of DSP objects in each precision, Prepare will resize them if the host gives us a different channel count.
+    initChannelDSP(channelDSP);
+    initChannelDSP(channelDSPDouble);
+}
+
+TSStage::~TSStage()
+{
+
+}
+
+template <typename SampleType>
+void TSStage::initChannelDSP(std::vector<ChannelDSP<SampleType>>& channels)
+{
+    channels.resize(2);
+
+    for (auto& dsp : channels)
+    {
+        // Initialise our input stage filters, 48000 fs initially, however this will be reset before each playback anyway and will change if the host (DAW) changes sample rate. We can call this method here as the filter type will not change, only the sample rate.
+        dsp.InputStageHPF.Init(HPF, inputStageFc, 48000, 0.5, 0);
+
+        // Same for tone filters. However, the cutoff of these filters will be modulated at every parameter change so this will be updated in real time.
+        dsp.ToneFilter.Init(LPF, 5000.f, 48000, 0.5, 0);
+
+        // Diode clippers, this also builds the shared solver table so it never happens on the audio thread.
+        dsp.Clipper.Init(48000, 0.5f);
+
+        // A single band until SetBands asks for more.
+        dsp.Bands.Init(1, nullptr, 48000);
+    }
+}
+
+template <typename SampleType>
+void TSStage::resetChannelDSP(std::vector<ChannelDSP<SampleType>>& channels)
+{
+    // Reset with the current sample rate only clears the state variables, a new sample rate also recalculates the filters and clippers.
+    for (auto& dsp : channels)
+    {
+        dsp.InputStageHPF.Reset(SampleRate);
+        dsp.ToneFilter.Reset(SampleRate);
+        dsp.Clipper.Reset(SampleRate);
+        dsp.Bands.Reset(SampleRate);
+
+        if (Resampling)
+            dsp.Rate.Reset();
+    }
+}
+
+template <typename SampleType>
+void TSStage::prepareResampling(std::vector<ChannelDSP<SampleType>>& channels, double hostRate)
+{
+    for (auto& dsp : channels)
+    {
+        if (Resampling)
+        {
+            dsp.Rate.Prepare(hostRate, SampleRate, ResampleBlockSize);
+            dsp.Internal.resize((size_t)dsp.Rate.GetMaxInternalSamples());
+        }
+        else
+        {
+            dsp.Internal = {};
+        }
+    }
+
+    LatencySamples = Resampling ? channels.front().Rate.GetLatencySamples() : 0;
+    unityRamp.assign(channels.front().Internal.size(), 1.0f);
+}
+
+double TSStage::GetInternalRate(double hostRate)
+{
+    return std::fmod(hostRate, 11025.0) == 0.0 ? 88200.0 : 96000.0;
+}
+
+template <typename SampleType>
+void TSStage::updateChannelDSP(std::vector<ChannelDSP<SampleType>>& channels, float drive)
+{
+    for (auto& dsp : channels)
+    {
+        // Set frequency cutoff of tone filters.
+        dsp.ToneFilter.SetFc(tone);
+
+        // The diode clipper takes the raw drive value as it maps directly onto the drive pot.
+        dsp.Clipper.SetDrive(drive);
+    }
+}
+
+void TSStage::Prepare(double sampleRate, int numChannels, bool doublePrecision)
+{
+    // The model runs at the internal rate with a fixed rate, and the filters, clippers and bands are all set up for that rate.
+    SampleRate = (float)(FixedRate ? GetInternalRate(sampleRate) : sampleRate);
+    Resampling = (double)SampleRate != sampleRate;
+    DoublePrecision = doublePrecision;
+
+    // Make sure we have a set of DSP objects for every channel, new channels copy the settings of the first one. Then reset our filters and
+    // clippers with the sample rate. The bands keep their count but their crossovers are redesigned for the rate.
+    if (DoublePrecision)
+    {
+        channelDSPDouble.resize((size_t)std::max(1, numChannels), channelDSPDouble.front());
+        prepareResampling(channelDSPDouble, sampleRate);
+        resetChannelDSP(channelDSPDouble);
+    }
+    else
+    {
+        channelDSP.resize((size_t)std::max(1, numChannels), channelDSP.front());
+        prepareResampling(channelDSP, sampleRate);
+        resetChannelDSP(channelDSP);
+    }
+
+    // A band count asked for before the first Prepare, or changed since the last block, takes effect straight away on the cleared state.
+    updateBands(false);
+}
+
+void TSStage::Reset()
+{
+    if (DoublePrecision)
+        resetChannelDSP(channelDSPDouble);
+    else
+        resetChannelDSP(channelDSP);
+
+    // With the state cleared there is nothing to crossfade from.
+    updateBands(false);
+}
+
+void TSStage::Update(float drive, float tone01, bool useDiodeClipper, const float* level)
+{
+    // Map our float parameters to desired bounds.
+    saturation = map(drive, 0.0f, 1.0f, 50.0f, 1000.0f);
+    tone = map(tone01, 0.0f, 1.0f, minToneFc, maxToneFc);
+    clipperNormalisation = 1.0f / tanh(saturation);
+    diodeClipper = useDiodeClipper;
+    levelRamp = level;
+
+    if (DoublePrecision)
+        updateChannelDSP(channelDSPDouble, drive);
+    else
+        updateChannelDSP(channelDSP, drive);
+}
+
+void TSStage::SetBands(int bands)
+{
+    requestedBands = std::clamp(bands, 1, Crossover::MaxBands);
+}
+
+void TSStage::updateBands(bool crossfade)
+{
+    int& fadeRemaining = DoublePrecision ? channelDSPDouble.front().BandFadeRemaining : channelDSP.front().BandFadeRemaining;
+
+    if (! crossfade)
+    {
+        for (auto& dsp : channelDSP)
+            dsp.BandFadeRemaining = 0;
+
+        for (auto& dsp : channelDSPDouble)
+            dsp.BandFadeRemaining = 0;
+    }
+
+    // A crossfade that is running finishes before the next change starts, so there are never more than two splits to run.
+    if (requestedBands == numBands || fadeRemaining > 0)
+        return;
+
+    fadingBandGain = bandGain;
+    numBands = requestedBands;
+    bandGain = 1.0f / std::sqrt((float)numBands);
+    bandFadeLength = crossfade ? std::max(1, (int)(SampleRate * BandCrossfadeMs / 1000.0f)) : 0;
+
+    // Both precisions are kept on the same band count so a later Prepare in the other precision carries on with it, only the one in use fades.
+    switchBands(channelDSP, DoublePrecision ? 0 : bandFadeLength);
+    switchBands(channelDSPDouble, DoublePrecision ? bandFadeLength : 0);
+}
+
+template <typename SampleType>
+void TSStage::switchBands(std::vector<ChannelDSP<SampleType>>& channels, int fadeLength)
+{
+    for (auto& dsp : channels)
+    {
+        dsp.FadingBands = dsp.Bands;
+        dsp.Bands.Init(numBands, crossoverFrequencies[numBands], SampleRate);
+        dsp.BandFadeRemaining = fadeLength;
+    }
+}
+
+void TSStage::Resolve(float drive, float tone01, double sampleRate, Settings& settings)
+{
+    // The same mapping as Update.
+    settings.Drive = drive;
+    settings.Tone = tone01;
+    settings.Saturation = map(drive, 0.0f, 1.0f, 50.0f, 1000.0f);
+    settings.ClipperNormalisation = 1.0f / tanh(settings.Saturation);
+    settings.ToneFc = map(tone01, 0.0f, 1.0f, minToneFc, maxToneFc);
+
+    // Design the tone filter in double, the float filters are loaded with the rounded coefficients.
+    BiquadDouble toneFilter;
+    toneFilter.Init(LPF, settings.ToneFc, (float)sampleRate, 0.5, 0);
+
+    double* c = settings.ToneCoefficients;
+    toneFilter.GetCoefficients(c[0], c[1], c[2], c[3], c[4]);
+
+    DiodeClipperDouble clipper;
+    clipper.Init((float)sampleRate, drive);
+    clipper.GetCircuit(settings.Circuit);
+}
+
+void TSStage::Mix(const Settings& a, const Settings& b, float amount, Settings& result)
+{
+    // Drive and tone are mixed and everything that is cheap to map from them is mapped again, as Update would.
+    result.Drive = a.Drive + (b.Drive - a.Drive) * amount;
+    result.Tone = a.Tone + (b.Tone - a.Tone) * amount;
+    result.Saturation = map(result.Drive, 0.0f, 1.0f, 50.0f, 1000.0f);
+    result.ClipperNormalisation = 1.0f / tanh(result.Saturation);
+    result.ToneFc = map(result.Tone, 0.0f, 1.0f, minToneFc, maxToneFc);
+
+    for (int i = 0; i < 5; i++)
+        result.ToneCoefficients[i] = a.ToneCoefficients[i] + (b.ToneCoefficients[i] - a.ToneCoefficients[i]) * amount;
+
+    DiodeClipperSolver::Circuit::Mix(a.Circuit, b.Circuit, amount, result.Circuit);
+}
+
+void TSStage::Apply(const Settings& settings)
+{
+    saturation = settings.Saturation;
+    clipperNormalisation = settings.ClipperNormalisation;
+    tone = settings.ToneFc;
+
+    if (DoublePrecision)
+        applyChannelDSP(channelDSPDouble, settings);
+    else
+        applyChannelDSP(channelDSP, settings);
+}
+
+template <typename SampleType>
+void TSStage::applyChannelDSP(std::vector<ChannelDSP<SampleType>>& channels, const Settings& settings)
+{
+    // Settings resolved for another sample rate can only be used for their drive and tone, so recalculate as Update would.
+    if (settings.Circuit.SampleRate != SampleRate)
+    {
+        updateChannelDSP(channels, settings.Drive);
+        return;
+    }
+
+    const double* c = settings.ToneCoefficients;
+
+    for (auto& dsp : channels)
+    {
+        dsp.ToneFilter.SetCoefficients(settings.ToneFc, (SampleType)c[0], (SampleType)c[1], (SampleType)c[2], (SampleType)c[3], (SampleType)c[4]);
+        dsp.Clipper.SetCircuit(settings.Circuit);
+    }
+}
+
+void TSStage::sigmoid(double* data, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+        data[sample] = mildSigmoid(data[sample]);
+}
+
+void TSStage::sigmoidTanh(double* data, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+        data[sample] = std::tanh(mildSigmoid(data[sample]) * saturation) * clipperNormalisation;
+}
+
+void TSStage::output(double* data, const float* ramp, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+        data[sample] = mildSigmoid(data[sample] * gainCompensation) * ((double)ramp[sample] * maxLevel);
+}
+
+double TSStage::GetTailSeconds()
+{
+    // The output keeps ringing for as long as the two filters take to decay, the tone filter rings longest at its lowest cutoff. With bands the
+    // two biquads of the lowest crossover ring on top of that.
+    return TailTracker::FilterRingTime(inputStageFc, 0.5) + TailTracker::FilterRingTime(minToneFc, 0.5)
+         + 2.0 * TailTracker::FilterRingTime(crossoverFrequencies[Crossover::MaxBands][0], 0.7071);
+}
+
+template <ChannelLayout Layout, bool UseDiodeClipper, typename SampleType>
+void TSStage::processKernel(SampleType* const* channelData, int numChannels, int numSamples)
+{
+    if constexpr (Layout == ChannelLayout::Mono)
+    {
+        // Mono, one set of DSP objects processes the only channel.
+        processChannel<UseDiodeClipper>(channelData[0], getChannelDSP<SampleType>()[0], numSamples);
+    }
+    else if constexpr (Layout == ChannelLayout::MonoToStereo)
+    {
+        // Mono/stereo, the single input channel is duplicated into the second channel which can then be processed as stereo.
+        juce::FloatVectorOperations::copy(channelData[1], channelData[0], numSamples);
+
+        processKernel<ChannelLayout::Stereo, UseDiodeClipper>(channelData, 2, numSamples);
+    }
+    else if constexpr (Layout == ChannelLayout::Stereo)
+    {
+        // Stereo, each channel with its own DSP objects.
+        processChannel<UseDiodeClipper>(channelData[0], getChannelDSP<SampleType>()[0], numSamples);
+        processChannel<UseDiodeClipper>(channelData[1], getChannelDSP<SampleType>()[1], numSamples);
+    }
+    else
+    {
+        // Any other channel count, each channel is processed in turn with its own DSP objects.
+        for (int channel = 0; channel < numChannels; channel++)
+            processChannel<UseDiodeClipper>(channelData[channel], getChannelDSP<SampleType>()[(size_t)channel], numSamples);
+    }
+}
+
+void TSStage::Process(ChannelLayout layout, float* const* channelData, int numChannels, int numSamples)
+{
+    jassert(! DoublePrecision);
+    processLayout(layout, channelData, numChannels, numSamples);
+}
+
+void TSStage::Process(ChannelLayout layout, double* const* channelData, int numChannels, int numSamples)
+{
+    jassert(DoublePrecision);
+    processLayout(layout, channelData, numChannels, numSamples);
+}
+
+template <typename SampleType>
+void TSStage::processLayout(ChannelLayout layout, SampleType* const* channelData, int numChannels, int numSamples)
+{
+    // Never process more channels than we have DSP objects for.
+    numChannels = std::min(numChannels, (int)getChannelDSP<SampleType>().size());
+
+    // Pick up a new band count. The diode clipper doesn't use the bands, so they can switch straight over under it.
+    updateBands(! diodeClipper);
+
+    // Pick the kernel for the current layout and clipper.
+    switch (layout)
+    {
+        case ChannelLayout::Mono:
+            diodeClipper ? processKernel<ChannelLayout::Mono, true>(channelData, numChannels, numSamples)
+                         : processKernel<ChannelLayout::Mono, false>(channelData, numChannels, numSamples);
+            break;
+
+        case ChannelLayout::MonoToStereo:
+            diodeClipper ? processKernel<ChannelLayout::MonoToStereo, true>(channelData, numChannels, numSamples)
+                         : processKernel<ChannelLayout::MonoToStereo, false>(channelData, numChannels, numSamples);
+            break;
+
+        case ChannelLayout::Stereo:
+            diodeClipper ? processKernel<ChannelLayout::Stereo, true>(channelData, numChannels, numSamples)
+                         : processKernel<ChannelLayout::Stereo, false>(channelData, numChannels, numSamples);
+            break;
+
+        case ChannelLayout::MultiChannel:
+            diodeClipper ? processKernel<ChannelLayout::MultiChannel, true>(channelData, numChannels, numSamples)
+                         : processKernel<ChannelLayout::MultiChannel, false>(channelData, numChannels, numSamples);
+            break;
+    }
+}
@@ -0,0 +1,359 @@
+/*
+  ==============================================================================
+
+    TSStage.h
+    Created: 19 Oct 2026 5:12:40pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include <JuceHeader.h>
+#include "Biquad.h"
+#include "Crossover.h"
+#include "DiodeClipper.h"
+#include "ChannelLayout.h"
+#include "Resampler.h"
+
+// The Tube Screamer DSP on its own, without any of the plugin around it (parameters, bypass, idle detection). The TS plugin runs one of these over
+// its buffer, and because it only needs channel pointers it can also be run as a stage in a chain of effects.
+//
+// With a fixed rate set the model runs at 88.2 or 96 kHz whatever rate the host runs at, so it sounds the same and costs the same at every host
+// rate. Each channel is resampled up to the internal rate, run through the model and resampled back down, which adds GetLatencySamples of delay.
+class TSStage
+{
+
+public:
+
+    // C-tor
+    TSStage();
+    // D-tor
+    ~TSStage();
+
+    // Create a set of DSP objects for each channel and reset them for the sample rate, call from prepareToPlay. With doublePrecision set the
+    // double DSP objects are the ones kept up to date, and only the double Process can be used until the next Prepare.
+    void Prepare(double sampleRate, int numChannels, bool doublePrecision = false);
+
+    // Run the model at the fixed internal rate for the host rate rather than at the host rate, from the next Prepare on.
+    void SetFixedRate(bool fixedRate) { FixedRate = fixedRate; }
+
+    // The internal rate for a host rate, 88.2 kHz for the 44.1 kHz family and 96 kHz for everything else.
+    static double GetInternalRate(double hostRate);
+
+    // Rate the model runs at since the last Prepare, the one to resolve settings for.
+    double GetSampleRate() const { return SampleRate; }
+
+    // Host samples of delay the resampling adds, 0 when the model runs at the host rate.
+    int GetLatencySamples() const { return LatencySamples; }
+
+    // Clears the filter and clipper states.
+    void Reset();
+
+    // Set the controls (0 - 1) and clipper for the next sub-block. Drive and tone recalculate the clipper and tone filters so they are updated once per
+    // sub-block, level is applied per sample from levelRamp which must cover the whole sub-block.
+    void Update(float drive, float tone, bool diodeClipper, const float* levelRamp);
+
+    // Split the tanh clipper into numBands (1 - 4) bands with LR4 crossovers, so each band saturates on its own and the low end no longer
+    // intermodulates with everything above it. The bands are saturated together with the four of each sample in one SIMD batch and then summed
+    // back up, phase coherent, before the tone filter. The diode clipper models a single circuit and always runs full band. The next Process
+    // makes the change, crossfading from the old band split to the new one over BandCrossfadeMs so the switch doesn't click. Only changing the
+    // band count does any work, so this can be called every block.
+    void SetBands(int numBands);
+
+    // How long a change in the band count crossfades over.
+    static constexpr float BandCrossfadeMs = 10.0f;
+
+    // Process numSamples samples in place, channelData holds numChannels pointers laid out as the layout describes.
+    void Process(ChannelLayout layout, float* const* channelData, int numChannels, int numSamples);
+
+    // Same in double precision, for a stage prepared with doublePrecision. The filters and clipper run in double throughout, the sigmoids and tanh
+    // clipper run sample by sample as the SIMD kernels are float only.
+    void Process(ChannelLayout layout, double* const* channelData, int numChannels, int numSamples);
+
+    // How long the output keeps ringing after the input goes silent.
+    static double GetTailSeconds();
+
+    // Everything Update works out from drive and tone, resolved ahead of time for a preset so that switching to the preset only copies values in.
+    struct Settings
+    {
+        float Drive = 0.0f;
+        float Tone = 0.0f;
+
+        float Saturation = 0.0f;
+        float ClipperNormalisation = 1.0f;
+        float ToneFc = 0.0f;
+
+        // Tone filter coefficients normalised by a0, b0, b1, b2, a1, a2.
+        double ToneCoefficients[5] = {};
+
+        DiodeClipperSolver::Circuit Circuit;
+    };
+
+    // Work out the settings for drive and tone (0 - 1) at a sample rate. This is the work Update would do, so call it off the audio thread.
+    static void Resolve(float drive, float tone, double sampleRate, Settings& settings);
+
+    // Mix two resolved settings, amount 0 is a and 1 is b. The tone filter coefficients are mixed linearly, which keeps the filter stable as the
+    // stable values of a1 and a2 form a triangle and any point between two stable filters is inside it.
+    static void Mix(const Settings& a, const Settings& b, float amount, Settings& result);
+
+    // Load resolved settings into every channel, in place of the drive and tone given to Update. Update then only recalculates the filters or
+    // clipper once drive or tone move away from the values the settings were resolved for.
+    void Apply(const Settings& settings);
+
+private:
+
+    // DSP objects for a single channel, one of these is created per channel in Prepare so any channel count can be processed.
+    template <typename SampleType>
+    struct ChannelDSP
+    {
+        FloatBiquad<SampleType> InputStageHPF;
+        FloatBiquad<SampleType> ToneFilter;
+
+        // Circuit modelled clipping stage, used in place of the tanh clipper when the clipper parameter is set to diode.
+        FloatDiodeClipper<SampleType> Clipper;
+
+        // Splits the tanh clipper's input into bands when there is more than one.
+        FloatCrossover<SampleType> Bands;
+
+        // The split from before the band count changed, kept running while the output crossfades from it to Bands, and the samples left to go.
+        FloatCrossover<SampleType> FadingBands;
+        int BandFadeRemaining = 0;
+
+        // Converts to and from the internal rate with a fixed rate, and holds a chunk of the channel at that rate.
+        FloatResampler<SampleType> Rate;
+        std::vector<SampleType> Internal;
+    };
+
+    // A set for each precision, only the one for the precision given to Prepare is updated.
+    std::vector<ChannelDSP<float>> channelDSP;
+    std::vector<ChannelDSP<double>> channelDSPDouble;
+    bool DoublePrecision = false;
+
+    template <typename SampleType>
+    std::vector<ChannelDSP<SampleType>>& getChannelDSP()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return channelDSPDouble;
+        else
+            return channelDSP;
+    }
+
+    static constexpr float inputStageFc = 300.f;
+    static constexpr float minToneFc = 1000.f;
+    static constexpr float maxToneFc = 6000.f;
+    float gainCompensation = 0.125;
+    float maxLevel = 1.5f;
+
+    // Crossover frequencies for each band count, lowest first. The lowest sits just above the input stage HPF so the low mids the HPF leaves in
+    // get a band of their own.
+    static constexpr float crossoverFrequencies[Crossover::MaxBands + 1][Crossover::MaxBands - 1] =
+    {
+        {}, {}, { 600.0f }, { 400.0f, 1600.0f }, { 300.0f, 1000.0f, 3000.0f }
+    };
+
+    // Bands are split and summed in chunks of this many samples, so the band buffer can live on the stack.
+    static constexpr int BandBlockSize = 64;
+
+    int numBands = 1;
+
+    // Each band saturates to full scale on its own, so the sum is brought back to the level of a single band's by 1 / sqrt(numBands).
+    float bandGain = 1.0f;
+
+    // The band count SetBands last asked for, and the gain of the old split and length of the crossfade from it while one is running.
+    int requestedBands = 1;
+    float fadingBandGain = 1.0f;
+    int bandFadeLength = 0;
+
+    float SampleRate = 48000.0f;
+
+    // Whether the model runs at a fixed rate, whether that differs from the host rate since the last Prepare, and the delay it adds if so.
+    bool FixedRate = false;
+    bool Resampling = false;
+    int LatencySamples = 0;
+
+    // Host samples resampled at a time, so the internal chunk is only a few times this long whatever size the host's blocks are.
+    static constexpr int ResampleBlockSize = 128;
+
+    // Level ramp for the model while resampling, the level is applied at the host rate after resampling back down instead.
+    std::vector<float> unityRamp;
+    float saturation = 0.0f;
+    float tone = 0.0f;
+    bool diodeClipper = false;
+    const float* levelRamp = nullptr;
+
+    // Per sub-block value used by the processing kernels, this lets the clipper normalisation be applied without a per sample division.
+    float clipperNormalisation = 1.0f;
+
+    // Linear mapping function, this will allow us to calculate our current frequency cutoff without exposing the user to the cutoff value. The user will have a parameter between 0 and 1, we will then map that to our upper and lower cutoff bounds.
+    static float map(float x, float in_min, float in_max, float out_min, float out_max)
+    {
+            return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+    }
+
+    // SIMD kernels for the memoryless parts of the chain, picked for the machine when the stage is created.
+    void (*sigmoidKernel)(float* data, int numSamples) = nullptr;
+    void (*sigmoidTanhKernel)(float* data, int numSamples, float saturation, float normalisation) = nullptr;
+    void (*outputKernel)(float* data, const float* levelRamp, int numSamples, float inputGain, float outputGain) = nullptr;
+
+    // The memoryless parts of the chain for a sub-block, the kernels above in float and sample by sample in double.
+    void sigmoid(float* data, int numSamples)       { sigmoidKernel(data, numSamples); }
+    void sigmoidTanh(float* data, int numSamples)   { sigmoidTanhKernel(data, numSamples, saturation, clipperNormalisation); }
+    void output(float* data, const float* ramp, int numSamples) { outputKernel(data, ramp, numSamples, gainCompensation, maxLevel); }
+
+    void sigmoid(double* data, int numSamples);
+    void sigmoidTanh(double* data, int numSamples);
+    void output(double* data, const float* ramp, int numSamples);
+
+    // Set up a set of DSP objects for two channels at 48 kHz, and bring a set up to date with the current settings.
+    template <typename SampleType>
+    void initChannelDSP(std::vector<ChannelDSP<SampleType>>& dsp);
+
+    template <typename SampleType>
+    void updateChannelDSP(std::vector<ChannelDSP<SampleType>>& dsp, float drive);
+
+    template <typename SampleType>
+    void resetChannelDSP(std::vector<ChannelDSP<SampleType>>& dsp);
+
+    // Size each channel's resampler for the host and internal rates, or free it when the model runs at the host rate.
+    template <typename SampleType>
+    void prepareResampling(std::vector<ChannelDSP<SampleType>>& dsp, double hostRate);
+
+    template <typename SampleType>
+    void applyChannelDSP(std::vector<ChannelDSP<SampleType>>& dsp, const Settings& settings);
+
+    // Move to the requested band count if it has changed and no crossfade is running, crossfading from the old split or switching straight
+    // away. Switching straight away also ends a crossfade that is running.
+    void updateBands(bool crossfade);
+
+    // Give a set of DSP objects the new band count, keeping the old split to crossfade from over fadeLength samples.
+    template <typename SampleType>
+    void switchBands(std::vector<ChannelDSP<SampleType>>& dsp, int fadeLength);
+
+    // One channel at the rate the model runs at. At the host rate this is the model itself, otherwise the channel is resampled a chunk at a
+    // time, the model runs over each chunk at the internal rate with a level of one, and the level ramp is applied once the chunk is back at the
+    // host rate. The level follows the last sigmoid so applying it there gives the same result.
+    template <bool UseDiodeClipper, typename SampleType>
+    void processChannel(SampleType* data, ChannelDSP<SampleType>& dsp, int numSamples)
+    {
+        if (! Resampling)
+        {
+            processModel<UseDiodeClipper>(data, dsp, numSamples, levelRamp);
+            return;
+        }
+
+        SampleType* internal = dsp.Internal.data();
+
+        for (int offset = 0; offset < numSamples; offset += ResampleBlockSize)
+        {
+            int chunkSize = std::min(ResampleBlockSize, numSamples - offset);
+
+            int numInternal = dsp.Rate.Up(data + offset, chunkSize, internal);
+            processModel<UseDiodeClipper>(internal, dsp, numInternal, unityRamp.data());
+            dsp.Rate.Down(internal, numInternal, data + offset, chunkSize);
+
+            for (int sample = 0; sample < chunkSize; sample++)
+                data[offset + sample] *= (SampleType)levelRamp[offset + sample];
+        }
+    }
+
+    // Full TS chain for one channel. Each part of the chain runs over the whole sub-block in turn, the filters and diode clipper keep their state
+    // between samples and in float the sigmoids and tanh clipper run as SIMD kernels. The clipper is a template parameter so the choice of clipper
+    // is made once per sub-block rather than per sample.
+    template <bool UseDiodeClipper, typename SampleType>
+    void processModel(SampleType* data, ChannelDSP<SampleType>& dsp, int numSamples, const float* ramp)
+    {
+        // Process input with initial HPF. We also apply a mild sigmoid here to emulate the transistor non-linearity in the buffer.
+        dsp.InputStageHPF.ProcessBlock(data, numSamples);
+
+        // Saturate filtered signal with the selected clipper.
+        if constexpr (UseDiodeClipper)
+        {
+            sigmoid(data, numSamples);
+
+            for (int sample = 0; sample < numSamples; sample++)
+                data[sample] = dsp.Clipper.ProcessSample(data[sample]);
+        }
+        else if (dsp.BandFadeRemaining > 0)
+            sigmoidTanhBandFade(data, dsp, numSamples);
+        else
+            sigmoidTanhBands(data, dsp.Bands, bandGain, numSamples);
+
+        // Apply the tone filter. Gain compensation is also applied due to additional gain applied by the soft clipper. Again apply additional
+        // non-linearity after filtering for transistor emulation, then the level, which maps linearly onto 0 - maxLevel.
+        dsp.ToneFilter.ProcessBlock(data, numSamples);
+
+        output(data, ramp, numSamples);
+    }
+
+    // Sigmoid and tanh clipper per band, or over the whole signal with a single band. Each chunk is split into bands laid out four to a sample,
+    // the bands run through the same kernel as a single band would as one array four times as long, so the four bands of a sample share one
+    // SIMD batch, and are then summed back up.
+    template <typename SampleType>
+    void sigmoidTanhBands(SampleType* data, FloatCrossover<SampleType>& crossover, float gain, int numSamples)
+    {
+        if (crossover.GetNumBands() == 1)
+        {
+            sigmoidTanh(data, numSamples);
+            return;
+        }
+
+        SampleType bands[Crossover::MaxBands * BandBlockSize];
+
+        for (int offset = 0; offset < numSamples; offset += BandBlockSize)
+        {
+            int chunkSize = std::min(BandBlockSize, numSamples - offset);
+
+            crossover.Split(data + offset, bands, chunkSize);
+            sigmoidTanh(bands, Crossover::MaxBands * chunkSize);
+            FloatCrossover<SampleType>::Combine(bands, data + offset, chunkSize, (SampleType)gain);
+        }
+    }
+
+    // The same while the band count changes, the input runs through both the old and the new split and the output moves linearly from the
+    // old one to the new one, the way the bypass crossfades. Once the crossfade is over the rest of the sub-block only runs the new split.
+    template <typename SampleType>
+    void sigmoidTanhBandFade(SampleType* data, ChannelDSP<SampleType>& dsp, int numSamples)
+    {
+        SampleType previous[BandBlockSize];
+
+        for (int offset = 0; offset < numSamples; offset += BandBlockSize)
+        {
+            if (dsp.BandFadeRemaining == 0)
+            {
+                sigmoidTanhBands(data + offset, dsp.Bands, bandGain, numSamples - offset);
+                return;
+            }
+
+            int chunkSize = std::min(BandBlockSize, numSamples - offset);
+            SampleType* chunk = data + offset;
+
+            std::copy(chunk, chunk + chunkSize, previous);
+            sigmoidTanhBands(previous, dsp.FadingBands, fadingBandGain, chunkSize);
+            sigmoidTanhBands(chunk, dsp.Bands, bandGain, chunkSize);
+
+            for (int sample = 0; sample < chunkSize; sample++)
+            {
+                SampleType amount = (SampleType)dsp.BandFadeRemaining / (SampleType)bandFadeLength;
+                chunk[sample] += (previous[sample] - chunk[sample]) * amount;
+
+                if (dsp.BandFadeRemaining > 0)
+                    dsp.BandFadeRemaining--;
+            }
+        }
+    }
+
+    // Processing kernel for a channel layout. The layout is checked once per sub-block to pick a kernel, so the sample loops inside the kernels have no layout checks.
+    template <ChannelLayout Layout, bool UseDiodeClipper, typename SampleType>
+    void processKernel(SampleType* const* channelData, int numChannels, int numSamples);
+
+    // Picks the kernel for the layout and clipper, shared by both precisions.
+    template <typename SampleType>
+    void processLayout(ChannelLayout layout, SampleType* const* channelData, int numChannels, int numSamples);
+
+};
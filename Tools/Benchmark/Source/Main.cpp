@@ -0,0 +1,688 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 7:10:44pm
+    Author:  JEPlugins
+
+    Headless benchmarks for the DSP building blocks and the full plugin processors. Every benchmark is run over a sweep of block sizes, sample
+    rates and channel counts, and reports the time per sample (one sample on every channel) and how many times faster than realtime it ran.
+
+        Benchmark [options]
+
+            --filter <text>        Only run benchmarks whose name contains the text
+            --blocks <list>        Block sizes, 32,64,128,256,512,1024,2048 by default
+            --rates <list>         Sample rates, 44100,48000,96000 by default
+            --channels <list>      Channel counts, 1,2 by default
+            --seconds <s>          Audio processed per timed run, 0.25 by default
+            --runs <n>             Timed runs per measurement, the median is reported, 7 by default
+            --json <file>          Write the results as JSON
+            --compare <file>       Compare against a JSON file from an earlier run, exits with 2 if anything is slower than the tolerance
+            --tolerance <percent>  Allowed slowdown for --compare, 10 by default
+            --list                 List the benchmarks and exit
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <JuceHeader.h>
+#include "../../Common/HeadlessHost.h"
+#include "../../Common/TimingStats.h"
+
+// The chain plugin keeps a copy of every DSP class in one folder, so include them from there to get a single ChannelLayout.h.
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/TSStage.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/DelayStage.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/Modulation.h"
+
+using namespace juce;
+
+namespace
+{
+    struct BenchmarkSettings
+    {
+        String Filter;
+        std::vector<int> BlockSizes { 32, 64, 128, 256, 512, 1024, 2048 };
+        std::vector<double> SampleRates { 44100.0, 48000.0, 96000.0 };
+        std::vector<int> ChannelCounts { 1, 2 };
+        double SecondsPerRun = 0.25;
+        int NumRuns = 7;
+        File JsonFile;
+        File CompareFile;
+        double TolerancePercent = 10.0;
+        bool ListOnly = false;
+    };
+
+    // Everything a benchmark gets to set itself up. The input holds one second of noise per channel, and the buffer is block sized and is what
+    // gets processed.
+    struct BenchmarkContext
+    {
+        double SampleRate = 48000.0;
+        int BlockSize = 512;
+        int NumChannels = 2;
+        AudioBuffer<float>* Input = nullptr;
+        AudioBuffer<float>* Buffer = nullptr;
+    };
+
+    // A benchmark sets up whatever it measures and returns the function that processes one block, starting at inputPosition in the input.
+    using BlockFunction = std::function<void(int inputPosition, int numSamples)>;
+
+    struct Benchmark
+    {
+        String Name;
+        std::function<BlockFunction(BenchmarkContext&)> Create;
+    };
+
+    struct BenchmarkResult
+    {
+        String Name;
+        double SampleRate = 0.0;
+        int BlockSize = 0;
+        int NumChannels = 0;
+        double MedianNsPerSample = 0.0;
+        double MinNsPerSample = 0.0;
+        double RealtimeFactor = 0.0;
+
+        String GetKey() const { return Name + "|" + String(SampleRate, 0) + "|" + String(BlockSize) + "|" + String(NumChannels); }
+    };
+
+    ChannelLayout getLayout(int numChannels)
+    {
+        return numChannels == 1 ? ChannelLayout::Mono : ChannelLayout::Stereo;
+    }
+
+    // Copy a block of the input into the buffer, the processors work in place so they need fresh input every block.
+    void copyInput(BenchmarkContext& context, int inputPosition, int numSamples)
+    {
+        for (int channel = 0; channel < context.NumChannels; channel++)
+            context.Buffer->copyFrom(channel, 0, *context.Input, channel, inputPosition, numSamples);
+    }
+
+    // Benchmark for a plugin processor's processBlock, set up with parameters given as text. With doublePrecision the processor runs its double
+    // path, and the input is copied into a double buffer in place of the usual copy so both precisions pay for one copy per block.
+    Benchmark processorBenchmark(const String& name, const String& pluginName, std::vector<HeadlessHost::ParameterSetting> parameters,
+                                 bool doublePrecision = false)
+    {
+        return { name, [pluginName, parameters, doublePrecision](BenchmarkContext& context) -> BlockFunction
+        {
+            std::shared_ptr<AudioProcessor> processor = HeadlessHost::CreateProcessor(pluginName);
+
+            for (auto& parameter : parameters)
+                HeadlessHost::SetParameter(*processor, parameter);
+
+            HeadlessHost::PrepareProcessor(*processor, context.NumChannels, context.SampleRate, context.BlockSize, false, doublePrecision);
+
+            auto midi = std::make_shared<MidiBuffer>();
+
+            if (doublePrecision)
+            {
+                auto buffer = std::make_shared<AudioBuffer<double>>(context.NumChannels, context.BlockSize);
+
+                return [&context, processor, midi, buffer](int inputPosition, int numSamples)
+                {
+                    for (int channel = 0; channel < context.NumChannels; channel++)
+                    {
+                        const float* input = context.Input->getReadPointer(channel, inputPosition);
+                        double* data = buffer->getWritePointer(channel);
+
+                        for (int sample = 0; sample < numSamples; sample++)
+                            data[sample] = input[sample];
+                    }
+
+                    AudioBuffer<double> block(buffer->getArrayOfWritePointers(), context.NumChannels, numSamples);
+                    processor->processBlock(block, *midi);
+                };
+            }
+
+            return [&context, processor, midi](int inputPosition, int numSamples)
+            {
+                copyInput(context, inputPosition, numSamples);
+
+                AudioBuffer<float> block(context.Buffer->getArrayOfWritePointers(), context.NumChannels, numSamples);
+                processor->processBlock(block, *midi);
+            };
+        } };
+    }
+
+    std::vector<Benchmark> createBenchmarks()
+    {
+        std::vector<Benchmark> benchmarks;
+
+        // One Biquad per channel, the TS input stage high pass.
+        benchmarks.push_back({ "Biquad.ProcessSample", [](BenchmarkContext& context) -> BlockFunction
+        {
+            auto filters = std::make_shared<std::vector<Biquad>>((size_t)context.NumChannels);
+
+            for (auto& filter : *filters)
+                filter.Init(HPF, 300.0f, (float)context.SampleRate, 0.5f, 0.0f);
+
+            return [&context, filters](int inputPosition, int numSamples)
+            {
+                for (int channel = 0; channel < context.NumChannels; channel++)
+                {
+                    const float* input = context.Input->getReadPointer(channel, inputPosition);
+                    float* output = context.Buffer->getWritePointer(channel);
+                    Biquad& filter = (*filters)[(size_t)channel];
+
+                    for (int sample = 0; sample < numSamples; sample++)
+                        output[sample] = filter.ProcessSample(input[sample]);
+                }
+            };
+        } });
+
+        // The same filters a block at a time, with the feedforward half running as a SIMD kernel.
+        benchmarks.push_back({ "Biquad.ProcessBlock", [](BenchmarkContext& context) -> BlockFunction
+        {
+            auto filters = std::make_shared<std::vector<Biquad>>((size_t)context.NumChannels);
+
+            for (auto& filter : *filters)
+                filter.Init(HPF, 300.0f, (float)context.SampleRate, 0.5f, 0.0f);
+
+            return [&context, filters](int inputPosition, int numSamples)
+            {
+                for (int channel = 0; channel < context.NumChannels; channel++)
+                {
+                    float* output = context.Buffer->getWritePointer(channel);
+
+                    FloatVectorOperations::copy(output, context.Input->getReadPointer(channel, inputPosition), numSamples);
+                    (*filters)[(size_t)channel].ProcessBlock(output, numSamples);
+                }
+            };
+        } });
+
+        // One delay line per channel, written and read every sample as the delay does. Each read method is measured on its own.
+        auto circularBufferBenchmark = [](const String& name, int readMethod)
+        {
+            return Benchmark { name, [readMethod](BenchmarkContext& context) -> BlockFunction
+            {
+                auto delayLines = std::shared_ptr<CircularBuffer[]>(new CircularBuffer[(size_t)context.NumChannels]);
+
+                for (int channel = 0; channel < context.NumChannels; channel++)
+                    delayLines[channel].Init((int)context.SampleRate, 2000.0f);
+
+                float delaySamples = (float)(context.SampleRate * 0.3317);
+
+                return [&context, delayLines, readMethod, delaySamples](int inputPosition, int numSamples)
+                {
+                    for (int channel = 0; channel < context.NumChannels; channel++)
+                    {
+                        const float* input = context.Input->getReadPointer(channel, inputPosition);
+                        float* output = context.Buffer->getWritePointer(channel);
+                        CircularBuffer& delayLine = delayLines[channel];
+
+                        for (int sample = 0; sample < numSamples; sample++)
+                        {
+                            if (readMethod == 0)
+                                output[sample] = delayLine.BufferReadSamples((int)delaySamples);
+                            else if (readMethod == 1)
+                                output[sample] = delayLine.BufferRead(331.7f, true);
+                            else
+                                output[sample] = delayLine.BufferReadFractional(delaySamples);
+
+                            delayLine.BufferWrite(input[sample] + 0.5f * output[sample]);
+                        }
+                    }
+                };
+            } };
+        };
+
+        benchmarks.push_back(circularBufferBenchmark("CircularBuffer.ReadSamples", 0));
+        benchmarks.push_back(circularBufferBenchmark("CircularBuffer.ReadInterpolated", 1));
+        benchmarks.push_back(circularBufferBenchmark("CircularBuffer.ReadFractional", 2));
+
+        // The TS nonlinear chain on its own (input high pass, clipper, tone filter and level) with each clipper, the tanh clipper split into
+        // bands, and the tanh clipper run at the fixed internal rate with the resampling either side of it.
+        auto tsStageBenchmark = [](const String& name, bool diodeClipper, int numBands, bool fixedRate = false)
+        {
+            return Benchmark { name, [diodeClipper, numBands, fixedRate](BenchmarkContext& context) -> BlockFunction
+            {
+                auto stage = std::make_shared<TSStage>();
+                auto levelRamp = std::make_shared<std::vector<float>>((size_t)context.BlockSize, 0.7f);
+                stage->SetFixedRate(fixedRate);
+                stage->Prepare(context.SampleRate, context.NumChannels);
+                stage->SetBands(numBands);
+
+                return [&context, stage, levelRamp, diodeClipper](int inputPosition, int numSamples)
+                {
+                    copyInput(context, inputPosition, numSamples);
+                    stage->Update(0.7f, 0.5f, diodeClipper, levelRamp->data());
+                    stage->Process(getLayout(context.NumChannels), context.Buffer->getArrayOfWritePointers(), context.NumChannels, numSamples);
+                };
+            } };
+        };
+
+        benchmarks.push_back(tsStageBenchmark("TSStage.Tanh", false, 1));
+        benchmarks.push_back(tsStageBenchmark("TSStage.Diode", true, 1));
+        benchmarks.push_back(tsStageBenchmark("TSStage.Tanh.Bands2", false, 2));
+        benchmarks.push_back(tsStageBenchmark("TSStage.Tanh.Bands4", false, 4));
+        benchmarks.push_back(tsStageBenchmark("TSStage.Tanh.FixedRate", false, 1, true));
+        benchmarks.push_back(tsStageBenchmark("TSStage.Diode.FixedRate", true, 1, true));
+
+        // The diode TS stage switching between two presets every block, loading settings resolved ahead of time or recalculating them in Update.
+        auto tsPresetBenchmark = [](const String& name, bool resolved)
+        {
+            return Benchmark { name, [resolved](BenchmarkContext& context) -> BlockFunction
+            {
+                auto stage = std::make_shared<TSStage>();
+                auto levelRamp = std::make_shared<std::vector<float>>((size_t)context.BlockSize, 0.7f);
+                auto presets = std::make_shared<std::vector<TSStage::Settings>>(2);
+                auto blockIndex = std::make_shared<int>(0);
+                stage->Prepare(context.SampleRate, context.NumChannels);
+
+                TSStage::Resolve(0.2f, 0.8f, context.SampleRate, (*presets)[0]);
+                TSStage::Resolve(0.9f, 0.1f, context.SampleRate, (*presets)[1]);
+
+                return [&context, stage, levelRamp, presets, blockIndex, resolved](int inputPosition, int numSamples)
+                {
+                    copyInput(context, inputPosition, numSamples);
+
+                    const auto& preset = (*presets)[(size_t)((*blockIndex)++ & 1)];
+
+                    if (resolved)
+                        stage->Apply(preset);
+
+                    stage->Update(preset.Drive, preset.Tone, true, levelRamp->data());
+                    stage->Process(getLayout(context.NumChannels), context.Buffer->getArrayOfWritePointers(), context.NumChannels, numSamples);
+                };
+            } };
+        };
+
+        benchmarks.push_back(tsPresetBenchmark("TSStage.PresetSwitch.Resolved", true));
+        benchmarks.push_back(tsPresetBenchmark("TSStage.PresetSwitch.Recalculated", false));
+
+        // The delay DSP on its own, with and without ping pong.
+        auto delayStageBenchmark = [](const String& name, bool pingPong)
+        {
+            return Benchmark { name, [pingPong](BenchmarkContext& context) -> BlockFunction
+            {
+                auto stage = std::make_shared<DelayStage>();
+                auto feedbackRamp = std::make_shared<std::vector<float>>((size_t)context.BlockSize, 0.5f);
+                auto mixRamp = std::make_shared<std::vector<float>>((size_t)context.BlockSize, 0.5f);
+                auto masterRamp = std::make_shared<std::vector<float>>((size_t)context.BlockSize, 1.0f);
+                stage->Prepare(context.SampleRate, context.NumChannels, context.BlockSize);
+                stage->SetDelayTime((float)(context.SampleRate * 0.3317), 0);
+
+                return [&context, stage, feedbackRamp, mixRamp, masterRamp, pingPong](int inputPosition, int numSamples)
+                {
+                    copyInput(context, inputPosition, numSamples);
+                    stage->Update(pingPong, feedbackRamp->data(), mixRamp->data(), masterRamp->data());
+                    stage->Process(getLayout(context.NumChannels), context.Buffer->getArrayOfWritePointers(), context.NumChannels, numSamples);
+                };
+            } };
+        };
+
+        benchmarks.push_back(delayStageBenchmark("DelayStage", false));
+        benchmarks.push_back(delayStageBenchmark("DelayStage.PingPong", true));
+
+        // Four chorus LFOs per channel, read back into the buffer so none of the work can be skipped. The bank with each shape, against the same
+        // phase accumulators calling std::sin every sample.
+        auto lfoBenchmark = [](const String& name, int shape)
+        {
+            return Benchmark { name, [shape](BenchmarkContext& context) -> BlockFunction
+            {
+                auto bank = std::make_shared<LfoBank>();
+                int numVoices = 4 * context.NumChannels;
+                auto phases = std::make_shared<std::vector<double>>((size_t)numVoices, 0.0);
+
+                for (int voice = 0; voice < numVoices; voice++)
+                {
+                    bank->SetShape(voice, shape == 2 ? LfoBank::Shape::SmoothRandom : LfoBank::Shape::Sine);
+                    bank->SetRate(voice, 0.5f + 0.37f * voice);
+                }
+
+                bank->Prepare(context.SampleRate, numVoices, context.BlockSize);
+
+                return [&context, bank, phases, shape](int, int numSamples)
+                {
+                    const float* values = shape == 0 ? nullptr : bank->Process(numSamples);
+                    int stride = bank->GetStride();
+
+                    for (int channel = 0; channel < context.NumChannels; channel++)
+                    {
+                        float* output = context.Buffer->getWritePointer(channel);
+
+                        for (int sample = 0; sample < numSamples; sample++)
+                        {
+                            float sum = 0.0f;
+
+                            for (int voice = channel * 4; voice < channel * 4 + 4; voice++)
+                            {
+                                if (values != nullptr)
+                                {
+                                    sum += values[sample * stride + voice];
+                                }
+                                else
+                                {
+                                    double& phase = (*phases)[(size_t)voice];
+                                    sum += std::sin((float)(phase * MathConstants<double>::twoPi));
+                                    phase += (0.5 + 0.37 * voice) / context.SampleRate;
+                                    phase -= phase >= 1.0 ? 1.0 : 0.0;
+                                }
+                            }
+
+                            output[sample] = sum;
+                        }
+                    }
+                };
+            } };
+        };
+
+        benchmarks.push_back(lfoBenchmark("Modulation.Lfo.StdSin", 0));
+        benchmarks.push_back(lfoBenchmark("Modulation.Lfo.Sine", 1));
+        benchmarks.push_back(lfoBenchmark("Modulation.Lfo.SmoothRandom", 2));
+
+        // An envelope follower on every channel, its envelope written back over the input.
+        benchmarks.push_back({ "Modulation.EnvelopeFollower", [](BenchmarkContext& context) -> BlockFunction
+        {
+            auto follower = std::make_shared<EnvelopeFollower>();
+            follower->SetTimes(5.0f, 120.0f);
+            follower->Prepare(context.SampleRate, context.NumChannels, context.BlockSize);
+
+            return [&context, follower](int inputPosition, int numSamples)
+            {
+                copyInput(context, inputPosition, numSamples);
+
+                const float* levels = follower->Process(context.Buffer->getArrayOfReadPointers(), numSamples);
+                int stride = follower->GetStride();
+
+                for (int channel = 0; channel < context.NumChannels; channel++)
+                {
+                    float* output = context.Buffer->getWritePointer(channel);
+
+                    for (int sample = 0; sample < numSamples; sample++)
+                        output[sample] = levels[sample * stride + channel];
+                }
+            };
+        } });
+
+        // The full processors, including parameter handling, smoothing and idle detection (the noise input keeps them awake).
+        benchmarks.push_back(processorBenchmark("TSPlugin.processBlock.Tanh", "ts", { { "BYPASS", "OFF" }, { "CLIPPER", "Tanh" } }));
+        benchmarks.push_back(processorBenchmark("TSPlugin.processBlock.Diode", "ts", { { "BYPASS", "OFF" }, { "CLIPPER", "Diode" } }));
+        benchmarks.push_back(processorBenchmark("TSPlugin.processBlock.Tanh.Bands4", "ts", { { "BYPASS", "OFF" }, { "CLIPPER", "Tanh" }, { "BANDS", "4" } }));
+        benchmarks.push_back(processorBenchmark("TSPlugin.processBlock.Tanh.Double", "ts", { { "BYPASS", "OFF" }, { "CLIPPER", "Tanh" } }, true));
+        benchmarks.push_back(processorBenchmark("TSPlugin.processBlock.Diode.Double", "ts", { { "BYPASS", "OFF" }, { "CLIPPER", "Diode" } }, true));
+        benchmarks.push_back(processorBenchmark("DelayPlugin.processBlock", "delay", {}));
+        benchmarks.push_back(processorBenchmark("DelayPlugin.processBlock.PingPong", "delay", { { "PINGPONGENABLED", "1" } }));
+        benchmarks.push_back(processorBenchmark("DelayPlugin.processBlock.Double", "delay", {}, true));
+        benchmarks.push_back(processorBenchmark("ChainPlugin.processBlock", "chain", {}));
+
+        return benchmarks;
+    }
+
+    // Time one benchmark at one block size, sample rate and channel count. A warm up run is made first, then the median of the timed runs is
+    // reported so a stray interruption doesn't skew the result.
+    BenchmarkResult runBenchmark(const Benchmark& benchmark, const BenchmarkSettings& settings, double sampleRate, int blockSize, int numChannels)
+    {
+        BenchmarkContext context;
+        context.SampleRate = sampleRate;
+        context.BlockSize = blockSize;
+        context.NumChannels = numChannels;
+
+        // One second of noise at -12 dB, the same for every run so the results are repeatable.
+        int inputLength = jmax((int)sampleRate, blockSize);
+        AudioBuffer<float> input(numChannels, inputLength);
+        AudioBuffer<float> buffer(numChannels, blockSize);
+        Random random(0x5eed);
+
+        for (int channel = 0; channel < numChannels; channel++)
+            for (int sample = 0; sample < inputLength; sample++)
+                input.getWritePointer(channel)[sample] = (random.nextFloat() * 2.0f - 1.0f) * 0.25f;
+
+        context.Input = &input;
+        context.Buffer = &buffer;
+
+        BlockFunction processBlock = benchmark.Create(context);
+
+        int samplesPerRun = jmax(blockSize, (int)(sampleRate * settings.SecondsPerRun));
+        int inputPosition = 0;
+
+        auto timedRun = [&]()
+        {
+            juce::int64 startTicks = TimingStats::Now();
+
+            for (int processed = 0; processed < samplesPerRun; processed += blockSize)
+            {
+                int numSamples = jmin(blockSize, samplesPerRun - processed);
+
+                if (inputPosition + numSamples > inputLength)
+                    inputPosition = 0;
+
+                processBlock(inputPosition, numSamples);
+                inputPosition += numSamples;
+            }
+
+            return TimingStats::ElapsedNs(startTicks, TimingStats::Now()) / (double)samplesPerRun;
+        };
+
+        timedRun();
+
+        TimingStats::Collector runs;
+        runs.Reserve((size_t)settings.NumRuns);
+
+        for (int run = 0; run < settings.NumRuns; run++)
+            runs.Add(timedRun());
+
+        BenchmarkResult result;
+        result.Name = benchmark.Name;
+        result.SampleRate = sampleRate;
+        result.BlockSize = blockSize;
+        result.NumChannels = numChannels;
+        result.MedianNsPerSample = runs.Median();
+        result.MinNsPerSample = runs.Min();
+        result.RealtimeFactor = 1.0e9 / (result.MedianNsPerSample * sampleRate);
+        return result;
+    }
+
+    var resultsToJson(const std::vector<BenchmarkResult>& results, const BenchmarkSettings& settings)
+    {
+        auto* root = new DynamicObject();
+        root->setProperty("date", Time::getCurrentTime().toISO8601(true));
+        root->setProperty("cpu", SystemStats::getCpuModel());
+        root->setProperty("numCpus", SystemStats::getNumCpus());
+        root->setProperty("simd", Simd::GetIsaName(Simd::GetIsa()));
+        root->setProperty("os", SystemStats::getOperatingSystemName());
+       #if JUCE_DEBUG
+        root->setProperty("build", "Debug");
+       #else
+        root->setProperty("build", "Release");
+       #endif
+        root->setProperty("secondsPerRun", settings.SecondsPerRun);
+        root->setProperty("runs", settings.NumRuns);
+
+        Array<var> resultArray;
+
+        for (auto& result : results)
+        {
+            auto* entry = new DynamicObject();
+            entry->setProperty("name", result.Name);
+            entry->setProperty("sampleRate", result.SampleRate);
+            entry->setProperty("blockSize", result.BlockSize);
+            entry->setProperty("channels", result.NumChannels);
+            entry->setProperty("nsPerSample", result.MedianNsPerSample);
+            entry->setProperty("minNsPerSample", result.MinNsPerSample);
+            entry->setProperty("realtimeFactor", result.RealtimeFactor);
+            resultArray.add(var(entry));
+        }
+
+        root->setProperty("results", resultArray);
+        return var(root);
+    }
+
+    // Compare the results with an earlier run, returns the number of benchmarks that got slower by more than the tolerance.
+    int compareWithBaseline(const std::vector<BenchmarkResult>& results, const BenchmarkSettings& settings)
+    {
+        var baseline = JSON::parse(settings.CompareFile);
+
+        if (! baseline.isObject())
+        {
+            std::cout << "Could not read " << settings.CompareFile.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        int numRegressions = 0;
+        int numCompared = 0;
+
+        for (auto& result : results)
+        {
+            if (auto* baselineResults = baseline["results"].getArray())
+            {
+                for (auto& entry : *baselineResults)
+                {
+                    BenchmarkResult old;
+                    old.Name = entry["name"].toString();
+                    old.SampleRate = (double)entry["sampleRate"];
+                    old.BlockSize = (int)entry["blockSize"];
+                    old.NumChannels = (int)entry["channels"];
+
+                    if (old.GetKey() != result.GetKey())
+                        continue;
+
+                    double change = ((result.MedianNsPerSample / (double)entry["nsPerSample"]) - 1.0) * 100.0;
+                    ++numCompared;
+
+                    if (change > settings.TolerancePercent)
+                    {
+                        ++numRegressions;
+                        std::cout << "SLOWER  " << result.GetKey() << "  " << String(change, 1) << "%" << std::endl;
+                    }
+                }
+            }
+        }
+
+        std::cout << numCompared << " results compared, " << numRegressions << " slower than the " << String(settings.TolerancePercent, 1) << "% tolerance" << std::endl;
+        return numRegressions;
+    }
+
+    template <typename Type>
+    std::vector<Type> parseList(const String& text)
+    {
+        std::vector<Type> values;
+        StringArray tokens;
+        tokens.addTokens(text, ",", "");
+
+        for (auto& token : tokens)
+            if (token.trim().isNotEmpty())
+                values.push_back((Type)token.trim().getDoubleValue());
+
+        return values;
+    }
+
+    bool parseArguments(int argc, char* argv[], BenchmarkSettings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            String argument(argv[i]);
+
+            if (argument == "--list")
+            {
+                settings.ListOnly = true;
+                continue;
+            }
+
+            if (! argument.startsWith("--") || i + 1 >= argc)
+            {
+                std::cout << "Unknown or incomplete option " << argument << std::endl;
+                return false;
+            }
+
+            String value(argv[++i]);
+
+            if (argument == "--filter")
+                settings.Filter = value;
+            else if (argument == "--blocks")
+                settings.BlockSizes = parseList<int>(value);
+            else if (argument == "--rates")
+                settings.SampleRates = parseList<double>(value);
+            else if (argument == "--channels")
+                settings.ChannelCounts = parseList<int>(value);
+            else if (argument == "--seconds")
+                settings.SecondsPerRun = jmax(0.001, value.getDoubleValue());
+            else if (argument == "--runs")
+                settings.NumRuns = jmax(1, value.getIntValue());
+            else if (argument == "--json")
+                settings.JsonFile = File::getCurrentWorkingDirectory().getChildFile(value);
+            else if (argument == "--compare")
+                settings.CompareFile = File::getCurrentWorkingDirectory().getChildFile(value);
+            else if (argument == "--tolerance")
+                settings.TolerancePercent = value.getDoubleValue();
+            else
+            {
+                std::cout << "Unknown option " << argument << std::endl;
+                return false;
+            }
+        }
+
+        // Only mono and stereo are supported by the plugins, and every block size needs at least one sample.
+        settings.ChannelCounts.erase(std::remove_if(settings.ChannelCounts.begin(), settings.ChannelCounts.end(), [](int n) { return n < 1 || n > 2; }), settings.ChannelCounts.end());
+        settings.BlockSizes.erase(std::remove_if(settings.BlockSizes.begin(), settings.BlockSizes.end(), [](int n) { return n < 1; }), settings.BlockSizes.end());
+        settings.SampleRates.erase(std::remove_if(settings.SampleRates.begin(), settings.SampleRates.end(), [](double n) { return n < 8000.0; }), settings.SampleRates.end());
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processors' parameter trees need the message manager to exist, even though nothing here runs a message loop.
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    BenchmarkSettings settings;
+
+    if (! parseArguments(argc, argv, settings))
+        return 1;
+
+    std::vector<Benchmark> benchmarks = createBenchmarks();
+
+    if (settings.ListOnly)
+    {
+        for (auto& benchmark : benchmarks)
+            std::cout << benchmark.Name << std::endl;
+
+        return 0;
+    }
+
+    std::vector<BenchmarkResult> results;
+
+    std::cout << "DSP kernels: " << Simd::GetIsaName(Simd::GetIsa()) << std::endl;
+
+    std::cout << String("benchmark").paddedRight(' ', 36) << String("rate").paddedLeft(' ', 8) << String("block").paddedLeft(' ', 7)
+              << String("ch").paddedLeft(' ', 4) << String("ns/sample").paddedLeft(' ', 12) << String("x realtime").paddedLeft(' ', 12) << std::endl;
+
+    for (auto& benchmark : benchmarks)
+    {
+        if (settings.Filter.isNotEmpty() && ! benchmark.Name.containsIgnoreCase(settings.Filter))
+            continue;
+
+        for (double sampleRate : settings.SampleRates)
+        {
+            for (int numChannels : settings.ChannelCounts)
+            {
+                for (int blockSize : settings.BlockSizes)
+                {
+                    BenchmarkResult result = runBenchmark(benchmark, settings, sampleRate, blockSize, numChannels);
+                    results.push_back(result);
+
+                    std::cout << result.Name.paddedRight(' ', 36) << String(sampleRate, 0).paddedLeft(' ', 8) << String(blockSize).paddedLeft(' ', 7)
+                              << String(numChannels).paddedLeft(' ', 4) << String(result.MedianNsPerSample, 2).paddedLeft(' ', 12)
+                              << String(result.RealtimeFactor, 1).paddedLeft(' ', 12) << std::endl;
+                }
+            }
+        }
+    }
+
+    if (settings.JsonFile != File())
+    {
+        if (! settings.JsonFile.replaceWithText(JSON::toString(resultsToJson(results, settings))))
+        {
+            std::cout << "Could not write " << settings.JsonFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    if (settings.CompareFile != File() && compareWithBaseline(results, settings) > 0)
+        return 2;
+
+    return 0;
+}
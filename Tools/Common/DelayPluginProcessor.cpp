@@ -0,0 +1,13 @@
+/*
+  ==============================================================================
+
+    DelayPluginProcessor.cpp
+    Created: 19 Oct 2026 6:31:52pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+// Builds the Delay plugin processor into the tools. Every plugin's processor source is called PluginProcessor.cpp, so each one is compiled through
+// a file with its own name to keep the object files apart. Build with JEPLUGINS_HEADLESS=1 to get createDelayPluginProcessor.
+#include "../../Episode 4 - Delay/DelayPlugin/Source/PluginProcessor.cpp"
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    HeadlessHost.h
+    Created: 19 Oct 2026 6:20:11pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <memory>
+#include <JuceHeader.h>
+
+// Factories for the plugin processors. The tools build the plugin sources with JEPLUGINS_HEADLESS=1, which gives each processor its own factory
+// in place of createPluginFilter so they can all be linked into one program.
+juce::AudioProcessor* createTSPluginProcessor();
+juce::AudioProcessor* createDelayPluginProcessor();
+juce::AudioProcessor* createChainPluginProcessor();
+
+// Sample accurate parameter changes, each returns false for any processor that is not its own plugin's.
+bool scheduleTSParameterChange(juce::AudioProcessor& processor, int parameterIndex, float normalisedValue, int sampleOffset);
+bool scheduleDelayParameterChange(juce::AudioProcessor& processor, int parameterIndex, float normalisedValue, int sampleOffset);
+bool scheduleChainParameterChange(juce::AudioProcessor& processor, int parameterIndex, float normalisedValue, int sampleOffset);
+
+// Helpers for driving the plugin processors without a plugin host, shared by the command line tools.
+namespace HeadlessHost
+{
+    struct PluginEntry
+    {
+        const char* Name;
+        juce::AudioProcessor* (*Create)();
+        bool (*ScheduleParameterChange)(juce::AudioProcessor&, int, float, int);
+    };
+
+    // Every plugin the tools can run, by the name used on the command line.
+    static const PluginEntry Plugins[] = { { "ts",    createTSPluginProcessor,    scheduleTSParameterChange },
+                                           { "delay", createDelayPluginProcessor, scheduleDelayParameterChange },
+                                           { "chain", createChainPluginProcessor, scheduleChainParameterChange } };
+
+    // A parameter value given on the command line, the value is the parameter's own text ("0.7", "Diode", "1/8D").
+    struct ParameterSetting
+    {
+        juce::String Id;
+        juce::String Value;
+    };
+
+    // List of the plugin names for usage messages.
+    inline juce::String GetPluginNames()
+    {
+        juce::String names;
+
+        for (auto& plugin : Plugins)
+            names = names.isEmpty() ? juce::String(plugin.Name) : names + ", " + plugin.Name;
+
+        return names;
+    }
+
+    // Create a processor by name, returns nullptr if there is no plugin with that name.
+    inline std::unique_ptr<juce::AudioProcessor> CreateProcessor(const juce::String& name)
+    {
+        for (auto& plugin : Plugins)
+            if (name.equalsIgnoreCase(plugin.Name))
+                return std::unique_ptr<juce::AudioProcessor>(plugin.Create());
+
+        return nullptr;
+    }
+
+    // Find a parameter by its ID or name, returns nullptr if the processor has no such parameter.
+    inline juce::RangedAudioParameter* FindParameter(juce::AudioProcessor& processor, const juce::String& id)
+    {
+        for (auto* parameter : processor.getParameters())
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+
+            if (ranged != nullptr && (id.equalsIgnoreCase(ranged->getParameterID()) || id.equalsIgnoreCase(ranged->getName(64))))
+                return ranged;
+        }
+
+        return nullptr;
+    }
+
+    // Set a parameter from its text, matched against the parameter ID or name. Set parameters before PrepareProcessor so the processor starts at
+    // the new values instead of smoothing towards them. Returns false if the processor has no such parameter.
+    inline bool SetParameter(juce::AudioProcessor& processor, const ParameterSetting& setting)
+    {
+        juce::RangedAudioParameter* parameter = FindParameter(processor, setting.Id);
+
+        if (parameter == nullptr)
+            return false;
+
+        parameter->setValueNotifyingHost(parameter->getValueForText(setting.Value));
+        return true;
+    }
+
+    // Change a parameter from its text at sampleOffset samples into the next processBlock, as a host with sample accurate automation would. Call
+    // between blocks. Returns false if the processor has no such parameter or could not take the change.
+    inline bool ScheduleParameter(juce::AudioProcessor& processor, const ParameterSetting& setting, int sampleOffset)
+    {
+        juce::RangedAudioParameter* parameter = FindParameter(processor, setting.Id);
+
+        if (parameter == nullptr)
+            return false;
+
+        float value = parameter->getValueForText(setting.Value);
+
+        for (auto& plugin : Plugins)
+            if (plugin.ScheduleParameterChange(processor, parameter->getParameterIndex(), value, sampleOffset))
+                return true;
+
+        return false;
+    }
+
+    // Set up a processor for numChannels in and out and prepare it. Only mono and stereo are supported by the plugins, returns false for anything else.
+    // With doublePrecision the processor is prepared for processBlock with double buffers, as a host with a 64 bit mix bus would.
+    inline bool PrepareProcessor(juce::AudioProcessor& processor, int numChannels, double sampleRate, int blockSize, bool nonRealtime,
+                                 bool doublePrecision = false)
+    {
+        if (numChannels < 1 || numChannels > 2)
+            return false;
+
+        // setPlayConfigDetails has no result, so check the buses ended up with the channels asked for.
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+
+        if (processor.getTotalNumInputChannels() != numChannels || processor.getTotalNumOutputChannels() != numChannels)
+            return false;
+
+        if (doublePrecision && ! processor.supportsDoublePrecisionProcessing())
+            return false;
+
+        processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+        processor.setNonRealtime(nonRealtime);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        return true;
+    }
+}
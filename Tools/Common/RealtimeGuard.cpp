@@ -0,0 +1,285 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.cpp
+    Created: 19 Oct 2026 9:17:52pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+// The file functions are replaced below, so the fortified inline versions from the system headers must not be used in this file.
+#undef _FORTIFY_SOURCE
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <JuceHeader.h>
+#include "RealtimeGuard.h"
+
+// On Linux with glibc every libc function can be replaced from the executable and forwarded to the real one, elsewhere only the C++ allocation
+// functions can be replaced portably.
+#if defined(__linux__) && defined(__GLIBC__)
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <pthread.h>
+ #include <sched.h>
+ #include <semaphore.h>
+ #include <sys/mman.h>
+ #include <time.h>
+ #include <unistd.h>
+ #define REALTIME_GUARD_INTERPOSE_LIBC 1
+#else
+ #define REALTIME_GUARD_INTERPOSE_LIBC 0
+#endif
+
+#if REALTIME_GUARD_INTERPOSE_LIBC || JUCE_MAC
+ #include <execinfo.h>
+ #define REALTIME_GUARD_BACKTRACE 1
+#else
+ #define REALTIME_GUARD_BACKTRACE 0
+#endif
+
+namespace
+{
+    // Per thread state. These are plain thread locals so reading them never allocates, even from inside malloc.
+    thread_local int checkDepth = 0;
+    thread_local int suspendDepth = 0;
+
+    std::atomic<int> numViolations { 0 };
+    std::atomic<int> maxReports { 5 };
+    std::atomic<bool> abortOnViolation { false };
+
+    bool isChecking()
+    {
+        return checkDepth > 0 && suspendDepth == 0;
+    }
+
+    // Report a violation. Checking is suspended while reporting because printing and stack traces are allowed to allocate.
+    void reportViolation(const char* function)
+    {
+        ++suspendDepth;
+
+        int count = ++numViolations;
+
+        if (count <= maxReports.load())
+        {
+            std::fprintf(stderr, "\nREAL-TIME VIOLATION: %s called on a checked thread\n", function);
+
+           #if REALTIME_GUARD_BACKTRACE
+            void* frames[64];
+            int numFrames = backtrace(frames, 64);
+            backtrace_symbols_fd(frames, numFrames, 2);
+           #else
+            std::fputs(juce::SystemStats::getStackBacktrace().toRawUTF8(), stderr);
+           #endif
+
+            std::fflush(stderr);
+        }
+
+        if (abortOnViolation.load())
+            std::abort();
+
+        --suspendDepth;
+    }
+
+    inline void check(const char* function)
+    {
+        if (isChecking())
+            reportViolation(function);
+    }
+
+    // Where malloc is replaced as well it reports the allocation, so operator new only reports where it is the only hook.
+    inline void checkAllocation(const char* function)
+    {
+       #if ! REALTIME_GUARD_INTERPOSE_LIBC
+        check(function);
+       #else
+        juce::ignoreUnused(function);
+       #endif
+    }
+}
+
+//==============================================================================
+namespace RealtimeGuard
+{
+    void Begin() { ++checkDepth; }
+    void End() { --checkDepth; }
+
+    Suspend::Suspend() { ++suspendDepth; }
+    Suspend::~Suspend() { --suspendDepth; }
+
+    int GetNumViolations() { return numViolations.load(); }
+    void ResetViolations() { numViolations = 0; }
+
+    void SetAbortOnViolation(bool shouldAbort) { abortOnViolation = shouldAbort; }
+    void SetMaxReports(int newMaxReports) { maxReports = newMaxReports; }
+}
+
+//==============================================================================
+// C++ allocation, replaced on every platform.
+void* operator new(std::size_t size)
+{
+    checkAllocation("operator new");
+
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    if (memory != nullptr)
+        checkAllocation("operator delete");
+
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept                  { operator delete(memory); }
+void operator delete(void* memory, std::size_t) noexcept        { operator delete(memory); }
+void operator delete[](void* memory, std::size_t) noexcept      { operator delete(memory); }
+
+//==============================================================================
+#if REALTIME_GUARD_INTERPOSE_LIBC
+
+// glibc's own entry points, the replacements below check and then forward to these.
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+}
+
+namespace
+{
+    // The real versions of the other functions, looked up once in Install. They are also looked up on first use in case something calls them
+    // before main, there is no function local static here because its guard would lock a mutex.
+    template <typename Function>
+    Function resolve(Function& function, const char* name)
+    {
+        if (function == nullptr)
+            function = (Function)dlsym(RTLD_NEXT, name);
+
+        return function;
+    }
+
+    int (*realMutexLock)(pthread_mutex_t*) = nullptr;
+    int (*realMutexTryLock)(pthread_mutex_t*) = nullptr;
+    int (*realRwLockRead)(pthread_rwlock_t*) = nullptr;
+    int (*realRwLockWrite)(pthread_rwlock_t*) = nullptr;
+    int (*realCondWait)(pthread_cond_t*, pthread_mutex_t*) = nullptr;
+    int (*realCondTimedWait)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*) = nullptr;
+    int (*realSemWait)(sem_t*) = nullptr;
+    ssize_t (*realRead)(int, void*, size_t) = nullptr;
+    ssize_t (*realWrite)(int, const void*, size_t) = nullptr;
+    int (*realClose)(int) = nullptr;
+    FILE* (*realFopen)(const char*, const char*) = nullptr;
+    void* (*realMmap)(void*, size_t, int, int, int, off_t) = nullptr;
+    int (*realMunmap)(void*, size_t) = nullptr;
+    int (*realNanosleep)(const struct timespec*, struct timespec*) = nullptr;
+    int (*realUsleep)(useconds_t) = nullptr;
+    int (*realSchedYield)() = nullptr;
+}
+
+void RealtimeGuard::Install()
+{
+    resolve(realMutexLock, "pthread_mutex_lock");
+    resolve(realMutexTryLock, "pthread_mutex_trylock");
+    resolve(realRwLockRead, "pthread_rwlock_rdlock");
+    resolve(realRwLockWrite, "pthread_rwlock_wrlock");
+    resolve(realCondWait, "pthread_cond_wait");
+    resolve(realCondTimedWait, "pthread_cond_timedwait");
+    resolve(realSemWait, "sem_wait");
+    resolve(realRead, "read");
+    resolve(realWrite, "write");
+    resolve(realClose, "close");
+    resolve(realFopen, "fopen");
+    resolve(realMmap, "mmap");
+    resolve(realMunmap, "munmap");
+    resolve(realNanosleep, "nanosleep");
+    resolve(realUsleep, "usleep");
+    resolve(realSchedYield, "sched_yield");
+}
+
+extern "C"
+{
+    // Allocation
+    void* malloc(size_t size) noexcept                          { check("malloc"); return __libc_malloc(size); }
+    void* calloc(size_t count, size_t size) noexcept            { check("calloc"); return __libc_calloc(count, size); }
+    void* realloc(void* memory, size_t size) noexcept           { check("realloc"); return __libc_realloc(memory, size); }
+    void* memalign(size_t alignment, size_t size) noexcept      { check("memalign"); return __libc_memalign(alignment, size); }
+    void* aligned_alloc(size_t alignment, size_t size) noexcept { check("aligned_alloc"); return __libc_memalign(alignment, size); }
+
+    int posix_memalign(void** memory, size_t alignment, size_t size) noexcept
+    {
+        check("posix_memalign");
+        *memory = __libc_memalign(alignment, size);
+        return *memory != nullptr || size == 0 ? 0 : ENOMEM;
+    }
+
+    void free(void* memory) noexcept
+    {
+        if (memory != nullptr)
+            check("free");
+
+        __libc_free(memory);
+    }
+
+    // Locks and waits
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept     { check("pthread_mutex_lock"); return resolve(realMutexLock, "pthread_mutex_lock")(mutex); }
+    int pthread_mutex_trylock(pthread_mutex_t* mutex) noexcept  { check("pthread_mutex_trylock"); return resolve(realMutexTryLock, "pthread_mutex_trylock")(mutex); }
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept  { check("pthread_rwlock_rdlock"); return resolve(realRwLockRead, "pthread_rwlock_rdlock")(lock); }
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept  { check("pthread_rwlock_wrlock"); return resolve(realRwLockWrite, "pthread_rwlock_wrlock")(lock); }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        check("pthread_cond_wait");
+        return resolve(realCondWait, "pthread_cond_wait")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time)
+    {
+        check("pthread_cond_timedwait");
+        return resolve(realCondTimedWait, "pthread_cond_timedwait")(condition, mutex, time);
+    }
+
+    int sem_wait(sem_t* semaphore)                              { check("sem_wait"); return resolve(realSemWait, "sem_wait")(semaphore); }
+
+    // Files
+    ssize_t read(int file, void* data, size_t size)             { check("read"); return resolve(realRead, "read")(file, data, size); }
+    ssize_t write(int file, const void* data, size_t size)      { check("write"); return resolve(realWrite, "write")(file, data, size); }
+    int close(int file)                                         { check("close"); return resolve(realClose, "close")(file); }
+    FILE* fopen(const char* path, const char* mode)             { check("fopen"); return resolve(realFopen, "fopen")(path, mode); }
+
+    // Memory mapping
+    void* mmap(void* address, size_t size, int protection, int flags, int file, off_t offset) noexcept
+    {
+        check("mmap");
+        return resolve(realMmap, "mmap")(address, size, protection, flags, file, offset);
+    }
+
+    int munmap(void* address, size_t size) noexcept             { check("munmap"); return resolve(realMunmap, "munmap")(address, size); }
+
+    // Sleeping and yielding
+    int nanosleep(const struct timespec* time, struct timespec* remaining) { check("nanosleep"); return resolve(realNanosleep, "nanosleep")(time, remaining); }
+    int usleep(useconds_t time)                                 { check("usleep"); return resolve(realUsleep, "usleep")(time); }
+    int sched_yield() noexcept                                  { check("sched_yield"); return resolve(realSchedYield, "sched_yield")(); }
+}
+
+#else
+
+void RealtimeGuard::Install()
+{
+}
+
+#endif
@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.h
+    Created: 19 Oct 2026 9:17:52pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// Catches code that is not real-time safe while it runs on a thread that is being checked. The tool that links RealtimeGuard.cpp replaces the
+// allocation functions (operator new/delete everywhere, and malloc/free on Linux) and on Linux also interposes the mutex, condition variable,
+// semaphore, file, memory mapping and sleep calls. Any of them being called inside a RealtimeGuard::Scope is a violation, which is reported with
+// a stack trace.
+//
+// Only link RealtimeGuard.cpp into the test tools, never into the plugins.
+namespace RealtimeGuard
+{
+    // Resolve the interposed functions, call once at the start of main before any checking starts.
+    void Install();
+
+    // Start and stop checking the calling thread. Scopes can be nested.
+    void Begin();
+    void End();
+
+    // Checks the calling thread for as long as it is in scope.
+    struct Scope
+    {
+        Scope() { Begin(); }
+        ~Scope() { End(); }
+    };
+
+    // Call on a checked thread to suspend checking, for work the test itself does in the middle of a checked section.
+    struct Suspend
+    {
+        Suspend();
+        ~Suspend();
+    };
+
+    // Number of violations since the last reset, on any thread.
+    int GetNumViolations();
+    void ResetViolations();
+
+    // Stop the process at the first violation rather than counting them, useful under a debugger.
+    void SetAbortOnViolation(bool shouldAbort);
+
+    // Stack traces are printed for the first few violations since the last reset, the rest are only counted.
+    void SetMaxReports(int maxReports);
+}
@@ -0,0 +1,390 @@
+/*
+  ==============================================================================
+
+    SessionHost.cpp
+    Created: 20 Oct 2026 9:41:06pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#include "SessionHost.h"
+#include "HeadlessHost.h"
+
+namespace
+{
+    // How many times a thread with nothing to do checks for the next block before it goes to sleep, a few milliseconds of spinning. A session
+    // rendering back to back never sleeps, one that has stopped does not keep the cores busy.
+    static constexpr int SpinsBeforeSleep = 20000;
+
+    // Longest a sleeping thread waits before checking again, in case it is asked to exit.
+    static constexpr int SleepTimeoutMs = 100;
+
+    // Space reserved in each thread's MIDI buffer, the plugins make no MIDI so this is only there so one that did would not allocate.
+    static constexpr int MidiScratchBytes = 2048;
+
+    // Chase-Lev work-stealing deque of node indices, with the memory orders from Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+    // Work-Stealing for Weak Memory Models". The owning thread pushes and takes at the bottom, newest first, any other thread steals from the
+    // top, oldest first. Only a take and a steal going for the last node at the same time ever contend, and they settle it with one compare and
+    // swap. Every node is queued once a block, so a ring with room for every node never fills and never needs to grow.
+    class WorkQueue
+    {
+
+    public:
+
+        explicit WorkQueue(int capacity)
+            : items((size_t)capacity), mask(capacity - 1)
+        {
+            jassert(juce::isPowerOfTwo(capacity));
+        }
+
+        // Owning thread only.
+        void Push(int item)
+        {
+            juce::int64 b = bottom.load(std::memory_order_relaxed);
+
+            items[(size_t)(b & mask)].store(item, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        // Owning thread only, returns -1 when the queue is empty.
+        int Take()
+        {
+            juce::int64 b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            juce::int64 t = top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return -1;
+            }
+
+            int item = items[(size_t)(b & mask)].load(std::memory_order_relaxed);
+
+            // The last node, a thief may be taking it at the same time.
+            if (t == b)
+            {
+                if (! top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    item = -1;
+
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        // Any other thread, returns -1 when the queue is empty or another thread got the node first.
+        int Steal()
+        {
+            juce::int64 t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            juce::int64 b = bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+                return -1;
+
+            int item = items[(size_t)(t & mask)].load(std::memory_order_relaxed);
+
+            if (! top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return -1;
+
+            return item;
+        }
+
+    private:
+
+        std::vector<std::atomic<int>> items;
+        juce::int64 mask;
+
+        // Each end on a cache line of its own, so the owner working at the bottom does not slow down thieves reading the top.
+        alignas(64) std::atomic<juce::int64> top { 0 };
+        alignas(64) std::atomic<juce::int64> bottom { 0 };
+    };
+}
+
+struct SessionHost::Worker
+{
+    explicit Worker(int capacity)
+        : Queue(capacity)
+    {
+        Midi.ensureSize(MidiScratchBytes);
+    }
+
+    WorkQueue Queue;
+    ThreadStats Stats;
+
+    // Scratch for the nodes this thread runs. processBlock needs a MIDI buffer, it is cleared after every node.
+    juce::MidiBuffer Midi;
+
+    // Set while the thread sleeps between blocks, Process only wakes threads that have it set.
+    std::atomic<bool> Sleeping { false };
+    juce::WaitableEvent WakeUp;
+};
+
+SessionHost::SessionHost()
+{
+
+}
+
+SessionHost::~SessionHost()
+{
+    Release();
+}
+
+int SessionHost::AddNode(const juce::String& name, std::unique_ptr<juce::AudioProcessor> processor, InputFunction input)
+{
+    jassert(threads.empty());
+
+    auto node = std::make_unique<Node>();
+    node->Name = name;
+    node->Processor = std::move(processor);
+    node->Input = std::move(input);
+    nodes.push_back(std::move(node));
+
+    return (int)nodes.size() - 1;
+}
+
+void SessionHost::Connect(int source, int destination)
+{
+    jassert(threads.empty());
+    jassert(juce::isPositiveAndBelow(source, (int)nodes.size()) && juce::isPositiveAndBelow(destination, (int)nodes.size()) && source != destination);
+
+    nodes[(size_t)destination]->Sources.push_back(source);
+    nodes[(size_t)source]->Destinations.push_back(destination);
+}
+
+bool SessionHost::checkOrder() const
+{
+    // Take away nodes whose sources have all been taken away, if every node goes there is no loop.
+    std::vector<int> pending(nodes.size());
+    std::vector<int> ready;
+
+    for (size_t node = 0; node < nodes.size(); node++)
+    {
+        pending[node] = (int)nodes[node]->Sources.size();
+
+        if (pending[node] == 0)
+            ready.push_back((int)node);
+    }
+
+    size_t numTaken = 0;
+
+    while (! ready.empty())
+    {
+        int node = ready.back();
+        ready.pop_back();
+        numTaken++;
+
+        for (int destination : nodes[(size_t)node]->Destinations)
+            if (--pending[(size_t)destination] == 0)
+                ready.push_back(destination);
+    }
+
+    return numTaken == nodes.size();
+}
+
+bool SessionHost::Prepare(double sampleRate, int maxBlockSize, int numChannels, int numThreads)
+{
+    Release();
+
+    if (! checkOrder())
+        return false;
+
+    NumChannels = numChannels;
+    MaxBlockSize = juce::jmax(1, maxBlockSize);
+    roots.clear();
+
+    for (size_t index = 0; index < nodes.size(); index++)
+    {
+        Node& node = *nodes[index];
+
+        if (node.Processor != nullptr && ! HeadlessHost::PrepareProcessor(*node.Processor, NumChannels, sampleRate, MaxBlockSize, true))
+            return false;
+
+        node.Buffer.setSize(NumChannels, MaxBlockSize);
+        node.Buffer.clear();
+
+        if (node.Sources.empty())
+            roots.push_back((int)index);
+    }
+
+    // Any one queue may end up holding every node, the calling thread's holds all the roots at the start of a block.
+    int capacity = juce::nextPowerOfTwo(juce::jmax(1, (int)nodes.size()));
+
+    workers.clear();
+
+    for (int thread = 0; thread < juce::jmax(1, numThreads); thread++)
+        workers.push_back(std::make_unique<Worker>(capacity));
+
+    shouldExit = false;
+
+    for (int thread = 1; thread < (int)workers.size(); thread++)
+        threads.emplace_back([this, thread] { runWorker(thread); });
+
+    return true;
+}
+
+void SessionHost::Release()
+{
+    shouldExit = true;
+
+    for (auto& worker : workers)
+        worker->WakeUp.signal();
+
+    for (auto& thread : threads)
+        thread.join();
+
+    threads.clear();
+
+    for (auto& node : nodes)
+        if (node->Processor != nullptr)
+            node->Processor->releaseResources();
+}
+
+const SessionHost::ThreadStats& SessionHost::GetThreadStats(int thread) const
+{
+    return workers[(size_t)thread]->Stats;
+}
+
+void SessionHost::Process(int numSamples)
+{
+    jassert(! workers.empty());
+
+    numSamples = juce::jlimit(0, MaxBlockSize, numSamples);
+
+    if (nodes.empty() || numSamples == 0)
+        return;
+
+    // Everything a block needs is set before the roots are queued, the queue's release fence makes it visible to any thread that steals one.
+    for (auto& node : nodes)
+        node->Pending.store((int)node->Sources.size(), std::memory_order_relaxed);
+
+    blockSize.store(numSamples, std::memory_order_relaxed);
+    remaining.store((int)nodes.size(), std::memory_order_relaxed);
+
+    Worker& own = *workers.front();
+
+    for (int root : roots)
+        own.Queue.Push(root);
+
+    // Start the block, and wake any thread that has gone to sleep. Either the thread sees the new generation before it sleeps or this sees it
+    // asleep, both are sequentially consistent so it can never miss the block.
+    generation.fetch_add(1, std::memory_order_seq_cst);
+
+    for (auto& worker : workers)
+        if (worker->Sleeping.load(std::memory_order_seq_cst))
+            worker->WakeUp.signal();
+
+    work(0);
+}
+
+void SessionHost::runWorker(int thread)
+{
+    Worker& worker = *workers[(size_t)thread];
+    juce::int64 seen = generation.load(std::memory_order_acquire);
+
+    while (true)
+    {
+        // Spin until the next block, then sleep if it is a long time coming.
+        int spins = 0;
+
+        while (generation.load(std::memory_order_acquire) == seen && ! shouldExit.load(std::memory_order_relaxed))
+        {
+            if (++spins < SpinsBeforeSleep)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            worker.Sleeping.store(true, std::memory_order_seq_cst);
+
+            if (generation.load(std::memory_order_seq_cst) == seen && ! shouldExit.load(std::memory_order_relaxed))
+                worker.WakeUp.wait(SleepTimeoutMs);
+
+            worker.Sleeping.store(false, std::memory_order_relaxed);
+        }
+
+        if (shouldExit.load(std::memory_order_relaxed))
+            return;
+
+        seen = generation.load(std::memory_order_acquire);
+        work(thread);
+    }
+}
+
+void SessionHost::work(int thread)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    Worker& worker = *workers[(size_t)thread];
+    int numWorkers = (int)workers.size();
+
+    // Run this thread's own nodes first, then steal from the others in turn starting with the next thread along, until every node in the block
+    // has finished.
+    while (remaining.load(std::memory_order_acquire) > 0)
+    {
+        int node = worker.Queue.Take();
+
+        for (int offset = 1; offset < numWorkers && node < 0; offset++)
+        {
+            node = workers[(size_t)((thread + offset) % numWorkers)]->Queue.Steal();
+
+            if (node >= 0)
+                worker.Stats.NodesStolen++;
+        }
+
+        if (node >= 0)
+            runNode(node, worker);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void SessionHost::runNode(int index, Worker& worker)
+{
+    Node& node = *nodes[(size_t)index];
+    int numSamples = blockSize.load(std::memory_order_relaxed);
+
+    // A buffer over the node's own channels for just this block, it refers to them rather than allocating.
+    juce::AudioBuffer<float> buffer(node.Buffer.getArrayOfWritePointers(), NumChannels, numSamples);
+
+    // Sum the sources in the order they were connected. Each finished before this node was queued, and the acquire on its count makes its output
+    // visible here.
+    if (node.Sources.empty())
+    {
+        if (node.Input)
+            node.Input(buffer, numSamples);
+        else
+            buffer.clear();
+    }
+    else
+    {
+        for (int channel = 0; channel < NumChannels; channel++)
+        {
+            float* destination = buffer.getWritePointer(channel);
+            juce::FloatVectorOperations::copy(destination, nodes[(size_t)node.Sources.front()]->Buffer.getReadPointer(channel), numSamples);
+
+            for (size_t source = 1; source < node.Sources.size(); source++)
+                juce::FloatVectorOperations::add(destination, nodes[(size_t)node.Sources[source]]->Buffer.getReadPointer(channel), numSamples);
+        }
+    }
+
+    if (node.Processor != nullptr)
+    {
+        node.Processor->processBlock(buffer, worker.Midi);
+        worker.Midi.clear();
+    }
+
+    worker.Stats.NodesRun++;
+
+    // Queue the nodes this was the last source of on this thread, they read the output just written. Only then count this node as finished, so
+    // the block cannot end with nodes still to be queued.
+    for (int destination : node.Destinations)
+        if (nodes[(size_t)destination]->Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            worker.Queue.Push(destination);
+
+    remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    SessionHost.h
+    Created: 20 Oct 2026 9:41:06pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <JuceHeader.h>
+
+// Runs a whole session of plugin processors, the way a host runs tracks and buses, across a pool of threads. Each node is a processor (or just a
+// sum, for a bus with no plugin on it) and its input is the sum of the outputs of the nodes connected to it, or the node's input function for a
+// track. Every block each node runs as soon as the last of its inputs has finished, on whichever thread gets to it first.
+//
+// Each thread has its own work-stealing queue. A thread that finishes a node pushes the nodes that were only waiting on it onto its own queue and
+// takes from it newest first, so the output it just wrote is still in its cache when the next node reads it, and a thread that runs out of work
+// steals the oldest node from another thread's queue. The queues are fixed size, lock-free Chase-Lev deques, the dependency counts are atomics,
+// and every buffer is made in Prepare, so processing a block takes no locks and never allocates beyond what the plugins themselves do. Threads
+// spin between blocks while a session is rendering and only go to sleep after a while with nothing to do.
+//
+// Inputs are always summed in the order they were connected, so a session renders the same samples on any number of threads.
+class SessionHost
+{
+
+public:
+
+    // Fills a track's buffer with its input for the next block, called on whichever thread runs the track.
+    using InputFunction = std::function<void(juce::AudioBuffer<float>& buffer, int numSamples)>;
+
+    // Counts kept by each thread, read them between blocks.
+    struct ThreadStats
+    {
+        juce::int64 NodesRun = 0;
+        juce::int64 NodesStolen = 0;
+    };
+
+    // C-tor
+    SessionHost();
+    // D-tor
+    ~SessionHost();
+
+    // Add a node, returns its index. A node with no processor only sums its inputs. A node with an input function and no connections into it
+    // is a track, the function fills its buffer before the processor runs; a node with neither starts each block silent.
+    int AddNode(const juce::String& name, std::unique_ptr<juce::AudioProcessor> processor, InputFunction input = nullptr);
+
+    // Sum the output of source into the input of destination.
+    void Connect(int source, int destination);
+
+    // Prepare every processor for numChannels in and out, size the buffers and start numThreads - 1 worker threads, the thread calling Process
+    // is the last one. Returns false if a processor cannot run with numChannels or the connections form a loop.
+    bool Prepare(double sampleRate, int maxBlockSize, int numChannels, int numThreads);
+
+    // Stop the worker threads and release the processors' resources, the nodes are kept.
+    void Release();
+
+    // Run every node over the next numSamples (up to maxBlockSize) samples, returns once they have all finished.
+    void Process(int numSamples);
+
+    // Output of a node from the last Process.
+    const juce::AudioBuffer<float>& GetOutput(int node) const { return nodes[(size_t)node]->Buffer; }
+
+    int GetNumNodes() const { return (int)nodes.size(); }
+    const juce::String& GetNodeName(int node) const { return nodes[(size_t)node]->Name; }
+
+    int GetNumThreads() const { return (int)workers.size(); }
+    const ThreadStats& GetThreadStats(int thread) const;
+
+private:
+
+    struct Node
+    {
+        juce::String Name;
+        std::unique_ptr<juce::AudioProcessor> Processor;
+        InputFunction Input;
+
+        // Nodes whose outputs are summed into this one, in the order they were connected, and the nodes this one is summed into.
+        std::vector<int> Sources;
+        std::vector<int> Destinations;
+
+        // Sources still to finish in the current block.
+        std::atomic<int> Pending { 0 };
+
+        juce::AudioBuffer<float> Buffer;
+    };
+
+    // A thread's work-stealing queue, its stats and its scratch, defined in SessionHost.cpp.
+    struct Worker;
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // Nodes with no sources, queued at the start of every block.
+    std::vector<int> roots;
+
+    int NumChannels = 2;
+    int MaxBlockSize = 0;
+
+    // Block counter the worker threads wait on, the size of the current block, and the nodes in it still to finish.
+    std::atomic<juce::int64> generation { 0 };
+    std::atomic<int> blockSize { 0 };
+    std::atomic<int> remaining { 0 };
+
+    std::atomic<bool> shouldExit { false };
+
+    // Worker thread loop, and the work one thread does on a block until every node in it has finished.
+    void runWorker(int thread);
+    void work(int thread);
+
+    // Sum a node's inputs, run its processor and release the nodes waiting on it.
+    void runNode(int node, Worker& worker);
+
+    // Check every node can run, returns false if the connections form a loop so some nodes would wait on each other for ever.
+    bool checkOrder() const;
+
+    JUCE_DECLARE_NON_COPYABLE(SessionHost)
+};
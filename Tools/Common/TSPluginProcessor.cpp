@@ -0,0 +1,13 @@
+/*
+  ==============================================================================
+
+    TSPluginProcessor.cpp
+    Created: 19 Oct 2026 6:31:52pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+// Builds the TS plugin processor into the tools. Every plugin's processor source is called PluginProcessor.cpp, so each one is compiled through
+// a file with its own name to keep the object files apart. Build with JEPLUGINS_HEADLESS=1 to get createTSPluginProcessor.
+#include "../../Episode 3 - Tube Screamer/TSPlugin/Source/PluginProcessor.cpp"
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    TimingStats.h
+    Created: 19 Oct 2026 7:02:18pm
+    Author:  JEPlugins
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <JuceHeader.h>
+
+// High resolution timer and summary statistics for the benchmark and stress tools.
+namespace TimingStats
+{
+    // Current time in high resolution ticks.
+    inline juce::int64 Now()
+    {
+        return juce::Time::getHighResolutionTicks();
+    }
+
+    // Time between two tick counts in nanoseconds.
+    inline double ElapsedNs(juce::int64 startTicks, juce::int64 endTicks)
+    {
+        return (double)(endTicks - startTicks) * 1.0e9 / (double)juce::Time::getHighResolutionTicksPerSecond();
+    }
+
+    // Collects timings and summarises them. Reserve enough space before timing starts so adding a timing never allocates.
+    class Collector
+    {
+
+    public:
+
+        void Reserve(size_t numTimings) { timings.reserve(numTimings); }
+        void Clear() { timings.clear(); sorted = true; }
+        void Add(double timing) { timings.push_back(timing); sorted = false; }
+
+        size_t Size() const { return timings.size(); }
+        bool IsEmpty() const { return timings.empty(); }
+
+        // Value below which the given percentage (0 - 100) of the timings fall, using the nearest rank.
+        double Percentile(double percent)
+        {
+            if (timings.empty())
+                return 0.0;
+
+            sort();
+
+            size_t rank = (size_t)std::ceil(percent / 100.0 * (double)timings.size());
+            return timings[juce::jlimit((size_t)0, timings.size() - 1, rank == 0 ? 0 : rank - 1)];
+        }
+
+        double Median() { return Percentile(50.0); }
+        double Min() { sort(); return timings.empty() ? 0.0 : timings.front(); }
+        double Max() { sort(); return timings.empty() ? 0.0 : timings.back(); }
+
+        double Mean() const
+        {
+            double total = 0.0;
+
+            for (double timing : timings)
+                total += timing;
+
+            return timings.empty() ? 0.0 : total / (double)timings.size();
+        }
+
+        // Number of timings above a limit.
+        int CountAbove(double limit) const
+        {
+            return (int)std::count_if(timings.begin(), timings.end(), [limit](double timing) { return timing > limit; });
+        }
+
+    private:
+
+        std::vector<double> timings;
+        bool sorted = true;
+
+        void sort()
+        {
+            if (! sorted)
+                std::sort(timings.begin(), timings.end());
+
+            sorted = true;
+        }
+
+    };
+}
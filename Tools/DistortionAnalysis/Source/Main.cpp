@@ -0,0 +1,598 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 20 Oct 2026 9:14:52am
+    Author:  JEPlugins
+
+    THD and aliasing measurements for the clippers and the TS chain, the C++ replacement for the thd() plots in dist_test.m. Every device is
+    driven with steady sines over a grid of drive, frequency and sample rate, once at the base rate and once for each oversampling setting, and
+    the FFT of the output gives the harmonic distortion and the energy aliased back below Nyquist. The grid runs on every core.
+
+        DistortionAnalysis [options]
+
+            --devices <list>       Devices to measure, hard,tanh,diode,ts,tsdiode,tsfixed by default
+            --drive <grid>         Drive settings (0 - 1), 0:1:5 by default
+            --freq <grid>          Sine frequencies in Hz, 100:10000:9 by default
+            --rates <list>         Sample rates, 44100,48000,96000 by default
+            --amplitude <a>        Peak level of the sines, 0.5 by default
+            --oversample <list>    Oversampling factors to compare, 1,2,4,8 by default
+            --filters <list>       Anti-aliasing filters for the oversampled settings, iir,fir by default
+            --fft <n>              FFT size, a power of two, 16384 by default
+            --band <Hz>            Aliases are also summed up to this frequency, the audible band, 20000 by default
+            --budget <dB>          Largest aliased energy in the audible band, relative to the fundamental, -80 by default
+            --threads <n>          Worker threads, every core by default
+            --csv <file>           Write every measurement as CSV
+
+    A grid is either a list (100,1000,10000) or start:end:count, which is log spaced for frequency and linear for drive.
+
+    Each sine is rounded to an odd number of cycles in the FFT, so it and all its harmonics land exactly on bins and no window is needed. The
+    device runs for half a second before the capture so the filters have settled, and then the output is periodic over the FFT, which means any
+    energy that is not at a harmonic of the sine is a harmonic that has folded back from above Nyquist, plus rounding noise. Folded harmonics
+    never land on an in-band harmonic with an odd number of cycles, so the two can be told apart:
+
+        THD         in-band harmonics relative to the fundamental
+        THD+N       everything except DC and the fundamental, relative to the fundamental
+        alias       everything except DC, the fundamental and the in-band harmonics, relative to the fundamental
+        alias band  the same, only up to --band
+
+    The summary lists, for each device and sample rate, the worst figures of every oversampling setting over the drive and frequency grid and
+    its cost, and picks the cheapest setting inside the alias budget. Cost is the time per base rate sample including the oversampling filters,
+    measured while the other threads are busy, so use --threads 1 for cleaner timings.
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <JuceHeader.h>
+#include "../../Common/TimingStats.h"
+
+// The chain plugin keeps a copy of every DSP class in one folder, so include them from there to get a single ChannelLayout.h.
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/TSStage.h"
+
+using namespace juce;
+
+namespace
+{
+    // Biquad.h defines pi as a macro, so the constant here has its own name.
+    constexpr double TwoPi = 6.283185307179586476925286766559;
+
+    // Seconds each device runs before the capture, long enough for the input and tone filters to settle.
+    constexpr double SettleSeconds = 0.5;
+
+    // Block size the devices are run at, and the largest oversampling factor.
+    constexpr int BlockSize = 512;
+    constexpr int MaxOversampling = 16;
+
+    // Smallest power ratio reported, -200 dB.
+    constexpr double MinRatio = 1.0e-20;
+
+    struct AnalysisSettings
+    {
+        StringArray Devices { "hard", "tanh", "diode", "ts", "tsdiode", "tsfixed" };
+        String Drives = "0:1:5";
+        String Frequencies = "100:10000:9";
+        std::vector<double> SampleRates { 44100.0, 48000.0, 96000.0 };
+        double Amplitude = 0.5;
+        std::vector<int> OversamplingFactors { 1, 2, 4, 8 };
+        StringArray Filters { "iir", "fir" };
+        int FFTOrder = 14;
+        double BandLimit = 20000.0;
+        double BudgetDb = -80.0;
+        int NumThreads = 0;
+        File CsvFile;
+    };
+
+    // Processes a block of one channel in place.
+    using ProcessFunction = std::function<void(float* data, int numSamples)>;
+
+    // A device sets itself up for a sample rate and drive and returns the function that processes it.
+    struct Device
+    {
+        String Name;
+        std::function<ProcessFunction(double sampleRate, float drive)> Create;
+    };
+
+    // Level ramp for the TS stage, long enough for an oversampled block, the level stays at the middle of its range.
+    const std::vector<float>& getLevelRamp()
+    {
+        static const std::vector<float> ramp((size_t)BlockSize * MaxOversampling, 0.5f);
+        return ramp;
+    }
+
+    ProcessFunction createTSStage(double sampleRate, float drive, bool diodeClipper, bool fixedRate = false)
+    {
+        auto stage = std::make_shared<TSStage>();
+        stage->SetFixedRate(fixedRate);
+        stage->Prepare(sampleRate, 1);
+        stage->Update(drive, 0.5f, diodeClipper, getLevelRamp().data());
+
+        return [stage](float* data, int numSamples)
+        {
+            stage->Process(ChannelLayout::Mono, &data, 1, numSamples);
+        };
+    }
+
+    std::vector<Device> getDevices()
+    {
+        std::vector<Device> devices;
+
+        // Hard clipper from hard_clipper.m, drive lowers the threshold from 1 to 0.05.
+        devices.push_back({ "hard", [](double, float drive) -> ProcessFunction
+        {
+            float threshold = 1.0f - 0.95f * drive;
+
+            return [threshold](float* data, int numSamples)
+            {
+                for (int sample = 0; sample < numSamples; sample++)
+                    data[sample] = jlimit(-threshold, threshold, data[sample]);
+            };
+        } });
+
+        // Tanh clipper with a saturation coefficient from distortion.m, drive maps the saturation from 1 to 20.
+        devices.push_back({ "tanh", [](double, float drive) -> ProcessFunction
+        {
+            float saturation = 1.0f + 19.0f * drive;
+            float normalisation = 1.0f / std::tanh(saturation);
+
+            return [saturation, normalisation](float* data, int numSamples)
+            {
+                for (int sample = 0; sample < numSamples; sample++)
+                    data[sample] = std::tanh(data[sample] * saturation) * normalisation;
+            };
+        } });
+
+        // The circuit model of the TS clipping stage on its own.
+        devices.push_back({ "diode", [](double sampleRate, float drive) -> ProcessFunction
+        {
+            auto clipper = std::make_shared<DiodeClipper>();
+            clipper->Init((float)sampleRate, drive);
+
+            return [clipper](float* data, int numSamples)
+            {
+                for (int sample = 0; sample < numSamples; sample++)
+                    data[sample] = clipper->ProcessSample(data[sample]);
+            };
+        } });
+
+        // The whole TS chain with each clipper, with the tone in the middle.
+        devices.push_back({ "ts", [](double sampleRate, float drive) { return createTSStage(sampleRate, drive, false); } });
+        devices.push_back({ "tsdiode", [](double sampleRate, float drive) { return createTSStage(sampleRate, drive, true); } });
+
+        // The tanh TS chain run at its fixed internal rate, so at 44.1 and 48 kHz it is resampled up and back down around the model.
+        devices.push_back({ "tsfixed", [](double sampleRate, float drive) { return createTSStage(sampleRate, drive, false, true); } });
+
+        return devices;
+    }
+
+    // How the device is run, at the base rate or oversampled with one of JUCE's half band filters.
+    struct OversamplingSetting
+    {
+        int Factor = 1;
+        bool FIR = false;
+
+        String GetName() const
+        {
+            return Factor == 1 ? String("1x") : String(Factor) + "x " + (FIR ? "fir" : "iir");
+        }
+    };
+
+    struct Measurement
+    {
+        const Device* DeviceUnderTest = nullptr;
+        OversamplingSetting Setting;
+        float Drive = 0.0f;
+        double SampleRate = 0.0;
+
+        // Whole number of cycles of the sine in the FFT, and the frequency that gives.
+        int Cycles = 0;
+        double Frequency = 0.0;
+
+        // Results, power ratios relative to the fundamental in dB, and the cost in nanoseconds per base rate sample.
+        double FundamentalDb = 0.0;
+        double THDDb = 0.0;
+        double THDNDb = 0.0;
+        double AliasDb = 0.0;
+        double AliasBandDb = 0.0;
+        double NanosecondsPerSample = 0.0;
+    };
+
+    //==============================================================================
+    void runMeasurement(Measurement& m, const AnalysisSettings& settings)
+    {
+        int fftSize = 1 << settings.FFTOrder;
+        int oversamplingOrder = 0;
+
+        while ((1 << oversamplingOrder) < m.Setting.Factor)
+            oversamplingOrder++;
+
+        ProcessFunction process = m.DeviceUnderTest->Create(m.SampleRate * m.Setting.Factor, m.Drive);
+
+        std::unique_ptr<dsp::Oversampling<float>> oversampling;
+
+        if (oversamplingOrder > 0)
+        {
+            oversampling = std::make_unique<dsp::Oversampling<float>>(1, (size_t)oversamplingOrder,
+                                                                      m.Setting.FIR ? dsp::Oversampling<float>::filterHalfBandFIREquiripple
+                                                                                    : dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+                                                                      true);
+            oversampling->initProcessing((size_t)BlockSize);
+        }
+
+        // One period of the input, the sine repeats exactly every fftSize samples.
+        std::vector<float> sine((size_t)fftSize);
+
+        for (int sample = 0; sample < fftSize; sample++)
+            sine[(size_t)sample] = (float)(settings.Amplitude * std::sin(TwoPi * (double)((int64)sample * m.Cycles % fftSize) / fftSize));
+
+        // Settle for whole periods, then capture one more.
+        int numPeriods = (int)std::ceil(SettleSeconds * m.SampleRate / fftSize) + 1;
+        int totalSamples = numPeriods * fftSize;
+
+        std::vector<float> output((size_t)fftSize);
+        float block[BlockSize];
+
+        auto startTicks = TimingStats::Now();
+
+        for (int position = 0; position < totalSamples; position += BlockSize)
+        {
+            int numSamples = jmin(BlockSize, totalSamples - position);
+
+            for (int sample = 0; sample < numSamples; sample++)
+                block[sample] = sine[(size_t)((position + sample) % fftSize)];
+
+            if (oversampling != nullptr)
+            {
+                float* channels[] = { block };
+                dsp::AudioBlock<float> audioBlock(channels, 1, (size_t)numSamples);
+                auto upsampled = oversampling->processSamplesUp(audioBlock);
+
+                process(upsampled.getChannelPointer(0), (int)upsampled.getNumSamples());
+                oversampling->processSamplesDown(audioBlock);
+            }
+            else
+                process(block, numSamples);
+
+            // The last period is the capture.
+            for (int sample = 0; sample < numSamples; sample++)
+                if (position + sample >= totalSamples - fftSize)
+                    output[(size_t)(position + sample - (totalSamples - fftSize))] = block[sample];
+        }
+
+        m.NanosecondsPerSample = TimingStats::ElapsedNs(startTicks, TimingStats::Now()) / totalSamples;
+
+        // Power in each bin. The capture is exactly periodic so no window is needed, and every component is in exactly one bin.
+        dsp::FFT fft(settings.FFTOrder);
+        std::vector<float> spectrum((size_t)fftSize * 2, 0.0f);
+        std::copy(output.begin(), output.end(), spectrum.begin());
+        fft.performRealOnlyForwardTransform(spectrum.data(), true);
+
+        int numBins = fftSize / 2 + 1;
+        int bandBin = jmin(numBins - 1, (int)(settings.BandLimit * fftSize / m.SampleRate));
+
+        auto power = [&](int bin) { return (double)spectrum[(size_t)bin * 2] * spectrum[(size_t)bin * 2] + (double)spectrum[(size_t)bin * 2 + 1] * spectrum[(size_t)bin * 2 + 1]; };
+
+        // Every bin other than DC and the fundamental is either an in-band harmonic, a multiple of the fundamental's bin, or an alias.
+        double fundamental = power(m.Cycles);
+        double harmonics = 0.0, aliases = 0.0, aliasesInBand = 0.0;
+
+        for (int bin = 1; bin < numBins; bin++)
+        {
+            if (bin == m.Cycles)
+                continue;
+
+            if (bin % m.Cycles == 0)
+                harmonics += power(bin);
+            else
+            {
+                aliases += power(bin);
+
+                if (bin <= bandBin)
+                    aliasesInBand += power(bin);
+            }
+        }
+
+        auto toDb = [&](double ratio) { return 10.0 * std::log10(jmax(ratio, MinRatio)); };
+
+        // Full scale sine in dB, the real transform of a sine of amplitude 1 has a magnitude of fftSize / 2 in its bin.
+        m.FundamentalDb = toDb(fundamental / ((double)fftSize * fftSize / 4.0));
+        fundamental = jmax(fundamental, MinRatio);
+
+        m.THDDb = toDb(harmonics / fundamental);
+        m.THDNDb = toDb((harmonics + aliases) / fundamental);
+        m.AliasDb = toDb(aliases / fundamental);
+        m.AliasBandDb = toDb(aliasesInBand / fundamental);
+    }
+
+    //==============================================================================
+    // A list of values, or start:end:count spaced logarithmically or linearly.
+    std::vector<double> parseGrid(const String& text, bool logSpaced)
+    {
+        std::vector<double> values;
+        StringArray tokens;
+
+        if (text.contains(":"))
+        {
+            tokens.addTokens(text, ":", "");
+
+            if (tokens.size() != 3)
+                return values;
+
+            double start = tokens[0].getDoubleValue();
+            double end = tokens[1].getDoubleValue();
+            int count = jmax(1, tokens[2].getIntValue());
+
+            for (int i = 0; i < count; i++)
+            {
+                double position = count > 1 ? i / (double)(count - 1) : 0.0;
+                values.push_back(logSpaced ? start * std::pow(end / start, position) : start + (end - start) * position);
+            }
+
+            return values;
+        }
+
+        tokens.addTokens(text, ",", "");
+
+        for (auto& token : tokens)
+            if (token.trim().isNotEmpty())
+                values.push_back(token.trim().getDoubleValue());
+
+        return values;
+    }
+
+    bool parseArguments(int argc, char* argv[], AnalysisSettings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            String argument(argv[i]);
+
+            if (! argument.startsWith("--") || i + 1 >= argc)
+            {
+                std::cout << "Unknown or incomplete option " << argument << std::endl;
+                return false;
+            }
+
+            String value(argv[++i]);
+
+            if (argument == "--devices")
+                settings.Devices = StringArray::fromTokens(value, ",", "");
+            else if (argument == "--drive")
+                settings.Drives = value;
+            else if (argument == "--freq")
+                settings.Frequencies = value;
+            else if (argument == "--rates")
+                settings.SampleRates = parseGrid(value, false);
+            else if (argument == "--amplitude")
+                settings.Amplitude = value.getDoubleValue();
+            else if (argument == "--oversample")
+            {
+                settings.OversamplingFactors.clear();
+
+                for (double factor : parseGrid(value, false))
+                    settings.OversamplingFactors.push_back(jlimit(1, MaxOversampling, nextPowerOfTwo((int)factor)));
+            }
+            else if (argument == "--filters")
+                settings.Filters = StringArray::fromTokens(value, ",", "");
+            else if (argument == "--fft")
+            {
+                settings.FFTOrder = 0;
+
+                while ((1 << settings.FFTOrder) < value.getIntValue())
+                    settings.FFTOrder++;
+
+                settings.FFTOrder = jlimit(10, 20, settings.FFTOrder);
+            }
+            else if (argument == "--band")
+                settings.BandLimit = value.getDoubleValue();
+            else if (argument == "--budget")
+                settings.BudgetDb = value.getDoubleValue();
+            else if (argument == "--threads")
+                settings.NumThreads = jmax(1, value.getIntValue());
+            else if (argument == "--csv")
+                settings.CsvFile = File::getCurrentWorkingDirectory().getChildFile(value);
+            else
+            {
+                std::cout << "Unknown option " << argument << std::endl;
+                return false;
+            }
+        }
+
+        if (settings.NumThreads == 0)
+            settings.NumThreads = jmax(1, SystemStats::getNumCpus());
+
+        return true;
+    }
+
+    // Every combination of the grid, at the base rate and at each oversampling setting.
+    std::vector<Measurement> createMeasurements(const AnalysisSettings& settings, const std::vector<Device>& devices)
+    {
+        std::vector<OversamplingSetting> oversamplingSettings;
+
+        for (int factor : settings.OversamplingFactors)
+        {
+            if (factor == 1)
+                oversamplingSettings.push_back({ 1, false });
+            else
+                for (auto& filter : settings.Filters)
+                    oversamplingSettings.push_back({ factor, filter.trim().equalsIgnoreCase("fir") });
+        }
+
+        int fftSize = 1 << settings.FFTOrder;
+        std::vector<Measurement> measurements;
+
+        for (auto& device : devices)
+        {
+            if (! settings.Devices.contains(device.Name))
+                continue;
+
+            for (double sampleRate : settings.SampleRates)
+                for (double drive : parseGrid(settings.Drives, false))
+                    for (double frequency : parseGrid(settings.Frequencies, true))
+                        for (auto& setting : oversamplingSettings)
+                        {
+                            // Round to an odd number of cycles, so no folded harmonic lands on an in-band one.
+                            int cycles = (int)std::round(frequency * fftSize / sampleRate);
+                            cycles = jlimit(1, fftSize / 2 - 1, cycles | 1);
+
+                            if (frequency <= 0.0 || frequency >= sampleRate / 2.0)
+                                continue;
+
+                            Measurement m;
+                            m.DeviceUnderTest = &device;
+                            m.Setting = setting;
+                            m.Drive = jlimit(0.0f, 1.0f, (float)drive);
+                            m.SampleRate = sampleRate;
+                            m.Cycles = cycles;
+                            m.Frequency = cycles * sampleRate / fftSize;
+                            measurements.push_back(m);
+                        }
+        }
+
+        return measurements;
+    }
+
+    bool writeCsv(const File& file, const std::vector<Measurement>& measurements)
+    {
+        String csv = "device,oversampling,drive,frequency,sample_rate,fundamental_db,thd_db,thdn_db,alias_db,alias_band_db,ns_per_sample\n";
+
+        for (auto& m : measurements)
+            csv << m.DeviceUnderTest->Name << "," << m.Setting.GetName() << "," << m.Drive << "," << m.Frequency << "," << m.SampleRate << ","
+                << m.FundamentalDb << "," << m.THDDb << "," << m.THDNDb << "," << m.AliasDb << "," << m.AliasBandDb << "," << m.NanosecondsPerSample << "\n";
+
+        return file.replaceWithText(csv);
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    AnalysisSettings settings;
+
+    if (! parseArguments(argc, argv, settings))
+        return 1;
+
+    std::vector<Device> devices = getDevices();
+
+    for (auto& name : settings.Devices)
+    {
+        if (std::none_of(devices.begin(), devices.end(), [&](const Device& d) { return d.Name == name; }))
+        {
+            std::cout << "Unknown device " << name << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Measurement> measurements = createMeasurements(settings, devices);
+    int numMeasurements = (int)measurements.size();
+
+    std::cout << numMeasurements << " measurements on " << settings.NumThreads << " threads, DSP kernels: " << Simd::GetIsaName(Simd::GetIsa()) << std::endl;
+
+    // Threads take the next measurement until there are none left.
+    std::atomic<int> next { 0 };
+    std::vector<std::thread> threads;
+
+    auto startTime = Time::getMillisecondCounterHiRes();
+
+    for (int thread = 0; thread < jmin(settings.NumThreads, numMeasurements); thread++)
+    {
+        threads.emplace_back([&]
+        {
+            for (int index = next++; index < numMeasurements; index = next++)
+                runMeasurement(measurements[(size_t)index], settings);
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    std::cout << "ran in " << String((Time::getMillisecondCounterHiRes() - startTime) / 1000.0, 2) << " s" << std::endl << std::endl;
+
+    if (settings.CsvFile != File() && ! writeCsv(settings.CsvFile, measurements))
+    {
+        std::cout << "Could not write " << settings.CsvFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    // Worst case of each oversampling setting over the drive and frequency grid, for each device and sample rate, in the order they were measured.
+    struct Summary
+    {
+        String Device;
+        double SampleRate = 0.0;
+        OversamplingSetting Setting;
+        double WorstTHDDb = -999.0;
+        double WorstAliasDb = -999.0;
+        double WorstAliasBandDb = -999.0;
+        TimingStats::Collector Costs;
+    };
+
+    std::vector<Summary> summaries;
+
+    for (auto& m : measurements)
+    {
+        auto summary = std::find_if(summaries.begin(), summaries.end(), [&](const Summary& s)
+        {
+            return s.Device == m.DeviceUnderTest->Name && s.SampleRate == m.SampleRate && s.Setting.Factor == m.Setting.Factor && s.Setting.FIR == m.Setting.FIR;
+        });
+
+        if (summary == summaries.end())
+        {
+            Summary added;
+            added.Device = m.DeviceUnderTest->Name;
+            added.SampleRate = m.SampleRate;
+            added.Setting = m.Setting;
+
+            summary = summaries.insert(summaries.end(), added);
+        }
+
+        summary->WorstTHDDb = jmax(summary->WorstTHDDb, m.THDDb);
+        summary->WorstAliasDb = jmax(summary->WorstAliasDb, m.AliasDb);
+        summary->WorstAliasBandDb = jmax(summary->WorstAliasBandDb, m.AliasBandDb);
+        summary->Costs.Add(m.NanosecondsPerSample);
+    }
+
+    std::cout << String("device").paddedRight(' ', 10) << String("rate").paddedLeft(' ', 8) << "  " << String("setting").paddedRight(' ', 8)
+              << String("THD dB").paddedLeft(' ', 10) << String("alias dB").paddedLeft(' ', 10) << String("band dB").paddedLeft(' ', 10)
+              << String("ns/sample").paddedLeft(' ', 11) << std::endl;
+
+    String lastGroup;
+    Summary* cheapest = nullptr;
+
+    auto printCheapest = [&]()
+    {
+        if (lastGroup.isEmpty())
+            return;
+
+        std::cout << "  " << (cheapest != nullptr ? "cheapest inside " + String(settings.BudgetDb, 0) + " dB: " + cheapest->Setting.GetName()
+                                                  : "nothing inside " + String(settings.BudgetDb, 0) + " dB") << std::endl;
+    };
+
+    for (auto& summary : summaries)
+    {
+        String group = summary.Device + String(summary.SampleRate);
+
+        if (group != lastGroup)
+        {
+            printCheapest();
+            lastGroup = group;
+            cheapest = nullptr;
+        }
+
+        double cost = summary.Costs.Median();
+
+        if (summary.WorstAliasBandDb <= settings.BudgetDb && (cheapest == nullptr || cost < cheapest->Costs.Median()))
+            cheapest = &summary;
+
+        std::cout << summary.Device.paddedRight(' ', 10) << String(summary.SampleRate, 0).paddedLeft(' ', 8) << "  " << summary.Setting.GetName().paddedRight(' ', 8)
+                  << String(summary.WorstTHDDb, 1).paddedLeft(' ', 10) << String(summary.WorstAliasDb, 1).paddedLeft(' ', 10)
+                  << String(summary.WorstAliasBandDb, 1).paddedLeft(' ', 10) << String(cost, 1).paddedLeft(' ', 11) << std::endl;
+    }
+
+    printCheapest();
+
+    return 0;
+}
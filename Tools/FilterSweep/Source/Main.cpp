@@ -0,0 +1,618 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 10:31:27pm
+    Author:  JEPlugins
+
+    Filter design sweep, the C++ replacement for digital_filters.m. Every combination of filter type, cutoff, Q, gain and sample rate is run
+    through the real Biquad class, and the tool captures its impulse response and its magnitude and phase response. Each design is checked
+    against the cookbook transfer function worked out independently in double precision, so broken coefficients, unstable designs and
+    differences between ProcessSample and ProcessBlock show up. The grid is spread over every core.
+
+        FilterSweep [options]
+
+            --types <list>         Filter types, lpf,hpf,notch,peaking,lowshelf,highshelf by default
+            --fc <grid>            Cutoff frequencies in Hz, 20:20000:64 by default
+            --q <grid>             Quality factors, 0.3:12:8 by default
+            --gain <grid>          Gains in dB for the peaking and shelving types, -12:12:5 by default, the other types only run at 0
+            --rates <list>         Sample rates, 44100,48000,96000 by default
+            --length <n>           Impulse response length in samples, 2048 by default
+            --points <n>           Frequencies the response is captured at, log spaced from 10 Hz to Nyquist, 128 by default
+            --out <file>           Write the results, .csv files are written as CSV and anything else as binary
+            --tolerance <dB>       Largest error against the reference, relative to the peak of the response, -40 by default
+            --threads <n>          Worker threads, every core by default
+            --delta <file>         Also write a one second unit impulse WAV at the first sample rate, for the MATLAB scripts
+
+    A grid is either a list (100,1000,10000) or start:end:count, which is log spaced for cutoff and Q and linear for gain. Cutoffs at or
+    above Nyquist are skipped.
+
+    Exits with 1 if any design fails, which is a non-finite output, ProcessSample and ProcessBlock disagreeing, or an error above the
+    tolerance. Designs whose impulse has not decayed within the length are reported as truncated and not checked, use a longer --length to
+    check them. The coefficients are worked out in single precision, and 1 - cos(w) cancels at low cutoffs, so the shelving designs near 20 Hz
+    are only good to about -50 dB. The default tolerance leaves room for that, run with --tolerance -60 to list them.
+
+    Binary layout, little endian:
+
+        char[4]  "JEFS"
+        uint32   version (1), number of designs, impulse length, number of points
+        per design:
+            int32    type (BiquadType)
+            float32  cutoff, Q, gain dB, sample rate
+            uint32   flags (1 truncated, 2 not finite, 4 unstable, 8 ProcessSample and ProcessBlock differ, 16 failed)
+            float32  error dB
+            float32  impulse[length], frequency[points], magnitude dB[points], phase radians[points]
+
+    read_filter_sweep.m in Episode 2 reads this into MATLAB.
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include <JuceHeader.h>
+
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/Biquad.h"
+
+using namespace juce;
+
+namespace
+{
+    // Biquad.h defines pi as a macro, so the constant here has its own name.
+    constexpr double TwoPi = 6.283185307179586476925286766559;
+
+    constexpr double MinFrequency = 10.0;
+
+    enum Flags
+    {
+        Truncated = 1,
+        NotFinite = 2,
+        Unstable = 4,
+        PathMismatch = 8,
+        Failed = 16
+    };
+
+    struct FilterType
+    {
+        const char* Name;
+        BiquadType Type;
+        bool UsesGain;
+    };
+
+    const FilterType FilterTypes[] = { { "lpf",       LPF,       false },
+                                       { "hpf",       HPF,       false },
+                                       { "notch",     Notch,     false },
+                                       { "peaking",   Peaking,   true },
+                                       { "lowshelf",  LowShelf,  true },
+                                       { "highshelf", HighShelf, true } };
+
+    struct SweepSettings
+    {
+        std::vector<FilterType> Types { std::begin(FilterTypes), std::end(FilterTypes) };
+        String Cutoffs = "20:20000:64";
+        String QualityFactors = "0.3:12:8";
+        String Gains = "-12:12:5";
+        std::vector<double> SampleRates { 44100.0, 48000.0, 96000.0 };
+        int Length = 2048;
+        int NumPoints = 128;
+        File OutputFile;
+        double ToleranceDb = -40.0;
+        int NumThreads = 0;
+        File DeltaFile;
+    };
+
+    struct Design
+    {
+        FilterType Type;
+        double Cutoff = 0.0;
+        double Q = 0.0;
+        double GainDb = 0.0;
+        double SampleRate = 0.0;
+    };
+
+    struct DesignResult
+    {
+        uint32 Flags = 0;
+        float ErrorDb = -999.0f;
+        std::vector<float> Impulse;
+        std::vector<float> Frequencies;
+        std::vector<float> MagnitudeDb;
+        std::vector<float> Phase;
+    };
+
+    //==============================================================================
+    // Cookbook coefficients in double precision, written out separately from Biquad::CalcFilter so the two can be checked against each other.
+    struct Coefficients
+    {
+        double b0, b1, b2, a0, a1, a2;
+    };
+
+    Coefficients referenceCoefficients(const Design& design)
+    {
+        double w = TwoPi * design.Cutoff / design.SampleRate;
+        double cosw = std::cos(w);
+        double alpha = std::sin(w) / (2.0 * design.Q);
+        double A = std::pow(10.0, design.GainDb / 40.0);
+        double shelf = 2.0 * std::sqrt(A) * alpha;
+
+        switch (design.Type.Type)
+        {
+            case LPF:       return { (1.0 - cosw) / 2.0, 1.0 - cosw, (1.0 - cosw) / 2.0, 1.0 + alpha, -2.0 * cosw, 1.0 - alpha };
+            case HPF:       return { (1.0 + cosw) / 2.0, -(1.0 + cosw), (1.0 + cosw) / 2.0, 1.0 + alpha, -2.0 * cosw, 1.0 - alpha };
+            case Notch:     return { 1.0, -2.0 * cosw, 1.0, 1.0 + alpha, -2.0 * cosw, 1.0 - alpha };
+            case Peaking:   return { 1.0 + alpha * A, -2.0 * cosw, 1.0 - alpha * A, 1.0 + alpha / A, -2.0 * cosw, 1.0 - alpha / A };
+
+            case LowShelf:
+                return { A * ((A + 1.0) - (A - 1.0) * cosw + shelf), 2.0 * A * ((A - 1.0) - (A + 1.0) * cosw), A * ((A + 1.0) - (A - 1.0) * cosw - shelf),
+                         (A + 1.0) + (A - 1.0) * cosw + shelf, -2.0 * ((A - 1.0) + (A + 1.0) * cosw), (A + 1.0) + (A - 1.0) * cosw - shelf };
+
+            case HighShelf:
+            default:
+                return { A * ((A + 1.0) + (A - 1.0) * cosw + shelf), -2.0 * A * ((A - 1.0) + (A + 1.0) * cosw), A * ((A + 1.0) + (A - 1.0) * cosw - shelf),
+                         (A + 1.0) - (A - 1.0) * cosw + shelf, 2.0 * ((A - 1.0) - (A + 1.0) * cosw), (A + 1.0) - (A - 1.0) * cosw - shelf };
+        }
+    }
+
+    std::complex<double> referenceResponse(const Coefficients& c, double w)
+    {
+        std::complex<double> z1 = std::polar(1.0, -w);
+        std::complex<double> z2 = z1 * z1;
+
+        return (c.b0 + c.b1 * z1 + c.b2 * z2) / (c.a0 + c.a1 * z1 + c.a2 * z2);
+    }
+
+    // Both poles are inside the unit circle (the stability triangle for a second order denominator).
+    bool isStable(const Coefficients& c)
+    {
+        double a1 = c.a1 / c.a0;
+        double a2 = c.a2 / c.a0;
+
+        return std::abs(a2) < 1.0 && std::abs(a1) < 1.0 + a2;
+    }
+
+    // Fourier transform of the captured impulse at one frequency.
+    std::complex<double> measuredResponse(const std::vector<float>& impulse, double w)
+    {
+        std::complex<double> rotation = std::polar(1.0, -w);
+        std::complex<double> phasor = 1.0;
+        std::complex<double> sum = 0.0;
+
+        for (float sample : impulse)
+        {
+            sum += (double)sample * phasor;
+            phasor *= rotation;
+        }
+
+        return sum;
+    }
+
+    //==============================================================================
+    DesignResult runDesign(const Design& design, const SweepSettings& settings)
+    {
+        DesignResult result;
+        int length = settings.Length;
+
+        // Impulse through the block path the plugins use, in blocks of a typical size, and through ProcessSample on a second filter.
+        Biquad blockFilter, sampleFilter;
+        blockFilter.Init(design.Type.Type, (float)design.Cutoff, (float)design.SampleRate, (float)design.Q, (float)design.GainDb);
+        sampleFilter.Init(design.Type.Type, (float)design.Cutoff, (float)design.SampleRate, (float)design.Q, (float)design.GainDb);
+
+        result.Impulse.assign((size_t)length, 0.0f);
+        result.Impulse[0] = 1.0f;
+
+        for (int offset = 0; offset < length; offset += 256)
+            blockFilter.ProcessBlock(result.Impulse.data() + offset, jmin(256, length - offset));
+
+        double energy = 0.0, tailEnergy = 0.0, pathError = 0.0, peak = 0.0;
+
+        for (int sample = 0; sample < length; sample++)
+        {
+            double y = result.Impulse[(size_t)sample];
+            double reference = sampleFilter.ProcessSample(sample == 0 ? 1.0f : 0.0f);
+
+            if (! std::isfinite(y) || ! std::isfinite(reference))
+                result.Flags |= NotFinite;
+
+            energy += y * y;
+            peak = jmax(peak, std::abs(y));
+            pathError = jmax(pathError, std::abs(y - reference));
+
+            if (sample >= length * 3 / 4)
+                tailEnergy += y * y;
+        }
+
+        // The block path only reorders the sums, so anything beyond rounding is a bug.
+        if (pathError > 1.0e-5 * jmax(1.0, peak))
+            result.Flags |= PathMismatch;
+
+        // Still ringing at the end of the capture, so the transform of the capture is not the filter's response.
+        if (tailEnergy > 1.0e-14 * energy)
+            result.Flags |= Truncated;
+
+        Coefficients coefficients = referenceCoefficients(design);
+
+        if (! isStable(coefficients))
+            result.Flags |= Unstable;
+
+        // Response at log spaced frequencies, and the largest difference from the reference relative to the reference's peak.
+        int numPoints = settings.NumPoints;
+        double nyquist = design.SampleRate / 2.0;
+        double maxDifference = 0.0, maxReference = 0.0;
+
+        result.Frequencies.resize((size_t)numPoints);
+        result.MagnitudeDb.resize((size_t)numPoints);
+        result.Phase.resize((size_t)numPoints);
+
+        for (int point = 0; point < numPoints; point++)
+        {
+            double frequency = numPoints > 1 ? MinFrequency * std::pow(nyquist / MinFrequency, point / (double)(numPoints - 1)) : nyquist;
+            double w = TwoPi * frequency / design.SampleRate;
+
+            std::complex<double> measured = measuredResponse(result.Impulse, w);
+            std::complex<double> reference = referenceResponse(coefficients, w);
+
+            result.Frequencies[(size_t)point] = (float)frequency;
+            result.MagnitudeDb[(size_t)point] = (float)(20.0 * std::log10(jmax(std::abs(measured), 1.0e-12)));
+            result.Phase[(size_t)point] = (float)std::arg(measured);
+
+            maxDifference = jmax(maxDifference, std::abs(measured - reference));
+            maxReference = jmax(maxReference, std::abs(reference));
+        }
+
+        if (std::isfinite(maxDifference) && maxReference > 0.0)
+            result.ErrorDb = (float)(20.0 * std::log10(jmax(maxDifference / maxReference, 1.0e-15)));
+
+        bool checked = (result.Flags & (Truncated | Unstable)) == 0;
+
+        if ((result.Flags & (NotFinite | PathMismatch)) != 0 || (checked && result.ErrorDb > settings.ToleranceDb))
+            result.Flags |= Failed;
+
+        return result;
+    }
+
+    //==============================================================================
+    // A list of values, or start:end:count spaced logarithmically or linearly.
+    std::vector<double> parseGrid(const String& text, bool logSpaced)
+    {
+        std::vector<double> values;
+        StringArray tokens;
+
+        if (text.contains(":"))
+        {
+            tokens.addTokens(text, ":", "");
+
+            if (tokens.size() != 3)
+                return values;
+
+            double start = tokens[0].getDoubleValue();
+            double end = tokens[1].getDoubleValue();
+            int count = jmax(1, tokens[2].getIntValue());
+
+            for (int i = 0; i < count; i++)
+            {
+                double position = count > 1 ? i / (double)(count - 1) : 0.0;
+                values.push_back(logSpaced ? start * std::pow(end / start, position) : start + (end - start) * position);
+            }
+
+            return values;
+        }
+
+        tokens.addTokens(text, ",", "");
+
+        for (auto& token : tokens)
+            if (token.trim().isNotEmpty())
+                values.push_back(token.trim().getDoubleValue());
+
+        return values;
+    }
+
+    std::vector<Design> createDesigns(const SweepSettings& settings)
+    {
+        std::vector<Design> designs;
+        std::vector<double> cutoffs = parseGrid(settings.Cutoffs, true);
+        std::vector<double> qualityFactors = parseGrid(settings.QualityFactors, true);
+        std::vector<double> gains = parseGrid(settings.Gains, false);
+
+        for (double sampleRate : settings.SampleRates)
+            for (auto& type : settings.Types)
+                for (double cutoff : cutoffs)
+                    for (double q : qualityFactors)
+                        for (double gain : type.UsesGain ? gains : std::vector<double> { 0.0 })
+                            if (cutoff > 0.0 && cutoff < sampleRate / 2.0 && q > 0.0)
+                                designs.push_back({ type, cutoff, q, gain, sampleRate });
+
+        return designs;
+    }
+
+    //==============================================================================
+    // Writes results as they come in, in design order.
+    class ResultWriter
+    {
+    public:
+
+        ResultWriter(const File& file, const SweepSettings& settings, int numDesigns)
+            : csv(file.hasFileExtension("csv")), length(settings.Length), numPoints(settings.NumPoints)
+        {
+            file.deleteFile();
+            stream = file.createOutputStream();
+
+            if (stream == nullptr)
+                return;
+
+            if (csv)
+            {
+                String header = "index,type,fc,q,gain_db,fs,flags,error_db";
+
+                for (int i = 0; i < length; i++)      header << ",h" << i;
+                for (int i = 0; i < numPoints; i++)   header << ",f" << i;
+                for (int i = 0; i < numPoints; i++)   header << ",mag_db" << i;
+                for (int i = 0; i < numPoints; i++)   header << ",phase" << i;
+
+                stream->writeText(header + "\n", false, false, nullptr);
+            }
+            else
+            {
+                stream->write("JEFS", 4);
+                stream->writeInt(1);
+                stream->writeInt(numDesigns);
+                stream->writeInt(length);
+                stream->writeInt(numPoints);
+            }
+        }
+
+        bool IsOpen() const { return stream != nullptr; }
+
+        void Write(int index, const Design& design, const DesignResult& result)
+        {
+            if (csv)
+            {
+                String line;
+                line << index << "," << design.Type.Name << "," << design.Cutoff << "," << design.Q << "," << design.GainDb << "," << design.SampleRate
+                     << "," << (int)result.Flags << "," << result.ErrorDb;
+
+                for (auto* values : { &result.Impulse, &result.Frequencies, &result.MagnitudeDb, &result.Phase })
+                    for (float value : *values)
+                        line << "," << value;
+
+                stream->writeText(line + "\n", false, false, nullptr);
+                return;
+            }
+
+            stream->writeInt((int)design.Type.Type);
+            stream->writeFloat((float)design.Cutoff);
+            stream->writeFloat((float)design.Q);
+            stream->writeFloat((float)design.GainDb);
+            stream->writeFloat((float)design.SampleRate);
+            stream->writeInt((int)result.Flags);
+            stream->writeFloat(result.ErrorDb);
+
+            // The arrays go out as they are in memory, every platform the plugins build for is little endian.
+            for (auto* values : { &result.Impulse, &result.Frequencies, &result.MagnitudeDb, &result.Phase })
+                stream->write(values->data(), values->size() * sizeof(float));
+        }
+
+    private:
+
+        bool csv = false;
+        int length = 0;
+        int numPoints = 0;
+        std::unique_ptr<FileOutputStream> stream;
+    };
+
+    //==============================================================================
+    bool writeDelta(const File& file, double sampleRate)
+    {
+        AudioBuffer<float> delta(1, (int)sampleRate);
+        delta.clear();
+        delta.setSample(0, 0, 1.0f);
+
+        file.deleteFile();
+        WavAudioFormat format;
+        std::unique_ptr<OutputStream> stream = file.createOutputStream();
+
+        if (stream == nullptr)
+            return false;
+
+        std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(stream.get(), sampleRate, 1, 24, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(delta, 0, delta.getNumSamples());
+    }
+
+    bool parseArguments(int argc, char* argv[], SweepSettings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            String argument(argv[i]);
+
+            if (! argument.startsWith("--") || i + 1 >= argc)
+            {
+                std::cout << "Unknown or incomplete option " << argument << std::endl;
+                return false;
+            }
+
+            String value(argv[++i]);
+
+            if (argument == "--types")
+            {
+                settings.Types.clear();
+                StringArray names;
+                names.addTokens(value, ",", "");
+
+                for (auto& name : names)
+                {
+                    auto type = std::find_if(std::begin(FilterTypes), std::end(FilterTypes), [&](const FilterType& t) { return name.trim().equalsIgnoreCase(t.Name); });
+
+                    if (type == std::end(FilterTypes))
+                    {
+                        std::cout << "Unknown filter type " << name << std::endl;
+                        return false;
+                    }
+
+                    settings.Types.push_back(*type);
+                }
+            }
+            else if (argument == "--fc")
+                settings.Cutoffs = value;
+            else if (argument == "--q")
+                settings.QualityFactors = value;
+            else if (argument == "--gain")
+                settings.Gains = value;
+            else if (argument == "--rates")
+                settings.SampleRates = parseGrid(value, false);
+            else if (argument == "--length")
+                settings.Length = jmax(3, value.getIntValue());
+            else if (argument == "--points")
+                settings.NumPoints = jmax(1, value.getIntValue());
+            else if (argument == "--out")
+                settings.OutputFile = File::getCurrentWorkingDirectory().getChildFile(value);
+            else if (argument == "--tolerance")
+                settings.ToleranceDb = value.getDoubleValue();
+            else if (argument == "--threads")
+                settings.NumThreads = jmax(1, value.getIntValue());
+            else if (argument == "--delta")
+                settings.DeltaFile = File::getCurrentWorkingDirectory().getChildFile(value);
+            else
+            {
+                std::cout << "Unknown option " << argument << std::endl;
+                return false;
+            }
+        }
+
+        settings.SampleRates.erase(std::remove_if(settings.SampleRates.begin(), settings.SampleRates.end(), [](double n) { return n < 8000.0; }), settings.SampleRates.end());
+
+        if (settings.NumThreads == 0)
+            settings.NumThreads = jmax(1, SystemStats::getNumCpus());
+
+        return true;
+    }
+
+    String describe(const Design& design)
+    {
+        String text = String(design.Type.Name).paddedRight(' ', 10) + " fc " + String(design.Cutoff, 1) + " Hz  Q " + String(design.Q, 3);
+
+        if (design.Type.UsesGain)
+            text += "  gain " + String(design.GainDb, 1) + " dB";
+
+        return text + "  fs " + String(design.SampleRate, 0);
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    SweepSettings settings;
+
+    if (! parseArguments(argc, argv, settings))
+        return 1;
+
+    if (settings.DeltaFile != File() && ! writeDelta(settings.DeltaFile, settings.SampleRates.empty() ? 44100.0 : settings.SampleRates.front()))
+    {
+        std::cout << "Could not write " << settings.DeltaFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    std::vector<Design> designs = createDesigns(settings);
+    int numDesigns = (int)designs.size();
+
+    std::unique_ptr<ResultWriter> writer;
+
+    if (settings.OutputFile != File())
+    {
+        writer = std::make_unique<ResultWriter>(settings.OutputFile, settings, numDesigns);
+
+        if (! writer->IsOpen())
+        {
+            std::cout << "Could not write " << settings.OutputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << numDesigns << " designs on " << settings.NumThreads << " threads, DSP kernels: " << Simd::GetIsaName(Simd::GetIsa()) << std::endl;
+
+    // The designs are run a chunk at a time so the results of a large grid never all have to be held at once. Threads take the next design in
+    // the chunk until it is done, then the chunk is written in order.
+    constexpr int ChunkSize = 1024;
+    std::vector<DesignResult> results((size_t)ChunkSize);
+
+    int numFailed = 0, numTruncated = 0, numUnstable = 0;
+    std::vector<float> worstError(std::size(FilterTypes), -999.0f);
+    std::vector<int> failures;
+
+    auto startTime = Time::getMillisecondCounterHiRes();
+
+    for (int chunkStart = 0; chunkStart < numDesigns; chunkStart += ChunkSize)
+    {
+        int chunkSize = jmin(ChunkSize, numDesigns - chunkStart);
+        std::atomic<int> next { 0 };
+        std::vector<std::thread> threads;
+
+        for (int thread = 0; thread < jmin(settings.NumThreads, chunkSize); thread++)
+        {
+            threads.emplace_back([&]
+            {
+                for (int index = next++; index < chunkSize; index = next++)
+                    results[(size_t)index] = runDesign(designs[(size_t)(chunkStart + index)], settings);
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        for (int index = 0; index < chunkSize; index++)
+        {
+            const Design& design = designs[(size_t)(chunkStart + index)];
+            const DesignResult& result = results[(size_t)index];
+
+            if (writer != nullptr)
+                writer->Write(chunkStart + index, design, result);
+
+            numTruncated += (result.Flags & Truncated) != 0 ? 1 : 0;
+            numUnstable += (result.Flags & Unstable) != 0 ? 1 : 0;
+
+            if ((result.Flags & Failed) != 0)
+            {
+                numFailed++;
+                failures.push_back(chunkStart + index);
+            }
+
+            if ((result.Flags & (Truncated | Unstable)) == 0)
+            {
+                auto typeIndex = (size_t)(std::find_if(std::begin(FilterTypes), std::end(FilterTypes), [&](const FilterType& t) { return t.Type == design.Type.Type; }) - std::begin(FilterTypes));
+                worstError[typeIndex] = jmax(worstError[typeIndex], result.ErrorDb);
+            }
+        }
+    }
+
+    double seconds = (Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    std::cout << "ran in " << String(seconds, 2) << " s, " << String(numDesigns / jmax(seconds, 1.0e-9), 0) << " designs/s" << std::endl;
+
+    for (auto& type : settings.Types)
+    {
+        auto index = (size_t)(std::find_if(std::begin(FilterTypes), std::end(FilterTypes), [&](const FilterType& t) { return t.Type == type.Type; }) - std::begin(FilterTypes));
+
+        std::cout << String(type.Name).paddedRight(' ', 10) << " worst error " << String(worstError[index], 1) << " dB" << std::endl;
+    }
+
+    std::cout << numTruncated << " truncated (not checked), " << numUnstable << " unstable, " << numFailed << " failed" << std::endl;
+
+    // The first few failures, enough to see what went wrong.
+    for (size_t i = 0; i < jmin<size_t>(failures.size(), 20); i++)
+    {
+        const Design& design = designs[(size_t)failures[i]];
+        DesignResult result = runDesign(design, settings);
+
+        std::cout << "FAILED " << describe(design) << "  error " << String(result.ErrorDb, 1) << " dB"
+                  << ((result.Flags & NotFinite) != 0 ? "  not finite" : "") << ((result.Flags & PathMismatch) != 0 ? "  block/sample mismatch" : "") << std::endl;
+    }
+
+    return numFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 20 Oct 2026 11:40:19am
+    Author:  JEPlugins
+
+    Checks the fixed point Biquad and delay lines against the float ones they port. Every filter type is run over a grid of cutoff, Q and gain
+    with the same noise through Biquad and FixedBiquad, and both are compared with the same coefficients run in double precision, so the check
+    measures the arithmetic and not the design. The delay lines are written with the same noise and read back at whole and moving fractional
+    delays through CircularBuffer and both storage types, and compared with the float line, which is exact for them. Each check reports the
+    signal to error ratio and fails if it is below the minimum for its format.
+
+        FixedPointCheck [options]
+
+            --rate <Hz>            Sample rate, 48000 by default
+            --seconds <s>          Noise run through every check, 1 by default
+            --level <dB>           Level of the noise, -18 dBFS by default, which leaves headroom for the resonant filters with gain
+            --q31-min <dB>         Smallest signal to error ratio for Q31, 120 by default
+            --q15-min <dB>         Smallest signal to error ratio for Q15, 70 by default
+            --verbose              Print every check, not only the failures and the summary
+
+    The float filter's ratio is printed next to the fixed point one for comparison. Low cutoffs are where float loses the most, and the fixed
+    point filter's error feedback keeps Q31 well above it there. Anything that clips at full scale fails, so a failure at a high gain is a sign
+    to lower --level rather than a bug.
+
+    Exits with 1 if any check fails.
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <vector>
+#include <JuceHeader.h>
+
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/Biquad.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/CircularBuffer.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/FixedBiquad.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/FixedCircularBuffer.h"
+
+using namespace juce;
+
+namespace
+{
+    struct CheckSettings
+    {
+        double SampleRate = 48000.0;
+        double Seconds = 1.0;
+        double LevelDb = -18.0;
+        double Q31MinDb = 120.0;
+        double Q15MinDb = 70.0;
+        bool Verbose = false;
+    };
+
+    // Running signal to error ratio of an output against its reference.
+    struct ErrorRatio
+    {
+        double Signal = 0.0;
+        double Error = 0.0;
+
+        void Add(double reference, float output)
+        {
+            Signal += reference * reference;
+            Error += ((double)output - reference) * ((double)output - reference);
+        }
+
+        double GetDb() const
+        {
+            return Error > 0.0 ? 10.0 * std::log10(Signal / Error) : 300.0;
+        }
+    };
+
+    struct CheckResult
+    {
+        String Name;
+        double RatioDb = 0.0;
+        double MinimumDb = 0.0;
+
+        // Ratio of the float version, for the filters.
+        double FloatRatioDb = 0.0;
+
+        bool Passed() const { return RatioDb >= MinimumDb; }
+    };
+
+    std::vector<float> createNoise(const CheckSettings& settings)
+    {
+        Random random(0x5eed);
+        float gain = Decibels::decibelsToGain((float)settings.LevelDb);
+
+        std::vector<float> noise((size_t)(settings.SampleRate * settings.Seconds));
+
+        for (auto& sample : noise)
+            sample = (random.nextFloat() * 2.0f - 1.0f) * gain;
+
+        return noise;
+    }
+
+    //==============================================================================
+    void checkFilters(const CheckSettings& settings, const std::vector<float>& noise, std::vector<CheckResult>& results)
+    {
+        struct FilterType { const char* Name; BiquadType Type; bool UsesGain; };
+
+        const FilterType types[] = { { "lpf", LPF, false }, { "hpf", HPF, false }, { "notch", Notch, false },
+                                     { "peaking", Peaking, true }, { "lowshelf", LowShelf, true }, { "highshelf", HighShelf, true } };
+
+        for (auto& type : types)
+            for (float fc : { 50.0f, 300.0f, 1000.0f, 5000.0f, 15000.0f })
+                for (float q : { 0.5f, 0.707f, 4.0f })
+                    for (float gain : type.UsesGain ? std::vector<float> { -12.0f, 6.0f } : std::vector<float> { 0.0f })
+                    {
+                        Biquad floating;
+                        FixedBiquad fixed;
+
+                        floating.Init(type.Type, fc, (float)settings.SampleRate, q, gain);
+                        fixed.Init(type.Type, fc, (float)settings.SampleRate, q, gain);
+
+                        // The same coefficients in double precision.
+                        float b0, b1, b2, a1, a2;
+                        floating.GetCoefficients(b0, b1, b2, a1, a2);
+
+                        double xminusone = 0.0, xminustwo = 0.0, yminusone = 0.0, yminustwo = 0.0;
+                        ErrorRatio fixedRatio, floatRatio;
+
+                        for (float xn : noise)
+                        {
+                            double yn = b0 * (double)xn + b1 * xminusone + b2 * xminustwo - a1 * yminusone - a2 * yminustwo;
+
+                            xminustwo = xminusone;
+                            xminusone = xn;
+                            yminustwo = yminusone;
+                            yminusone = yn;
+
+                            fixedRatio.Add(yn, fixed.ProcessSample(xn));
+                            floatRatio.Add(yn, floating.ProcessSample(xn));
+                        }
+
+                        String name = String("biquad ") + type.Name + " fc " + String(fc, 0) + " Q " + String(q, 3);
+
+                        if (type.UsesGain)
+                            name += " gain " + String(gain, 0);
+
+                        results.push_back({ name + " (shift " + String(fixed.GetCoefficientShift()) + ")", fixedRatio.GetDb(), settings.Q31MinDb, floatRatio.GetDb() });
+                    }
+    }
+
+    // Whole and moving fractional delays read back from the same noise, through the float line and one storage type.
+    template <typename StorageType>
+    void checkDelayLine(const String& format, double minimumDb, const CheckSettings& settings, const std::vector<float>& noise, std::vector<CheckResult>& results)
+    {
+        CircularBuffer reference;
+        FixedCircularBuffer<StorageType> fixed;
+
+        int sampleRate = (int)settings.SampleRate;
+        reference.Init(sampleRate, 1000.0f);
+        fixed.Init(sampleRate, 1000.0f);
+
+        ErrorRatio whole, fractional, fractionalQ31, block;
+        std::vector<float> referenceBlock(64), fixedBlock(64);
+
+        for (size_t sample = 0; sample < noise.size(); sample++)
+        {
+            reference.BufferWrite(noise[sample]);
+            fixed.BufferWrite(noise[sample]);
+
+            whole.Add(reference.BufferReadSamples(4800), fixed.BufferReadSamples(4800));
+
+            // A delay swept by a slow LFO, as the delay's modulation would, read through the float API and as 16.16 through the Q31 API.
+            float delay = 2400.0f + 480.0f * std::sin((float)sample * 0.0005f);
+            float expected = reference.BufferReadFractional(delay);
+
+            fractional.Add(expected, fixed.BufferReadFractional(delay));
+            fractionalQ31.Add(expected, FixedPoint::ToFloat(fixed.BufferReadFractionalQ31((int32_t)std::lround(delay * 65536.0f))));
+
+            if (sample % 64 == 63)
+            {
+                reference.BufferReadBlock(1000, referenceBlock.data(), 64);
+                fixed.BufferReadBlock(1000, fixedBlock.data(), 64);
+
+                for (int i = 0; i < 64; i++)
+                    block.Add(referenceBlock[(size_t)i], fixedBlock[(size_t)i]);
+            }
+        }
+
+        results.push_back({ "delay " + format + " whole", whole.GetDb(), minimumDb });
+        results.push_back({ "delay " + format + " fractional", fractional.GetDb(), minimumDb });
+        results.push_back({ "delay " + format + " fractional Q31 API", fractionalQ31.GetDb(), minimumDb });
+        results.push_back({ "delay " + format + " block", block.GetDb(), minimumDb });
+
+        std::cout << "delay " << format << " line for 1 s at " << sampleRate << " Hz: " << String(fixed.GetSizeInBytes() / 1024.0, 0) << " KB" << std::endl;
+    }
+
+    bool parseArguments(int argc, char* argv[], CheckSettings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            String argument(argv[i]);
+
+            if (argument == "--verbose")
+            {
+                settings.Verbose = true;
+                continue;
+            }
+
+            if (! argument.startsWith("--") || i + 1 >= argc)
+            {
+                std::cout << "Unknown or incomplete option " << argument << std::endl;
+                return false;
+            }
+
+            String value(argv[++i]);
+
+            if (argument == "--rate")
+                settings.SampleRate = jmax(8000.0, value.getDoubleValue());
+            else if (argument == "--seconds")
+                settings.Seconds = jmax(0.01, value.getDoubleValue());
+            else if (argument == "--level")
+                settings.LevelDb = value.getDoubleValue();
+            else if (argument == "--q31-min")
+                settings.Q31MinDb = value.getDoubleValue();
+            else if (argument == "--q15-min")
+                settings.Q15MinDb = value.getDoubleValue();
+            else
+            {
+                std::cout << "Unknown option " << argument << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    CheckSettings settings;
+
+    if (! parseArguments(argc, argv, settings))
+        return 1;
+
+    std::vector<float> noise = createNoise(settings);
+    std::vector<CheckResult> results;
+
+    checkFilters(settings, noise, results);
+    checkDelayLine<int32_t>("Q31", settings.Q31MinDb, settings, noise, results);
+    checkDelayLine<int16_t>("Q15", settings.Q15MinDb, settings, noise, results);
+
+    int numFailed = 0;
+    double worstFixedDb = 300.0, worstFloatDb = 300.0;
+
+    for (auto& result : results)
+    {
+        bool filter = result.Name.startsWith("biquad");
+
+        if (filter)
+        {
+            worstFixedDb = jmin(worstFixedDb, result.RatioDb);
+            worstFloatDb = jmin(worstFloatDb, result.FloatRatioDb);
+        }
+
+        if (! result.Passed())
+            numFailed++;
+
+        if (settings.Verbose || ! result.Passed())
+            std::cout << (result.Passed() ? "ok     " : "FAILED ") << result.Name.paddedRight(' ', 56) << String(result.RatioDb, 1).paddedLeft(' ', 8)
+                      << " dB (min " << String(result.MinimumDb, 0) << ")" << (filter ? ", float " + String(result.FloatRatioDb, 1) + " dB" : String()) << std::endl;
+    }
+
+    std::cout << results.size() << " checks, " << numFailed << " failed, worst biquad " << String(worstFixedDb, 1) << " dB (float " << String(worstFloatDb, 1) << " dB)" << std::endl;
+
+    return numFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 21 Oct 2026 1:02:44am
+    Author:  JEPlugins
+
+    Checks that the LFOs in Modulation.h keep their rate. Each sine LFO runs over whole cycles at every rate and sample rate, and the length of
+    its cycles, timed between upward zero crossings, has to be the rate's to within the tolerance. The slow rates are the ones that matter, a
+    0.01 Hz LFO runs for close to 5 million samples a cycle at 48 kHz and 19 million at 192 kHz, where any rounding that adds up per sample
+    shows. Then a tempo synced voice is lined up with the song position every block, the way a host drives it, and the correction at each
+    block start has to be no bigger than a step within a block.
+
+        ModulationCheck [options]
+
+            --tolerance <percent>  Largest error in the cycle length, 0.001 by default
+            --block <samples>      Block size the LFOs are run in, 512 by default
+            --verbose              Print every check, not only the failures and the summary
+
+    Exits with 1 if any check fails.
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <vector>
+#include <JuceHeader.h>
+
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/Modulation.h"
+
+using namespace juce;
+
+namespace
+{
+    struct CheckResult
+    {
+        String Name;
+        bool Passed = false;
+    };
+
+    struct CheckSettings
+    {
+        double TolerancePercent = 0.001;
+        int BlockSize = 512;
+        bool Verbose = false;
+    };
+
+    // Average cycle length in samples of a free running sine voice, over the given number of whole cycles.
+    double measureCycleLength(double sampleRate, float hz, int numCycles, int blockSize)
+    {
+        LfoBank bank;
+        bank.SetShape(0, LfoBank::Shape::Sine);
+        bank.SetRate(0, hz);
+        bank.Prepare(sampleRate, 1, blockSize);
+
+        // The sine starts at 0 on the way up, so the first crossing is a cycle in. Run on for half a cycle past the last one.
+        juce::int64 length = (juce::int64)(sampleRate / hz * (numCycles + 1.5));
+        double firstCrossing = -1.0, lastCrossing = -1.0;
+        int numCrossings = 0;
+        float previous = 0.0f;
+
+        for (juce::int64 position = 0; position < length; position += blockSize)
+        {
+            const float* output = bank.Process(blockSize);
+
+            for (int sample = 0; sample < blockSize; sample++)
+            {
+                float value = output[sample * bank.GetStride()];
+                juce::int64 index = position + sample;
+
+                // Where the line between the two samples crosses 0.
+                if (index > 0 && previous < 0.0f && value >= 0.0f)
+                {
+                    double crossing = (double)(index - 1) + previous / (previous - value);
+
+                    if (firstCrossing < 0.0)
+                        firstCrossing = crossing;
+                    else
+                        numCrossings++;
+
+                    lastCrossing = crossing;
+                }
+
+                previous = value;
+            }
+        }
+
+        return numCrossings > 0 ? (lastCrossing - firstCrossing) / numCrossings : 0.0;
+    }
+
+    void checkRates(const CheckSettings& settings, std::vector<CheckResult>& results)
+    {
+        const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+        const float rates[] = { 0.01f, 0.03f, 0.05f, 0.2f, 1.0f, 7.0f, 100.0f };
+
+        for (double sampleRate : sampleRates)
+        {
+            for (float hz : rates)
+            {
+                // Enough cycles to time the fast rates well, only a couple for the slow ones which are millions of samples each.
+                int numCycles = jlimit(2, 200, (int)(hz * 10.0f));
+                double expected = sampleRate / hz;
+                double measured = measureCycleLength(sampleRate, hz, numCycles, settings.BlockSize);
+                double errorPercent = (measured / expected - 1.0) * 100.0;
+
+                results.push_back({ String(hz) + " Hz at " + String(sampleRate / 1000.0) + " kHz, cycle length error " + String(errorPercent, 6) + "%",
+                                    std::abs(errorPercent) <= settings.TolerancePercent });
+            }
+        }
+    }
+
+    // A synced voice lined up with the position every block, for a few minutes of song at a tempo that doesn't divide the sample rate evenly.
+    void checkSync(const CheckSettings& settings, std::vector<CheckResult>& results)
+    {
+        const double sampleRate = 48000.0;
+        const double bpm = 137.3;
+
+        LfoBank bank;
+        bank.SetShape(0, LfoBank::Shape::Sine);
+        bank.SetSync(0, 64.0);
+        bank.SetTempo(bpm);
+        bank.Prepare(sampleRate, 1, settings.BlockSize);
+
+        float largestCorrection = 0.0f, largestStep = 0.0f;
+        float previous = 0.0f;
+        juce::int64 length = (juce::int64)(sampleRate * 180.0);
+
+        for (juce::int64 position = 0; position < length; position += settings.BlockSize)
+        {
+            bank.SyncToPosition((double)position / sampleRate * bpm / 60.0);
+            const float* output = bank.Process(settings.BlockSize);
+
+            for (int sample = 0; sample < settings.BlockSize; sample++)
+            {
+                float value = output[sample * bank.GetStride()];
+
+                if (position + sample > 0)
+                {
+                    float step = std::abs(value - previous);
+
+                    if (sample == 0)
+                        largestCorrection = jmax(largestCorrection, step);
+                    else
+                        largestStep = jmax(largestStep, step);
+                }
+
+                previous = value;
+            }
+        }
+
+        // Allow a little over the largest step for rounding.
+        results.push_back({ "synced voice, largest step at a block start " + String(largestCorrection, 8) + ", within a block " + String(largestStep, 8),
+                            largestCorrection <= largestStep * 1.1f });
+    }
+
+    bool parseArguments(int argc, char* argv[], CheckSettings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            String argument(argv[i]);
+
+            if (argument == "--verbose")
+            {
+                settings.Verbose = true;
+                continue;
+            }
+
+            if (! argument.startsWith("--") || i + 1 >= argc)
+            {
+                std::cout << "Unknown or incomplete option " << argument << std::endl;
+                return false;
+            }
+
+            String value(argv[++i]);
+
+            if (argument == "--tolerance")
+                settings.TolerancePercent = jmax(0.0, value.getDoubleValue());
+            else if (argument == "--block")
+                settings.BlockSize = jlimit(1, 65536, value.getIntValue());
+            else
+            {
+                std::cout << "Unknown option " << argument << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    CheckSettings settings;
+
+    if (! parseArguments(argc, argv, settings))
+        return 1;
+
+    std::vector<CheckResult> results;
+
+    checkRates(settings, results);
+    checkSync(settings, results);
+
+    int numFailed = 0;
+
+    for (auto& result : results)
+    {
+        if (! result.Passed)
+            numFailed++;
+
+        if (settings.Verbose || ! result.Passed)
+            std::cout << (result.Passed ? "ok     " : "FAILED ") << result.Name << std::endl;
+    }
+
+    std::cout << results.size() << " checks, " << numFailed << " failed" << std::endl;
+
+    return numFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,381 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 6:24:37pm
+    Author:  JEPlugins
+
+    Headless offline renderer. Runs one of the plugins over a batch of audio files without a plugin host, for reamping stems.
+
+        OfflineRender --plugin ts|delay|chain [options] files...
+
+            --out <dir>           Folder for the rendered files, by default they are written next to the inputs
+            --suffix <text>       Added to the rendered file names, "_<plugin>" by default
+            --param <ID>=<value>  Set a parameter, e.g. --param DRIVE=0.7 --param CLIPPER=Diode (can be repeated)
+            --automate <ID>=<value>@<seconds>
+                                  Change a parameter on the exact sample at a time in the input, e.g. --automate DRIVE=0.9@12.5 (can be repeated)
+            --block <samples>     Block size passed to the processor, 512 by default
+            --bits <16|24|32>     Output bit depth, 24 by default
+            --threads <n>         Number of files rendered at once, one per CPU by default
+            --max-tail <seconds>  Longest tail rendered after the end of the input, 30 by default
+            --no-tail             Stop at the end of the input
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <vector>
+#include <JuceHeader.h>
+#include "../../Common/HeadlessHost.h"
+
+using namespace juce;
+
+namespace
+{
+    // A parameter change at a time in the input.
+    struct AutomationPoint
+    {
+        HeadlessHost::ParameterSetting Setting;
+        double Seconds = 0.0;
+    };
+
+    struct RenderSettings
+    {
+        String PluginName;
+        std::vector<HeadlessHost::ParameterSetting> Parameters;
+        std::vector<AutomationPoint> Automation;
+        File OutputFolder;
+        String Suffix;
+        int BlockSize = 512;
+        int BitDepth = 24;
+        int NumThreads = 0;
+        double MaxTailSeconds = 30.0;
+        bool RenderTail = true;
+    };
+
+    struct RenderResult
+    {
+        bool Succeeded = false;
+        String Message;
+        double AudioSeconds = 0.0;
+        double RenderSeconds = 0.0;
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: OfflineRender --plugin <" << HeadlessHost::GetPluginNames() << "> [--out <dir>] [--suffix <text>] [--param ID=value]... [--automate ID=value@seconds]..."
+                  << " [--block <samples>] [--bits <16|24|32>] [--threads <n>] [--max-tail <seconds>] [--no-tail] files..." << std::endl;
+    }
+
+    // Open an input file. WAV files are memory mapped so every worker reads straight from the OS page cache without its own read buffers or
+    // a lock on a shared stream, anything else goes through the normal readers.
+    std::unique_ptr<AudioFormatReader> openInput(const File& file)
+    {
+        if (file.hasFileExtension("wav"))
+        {
+            WavAudioFormat wavFormat;
+            std::unique_ptr<MemoryMappedAudioFormatReader> mappedReader(wavFormat.createMemoryMappedReader(file));
+
+            if (mappedReader != nullptr && mappedReader->mapEntireFile())
+                return mappedReader;
+        }
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        return std::unique_ptr<AudioFormatReader>(formatManager.createReaderFor(file));
+    }
+
+    // Render one file with its own processor instance. The input is read, processed and written one block at a time, so memory use stays the
+    // same whatever the length of the file.
+    RenderResult renderFile(const File& inputFile, const RenderSettings& settings)
+    {
+        RenderResult result;
+        double startTime = Time::getMillisecondCounterHiRes();
+
+        std::unique_ptr<AudioFormatReader> reader = openInput(inputFile);
+
+        if (reader == nullptr)
+        {
+            result.Message = "could not open the file";
+            return result;
+        }
+
+        int numChannels = (int)reader->numChannels;
+        double sampleRate = reader->sampleRate;
+
+        std::unique_ptr<AudioProcessor> processor = HeadlessHost::CreateProcessor(settings.PluginName);
+
+        for (auto& parameter : settings.Parameters)
+            HeadlessHost::SetParameter(*processor, parameter);
+
+        if (! HeadlessHost::PrepareProcessor(*processor, numChannels, sampleRate, settings.BlockSize, true))
+        {
+            result.Message = "only mono and stereo files are supported";
+            return result;
+        }
+
+        // Write the output through a stream owned by the writer, the WAV writer streams each block straight to disk.
+        File outputFolder = settings.OutputFolder == File() ? inputFile.getParentDirectory() : settings.OutputFolder;
+        File outputFile = outputFolder.getChildFile(inputFile.getFileNameWithoutExtension() + settings.Suffix + ".wav");
+        outputFile.deleteFile();
+
+        std::unique_ptr<FileOutputStream> outputStream = outputFile.createOutputStream();
+
+        if (outputStream == nullptr || ! outputStream->openedOk())
+        {
+            result.Message = "could not create " + outputFile.getFullPathName();
+            return result;
+        }
+
+        WavAudioFormat wavFormat;
+        std::unique_ptr<AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream.get(), sampleRate, (unsigned int)numChannels, settings.BitDepth, {}, 0));
+
+        if (writer == nullptr)
+        {
+            result.Message = "could not create a WAV writer for " + String(settings.BitDepth) + " bit output";
+            return result;
+        }
+
+        outputStream.release();
+
+        // Render the input, then the tail fed with silence. The processor latency is trimmed off the start of the output and rendered on the end,
+        // so the rendered file lines up with the input.
+        int64 inputSamples = reader->lengthInSamples;
+        int latencySamples = processor->getLatencySamples();
+        int64 tailSamples = settings.RenderTail ? (int64)(jmin(processor->getTailLengthSeconds(), settings.MaxTailSeconds) * sampleRate) : 0;
+        int64 totalSamples = inputSamples + tailSamples + latencySamples;
+
+        AudioBuffer<float> buffer(numChannels, settings.BlockSize);
+        MidiBuffer midi;
+        int64 position = 0;
+        int samplesToSkip = latencySamples;
+        size_t nextPoint = 0;
+
+        while (position < totalSamples)
+        {
+            int numSamples = (int)jmin((int64)settings.BlockSize, totalSamples - position);
+            int numInputSamples = (int)jlimit((int64)0, (int64)numSamples, inputSamples - position);
+
+            // Hand the processor the automation that lands in this block at its own samples, the points are sorted by time.
+            for (; nextPoint < settings.Automation.size(); ++nextPoint)
+            {
+                auto& point = settings.Automation[nextPoint];
+                int64 pointSample = (int64)std::llround(point.Seconds * sampleRate);
+
+                if (pointSample >= position + numSamples)
+                    break;
+
+                if (! HeadlessHost::ScheduleParameter(*processor, point.Setting, (int)jmax((int64)0, pointSample - position)))
+                {
+                    result.Message = "could not automate " + point.Setting.Id + " at " + String(point.Seconds) + " s";
+                    return result;
+                }
+            }
+
+            buffer.clear();
+
+            if (numInputSamples > 0)
+                reader->read(&buffer, 0, numInputSamples, position, true, true);
+
+            // Process exactly numSamples samples without resizing the buffer.
+            AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+            processor->processBlock(block, midi);
+
+            int skipped = jmin(samplesToSkip, numSamples);
+            samplesToSkip -= skipped;
+
+            if (numSamples > skipped && ! writer->writeFromAudioSampleBuffer(block, skipped, numSamples - skipped))
+            {
+                result.Message = "write failed for " + outputFile.getFullPathName();
+                return result;
+            }
+
+            position += numSamples;
+        }
+
+        processor->releaseResources();
+        writer.reset();
+
+        result.Succeeded = true;
+        result.Message = outputFile.getFullPathName();
+        result.AudioSeconds = (double)(inputSamples + tailSamples) / sampleRate;
+        result.RenderSeconds = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+        return result;
+    }
+
+    // Read the command line, returns false (after printing why) if it can't be used.
+    bool parseArguments(int argc, char* argv[], RenderSettings& settings, std::vector<File>& inputFiles)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            String argument(argv[i]);
+            bool hasValue = i + 1 < argc;
+
+            if (argument.startsWith("--") && argument != "--no-tail" && ! hasValue)
+            {
+                std::cout << argument << " needs a value" << std::endl;
+                return false;
+            }
+
+            if (argument == "--plugin")
+                settings.PluginName = String(argv[++i]);
+            else if (argument == "--out")
+                settings.OutputFolder = File::getCurrentWorkingDirectory().getChildFile(String(argv[++i]));
+            else if (argument == "--suffix")
+                settings.Suffix = String(argv[++i]);
+            else if (argument == "--block")
+                settings.BlockSize = String(argv[++i]).getIntValue();
+            else if (argument == "--bits")
+                settings.BitDepth = String(argv[++i]).getIntValue();
+            else if (argument == "--threads")
+                settings.NumThreads = String(argv[++i]).getIntValue();
+            else if (argument == "--max-tail")
+                settings.MaxTailSeconds = String(argv[++i]).getDoubleValue();
+            else if (argument == "--no-tail")
+                settings.RenderTail = false;
+            else if (argument == "--automate")
+            {
+                String setting(argv[++i]);
+
+                if (! setting.contains("=") || ! setting.contains("@"))
+                {
+                    std::cout << "--automate needs ID=value@seconds, got " << setting << std::endl;
+                    return false;
+                }
+
+                String value = setting.fromFirstOccurrenceOf("=", false, false);
+                settings.Automation.push_back({ { setting.upToFirstOccurrenceOf("=", false, false).trim(), value.upToLastOccurrenceOf("@", false, false).trim() },
+                                                jmax(0.0, value.fromLastOccurrenceOf("@", false, false).getDoubleValue()) });
+            }
+            else if (argument == "--param")
+            {
+                String setting(argv[++i]);
+
+                if (! setting.contains("="))
+                {
+                    std::cout << "--param needs ID=value, got " << setting << std::endl;
+                    return false;
+                }
+
+                settings.Parameters.push_back({ setting.upToFirstOccurrenceOf("=", false, false).trim(), setting.fromFirstOccurrenceOf("=", false, false).trim() });
+            }
+            else if (argument.startsWith("--"))
+            {
+                std::cout << "Unknown option " << argument << std::endl;
+                return false;
+            }
+            else
+                inputFiles.push_back(File::getCurrentWorkingDirectory().getChildFile(argument));
+        }
+
+        std::unique_ptr<AudioProcessor> processor = HeadlessHost::CreateProcessor(settings.PluginName);
+
+        if (processor == nullptr || inputFiles.empty())
+        {
+            printUsage();
+            return false;
+        }
+
+        // Check the parameters once here rather than failing every file.
+        for (auto& parameter : settings.Parameters)
+        {
+            if (! HeadlessHost::SetParameter(*processor, parameter))
+            {
+                std::cout << "The " << settings.PluginName << " plugin has no parameter " << parameter.Id << std::endl;
+                return false;
+            }
+        }
+
+        for (auto& point : settings.Automation)
+        {
+            if (HeadlessHost::FindParameter(*processor, point.Setting.Id) == nullptr)
+            {
+                std::cout << "The " << settings.PluginName << " plugin has no parameter " << point.Setting.Id << std::endl;
+                return false;
+            }
+        }
+
+        std::stable_sort(settings.Automation.begin(), settings.Automation.end(),
+                         [](const AutomationPoint& a, const AutomationPoint& b) { return a.Seconds < b.Seconds; });
+
+        if (settings.BitDepth != 16 && settings.BitDepth != 24 && settings.BitDepth != 32)
+        {
+            std::cout << "--bits must be 16, 24 or 32" << std::endl;
+            return false;
+        }
+
+        if (settings.OutputFolder != File() && ! settings.OutputFolder.createDirectory())
+        {
+            std::cout << "Could not create " << settings.OutputFolder.getFullPathName() << std::endl;
+            return false;
+        }
+
+        settings.BlockSize = jlimit(1, 65536, settings.BlockSize);
+        settings.MaxTailSeconds = jmax(0.0, settings.MaxTailSeconds);
+
+        if (settings.NumThreads <= 0)
+            settings.NumThreads = SystemStats::getNumCpus();
+
+        if (settings.Suffix.isEmpty())
+            settings.Suffix = "_" + settings.PluginName.toLowerCase();
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processors' parameter trees need the message manager to exist, even though nothing here runs a message loop.
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    RenderSettings settings;
+    std::vector<File> inputFiles;
+
+    if (! parseArguments(argc, argv, settings, inputFiles))
+        return 1;
+
+    // Each file is a job on the pool with its own processor, reader and writer, so the workers share nothing and the batch scales with the cores.
+    // Results go into a slot per file so they can be reported in order once everything has finished.
+    std::vector<RenderResult> results(inputFiles.size());
+    int numThreads = jmin(settings.NumThreads, (int)inputFiles.size());
+    double startTime = Time::getMillisecondCounterHiRes();
+
+    {
+        ThreadPool pool(numThreads);
+
+        for (size_t i = 0; i < inputFiles.size(); ++i)
+            pool.addJob([&settings, &inputFiles, &results, i] { results[i] = renderFile(inputFiles[i], settings); });
+
+        while (pool.getNumJobs() > 0)
+            Thread::sleep(20);
+    }
+
+    double wallSeconds = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+    double totalAudioSeconds = 0.0;
+    int numFailed = 0;
+
+    for (size_t i = 0; i < inputFiles.size(); ++i)
+    {
+        auto& result = results[i];
+
+        if (result.Succeeded)
+        {
+            totalAudioSeconds += result.AudioSeconds;
+            std::cout << inputFiles[i].getFileName() << " -> " << result.Message << "  " << String(result.AudioSeconds, 2) << " s audio in "
+                      << String(result.RenderSeconds, 2) << " s (" << String(result.AudioSeconds / jmax(1.0e-9, result.RenderSeconds), 1) << "x realtime)" << std::endl;
+        }
+        else
+        {
+            ++numFailed;
+            std::cout << inputFiles[i].getFileName() << " FAILED: " << result.Message << std::endl;
+        }
+    }
+
+    std::cout << inputFiles.size() - (size_t)numFailed << " of " << inputFiles.size() << " files rendered on " << numThreads << " threads, "
+              << String(totalAudioSeconds, 1) << " s audio in " << String(wallSeconds, 2) << " s (" << String(totalAudioSeconds / jmax(1.0e-9, wallSeconds), 1)
+              << "x realtime)" << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
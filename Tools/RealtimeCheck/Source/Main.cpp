@@ -0,0 +1,418 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 9:17:52pm
+    Author:  JEPlugins
+
+    Real-time safety check. Runs the audio paths of the DSP classes and the plugin processors on a thread checked by RealtimeGuard, which traps any
+    allocation, lock, wait, file or memory mapping call, and sleep made on it. Setup (Init, Prepare, prepareToPlay) and everything the check itself
+    does between blocks runs outside the checked sections, the same as a host would do it on another thread. Every violation is reported with a
+    stack trace, and the exit code is 1 if there were any.
+
+        RealtimeCheck [options]
+
+            --filter <text>        Only run cases whose name contains the text
+            --seconds <s>          Audio processed per plugin case, 5 by default
+            --max-reports <n>      Stack traces printed per case, 5 by default
+            --abort                Abort at the first violation, to stop in a debugger
+
+  ==============================================================================
+*/
+
+#include <functional>
+#include <vector>
+#include <JuceHeader.h>
+#include "../../Common/HeadlessHost.h"
+#include "../../Common/RealtimeGuard.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/Biquad.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/CircularBuffer.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/DiodeClipper.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/TSStage.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/DelayStage.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/PresetState.h"
+
+using namespace juce;
+
+namespace
+{
+    static constexpr double CheckSampleRate = 48000.0;
+    static constexpr int DspBlockSize = 64;
+    static constexpr int DspNumBlocks = 2000;
+    static constexpr int MaxBlockSize = 4096;
+
+    struct CheckSettings
+    {
+        String Filter;
+        double Seconds = 5.0;
+        int MaxReports = 5;
+        bool Abort = false;
+    };
+
+    struct CheckCase
+    {
+        String Name;
+        std::function<void(const CheckSettings&)> Run;
+    };
+
+    // A play head whose tempo the check moves between blocks, so the delay's tempo sync path runs with a changing tempo.
+    class CheckPlayHead : public AudioPlayHead
+    {
+
+    public:
+
+        Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo position;
+            position.setBpm(Bpm);
+            position.setTimeInSamples(TimeInSamples);
+            position.setIsPlaying(true);
+            return position;
+        }
+
+        double Bpm = 120.0;
+        int64 TimeInSamples = 0;
+    };
+
+    // A block of noise, or silence when it falls in the gap between bursts so the processors go idle and wake up again.
+    void fillInput(float* const* channelData, int numChannels, int numSamples, int64 position, Random& random)
+    {
+        bool silent = (position / (int64)CheckSampleRate) % 2 == 1;
+
+        for (int channel = 0; channel < numChannels; channel++)
+            for (int sample = 0; sample < numSamples; sample++)
+                channelData[channel][sample] = silent ? 0.0f : (random.nextFloat() * 2.0f - 1.0f) * 0.25f;
+    }
+
+    //==============================================================================
+    // DSP classes, each prepared outside the guard and then driven through its audio thread API inside it.
+
+    void checkBiquad(const CheckSettings&)
+    {
+        Biquad filter;
+        filter.Init(BiquadType::Peaking, 1000.0f, (float)CheckSampleRate, 0.707f, 6.0f);
+
+        Random random(1);
+        RealtimeGuard::Scope scope;
+
+        for (int block = 0; block < DspNumBlocks; block++)
+        {
+            filter.SetFc(200.0f + 5000.0f * random.nextFloat());
+            filter.SetParameters(200.0f + 5000.0f * random.nextFloat(), 0.5f + random.nextFloat(), -12.0f + 24.0f * random.nextFloat());
+            filter.SetGain(-12.0f + 24.0f * random.nextFloat());
+
+            for (int sample = 0; sample < DspBlockSize; sample++)
+                filter.ProcessSample(random.nextFloat() - 0.5f);
+        }
+    }
+
+    void checkCircularBuffer(const CheckSettings&)
+    {
+        CircularBuffer delayLine;
+        delayLine.Init((int)CheckSampleRate, 2000.0f);
+
+        Random random(2);
+        RealtimeGuard::Scope scope;
+
+        for (int block = 0; block < DspNumBlocks; block++)
+        {
+            for (int sample = 0; sample < DspBlockSize; sample++)
+            {
+                delayLine.BufferWrite(random.nextFloat() - 0.5f);
+                delayLine.BufferReadSamples(1 + random.nextInt(90000));
+                delayLine.BufferRead(1.0f + 1999.0f * random.nextFloat(), true);
+                delayLine.BufferRead(1.0f + 1999.0f * random.nextFloat(), false);
+                delayLine.BufferReadFractional(1.0f + 90000.0f * random.nextFloat());
+            }
+
+            if (block % 500 == 499)
+                delayLine.ClearBuffer();
+        }
+    }
+
+    void checkDiodeClipper(const CheckSettings&)
+    {
+        DiodeClipper clipper;
+        clipper.Init((float)CheckSampleRate, 0.5f);
+
+        Random random(3);
+        RealtimeGuard::Scope scope;
+
+        for (int block = 0; block < DspNumBlocks; block++)
+        {
+            clipper.SetDrive(random.nextFloat());
+
+            for (int sample = 0; sample < DspBlockSize; sample++)
+                clipper.ProcessSample(random.nextFloat() * 2.0f - 1.0f);
+        }
+    }
+
+    void checkTSStage(bool fixedRate)
+    {
+        TSStage stage;
+        stage.SetFixedRate(fixedRate);
+        stage.Prepare(CheckSampleRate, 2);
+
+        AudioBuffer<float> buffer(2, DspBlockSize);
+        std::vector<float> levelRamp(DspBlockSize, 0.5f);
+        Random random(4);
+
+        for (int block = 0; block < DspNumBlocks; block++)
+        {
+            fillInput(buffer.getArrayOfWritePointers(), 2, DspBlockSize, (int64)block * DspBlockSize, random);
+
+            RealtimeGuard::Scope scope;
+
+            stage.Update(random.nextFloat(), random.nextFloat(), block % 2 == 0, levelRamp.data());
+            stage.Process(ChannelLayout::Stereo, buffer.getArrayOfWritePointers(), 2, 1 + random.nextInt(DspBlockSize));
+
+            if (block % 500 == 499)
+                stage.Reset();
+        }
+    }
+
+    void checkDelayStage(const CheckSettings&)
+    {
+        DelayStage stage;
+        stage.Prepare(CheckSampleRate, 2, DspBlockSize);
+
+        AudioBuffer<float> buffer(2, DspBlockSize);
+        std::vector<float> feedbackRamp(DspBlockSize, 0.5f);
+        std::vector<float> mixRamp(DspBlockSize, 0.5f);
+        std::vector<float> masterRamp(DspBlockSize, 0.5f);
+        Random random(5);
+
+        for (int block = 0; block < DspNumBlocks; block++)
+        {
+            fillInput(buffer.getArrayOfWritePointers(), 2, DspBlockSize, (int64)block * DspBlockSize, random);
+
+            RealtimeGuard::Scope scope;
+
+            // Alternate between gliding and jumping to a new delay time.
+            if (block % 50 == 0)
+                stage.SetDelayTime(1.0f + (float)CheckSampleRate * random.nextFloat(), block % 100 == 0 ? 2048 : 0);
+
+            stage.Update(block % 200 < 100, feedbackRamp.data(), mixRamp.data(), masterRamp.data());
+            stage.Process(ChannelLayout::Stereo, buffer.getArrayOfWritePointers(), 2, 1 + random.nextInt(DspBlockSize));
+
+            if (block % 500 == 499)
+                stage.Clear();
+        }
+    }
+
+    //==============================================================================
+    // Plugin processors, driven the way a host would be: with the block sizes it announced, smaller and empty blocks, blocks larger than it
+    // announced, parameter automation of every type between blocks and a play head whose tempo keeps changing.
+
+    // Move a random parameter of any type to a random value, outside the guard as the host would do it.
+    void automateParameter(AudioProcessor& processor, Random& random)
+    {
+        auto& parameters = processor.getParameters();
+
+        if (parameters.size() > 0)
+            parameters[random.nextInt((int)parameters.size())]->setValueNotifyingHost(random.nextFloat());
+    }
+
+    void checkPlugin(const String& pluginName, int preparedBlockSize, const std::function<int(Random&)>& nextBlockSize, const CheckSettings& settings)
+    {
+        std::unique_ptr<AudioProcessor> processor = HeadlessHost::CreateProcessor(pluginName);
+        CheckPlayHead playHead;
+
+        HeadlessHost::SetParameter(*processor, { "BYPASS", "OFF" });
+        HeadlessHost::PrepareProcessor(*processor, 2, CheckSampleRate, preparedBlockSize, false);
+        processor->setPlayHead(&playHead);
+
+        AudioBuffer<float> buffer(2, MaxBlockSize);
+        MidiBuffer midi;
+        Random random(6);
+
+        static const double tempos[] = { 60.0, 90.0, 120.0, 133.3, 174.0, 200.0 };
+        int64 totalSamples = (int64)(CheckSampleRate * settings.Seconds);
+
+        for (int callback = 0; playHead.TimeInSamples < totalSamples; callback++)
+        {
+            int numSamples = jlimit(0, MaxBlockSize, nextBlockSize(random));
+
+            fillInput(buffer.getArrayOfWritePointers(), 2, numSamples, playHead.TimeInSamples, random);
+            automateParameter(*processor, random);
+
+            if (callback % 40 == 0)
+                playHead.Bpm = tempos[random.nextInt((int)(sizeof(tempos) / sizeof(tempos[0])))];
+
+            AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, numSamples);
+
+            {
+                RealtimeGuard::Scope scope;
+                processor->processBlock(block, midi);
+            }
+
+            playHead.TimeInSamples += jmax(1, numSamples);
+        }
+
+        processor->setPlayHead(nullptr);
+    }
+
+    // Preset switching and morphing, which must cost the audio thread nothing but copying resolved values. A few presets are stored from random
+    // settings before the check, then every block selects a preset or moves a morph between two of them outside the guard, as the editor or host
+    // would, and the block that picks the change up runs inside it.
+    void checkPresets(const String& pluginName, const CheckSettings& settings)
+    {
+        std::unique_ptr<AudioProcessor> processor = HeadlessHost::CreateProcessor(pluginName);
+        auto* presetOwner = dynamic_cast<PresetBankOwner*>(processor.get());
+
+        HeadlessHost::SetParameter(*processor, { "BYPASS", "OFF" });
+        HeadlessHost::PrepareProcessor(*processor, 2, CheckSampleRate, 512, false);
+
+        Random random(7);
+        static constexpr int numPresets = 4;
+
+        for (int preset = 0; preset < numPresets; preset++)
+        {
+            for (int parameter = 0; parameter < 8; parameter++)
+                automateParameter(*processor, random);
+
+            HeadlessHost::SetParameter(*processor, { "BYPASS", "OFF" });
+            presetOwner->storePreset("Preset " + String(preset + 1));
+        }
+
+        AudioBuffer<float> buffer(2, 512);
+        MidiBuffer midi;
+        int64 totalSamples = (int64)(CheckSampleRate * settings.Seconds);
+
+        for (int64 position = 0; position < totalSamples; position += 512)
+        {
+            fillInput(buffer.getArrayOfWritePointers(), 2, 512, position, random);
+
+            if (random.nextInt(4) == 0)
+                presetOwner->selectPreset(random.nextInt(numPresets));
+            else
+                presetOwner->morphPresets(random.nextInt(numPresets), random.nextInt(numPresets), random.nextFloat());
+
+            RealtimeGuard::Scope scope;
+            processor->processBlock(buffer, midi);
+        }
+    }
+
+    std::vector<CheckCase> createCases()
+    {
+        std::vector<CheckCase> cases = { { "Biquad", checkBiquad },
+                                         { "CircularBuffer", checkCircularBuffer },
+                                         { "DiodeClipper", checkDiodeClipper },
+                                         { "TSStage", [](const CheckSettings&) { checkTSStage(false); } },
+                                         { "TSStage fixed rate", [](const CheckSettings&) { checkTSStage(true); } },
+                                         { "DelayStage", checkDelayStage } };
+
+        for (auto& plugin : HeadlessHost::Plugins)
+        {
+            String name(plugin.Name);
+
+            cases.push_back({ name + " fixed 512", [name](const CheckSettings& settings)
+            {
+                checkPlugin(name, 512, [](Random&) { return 512; }, settings);
+            } });
+
+            // Anything up to the announced size, including empty blocks.
+            cases.push_back({ name + " varied", [name](const CheckSettings& settings)
+            {
+                checkPlugin(name, 512, [](Random& random) { return random.nextInt(513); }, settings);
+            } });
+
+            // Blocks up to 64 times larger than the announced size.
+            cases.push_back({ name + " oversized", [name](const CheckSettings& settings)
+            {
+                checkPlugin(name, 64, [](Random& random) { return 1 + random.nextInt(MaxBlockSize); }, settings);
+            } });
+
+            // Only the plugins with a preset bank.
+            std::unique_ptr<AudioProcessor> processor(plugin.Create());
+
+            if (dynamic_cast<PresetBankOwner*>(processor.get()) != nullptr)
+            {
+                cases.push_back({ name + " presets", [name](const CheckSettings& settings)
+                {
+                    checkPresets(name, settings);
+                } });
+            }
+        }
+
+        return cases;
+    }
+
+    bool parseArguments(int argc, char* argv[], CheckSettings& settings)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            String argument(argv[i]);
+
+            if (argument == "--abort")
+            {
+                settings.Abort = true;
+                continue;
+            }
+
+            if (! argument.startsWith("--") || i + 1 >= argc)
+            {
+                std::cout << "Unknown or incomplete option " << argument << std::endl;
+                return false;
+            }
+
+            String value(argv[++i]);
+
+            if (argument == "--filter")
+                settings.Filter = value;
+            else if (argument == "--seconds")
+                settings.Seconds = jmax(0.1, value.getDoubleValue());
+            else if (argument == "--max-reports")
+                settings.MaxReports = jmax(0, value.getIntValue());
+            else
+            {
+                std::cout << "Unknown option " << argument << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // Resolve the interposed functions before anything is checked.
+    RealtimeGuard::Install();
+
+    // The processors' parameter trees need the message manager to exist, even though nothing here runs a message loop.
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    CheckSettings settings;
+
+    if (! parseArguments(argc, argv, settings))
+        return 1;
+
+    RealtimeGuard::SetAbortOnViolation(settings.Abort);
+    RealtimeGuard::SetMaxReports(settings.MaxReports);
+
+    int totalViolations = 0;
+    int numFailed = 0;
+
+    for (auto& checkCase : createCases())
+    {
+        if (settings.Filter.isNotEmpty() && ! checkCase.Name.containsIgnoreCase(settings.Filter))
+            continue;
+
+        RealtimeGuard::ResetViolations();
+        checkCase.Run(settings);
+
+        int numViolations = RealtimeGuard::GetNumViolations();
+        totalViolations += numViolations;
+
+        if (numViolations > 0)
+            ++numFailed;
+
+        std::cout << (numViolations > 0 ? "FAIL  " : "ok    ") << checkCase.Name.paddedRight(' ', 24) << numViolations << " violations" << std::endl;
+    }
+
+    std::cout << numFailed << " cases failed, " << totalViolations << " violations" << std::endl;
+
+    return totalViolations > 0 ? 1 : 0;
+}
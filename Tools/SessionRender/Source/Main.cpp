@@ -0,0 +1,285 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 20 Oct 2026 9:58:30pm
+    Author:  JEPlugins
+
+    Renders a large session of plugin processors on the SessionHost runtime and measures how it scales with threads. The session is a set of
+    tracks, each a plugin processor fed with its own noise, spread over buses that are summed into a master. The same session is rendered once for
+    each thread count, and the time taken, how much faster than real time and than one thread that is, the slowest block and the share of nodes
+    that were stolen are reported. Every render's master output is compared with the first, they must match sample for sample.
+
+        SessionRender [options]
+
+            --tracks <n>           Tracks in the session, 64 by default
+            --plugins <list>       Plugins the tracks take in turn, ts,delay by default
+            --buses <n>            Buses the tracks are spread over, 8 by default
+            --bus-plugin <name>    Plugin on every bus, none by default
+            --rate <Hz>            Sample rate, 48000 by default
+            --block <n>            Block size, 512 by default
+            --channels <n>         1 or 2, 2 by default
+            --seconds <s>          Audio rendered per thread count, 10 by default
+            --threads <list>       Thread counts to render with, 1 and then doubling up to every core by default
+
+    Returns 2 if any render's output differs from the first.
+
+  ==============================================================================
+*/
+
+#include <vector>
+#include <JuceHeader.h>
+#include "../../Common/HeadlessHost.h"
+#include "../../Common/SessionHost.h"
+#include "../../Common/TimingStats.h"
+
+using namespace juce;
+
+namespace
+{
+    struct RenderSettings
+    {
+        int NumTracks = 64;
+        StringArray Plugins { "ts", "delay" };
+        int NumBuses = 8;
+        String BusPlugin;
+        double SampleRate = 48000.0;
+        int BlockSize = 512;
+        int NumChannels = 2;
+        double Seconds = 10.0;
+        std::vector<int> ThreadCounts;
+    };
+
+    struct RenderResult
+    {
+        int NumThreads = 0;
+        double Seconds = 0.0;
+        double WorstBlockUs = 0.0;
+        double StolenPercent = 0.0;
+
+        // Master output of every block, one channel after another per block.
+        std::vector<float> Output;
+    };
+
+    std::unique_ptr<AudioProcessor> createPlugin(const String& name)
+    {
+        std::unique_ptr<AudioProcessor> processor = HeadlessHost::CreateProcessor(name);
+
+        // Keep the TS switched on, its bypass parameter defaults to on.
+        if (processor != nullptr)
+            HeadlessHost::SetParameter(*processor, { "BYPASS", "OFF" });
+
+        return processor;
+    }
+
+    // Tracks take the plugins in turn and the buses in turn, the master is the last node. Each track's noise comes from its own generator, so a
+    // track's input does not depend on which thread runs it or when.
+    int buildSession(SessionHost& session, const RenderSettings& settings)
+    {
+        std::vector<int> buses;
+
+        for (int bus = 0; bus < settings.NumBuses; bus++)
+            buses.push_back(session.AddNode("bus " + String(bus + 1), settings.BusPlugin.isEmpty() ? nullptr : createPlugin(settings.BusPlugin)));
+
+        for (int track = 0; track < settings.NumTracks; track++)
+        {
+            auto random = std::make_shared<Random>(0x5eed + track);
+
+            int node = session.AddNode("track " + String(track + 1), createPlugin(settings.Plugins[track % settings.Plugins.size()]),
+                                       [random](AudioBuffer<float>& buffer, int numSamples)
+            {
+                for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+                    for (int sample = 0; sample < numSamples; sample++)
+                        buffer.getWritePointer(channel)[sample] = (random->nextFloat() * 2.0f - 1.0f) * 0.25f;
+            });
+
+            session.Connect(node, buses[(size_t)(track % (int)buses.size())]);
+        }
+
+        int master = session.AddNode("master", nullptr);
+
+        for (int bus : buses)
+            session.Connect(bus, master);
+
+        return master;
+    }
+
+    bool render(int numThreads, const RenderSettings& settings, RenderResult& result)
+    {
+        SessionHost session;
+        int master = buildSession(session, settings);
+
+        if (! session.Prepare(settings.SampleRate, settings.BlockSize, settings.NumChannels, numThreads))
+            return false;
+
+        int numBlocks = jmax(1, (int)std::ceil(settings.SampleRate * settings.Seconds / settings.BlockSize));
+        TimingStats::Collector blockTimes;
+        blockTimes.Reserve((size_t)numBlocks);
+
+        result.NumThreads = numThreads;
+        result.Output.reserve((size_t)numBlocks * (size_t)(settings.BlockSize * settings.NumChannels));
+
+        int64 startTicks = TimingStats::Now();
+
+        for (int block = 0; block < numBlocks; block++)
+        {
+            int64 blockStartTicks = TimingStats::Now();
+            session.Process(settings.BlockSize);
+            blockTimes.Add(TimingStats::ElapsedNs(blockStartTicks, TimingStats::Now()));
+
+            // Copying the output is not part of the block's time, but it is part of the total, keep it small.
+            const AudioBuffer<float>& output = session.GetOutput(master);
+
+            for (int channel = 0; channel < settings.NumChannels; channel++)
+                result.Output.insert(result.Output.end(), output.getReadPointer(channel), output.getReadPointer(channel) + settings.BlockSize);
+        }
+
+        result.Seconds = TimingStats::ElapsedNs(startTicks, TimingStats::Now()) * 1.0e-9;
+        result.WorstBlockUs = blockTimes.Max() * 0.001;
+
+        int64 nodesRun = 0;
+        int64 nodesStolen = 0;
+
+        for (int thread = 0; thread < session.GetNumThreads(); thread++)
+        {
+            nodesRun += session.GetThreadStats(thread).NodesRun;
+            nodesStolen += session.GetThreadStats(thread).NodesStolen;
+        }
+
+        result.StolenPercent = nodesRun > 0 ? 100.0 * (double)nodesStolen / (double)nodesRun : 0.0;
+        return true;
+    }
+
+    bool parseArguments(int argc, char* argv[], RenderSettings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            String argument(argv[i]);
+
+            if (! argument.startsWith("--") || i + 1 >= argc)
+            {
+                std::cout << "Unknown or incomplete option " << argument << std::endl;
+                return false;
+            }
+
+            String value(argv[++i]);
+
+            if (argument == "--tracks")
+                settings.NumTracks = jmax(1, value.getIntValue());
+            else if (argument == "--plugins")
+            {
+                settings.Plugins = StringArray();
+                settings.Plugins.addTokens(value, ",", "");
+            }
+            else if (argument == "--buses")
+                settings.NumBuses = jmax(1, value.getIntValue());
+            else if (argument == "--bus-plugin")
+                settings.BusPlugin = value == "none" ? String() : value;
+            else if (argument == "--rate")
+                settings.SampleRate = jmax(8000.0, value.getDoubleValue());
+            else if (argument == "--block")
+                settings.BlockSize = jlimit(1, 8192, value.getIntValue());
+            else if (argument == "--channels")
+                settings.NumChannels = jlimit(1, 2, value.getIntValue());
+            else if (argument == "--seconds")
+                settings.Seconds = jmax(0.01, value.getDoubleValue());
+            else if (argument == "--threads")
+            {
+                StringArray counts;
+                counts.addTokens(value, ",", "");
+
+                for (auto& count : counts)
+                    settings.ThreadCounts.push_back(jmax(1, count.getIntValue()));
+            }
+            else
+            {
+                std::cout << "Unknown option " << argument << std::endl;
+                return false;
+            }
+        }
+
+        if (settings.Plugins.isEmpty())
+        {
+            std::cout << "No plugins for the tracks" << std::endl;
+            return false;
+        }
+
+        StringArray plugins(settings.Plugins);
+
+        if (settings.BusPlugin.isNotEmpty())
+            plugins.add(settings.BusPlugin);
+
+        for (auto& plugin : plugins)
+        {
+            if (HeadlessHost::CreateProcessor(plugin) == nullptr)
+            {
+                std::cout << "Unknown plugin " << plugin << ", the plugins are " << HeadlessHost::GetPluginNames() << std::endl;
+                return false;
+            }
+        }
+
+        // One thread, then twice as many each time up to every core, and every core itself if that is not a power of two.
+        if (settings.ThreadCounts.empty())
+        {
+            int numCores = jmax(1, SystemStats::getNumCpus());
+
+            for (int count = 1; count < numCores; count *= 2)
+                settings.ThreadCounts.push_back(count);
+
+            settings.ThreadCounts.push_back(numCores);
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processors' parameter trees need the message manager to exist, even though nothing here runs a message loop.
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    RenderSettings settings;
+
+    if (! parseArguments(argc, argv, settings))
+        return 1;
+
+    std::cout << settings.NumTracks << " tracks (" << settings.Plugins.joinIntoString(",") << ") over " << settings.NumBuses << " buses ("
+              << (settings.BusPlugin.isEmpty() ? String("no plugin") : settings.BusPlugin) << "), " << String(settings.Seconds, 1) << " s at "
+              << String(settings.SampleRate, 0) << " Hz in blocks of " << settings.BlockSize << std::endl;
+
+    std::cout << String("threads").paddedLeft(' ', 8) << String("seconds").paddedLeft(' ', 10) << String("realtime").paddedLeft(' ', 10)
+              << String("speedup").paddedLeft(' ', 9) << String("efficiency").paddedLeft(' ', 12) << String("worst block us").paddedLeft(' ', 16)
+              << String("stolen").paddedLeft(' ', 8) << String("output").paddedLeft(' ', 10) << std::endl;
+
+    std::vector<RenderResult> results;
+    bool allMatch = true;
+
+    for (int numThreads : settings.ThreadCounts)
+    {
+        RenderResult result;
+
+        if (! render(numThreads, settings, result))
+        {
+            std::cout << "Could not prepare the session" << std::endl;
+            return 1;
+        }
+
+        // Speed up against the first render, one thread by default, and how close that is to the thread count times as fast.
+        const RenderResult& first = results.empty() ? result : results.front();
+        double speedup = first.Seconds / result.Seconds;
+        double efficiency = 100.0 * speedup * first.NumThreads / numThreads;
+        bool matches = result.Output == first.Output;
+        allMatch = allMatch && matches;
+
+        std::cout << String(numThreads).paddedLeft(' ', 8) << String(result.Seconds, 3).paddedLeft(' ', 10)
+                  << (String(settings.Seconds / result.Seconds, 1) + "x").paddedLeft(' ', 10) << (String(speedup, 2) + "x").paddedLeft(' ', 9)
+                  << (String(efficiency, 0) + "%").paddedLeft(' ', 12) << String(result.WorstBlockUs, 0).paddedLeft(' ', 16)
+                  << (String(result.StolenPercent, 1) + "%").paddedLeft(' ', 8) << String(matches ? "match" : "DIFFERS").paddedLeft(' ', 10)
+                  << std::endl;
+
+        results.push_back(std::move(result));
+    }
+
+    return allMatch ? 0 : 2;
+}
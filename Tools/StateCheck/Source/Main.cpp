@@ -0,0 +1,262 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 21 Oct 2026 12:20:37am
+    Author:  JEPlugins
+
+    Checks the compact binary state format in PresetState.h. A chunk with a current state and a bank of presets is written and read back and has
+    to come back the same, and chunks that must be refused (a newer version, the wrong magic, every truncation of a good chunk) have to be
+    refused without touching what the reader was given. Then every plugin with a preset bank has presets stored, its state saved and loaded
+    into a new instance, and the new instance has to save the same state, with its values within a rounding error.
+
+        StateCheck [options]
+
+            --verbose              Print every check, not only the failures and the summary
+
+    Switching and morphing presets without allocating is checked by RealtimeCheck, in its "presets" cases.
+
+    Exits with 1 if any check fails.
+
+  ==============================================================================
+*/
+
+#include <vector>
+#include <JuceHeader.h>
+#include "../../Common/HeadlessHost.h"
+#include "../../../Episode 5 - Effect Chain/ChainPlugin/Source/PresetState.h"
+
+using namespace juce;
+
+namespace
+{
+    struct CheckResult
+    {
+        String Name;
+        bool Passed = false;
+    };
+
+    // Values are compared within tolerance, a parameter set from a state goes through its normalised range, which can move it by a rounding error.
+    bool sameState(const PresetState& a, const PresetState& b, float tolerance = 0.0f)
+    {
+        if (a.Name != b.Name || a.Properties != b.Properties || a.Values.size() != b.Values.size())
+            return false;
+
+        for (size_t i = 0; i < a.Values.size(); i++)
+            if (a.Values[i].first != b.Values[i].first || std::abs(a.Values[i].second - b.Values[i].second) > tolerance * jmax(1.0f, std::abs(a.Values[i].second)))
+                return false;
+
+        return true;
+    }
+
+    // Read two chunks and compare them.
+    bool sameChunk(const MemoryBlock& a, const MemoryBlock& b, float tolerance)
+    {
+        PresetState currentA, currentB;
+        std::vector<PresetState> presetsA, presetsB;
+        int presetA = -1, presetB = -1;
+
+        if (! PresetState::ReadChunk(a.getData(), (int)a.getSize(), currentA, presetA, presetsA)
+         || ! PresetState::ReadChunk(b.getData(), (int)b.getSize(), currentB, presetB, presetsB))
+            return false;
+
+        if (presetA != presetB || presetsA.size() != presetsB.size() || ! sameState(currentA, currentB, tolerance))
+            return false;
+
+        for (size_t i = 0; i < presetsA.size(); i++)
+            if (! sameState(presetsA[i], presetsB[i], tolerance))
+                return false;
+
+        return true;
+    }
+
+    // A current state and a bank with presets of different sizes, including an empty one and names and values that are not plain ASCII.
+    void createStates(PresetState& current, std::vector<PresetState>& presets)
+    {
+        current.Name = "Current";
+        current.Values = { { "DRIVE", 0.7f }, { "TONE", 0.25f }, { "CLIPPER", 1.0f } };
+        current.SetProperty("CabinetFile", "/IRs/4x12 Gr\xc3\xbcn.wav");
+
+        presets.resize(3);
+
+        presets[0].Name = "Verse";
+        presets[0].Values = { { "DRIVE", 0.2f }, { "LEVEL", -6.5f } };
+
+        presets[1].Name = "Chorus \xe2\x99\xaf";
+        presets[1].Values = { { "DRIVE", 1.0f }, { "DELAYTIMEMS", 375.0f }, { "FEEDBACK", 1.0e-7f } };
+        presets[1].SetProperty("Note", "");
+
+        presets[2].Name = "";
+    }
+
+    void checkChunks(std::vector<CheckResult>& results)
+    {
+        PresetState current;
+        std::vector<PresetState> presets;
+        createStates(current, presets);
+
+        MemoryBlock chunk;
+        PresetState::WriteChunk(chunk, current, 1, presets);
+
+        // A good chunk reads back the same.
+        {
+            PresetState readCurrent;
+            std::vector<PresetState> readPresets;
+            int readPreset = -1;
+
+            bool read = PresetState::ReadChunk(chunk.getData(), (int)chunk.getSize(), readCurrent, readPreset, readPresets);
+            bool same = read && readPreset == 1 && sameState(readCurrent, current) && readPresets.size() == presets.size();
+
+            for (size_t i = 0; same && i < presets.size(); i++)
+                same = sameState(readPresets[i], presets[i]);
+
+            results.push_back({ "chunk round trip", same });
+        }
+
+        // Anything refused has to leave the reader's arguments as they were.
+        auto checkRefused = [&results](const String& name, const void* data, int sizeInBytes)
+        {
+            PresetState readCurrent;
+            readCurrent.Name = "Untouched";
+            std::vector<PresetState> readPresets(2);
+            int readPreset = 7;
+
+            bool read = PresetState::ReadChunk(data, sizeInBytes, readCurrent, readPreset, readPresets);
+
+            results.push_back({ name, ! read && readCurrent.Name == "Untouched" && readPresets.size() == 2 && readPreset == 7 });
+        };
+
+        // The version follows the magic, a newer one is refused and an older one is read.
+        {
+            MemoryBlock newer(chunk);
+            static_cast<char*>(newer.getData())[4] = (char)(PresetState::Version + 1);
+            checkRefused("newer version refused", newer.getData(), (int)newer.getSize());
+
+            MemoryBlock older(chunk);
+            static_cast<char*>(older.getData())[4] = 0;
+
+            PresetState readCurrent;
+            std::vector<PresetState> readPresets;
+            int readPreset = -1;
+
+            results.push_back({ "older version read", PresetState::ReadChunk(older.getData(), (int)older.getSize(), readCurrent, readPreset, readPresets)
+                                                      && sameState(readCurrent, current) });
+        }
+
+        {
+            MemoryBlock wrongMagic(chunk);
+            static_cast<char*>(wrongMagic.getData())[0] ^= 0x20;
+            checkRefused("wrong magic refused", wrongMagic.getData(), (int)wrongMagic.getSize());
+        }
+
+        checkRefused("null chunk refused", nullptr, 0);
+
+        // Every truncation of the chunk, from empty to one byte short.
+        {
+            int numAccepted = 0;
+
+            for (int size = 0; size < (int)chunk.getSize(); size++)
+            {
+                PresetState readCurrent;
+                std::vector<PresetState> readPresets;
+                int readPreset = -1;
+
+                if (PresetState::ReadChunk(chunk.getData(), size, readCurrent, readPreset, readPresets))
+                    numAccepted++;
+            }
+
+            results.push_back({ "truncated chunks refused (" + String((int)chunk.getSize()) + " lengths)", numAccepted == 0 });
+        }
+    }
+
+    // Save a plugin with presets and load it into a new instance, which has to save the same state back.
+    void checkPlugin(const String& pluginName, std::vector<CheckResult>& results)
+    {
+        std::unique_ptr<AudioProcessor> processor = HeadlessHost::CreateProcessor(pluginName);
+        auto* presetOwner = dynamic_cast<PresetBankOwner*>(processor.get());
+
+        if (presetOwner == nullptr)
+            return;
+
+        HeadlessHost::PrepareProcessor(*processor, 2, 48000.0, 512, true);
+
+        Random random(8);
+
+        for (int preset = 0; preset < 3; preset++)
+        {
+            for (auto* parameter : processor->getParameters())
+                parameter->setValueNotifyingHost(random.nextFloat());
+
+            presetOwner->storePreset("Preset " + String(preset + 1));
+        }
+
+        presetOwner->selectPreset(1);
+
+        MemoryBlock saved;
+        processor->getStateInformation(saved);
+
+        std::unique_ptr<AudioProcessor> loaded = HeadlessHost::CreateProcessor(pluginName);
+        HeadlessHost::PrepareProcessor(*loaded, 2, 48000.0, 512, true);
+        loaded->setStateInformation(saved.getData(), (int)saved.getSize());
+
+        MemoryBlock resaved;
+        loaded->getStateInformation(resaved);
+
+        auto* loadedOwner = dynamic_cast<PresetBankOwner*>(loaded.get());
+
+        results.push_back({ pluginName + " state round trip", sameChunk(saved, resaved, 1.0e-5f) && loadedOwner->getNumPresets() == 3 && loadedOwner->getSelectedPreset() == 1
+                                                              && loaded->getNumPrograms() == 3 && loaded->getProgramName(2) == "Preset 3" });
+    }
+
+    bool parseArguments(int argc, char* argv[], bool& verbose)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            String argument(argv[i]);
+
+            if (argument == "--verbose")
+                verbose = true;
+            else
+            {
+                std::cout << "Unknown option " << argument << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processors' parameter trees need the message manager to exist, even though nothing here runs a message loop.
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    bool verbose = false;
+
+    if (! parseArguments(argc, argv, verbose))
+        return 1;
+
+    std::vector<CheckResult> results;
+
+    checkChunks(results);
+
+    for (auto& plugin : HeadlessHost::Plugins)
+        checkPlugin(plugin.Name, results);
+
+    int numFailed = 0;
+
+    for (auto& result : results)
+    {
+        if (! result.Passed)
+            numFailed++;
+
+        if (verbose || ! result.Passed)
+            std::cout << (result.Passed ? "ok     " : "FAILED ") << result.Name << std::endl;
+    }
+
+    std::cout << results.size() << " checks, " << numFailed << " failed" << std::endl;
+
+    return numFailed > 0 ? 1 : 0;
+}
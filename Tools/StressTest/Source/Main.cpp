@@ -0,0 +1,361 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 7:48:26pm
+    Author:  JEPlugins
+
+    Block size and deadline stress test. Each plugin processor is driven the way different hosts drive it, with fixed, random and pathological
+    sequences of block sizes at several sample rates. Every processBlock call is timed against the time the host has to fill that buffer, and the
+    worst case, the percentiles and the number of missed deadlines are reported.
+
+        StressTest [options]
+
+            --plugins <list>       Plugins to test, ts,delay,chain by default
+            --rates <list>         Sample rates, 44100,48000,96000,192000 by default
+            --channels <n>         1 or 2, 2 by default
+            --scenario <text>      Only run scenarios whose name contains the text
+            --seconds <s>          Audio processed per scenario, 10 by default
+            --budget <percent>     Share of each buffer's duration a callback may use before it counts as a miss, 100 by default
+            --signal <type>        noise, or bursts of noise with silence between them to exercise the idle switching, noise by default
+            --automate             Move a random parameter before every callback, as host automation would
+            --json <file>          Write the results as JSON
+            --fail-on-miss         Exit with 2 if any deadline is missed
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <JuceHeader.h>
+#include "../../Common/HeadlessHost.h"
+#include "../../Common/TimingStats.h"
+
+using namespace juce;
+
+namespace
+{
+    static constexpr int MaxBlockSize = 4096;
+
+    struct StressSettings
+    {
+        StringArray Plugins { "ts", "delay", "chain" };
+        std::vector<double> SampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+        int NumChannels = 2;
+        String ScenarioFilter;
+        double Seconds = 10.0;
+        double BudgetPercent = 100.0;
+        bool BurstSignal = false;
+        bool Automate = false;
+        File JsonFile;
+        bool FailOnMiss = false;
+    };
+
+    // A sequence of block sizes, and the block size announced in prepareToPlay. Some hosts deliver blocks larger than they announced, so the
+    // announced size is not always the largest block in the sequence.
+    struct Scenario
+    {
+        String Name;
+        int PreparedBlockSize;
+        std::function<int(Random&, int callbackIndex)> NextBlockSize;
+    };
+
+    struct StressResult
+    {
+        String Plugin;
+        String Scenario;
+        double SampleRate = 0.0;
+        int NumCallbacks = 0;
+        double WorstUs = 0.0;
+        double MedianUs = 0.0;
+        double P99Us = 0.0;
+        double P999Us = 0.0;
+        double WorstLoadPercent = 0.0;
+        double P99LoadPercent = 0.0;
+        int NumMisses = 0;
+    };
+
+    std::vector<Scenario> createScenarios()
+    {
+        std::vector<Scenario> scenarios;
+
+        // Every common fixed buffer size.
+        for (int blockSize : { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 })
+            scenarios.push_back({ "fixed " + String(blockSize), blockSize, [blockSize](Random&, int) { return blockSize; } });
+
+        // Hosts that split their buffers at automation or loop points deliver any size up to the announced one.
+        scenarios.push_back({ "random 1-64", 64, [](Random& random, int) { return 1 + random.nextInt(64); } });
+        scenarios.push_back({ "random 1-4096", MaxBlockSize, [](Random& random, int) { return 1 + random.nextInt(MaxBlockSize); } });
+
+        // Sizes that sit either side of the processors' sub-block lengths and ramp sizes, single samples and empty blocks.
+        scenarios.push_back({ "pathological", 512, [](Random&, int callbackIndex)
+        {
+            static const int sizes[] = { 1, 512, 0, 2, 3, 31, 33, 63, 65, 127, 129, 511, 1, 1, 1, 513, 4096, 1, 4095, 17 };
+            return sizes[callbackIndex % (int)(sizeof(sizes) / sizeof(sizes[0]))];
+        } });
+
+        // A host that announces a small block then delivers much larger ones.
+        scenarios.push_back({ "oversized", 64, [](Random& random, int) { return 64 + random.nextInt(MaxBlockSize - 64 + 1); } });
+
+        return scenarios;
+    }
+
+    // Move a random float parameter to a random value, the way host automation would between callbacks.
+    void automateParameter(AudioProcessor& processor, Random& random)
+    {
+        auto& parameters = processor.getParameters();
+
+        if (parameters.size() == 0)
+            return;
+
+        auto* parameter = parameters[random.nextInt((int)parameters.size())];
+
+        if (dynamic_cast<AudioParameterFloat*>(parameter) != nullptr)
+            parameter->setValueNotifyingHost(random.nextFloat());
+    }
+
+    StressResult runScenario(const String& pluginName, const Scenario& scenario, double sampleRate, const StressSettings& settings)
+    {
+        std::unique_ptr<AudioProcessor> processor = HeadlessHost::CreateProcessor(pluginName);
+
+        // Keep the TS switched on, its bypass parameter defaults to on.
+        HeadlessHost::SetParameter(*processor, { "BYPASS", "OFF" });
+        HeadlessHost::PrepareProcessor(*processor, settings.NumChannels, sampleRate, scenario.PreparedBlockSize, false);
+
+        // Two seconds of input, either noise or a half second noise burst followed by silence long enough for the processors to go idle.
+        int inputLength = (int)(sampleRate * 2.0) + MaxBlockSize;
+        AudioBuffer<float> input(settings.NumChannels, inputLength);
+        AudioBuffer<float> buffer(settings.NumChannels, MaxBlockSize);
+        MidiBuffer midi;
+        Random random(0x5eed);
+
+        for (int channel = 0; channel < settings.NumChannels; channel++)
+            for (int sample = 0; sample < inputLength; sample++)
+                input.getWritePointer(channel)[sample] = (settings.BurstSignal && sample > (int)(sampleRate * 0.5)) ? 0.0f : (random.nextFloat() * 2.0f - 1.0f) * 0.25f;
+
+        int64 totalSamples = (int64)(sampleRate * settings.Seconds);
+        TimingStats::Collector callbackTimes;
+        TimingStats::Collector callbackLoads;
+        callbackTimes.Reserve((size_t)totalSamples + 1024);
+        callbackLoads.Reserve((size_t)totalSamples + 1024);
+
+        int numMisses = 0;
+        int inputPosition = 0;
+        int callbackIndex = 0;
+        double budgetScale = settings.BudgetPercent / 100.0;
+
+        for (int64 processed = 0; processed < totalSamples; ++callbackIndex)
+        {
+            int numSamples = jlimit(0, MaxBlockSize, scenario.NextBlockSize(random, callbackIndex));
+
+            if (inputPosition + numSamples > inputLength - MaxBlockSize)
+                inputPosition = 0;
+
+            for (int channel = 0; channel < settings.NumChannels; channel++)
+                buffer.copyFrom(channel, 0, input, channel, inputPosition, numSamples);
+
+            if (settings.Automate)
+                automateParameter(*processor, random);
+
+            AudioBuffer<float> block(buffer.getArrayOfWritePointers(), settings.NumChannels, numSamples);
+
+            int64 startTicks = TimingStats::Now();
+            processor->processBlock(block, midi);
+            double elapsedNs = TimingStats::ElapsedNs(startTicks, TimingStats::Now());
+
+            callbackTimes.Add(elapsedNs);
+
+            // An empty block has no deadline of its own, so it only counts towards the timings.
+            if (numSamples > 0)
+            {
+                double deadlineNs = (double)numSamples / sampleRate * 1.0e9;
+                callbackLoads.Add(elapsedNs / deadlineNs * 100.0);
+
+                if (elapsedNs > deadlineNs * budgetScale)
+                    ++numMisses;
+            }
+
+            inputPosition += numSamples;
+            processed += jmax(1, numSamples);
+        }
+
+        StressResult result;
+        result.Plugin = pluginName;
+        result.Scenario = scenario.Name;
+        result.SampleRate = sampleRate;
+        result.NumCallbacks = (int)callbackTimes.Size();
+        result.WorstUs = callbackTimes.Max() * 0.001;
+        result.MedianUs = callbackTimes.Median() * 0.001;
+        result.P99Us = callbackTimes.Percentile(99.0) * 0.001;
+        result.P999Us = callbackTimes.Percentile(99.9) * 0.001;
+        result.WorstLoadPercent = callbackLoads.Max();
+        result.P99LoadPercent = callbackLoads.Percentile(99.0);
+        result.NumMisses = numMisses;
+        return result;
+    }
+
+    var resultsToJson(const std::vector<StressResult>& results, const StressSettings& settings)
+    {
+        auto* root = new DynamicObject();
+        root->setProperty("date", Time::getCurrentTime().toISO8601(true));
+        root->setProperty("cpu", SystemStats::getCpuModel());
+        root->setProperty("os", SystemStats::getOperatingSystemName());
+       #if JUCE_DEBUG
+        root->setProperty("build", "Debug");
+       #else
+        root->setProperty("build", "Release");
+       #endif
+        root->setProperty("channels", settings.NumChannels);
+        root->setProperty("budgetPercent", settings.BudgetPercent);
+        root->setProperty("signal", settings.BurstSignal ? "bursts" : "noise");
+        root->setProperty("automate", settings.Automate);
+
+        Array<var> resultArray;
+
+        for (auto& result : results)
+        {
+            auto* entry = new DynamicObject();
+            entry->setProperty("plugin", result.Plugin);
+            entry->setProperty("scenario", result.Scenario);
+            entry->setProperty("sampleRate", result.SampleRate);
+            entry->setProperty("callbacks", result.NumCallbacks);
+            entry->setProperty("worstUs", result.WorstUs);
+            entry->setProperty("medianUs", result.MedianUs);
+            entry->setProperty("p99Us", result.P99Us);
+            entry->setProperty("p999Us", result.P999Us);
+            entry->setProperty("worstLoadPercent", result.WorstLoadPercent);
+            entry->setProperty("p99LoadPercent", result.P99LoadPercent);
+            entry->setProperty("misses", result.NumMisses);
+            resultArray.add(var(entry));
+        }
+
+        root->setProperty("results", resultArray);
+        return var(root);
+    }
+
+    bool parseArguments(int argc, char* argv[], StressSettings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            String argument(argv[i]);
+
+            if (argument == "--automate")
+            {
+                settings.Automate = true;
+                continue;
+            }
+
+            if (argument == "--fail-on-miss")
+            {
+                settings.FailOnMiss = true;
+                continue;
+            }
+
+            if (! argument.startsWith("--") || i + 1 >= argc)
+            {
+                std::cout << "Unknown or incomplete option " << argument << std::endl;
+                return false;
+            }
+
+            String value(argv[++i]);
+
+            if (argument == "--plugins")
+            {
+                settings.Plugins = StringArray();
+                settings.Plugins.addTokens(value, ",", "");
+            }
+            else if (argument == "--rates")
+            {
+                StringArray rates;
+                rates.addTokens(value, ",", "");
+                settings.SampleRates.clear();
+
+                for (auto& rate : rates)
+                    if (rate.getDoubleValue() >= 8000.0)
+                        settings.SampleRates.push_back(rate.getDoubleValue());
+            }
+            else if (argument == "--channels")
+                settings.NumChannels = jlimit(1, 2, value.getIntValue());
+            else if (argument == "--scenario")
+                settings.ScenarioFilter = value;
+            else if (argument == "--seconds")
+                settings.Seconds = jmax(0.01, value.getDoubleValue());
+            else if (argument == "--budget")
+                settings.BudgetPercent = jmax(1.0, value.getDoubleValue());
+            else if (argument == "--signal")
+                settings.BurstSignal = value == "bursts";
+            else if (argument == "--json")
+                settings.JsonFile = File::getCurrentWorkingDirectory().getChildFile(value);
+            else
+            {
+                std::cout << "Unknown option " << argument << std::endl;
+                return false;
+            }
+        }
+
+        for (auto& plugin : settings.Plugins)
+        {
+            if (HeadlessHost::CreateProcessor(plugin) == nullptr)
+            {
+                std::cout << "Unknown plugin " << plugin << ", the plugins are " << HeadlessHost::GetPluginNames() << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processors' parameter trees need the message manager to exist, even though nothing here runs a message loop.
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StressSettings settings;
+
+    if (! parseArguments(argc, argv, settings))
+        return 1;
+
+    std::vector<Scenario> scenarios = createScenarios();
+    std::vector<StressResult> results;
+    int totalMisses = 0;
+
+    std::cout << String("plugin").paddedRight(' ', 8) << String("scenario").paddedRight(' ', 16) << String("rate").paddedLeft(' ', 8)
+              << String("calls").paddedLeft(' ', 9) << String("median us").paddedLeft(' ', 11) << String("p99 us").paddedLeft(' ', 10)
+              << String("p99.9 us").paddedLeft(' ', 10) << String("worst us").paddedLeft(' ', 10) << String("worst load").paddedLeft(' ', 12)
+              << String("misses").paddedLeft(' ', 8) << std::endl;
+
+    for (auto& plugin : settings.Plugins)
+    {
+        for (double sampleRate : settings.SampleRates)
+        {
+            for (auto& scenario : scenarios)
+            {
+                if (settings.ScenarioFilter.isNotEmpty() && ! scenario.Name.containsIgnoreCase(settings.ScenarioFilter))
+                    continue;
+
+                StressResult result = runScenario(plugin, scenario, sampleRate, settings);
+                results.push_back(result);
+                totalMisses += result.NumMisses;
+
+                std::cout << plugin.paddedRight(' ', 8) << scenario.Name.paddedRight(' ', 16) << String(sampleRate, 0).paddedLeft(' ', 8)
+                          << String(result.NumCallbacks).paddedLeft(' ', 9) << String(result.MedianUs, 2).paddedLeft(' ', 11)
+                          << String(result.P99Us, 2).paddedLeft(' ', 10) << String(result.P999Us, 2).paddedLeft(' ', 10)
+                          << String(result.WorstUs, 2).paddedLeft(' ', 10) << (String(result.WorstLoadPercent, 1) + "%").paddedLeft(' ', 12)
+                          << String(result.NumMisses).paddedLeft(' ', 8) << std::endl;
+            }
+        }
+    }
+
+    std::cout << totalMisses << " missed deadlines at a " << String(settings.BudgetPercent, 0) << "% budget" << std::endl;
+
+    if (settings.JsonFile != File() && ! settings.JsonFile.replaceWithText(JSON::toString(resultsToJson(results, settings))))
+    {
+        std::cout << "Could not write " << settings.JsonFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    return (settings.FailOnMiss && totalMisses > 0) ? 2 : 0;
+}